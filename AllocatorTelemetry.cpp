@@ -0,0 +1,234 @@
+#include "AllocatorTelemetry.h"
+
+#include <algorithm>
+#include <iomanip>
+
+Graphics::AllocatorCounters::AllocatorCounters(std::initializer_list<const char*> _categoryNames)
+	: categoryNames(_categoryNames), categoryCounters(_categoryNames.size(), Counters{}), totalCounters{}
+{
+
+}
+
+Graphics::AllocatorCounters::~AllocatorCounters()
+{
+	categoryCounters.clear();
+}
+
+void Graphics::AllocatorCounters::AddAllocation(size_t categoryId, uint64_t requestedBytes) noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (auto* counters : { &categoryCounters[categoryId], &totalCounters })
+	{
+		counters->allocationsCount++;
+		counters->requestedBytes += requestedBytes;
+
+		UpdatePeaks(*counters);
+	}
+}
+
+void Graphics::AllocatorCounters::RemoveAllocation(size_t categoryId, uint64_t requestedBytes) noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (auto* counters : { &categoryCounters[categoryId], &totalCounters })
+	{
+		counters->allocationsCount--;
+		counters->requestedBytes -= requestedBytes;
+	}
+}
+
+void Graphics::AllocatorCounters::AddPage(size_t categoryId, uint64_t reservedBytes) noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (auto* counters : { &categoryCounters[categoryId], &totalCounters })
+	{
+		counters->pagesCount++;
+		counters->reservedBytes += reservedBytes;
+
+		UpdatePeaks(*counters);
+	}
+}
+
+void Graphics::AllocatorCounters::RemovePage(size_t categoryId, uint64_t reservedBytes) noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (auto* counters : { &categoryCounters[categoryId], &totalCounters })
+	{
+		counters->pagesCount--;
+		counters->reservedBytes -= reservedBytes;
+	}
+}
+
+void Graphics::AllocatorCounters::FillTelemetry(const char* allocatorName, AllocatorTelemetry& telemetry) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	telemetry = {};
+	telemetry.allocatorName = allocatorName;
+	telemetry.peakRequestedBytes = totalCounters.peakRequestedBytes;
+	telemetry.peakReservedBytes = totalCounters.peakReservedBytes;
+	telemetry.categories.resize(categoryCounters.size());
+
+	for (size_t categoryId = 0; categoryId < categoryCounters.size(); categoryId++)
+	{
+		const auto& counters = categoryCounters[categoryId];
+		auto& categoryTelemetry = telemetry.categories[categoryId];
+
+		categoryTelemetry.name = categoryNames[categoryId];
+		categoryTelemetry.pagesCount = counters.pagesCount;
+		categoryTelemetry.allocationsCount = counters.allocationsCount;
+		categoryTelemetry.requestedBytes = counters.requestedBytes;
+		categoryTelemetry.reservedBytes = counters.reservedBytes;
+		categoryTelemetry.peakRequestedBytes = counters.peakRequestedBytes;
+		categoryTelemetry.peakReservedBytes = counters.peakReservedBytes;
+	}
+}
+
+void Graphics::AllocatorCounters::UpdatePeaks(Counters& counters) noexcept
+{
+	counters.peakRequestedBytes = (std::max)(counters.peakRequestedBytes, counters.requestedBytes);
+	counters.peakReservedBytes = (std::max)(counters.peakReservedBytes, counters.reservedBytes);
+}
+
+float Graphics::ComputeFragmentationRatio(uint64_t freeBytes, uint64_t largestFreeBlockBytes) noexcept
+{
+	if (freeBytes == 0)
+		return 0.0f;
+
+	return 1.0f - static_cast<float>(static_cast<double>((std::min)(largestFreeBlockBytes, freeBytes)) / static_cast<double>(freeBytes));
+}
+
+void Graphics::AddPageUsage(AllocatorCategoryTelemetry& categoryTelemetry, uint64_t usedBytes, uint64_t largestFreeBlockBytes) noexcept
+{
+	categoryTelemetry.usedBytes += usedBytes;
+	categoryTelemetry.largestFreeBlockBytes = (std::max)(categoryTelemetry.largestFreeBlockBytes, largestFreeBlockBytes);
+}
+
+void Graphics::FinalizeAllocatorTelemetry(AllocatorTelemetry& telemetry) noexcept
+{
+	telemetry.pagesCount = 0;
+	telemetry.allocationsCount = 0;
+	telemetry.requestedBytes = 0;
+	telemetry.usedBytes = 0;
+	telemetry.reservedBytes = 0;
+
+	for (auto& categoryTelemetry : telemetry.categories)
+	{
+		uint64_t freeBytes = categoryTelemetry.reservedBytes - (std::min)(categoryTelemetry.usedBytes, categoryTelemetry.reservedBytes);
+
+		categoryTelemetry.fragmentationRatio = ComputeFragmentationRatio(freeBytes, categoryTelemetry.largestFreeBlockBytes);
+
+		telemetry.pagesCount += categoryTelemetry.pagesCount;
+		telemetry.allocationsCount += categoryTelemetry.allocationsCount;
+		telemetry.requestedBytes += categoryTelemetry.requestedBytes;
+		telemetry.usedBytes += categoryTelemetry.usedBytes;
+		telemetry.reservedBytes += categoryTelemetry.reservedBytes;
+	}
+
+	telemetry.peakRequestedBytes = (std::max)(telemetry.peakRequestedBytes, telemetry.requestedBytes);
+	telemetry.peakReservedBytes = (std::max)(telemetry.peakReservedBytes, telemetry.reservedBytes);
+}
+
+void Graphics::AddDedicatedBufferUsage(BufferMemoryReport& report, uint64_t bufferPageBytes, bool isUniqueBuffer, uint64_t pageSize) noexcept
+{
+	report.dedicatedBuffersCount++;
+	report.dedicatedBytes += bufferPageBytes;
+
+	if (isUniqueBuffer)
+		report.dedicatedPagePerBufferBytes += (bufferPageBytes + pageSize - 1) / pageSize * pageSize;
+	else
+		report.dedicatedPagePerBufferBytes += bufferPageBytes;
+}
+
+void Graphics::FinalizeBufferMemoryReport(BufferMemoryReport& report, uint64_t pageSize) noexcept
+{
+	report.committedBytes = report.sharedPagesBytes + report.heapPagesBytes + report.dedicatedBytes;
+	report.pagePerBufferCommittedBytes = report.sharedPagesBytes + report.placedBuffersCount * pageSize + report.dedicatedPagePerBufferBytes;
+}
+
+void Graphics::WriteJsonString(std::ostream& stream, const std::string& value)
+{
+	stream << '"';
+
+	for (char character : value)
+	{
+		if (character == '"' || character == '\\')
+			stream << '\\' << character;
+		else if (static_cast<unsigned char>(character) < 0x20)
+			stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(character) << std::dec << std::setfill(' ');
+		else
+			stream << character;
+	}
+
+	stream << '"';
+}
+
+void Graphics::WriteAllocatorTelemetryJson(std::ostream& stream, const std::vector<AllocatorTelemetry>& telemetry, const BufferMemoryReport& bufferMemoryReport)
+{
+	std::ios_base::fmtflags streamFlags = stream.flags();
+	std::streamsize streamPrecision = stream.precision();
+
+	stream << "{\n\t\"allocators\": [";
+
+	for (size_t allocatorId = 0; allocatorId < telemetry.size(); allocatorId++)
+	{
+		const auto& allocatorTelemetry = telemetry[allocatorId];
+
+		stream << (allocatorId == 0 ? "\n" : ",\n");
+		stream << "\t\t{\n";
+		stream << "\t\t\t\"name\": ";
+		WriteJsonString(stream, allocatorTelemetry.allocatorName);
+		stream << ",\n";
+		stream << "\t\t\t\"pagesCount\": " << allocatorTelemetry.pagesCount << ",\n";
+		stream << "\t\t\t\"allocationsCount\": " << allocatorTelemetry.allocationsCount << ",\n";
+		stream << "\t\t\t\"requestedBytes\": " << allocatorTelemetry.requestedBytes << ",\n";
+		stream << "\t\t\t\"usedBytes\": " << allocatorTelemetry.usedBytes << ",\n";
+		stream << "\t\t\t\"reservedBytes\": " << allocatorTelemetry.reservedBytes << ",\n";
+		stream << "\t\t\t\"peakRequestedBytes\": " << allocatorTelemetry.peakRequestedBytes << ",\n";
+		stream << "\t\t\t\"peakReservedBytes\": " << allocatorTelemetry.peakReservedBytes << ",\n";
+		stream << "\t\t\t\"categories\": [";
+
+		for (size_t categoryId = 0; categoryId < allocatorTelemetry.categories.size(); categoryId++)
+		{
+			const auto& categoryTelemetry = allocatorTelemetry.categories[categoryId];
+
+			stream << (categoryId == 0 ? "\n" : ",\n");
+			stream << "\t\t\t\t{ ";
+			stream << "\"name\": ";
+			WriteJsonString(stream, categoryTelemetry.name);
+			stream << ", ";
+			stream << "\"pagesCount\": " << categoryTelemetry.pagesCount << ", ";
+			stream << "\"allocationsCount\": " << categoryTelemetry.allocationsCount << ", ";
+			stream << "\"requestedBytes\": " << categoryTelemetry.requestedBytes << ", ";
+			stream << "\"usedBytes\": " << categoryTelemetry.usedBytes << ", ";
+			stream << "\"reservedBytes\": " << categoryTelemetry.reservedBytes << ", ";
+			stream << "\"largestFreeBlockBytes\": " << categoryTelemetry.largestFreeBlockBytes << ", ";
+			stream << "\"peakRequestedBytes\": " << categoryTelemetry.peakRequestedBytes << ", ";
+			stream << "\"peakReservedBytes\": " << categoryTelemetry.peakReservedBytes << ", ";
+			stream << "\"fragmentationRatio\": " << std::fixed << std::setprecision(4) << categoryTelemetry.fragmentationRatio << " }";
+		}
+
+		stream << (allocatorTelemetry.categories.empty() ? "]\n" : "\n\t\t\t]\n");
+		stream << "\t\t}";
+	}
+
+	stream << (telemetry.empty() ? "],\n" : "\n\t],\n");
+
+	stream << "\t\"bufferMemoryReport\": {\n";
+	stream << "\t\t\"sharedPagesCount\": " << bufferMemoryReport.sharedPagesCount << ",\n";
+	stream << "\t\t\"heapPagesCount\": " << bufferMemoryReport.heapPagesCount << ",\n";
+	stream << "\t\t\"placedBuffersCount\": " << bufferMemoryReport.placedBuffersCount << ",\n";
+	stream << "\t\t\"dedicatedBuffersCount\": " << bufferMemoryReport.dedicatedBuffersCount << ",\n";
+	stream << "\t\t\"sharedPagesBytes\": " << bufferMemoryReport.sharedPagesBytes << ",\n";
+	stream << "\t\t\"heapPagesBytes\": " << bufferMemoryReport.heapPagesBytes << ",\n";
+	stream << "\t\t\"dedicatedBytes\": " << bufferMemoryReport.dedicatedBytes << ",\n";
+	stream << "\t\t\"committedBytes\": " << bufferMemoryReport.committedBytes << ",\n";
+	stream << "\t\t\"pagePerBufferCommittedBytes\": " << bufferMemoryReport.pagePerBufferCommittedBytes << "\n";
+	stream << "\t}\n}\n";
+
+	stream.flags(streamFlags);
+	stream.precision(streamPrecision);
+}
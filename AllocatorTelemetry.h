@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Graphics
+{
+	struct AllocatorCategoryTelemetry
+	{
+		std::string name;
+		size_t pagesCount;
+		size_t allocationsCount;
+		uint64_t requestedBytes;
+		uint64_t usedBytes;
+		uint64_t reservedBytes;
+		uint64_t largestFreeBlockBytes;
+		uint64_t peakRequestedBytes;
+		uint64_t peakReservedBytes;
+		float fragmentationRatio;
+	};
+
+	struct AllocatorTelemetry
+	{
+		std::string allocatorName;
+		size_t pagesCount;
+		size_t allocationsCount;
+		uint64_t requestedBytes;
+		uint64_t usedBytes;
+		uint64_t reservedBytes;
+		uint64_t peakRequestedBytes;
+		uint64_t peakReservedBytes;
+		std::vector<AllocatorCategoryTelemetry> categories;
+	};
+
+	// Memory held by the buffer allocator, and what the same buffers would commit if every custom and unordered access buffer
+	// opened its own page
+	struct BufferMemoryReport
+	{
+		size_t sharedPagesCount;
+		size_t heapPagesCount;
+		size_t placedBuffersCount;
+		size_t dedicatedBuffersCount;
+		uint64_t sharedPagesBytes;
+		uint64_t heapPagesBytes;
+		uint64_t dedicatedBytes;
+		uint64_t dedicatedPagePerBufferBytes;
+		uint64_t committedBytes;
+		uint64_t pagePerBufferCommittedBytes;
+	};
+
+	// Running counters of one allocator split into categories. Requested bytes are what callers asked for, reserved bytes are what the
+	// allocator holds in pages and heaps. Peaks are high-water marks since creation, the allocator total keeps its own peaks because
+	// categories rarely peak at the same time. Updates are serialized internally, so allocators may report from several locks at once.
+	class AllocatorCounters
+	{
+	public:
+		AllocatorCounters(std::initializer_list<const char*> _categoryNames);
+		~AllocatorCounters();
+
+		void AddAllocation(size_t categoryId, uint64_t requestedBytes) noexcept;
+		void RemoveAllocation(size_t categoryId, uint64_t requestedBytes) noexcept;
+		void AddPage(size_t categoryId, uint64_t reservedBytes) noexcept;
+		void RemovePage(size_t categoryId, uint64_t reservedBytes) noexcept;
+
+		// Used bytes and the largest free block live in the pages, the allocator adds them before FinalizeAllocatorTelemetry
+		void FillTelemetry(const char* allocatorName, AllocatorTelemetry& telemetry) const;
+
+	private:
+		AllocatorCounters(const AllocatorCounters&) = delete;
+		AllocatorCounters& operator=(const AllocatorCounters&) = delete;
+
+		struct Counters
+		{
+			size_t pagesCount;
+			size_t allocationsCount;
+			uint64_t requestedBytes;
+			uint64_t reservedBytes;
+			uint64_t peakRequestedBytes;
+			uint64_t peakReservedBytes;
+		};
+
+		static void UpdatePeaks(Counters& counters) noexcept;
+
+		std::vector<const char*> categoryNames;
+		std::vector<Counters> categoryCounters;
+		Counters totalCounters;
+
+		mutable std::mutex mutex;
+	};
+
+	// Share of free memory that is not part of the largest free block: 0 means all free memory is one block, values close to 1 mean
+	// it is scattered in pieces too small for bigger requests
+	float ComputeFragmentationRatio(uint64_t freeBytes, uint64_t largestFreeBlockBytes) noexcept;
+
+	void AddPageUsage(AllocatorCategoryTelemetry& categoryTelemetry, uint64_t usedBytes, uint64_t largestFreeBlockBytes) noexcept;
+	void FinalizeAllocatorTelemetry(AllocatorTelemetry& telemetry) noexcept;
+
+	// A unique buffer would take whole pages of its own, a dedicated page shared by several buffers costs the same either way
+	void AddDedicatedBufferUsage(BufferMemoryReport& report, uint64_t bufferPageBytes, bool isUniqueBuffer, uint64_t pageSize) noexcept;
+	void FinalizeBufferMemoryReport(BufferMemoryReport& report, uint64_t pageSize) noexcept;
+
+	// Quoted and escaped, so names coming from resources or settings cannot break the file
+	void WriteJsonString(std::ostream& stream, const std::string& value);
+	void WriteAllocatorTelemetryJson(std::ostream& stream, const std::vector<AllocatorTelemetry>& telemetry, const BufferMemoryReport& bufferMemoryReport);
+}
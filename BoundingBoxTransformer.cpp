@@ -0,0 +1,117 @@
+#include "BoundingBoxTransformer.h"
+
+Graphics::BoundingBoxTransformer::BoundingBoxTransformer()
+	: boundingBoxesCount(0), transformStatistics{}
+{
+
+}
+
+Graphics::BoundingBoxTransformer::~BoundingBoxTransformer()
+{
+
+}
+
+void Graphics::BoundingBoxTransformer::Clear()
+{
+	boundingBoxesCount = 0;
+
+	for (auto& component : localBoundingBoxes)
+		component.clear();
+
+	for (auto& component : worldMatrices)
+		component.clear();
+}
+
+size_t Graphics::BoundingBoxTransformer::AddBoundingBox(const BoundingBox& localBoundingBox, const float4x4& worldMatrix)
+{
+	localBoundingBoxes[0].push_back(localBoundingBox.minCornerPoint.x);
+	localBoundingBoxes[1].push_back(localBoundingBox.minCornerPoint.y);
+	localBoundingBoxes[2].push_back(localBoundingBox.minCornerPoint.z);
+	localBoundingBoxes[3].push_back(localBoundingBox.maxCornerPoint.x);
+	localBoundingBoxes[4].push_back(localBoundingBox.maxCornerPoint.y);
+	localBoundingBoxes[5].push_back(localBoundingBox.maxCornerPoint.z);
+
+	XMFLOAT4X4 matrix;
+	XMStoreFloat4x4(&matrix, worldMatrix);
+
+	for (uint32_t rowId = 0; rowId < 4; rowId++)
+		for (uint32_t columnId = 0; columnId < 3; columnId++)
+			worldMatrices[rowId * 3 + columnId].push_back(matrix.m[rowId][columnId]);
+
+	return boundingBoxesCount++;
+}
+
+void Graphics::BoundingBoxTransformer::Transform()
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	size_t alignedCount = AlignSize(boundingBoxesCount, static_cast<size_t>(4));
+
+	for (auto& component : localBoundingBoxes)
+		component.resize(alignedCount, 0.0f);
+
+	for (auto& component : worldMatrices)
+		component.resize(alignedCount, 0.0f);
+
+	for (auto& component : transformedBoundingBoxes)
+		component.resize(alignedCount);
+
+	auto load = [](const std::vector<float>& component, size_t firstId)
+	{
+		return XMLoadFloat4(reinterpret_cast<const float4*>(&component[firstId]));
+	};
+
+	for (size_t firstId = 0; firstId < alignedCount; firstId += 4)
+	{
+		std::array<floatN, 3> localMin = { load(localBoundingBoxes[0], firstId), load(localBoundingBoxes[1], firstId), load(localBoundingBoxes[2], firstId) };
+		std::array<floatN, 3> localMax = { load(localBoundingBoxes[3], firstId), load(localBoundingBoxes[4], firstId), load(localBoundingBoxes[5], firstId) };
+
+		for (uint32_t columnId = 0; columnId < 3; columnId++)
+		{
+			floatN transformedMin = load(worldMatrices[9 + columnId], firstId);
+			floatN transformedMax = transformedMin;
+
+			for (uint32_t rowId = 0; rowId < 3; rowId++)
+			{
+				floatN matrixElement = load(worldMatrices[rowId * 3 + columnId], firstId);
+
+				floatN minProduct = XMVectorMultiply(matrixElement, localMin[rowId]);
+				floatN maxProduct = XMVectorMultiply(matrixElement, localMax[rowId]);
+
+				transformedMin = XMVectorAdd(transformedMin, XMVectorMin(minProduct, maxProduct));
+				transformedMax = XMVectorAdd(transformedMax, XMVectorMax(minProduct, maxProduct));
+			}
+
+			XMStoreFloat4(reinterpret_cast<float4*>(&transformedBoundingBoxes[columnId][firstId]), transformedMin);
+			XMStoreFloat4(reinterpret_cast<float4*>(&transformedBoundingBoxes[3 + columnId][firstId]), transformedMax);
+		}
+	}
+
+	for (auto& component : localBoundingBoxes)
+		component.resize(boundingBoxesCount);
+
+	for (auto& component : worldMatrices)
+		component.resize(boundingBoxesCount);
+
+	transformStatistics.boundingBoxesTransformed = boundingBoxesCount;
+	transformStatistics.transformTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+size_t Graphics::BoundingBoxTransformer::GetBoundingBoxesCount() const noexcept
+{
+	return boundingBoxesCount;
+}
+
+Graphics::BoundingBox Graphics::BoundingBoxTransformer::GetTransformedBoundingBox(size_t boundingBoxId) const
+{
+	if (boundingBoxId >= boundingBoxesCount || boundingBoxId >= transformedBoundingBoxes[0].size())
+		throw std::exception("BoundingBoxTransformer::GetTransformedBoundingBox: Bounding box is not transformed");
+
+	return { { transformedBoundingBoxes[0][boundingBoxId], transformedBoundingBoxes[1][boundingBoxId], transformedBoundingBoxes[2][boundingBoxId] },
+		{ transformedBoundingBoxes[3][boundingBoxId], transformedBoundingBoxes[4][boundingBoxId], transformedBoundingBoxes[5][boundingBoxId] } };
+}
+
+const Graphics::BoundingBoxTransformStatistics& Graphics::BoundingBoxTransformer::GetTransformStatistics() const noexcept
+{
+	return transformStatistics;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "GraphicsHelper.h"
+
+namespace Graphics
+{
+	struct BoundingBoxTransformStatistics
+	{
+		size_t boundingBoxesTransformed;
+		float transformTime;
+	};
+
+	class BoundingBoxTransformer
+	{
+	public:
+		BoundingBoxTransformer();
+		~BoundingBoxTransformer();
+
+		void Clear();
+		size_t AddBoundingBox(const BoundingBox& localBoundingBox, const float4x4& worldMatrix);
+
+		void Transform();
+
+		size_t GetBoundingBoxesCount() const noexcept;
+		BoundingBox GetTransformedBoundingBox(size_t boundingBoxId) const;
+
+		const BoundingBoxTransformStatistics& GetTransformStatistics() const noexcept;
+
+	private:
+		BoundingBoxTransformer(const BoundingBoxTransformer&) = delete;
+		BoundingBoxTransformer& operator=(const BoundingBoxTransformer&) = delete;
+
+		static constexpr size_t BOX_COMPONENTS_COUNT = 6;
+		static constexpr size_t MATRIX_COMPONENTS_COUNT = 12;
+
+		size_t boundingBoxesCount;
+
+		std::array<std::vector<float>, BOX_COMPONENTS_COUNT> localBoundingBoxes;
+		std::array<std::vector<float>, MATRIX_COMPONENTS_COUNT> worldMatrices;
+		std::array<std::vector<float>, BOX_COMPONENTS_COUNT> transformedBoundingBoxes;
+
+		BoundingBoxTransformStatistics transformStatistics;
+	};
+}
@@ -0,0 +1,394 @@
+#include "BoundingVolumeHierarchy.h"
+
+Graphics::BoundingVolumeHierarchy::BoundingVolumeHierarchy(uint32_t _maxObjectsPerLeaf)
+	: maxObjectsPerLeaf((std::max)(_maxObjectsPerLeaf, 1U)), isBuildRequired(false), cullingStatistics{}
+{
+
+}
+
+Graphics::BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+{
+
+}
+
+void Graphics::BoundingVolumeHierarchy::AddObject(const GraphicObject* newObject, bool isDynamic)
+{
+	if (newObject == nullptr)
+		return;
+
+	IndexedObject indexedObject{};
+	indexedObject.object = newObject;
+	indexedObject.boundingBox = newObject->GetBoundingBox();
+	XMStoreFloat3(&indexedObject.centroid, (XMLoadFloat3(&indexedObject.boundingBox.minCornerPoint) +
+		XMLoadFloat3(&indexedObject.boundingBox.maxCornerPoint)) * 0.5f);
+	indexedObject.lastRejectingPlane = 0;
+	indexedObject.isDynamic = isDynamic;
+
+	objects.push_back(indexedObject);
+
+	isBuildRequired = true;
+}
+
+void Graphics::BoundingVolumeHierarchy::UpdateObjects(const ObjectPtrPool& movedObjects)
+{
+	if (isBuildRequired)
+		return;
+
+	refittedNodes.clear();
+
+	for (auto& movedObject : movedObjects)
+	{
+		auto objectIndexIt = objectIndices.find(movedObject);
+
+		if (objectIndexIt == objectIndices.end())
+			continue;
+
+		auto& indexedObject = objects[objectIndexIt->second];
+		indexedObject.boundingBox = movedObject->GetBoundingBox();
+		XMStoreFloat3(&indexedObject.centroid, (XMLoadFloat3(&indexedObject.boundingBox.minCornerPoint) +
+			XMLoadFloat3(&indexedObject.boundingBox.maxCornerPoint)) * 0.5f);
+
+		for (uint32_t nodeId = objectLeaves[objectIndexIt->second]; nodeId != INVALID_NODE; nodeId = nodes[nodeId].parent)
+		{
+			RefitNode(nodeId);
+			refittedNodes.push_back(nodeId);
+		}
+	}
+
+	std::sort(refittedNodes.begin(), refittedNodes.end());
+	refittedNodes.erase(std::unique(refittedNodes.begin(), refittedNodes.end()), refittedNodes.end());
+
+	for (auto& nodeId : refittedNodes)
+		TryRotate(nodeId);
+}
+
+void Graphics::BoundingVolumeHierarchy::PrepareVisibleObjectsList(const Camera& targetCamera, ObjectPtrPool& visibleObjectsList,
+	ObjectPtrPool& visibleTransparentObjectsList, ObjectPtrPool& visibleEffectObjectsList)
+{
+	cullingStatistics = {};
+
+	if (isBuildRequired)
+		Build();
+
+	if (nodes.empty())
+		return;
+
+	traversalStack.clear();
+	traversalStack.push_back({ 0, Camera::FRUSTUM_ALL_PLANES_MASK });
+
+	while (!traversalStack.empty())
+	{
+		TraversalEntry entry = traversalStack.back();
+		traversalStack.pop_back();
+
+		Node& node = nodes[entry.nodeId];
+
+		cullingStatistics.nodesVisited++;
+
+		if (entry.planeMask != 0)
+			if (targetCamera.ClassifyBoundingBox(node.boundingBox, entry.planeMask, node.lastRejectingPlane,
+				cullingStatistics.planeTests) == FrustumIntersection::FRUSTUM_OUTSIDE)
+			{
+				cullingStatistics.nodesCulled++;
+
+				continue;
+			}
+
+		if (!node.IsLeaf())
+		{
+			traversalStack.push_back({ node.rightChild, entry.planeMask });
+			traversalStack.push_back({ node.leftChild, entry.planeMask });
+
+			continue;
+		}
+
+		for (uint32_t objectId = node.firstObject; objectId < node.firstObject + node.objectsCount; objectId++)
+		{
+			auto& indexedObject = objects[objectId];
+
+			if (entry.planeMask != 0)
+			{
+				cullingStatistics.objectsTested++;
+
+				if (!IsObjectVisible(targetCamera, indexedObject.object, entry.planeMask, indexedObject.lastRejectingPlane, cullingStatistics))
+					continue;
+			}
+
+			cullingStatistics.objectsVisible++;
+
+			PushVisibleObject(indexedObject.object, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+		}
+	}
+}
+
+const Graphics::CullingStatistics& Graphics::BoundingVolumeHierarchy::GetCullingStatistics() const noexcept
+{
+	return cullingStatistics;
+}
+
+void Graphics::BoundingVolumeHierarchy::Build()
+{
+	nodes.clear();
+	objectLeaves.clear();
+	objectIndices.clear();
+
+	isBuildRequired = false;
+
+	if (objects.empty())
+		return;
+
+	for (auto& indexedObject : objects)
+	{
+		indexedObject.boundingBox = indexedObject.object->GetBoundingBox();
+		XMStoreFloat3(&indexedObject.centroid, (XMLoadFloat3(&indexedObject.boundingBox.minCornerPoint) +
+			XMLoadFloat3(&indexedObject.boundingBox.maxCornerPoint)) * 0.5f);
+	}
+
+	nodes.reserve(2 * objects.size());
+
+	BuildNode(INVALID_NODE, 0, static_cast<uint32_t>(objects.size()));
+
+	objectLeaves.resize(objects.size());
+
+	for (uint32_t nodeId = 0; nodeId < nodes.size(); nodeId++)
+		if (nodes[nodeId].IsLeaf())
+			for (uint32_t objectId = nodes[nodeId].firstObject; objectId < nodes[nodeId].firstObject + nodes[nodeId].objectsCount; objectId++)
+				objectLeaves[objectId] = nodeId;
+
+	objectIndices.reserve(objects.size());
+
+	for (uint32_t objectId = 0; objectId < objects.size(); objectId++)
+		objectIndices[objects[objectId].object] = objectId;
+}
+
+uint32_t Graphics::BoundingVolumeHierarchy::BuildNode(uint32_t parent, uint32_t firstObject, uint32_t objectsCount)
+{
+	uint32_t nodeId = static_cast<uint32_t>(nodes.size());
+	nodes.push_back({});
+
+	BoundingBox boundingBox = objects[firstObject].boundingBox;
+	BoundingBox centroidBoundingBox = { objects[firstObject].centroid, objects[firstObject].centroid };
+
+	for (uint32_t objectId = firstObject + 1; objectId < firstObject + objectsCount; objectId++)
+	{
+		boundingBox = ExpandBoundingBox(boundingBox, objects[objectId].boundingBox);
+		centroidBoundingBox = ExpandBoundingBox(centroidBoundingBox, { objects[objectId].centroid, objects[objectId].centroid });
+	}
+
+	Node node{};
+	node.boundingBox = boundingBox;
+	node.parent = parent;
+	node.leftChild = INVALID_NODE;
+	node.rightChild = INVALID_NODE;
+	node.firstObject = firstObject;
+	node.objectsCount = objectsCount;
+
+	uint32_t splitAxis = 0;
+	uint32_t splitBin = 0;
+	float splitCost = 0.0f;
+
+	bool isLeaf = objectsCount <= maxObjectsPerLeaf;
+
+	if (!isLeaf)
+	{
+		float leafCost = objectsCount * BoundingBoxSurfaceArea(boundingBox);
+
+		if (!FindBestSplit(centroidBoundingBox, firstObject, objectsCount, splitAxis, splitBin, splitCost))
+			isLeaf = true;
+		else if (splitCost >= leafCost && objectsCount <= 2 * maxObjectsPerLeaf)
+			isLeaf = true;
+	}
+
+	if (isLeaf)
+	{
+		nodes[nodeId] = node;
+
+		return nodeId;
+	}
+
+	auto objectsBegin = objects.begin() + firstObject;
+	auto objectsEnd = objectsBegin + objectsCount;
+
+	auto objectsMiddle = std::partition(objectsBegin, objectsEnd, [&](const IndexedObject& indexedObject)
+		{
+			return CalculateBinId(centroidBoundingBox, splitAxis, indexedObject.centroid) <= splitBin;
+		});
+
+	if (objectsMiddle == objectsBegin || objectsMiddle == objectsEnd)
+	{
+		objectsMiddle = objectsBegin + objectsCount / 2;
+
+		std::nth_element(objectsBegin, objectsMiddle, objectsEnd, [splitAxis](const IndexedObject& left, const IndexedObject& right)
+			{
+				return GetAxis(left.centroid, splitAxis) < GetAxis(right.centroid, splitAxis);
+			});
+	}
+
+	uint32_t leftObjectsCount = static_cast<uint32_t>(std::distance(objectsBegin, objectsMiddle));
+
+	node.objectsCount = 0;
+	nodes[nodeId] = node;
+
+	uint32_t leftChild = BuildNode(nodeId, firstObject, leftObjectsCount);
+	uint32_t rightChild = BuildNode(nodeId, firstObject + leftObjectsCount, objectsCount - leftObjectsCount);
+
+	nodes[nodeId].leftChild = leftChild;
+	nodes[nodeId].rightChild = rightChild;
+
+	return nodeId;
+}
+
+bool Graphics::BoundingVolumeHierarchy::FindBestSplit(const BoundingBox& centroidBoundingBox, uint32_t firstObject, uint32_t objectsCount,
+	uint32_t& splitAxis, uint32_t& splitBin, float& splitCost) const
+{
+	bool isSplitFound = false;
+
+	for (uint32_t axis = 0; axis < 3; axis++)
+	{
+		if (GetAxis(centroidBoundingBox.maxCornerPoint, axis) <= GetAxis(centroidBoundingBox.minCornerPoint, axis))
+			continue;
+
+		std::array<Bin, BINS_COUNT> bins{};
+
+		for (uint32_t objectId = firstObject; objectId < firstObject + objectsCount; objectId++)
+		{
+			auto& bin = bins[CalculateBinId(centroidBoundingBox, axis, objects[objectId].centroid)];
+
+			bin.boundingBox = (bin.objectsCount == 0) ? objects[objectId].boundingBox : ExpandBoundingBox(bin.boundingBox, objects[objectId].boundingBox);
+			bin.objectsCount++;
+		}
+
+		std::array<float, BINS_COUNT - 1> leftCosts{};
+		BoundingBox accumulatedBoundingBox{};
+		uint32_t accumulatedObjectsCount = 0;
+
+		for (uint32_t binId = 0; binId < BINS_COUNT - 1; binId++)
+		{
+			if (bins[binId].objectsCount != 0)
+			{
+				accumulatedBoundingBox = (accumulatedObjectsCount == 0) ? bins[binId].boundingBox :
+					ExpandBoundingBox(accumulatedBoundingBox, bins[binId].boundingBox);
+				accumulatedObjectsCount += bins[binId].objectsCount;
+			}
+
+			leftCosts[binId] = (accumulatedObjectsCount == 0) ? 0.0f : accumulatedObjectsCount * BoundingBoxSurfaceArea(accumulatedBoundingBox);
+		}
+
+		accumulatedObjectsCount = 0;
+
+		for (uint32_t binId = BINS_COUNT - 1; binId > 0; binId--)
+		{
+			if (bins[binId].objectsCount != 0)
+			{
+				accumulatedBoundingBox = (accumulatedObjectsCount == 0) ? bins[binId].boundingBox :
+					ExpandBoundingBox(accumulatedBoundingBox, bins[binId].boundingBox);
+				accumulatedObjectsCount += bins[binId].objectsCount;
+			}
+
+			if (accumulatedObjectsCount == 0 || accumulatedObjectsCount == objectsCount)
+				continue;
+
+			float cost = leftCosts[binId - 1] + accumulatedObjectsCount * BoundingBoxSurfaceArea(accumulatedBoundingBox);
+
+			if (!isSplitFound || cost < splitCost)
+			{
+				isSplitFound = true;
+				splitAxis = axis;
+				splitBin = binId - 1;
+				splitCost = cost;
+			}
+		}
+	}
+
+	return isSplitFound;
+}
+
+uint32_t Graphics::BoundingVolumeHierarchy::CalculateBinId(const BoundingBox& centroidBoundingBox, uint32_t axis, const float3& centroid) const noexcept
+{
+	float minValue = GetAxis(centroidBoundingBox.minCornerPoint, axis);
+	float extent = GetAxis(centroidBoundingBox.maxCornerPoint, axis) - minValue;
+
+	auto binId = static_cast<uint32_t>(BINS_COUNT * (GetAxis(centroid, axis) - minValue) / extent);
+
+	return (std::min)(binId, BINS_COUNT - 1);
+}
+
+void Graphics::BoundingVolumeHierarchy::RefitNode(uint32_t nodeId)
+{
+	Node& node = nodes[nodeId];
+
+	if (node.IsLeaf())
+	{
+		node.boundingBox = objects[node.firstObject].boundingBox;
+
+		for (uint32_t objectId = node.firstObject + 1; objectId < node.firstObject + node.objectsCount; objectId++)
+			node.boundingBox = ExpandBoundingBox(node.boundingBox, objects[objectId].boundingBox);
+	}
+	else
+		node.boundingBox = ExpandBoundingBox(nodes[node.leftChild].boundingBox, nodes[node.rightChild].boundingBox);
+}
+
+void Graphics::BoundingVolumeHierarchy::TryRotate(uint32_t nodeId)
+{
+	const Node& node = nodes[nodeId];
+
+	if (node.IsLeaf())
+		return;
+
+	float bestGain = 0.0f;
+	uint32_t bestChild = INVALID_NODE;
+	uint32_t bestGrandChild = INVALID_NODE;
+	uint32_t bestSibling = INVALID_NODE;
+
+	for (uint32_t childId : { node.leftChild, node.rightChild })
+	{
+		const Node& child = nodes[childId];
+
+		if (child.IsLeaf())
+			continue;
+
+		uint32_t siblingId = (childId == node.leftChild) ? node.rightChild : node.leftChild;
+		float childSurfaceArea = BoundingBoxSurfaceArea(child.boundingBox);
+
+		for (uint32_t grandChildId : { child.leftChild, child.rightChild })
+		{
+			uint32_t remainingGrandChildId = (grandChildId == child.leftChild) ? child.rightChild : child.leftChild;
+
+			float rotatedSurfaceArea = BoundingBoxSurfaceArea(ExpandBoundingBox(nodes[siblingId].boundingBox, nodes[remainingGrandChildId].boundingBox));
+			float gain = childSurfaceArea - rotatedSurfaceArea;
+
+			if (gain > bestGain)
+			{
+				bestGain = gain;
+				bestChild = childId;
+				bestGrandChild = grandChildId;
+				bestSibling = siblingId;
+			}
+		}
+	}
+
+	if (bestChild == INVALID_NODE)
+		return;
+
+	ReplaceChild(nodeId, bestSibling, bestGrandChild);
+	ReplaceChild(bestChild, bestGrandChild, bestSibling);
+
+	RefitNode(bestChild);
+}
+
+void Graphics::BoundingVolumeHierarchy::ReplaceChild(uint32_t parentId, uint32_t oldChildId, uint32_t newChildId)
+{
+	Node& parent = nodes[parentId];
+
+	if (parent.leftChild == oldChildId)
+		parent.leftChild = newChildId;
+	else
+		parent.rightChild = newChildId;
+
+	nodes[newChildId].parent = parentId;
+}
+
+float Graphics::BoundingVolumeHierarchy::GetAxis(const float3& vector, uint32_t axis) noexcept
+{
+	return (axis == 0) ? vector.x : (axis == 1) ? vector.y : vector.z;
+}
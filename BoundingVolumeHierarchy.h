@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ISpatialIndex.h"
+
+namespace Graphics
+{
+	class BoundingVolumeHierarchy final : public ISpatialIndex
+	{
+	public:
+		BoundingVolumeHierarchy(uint32_t _maxObjectsPerLeaf = 4);
+		~BoundingVolumeHierarchy();
+
+		void AddObject(const GraphicObject* newObject, bool isDynamic) override;
+		void UpdateObjects(const ObjectPtrPool& movedObjects) override;
+
+		void PrepareVisibleObjectsList(const Camera& targetCamera, ObjectPtrPool& visibleObjectsList, ObjectPtrPool& visibleTransparentObjectsList,
+			ObjectPtrPool& visibleEffectObjectsList) override;
+
+		const CullingStatistics& GetCullingStatistics() const noexcept override;
+
+		void Build();
+
+	private:
+		BoundingVolumeHierarchy(const BoundingVolumeHierarchy&) = delete;
+		BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy&) = delete;
+
+		static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+		static constexpr uint32_t BINS_COUNT = 16;
+
+		struct IndexedObject
+		{
+			const GraphicObject* object;
+			BoundingBox boundingBox;
+			float3 centroid;
+			uint32_t lastRejectingPlane;
+			bool isDynamic;
+		};
+
+		struct Node
+		{
+			BoundingBox boundingBox;
+
+			uint32_t parent;
+			uint32_t leftChild;
+			uint32_t rightChild;
+
+			uint32_t firstObject;
+			uint32_t objectsCount;
+
+			uint32_t lastRejectingPlane;
+
+			bool IsLeaf() const noexcept
+			{
+				return objectsCount != 0;
+			}
+		};
+
+		struct Bin
+		{
+			BoundingBox boundingBox;
+			uint32_t objectsCount;
+		};
+
+		struct TraversalEntry
+		{
+			uint32_t nodeId;
+			uint32_t planeMask;
+		};
+
+		uint32_t BuildNode(uint32_t parent, uint32_t firstObject, uint32_t objectsCount);
+		bool FindBestSplit(const BoundingBox& centroidBoundingBox, uint32_t firstObject, uint32_t objectsCount, uint32_t& splitAxis,
+			uint32_t& splitBin, float& splitCost) const;
+		uint32_t CalculateBinId(const BoundingBox& centroidBoundingBox, uint32_t axis, const float3& centroid) const noexcept;
+
+		void RefitNode(uint32_t nodeId);
+		void TryRotate(uint32_t nodeId);
+		void ReplaceChild(uint32_t parentId, uint32_t oldChildId, uint32_t newChildId);
+
+		static float GetAxis(const float3& vector, uint32_t axis) noexcept;
+
+		uint32_t maxObjectsPerLeaf;
+		bool isBuildRequired;
+
+		std::vector<IndexedObject> objects;
+		std::vector<Node> nodes;
+		std::vector<uint32_t> objectLeaves;
+		std::unordered_map<const GraphicObject*, uint32_t> objectIndices;
+
+		std::vector<TraversalEntry> traversalStack;
+		std::vector<uint32_t> refittedNodes;
+
+		CullingStatistics cullingStatistics;
+	};
+}
@@ -1,7 +1,7 @@
 #include "BufferAllocationPage.h"
 
 Graphics::BufferAllocationPage::BufferAllocationPage(ID3D12Device* device, D3D12_HEAP_TYPE _heapType, D3D12_RESOURCE_FLAGS resourceFlags, uint64_t _pageSize)
-	: heapType(_heapType), pageSize(_pageSize), offset(0), currentCPUAddress(nullptr), currentGPUAddress(D3D12_GPU_VIRTUAL_ADDRESS(0))
+	: heapType(_heapType), pageSize(_pageSize), subAllocator(_pageSize, CalculateGranularity(_pageSize)), currentCPUAddress(nullptr), currentGPUAddress(D3D12_GPU_VIRTUAL_ADDRESS(0))
 {
 	D3D12_HEAP_PROPERTIES heapProperties;
 	SetupHeapProperties(heapProperties, heapType);
@@ -37,8 +37,6 @@ Graphics::BufferAllocationPage::~BufferAllocationPage()
 
 	currentCPUAddress = nullptr;
 	currentGPUAddress = D3D12_GPU_VIRTUAL_ADDRESS(0);
-
-	offset = 0;
 }
 
 void Graphics::BufferAllocationPage::Allocate(uint64_t _size, uint64_t alignment, BufferAllocation& allocation)
@@ -46,22 +44,68 @@ void Graphics::BufferAllocationPage::Allocate(uint64_t _size, uint64_t alignment
 	if (!HasSpace(_size, alignment))
 		throw std::exception("BufferAllocationPage::Allocate: Bad allocation");
 
-	auto alignedSize = AlignSize(_size, alignment);
-	offset = AlignSize(offset, alignment);
+	subAllocator.Allocate(_size, alignment, allocation.subAllocation);
+
+	auto offset = allocation.subAllocation.offset;
 
 	allocation.cpuAddress = currentCPUAddress + offset;
 	allocation.gpuAddress = currentGPUAddress + offset;
 	allocation.gpuPageOffset = offset;
 	allocation.nonAlignedSizeInBytes = _size;
 	allocation.bufferResource = pageResource.Get();
+	allocation.page = this;
+	allocation.heapPage = nullptr;
+}
 
-	offset += alignedSize;
+void Graphics::BufferAllocationPage::Deallocate(const BufferAllocation& allocation)
+{
+	if (allocation.page != this)
+		throw std::exception("BufferAllocationPage::Deallocate: Allocation belongs to another page");
+
+	subAllocator.Deallocate(allocation.subAllocation);
 }
 
 bool Graphics::BufferAllocationPage::HasSpace(uint64_t _size, uint64_t alignment) const noexcept
 {
-	auto alignedSize = AlignSize(_size, alignment);
-	auto alignedOffset = AlignSize(offset, alignment);
+	return subAllocator.CanAllocate(_size, alignment);
+}
+
+bool Graphics::BufferAllocationPage::IsEmpty() const noexcept
+{
+	return subAllocator.IsEmpty();
+}
+
+uint64_t Graphics::BufferAllocationPage::GetPageSize() const noexcept
+{
+	return pageSize;
+}
+
+uint64_t Graphics::BufferAllocationPage::GetUsedSize() const noexcept
+{
+	return subAllocator.GetUsedSize();
+}
+
+uint64_t Graphics::BufferAllocationPage::GetLargestFreeBlockSize() const noexcept
+{
+	return subAllocator.GetLargestFreeBlockSize();
+}
+
+D3D12_HEAP_TYPE Graphics::BufferAllocationPage::GetHeapType() const noexcept
+{
+	return heapType;
+}
+
+const Graphics::SegregatedFitStatistics& Graphics::BufferAllocationPage::GetStatistics() const noexcept
+{
+	return subAllocator.GetStatistics();
+}
+
+uint64_t Graphics::BufferAllocationPage::CalculateGranularity(uint64_t _pageSize) noexcept
+{
+	uint64_t granularity = SUB_ALLOCATION_GRANULARITY;
+
+	while (_pageSize % granularity != 0)
+		granularity >>= 1;
 
-	return alignedSize + alignedOffset <= pageSize;
+	return granularity;
 }
\ No newline at end of file
@@ -1,9 +1,13 @@
 #pragma once
 
 #include "GraphicsHelper.h"
+#include "SegregatedFitAllocator.h"
 
 namespace Graphics
 {
+	struct BufferAllocationPage;
+	class BufferHeapPage;
+
 	struct BufferAllocation
 	{
 		uint8_t* cpuAddress;
@@ -11,6 +15,11 @@ namespace Graphics
 		uint64_t gpuPageOffset;
 		size_t nonAlignedSizeInBytes;
 		ID3D12Resource* bufferResource;
+		BufferAllocationPage* page;
+		SegregatedFitAllocation subAllocation;
+		BufferHeapPage* heapPage;
+		uint32_t heapSlot;
+		uint32_t shardId;
 	};
 
 	struct BufferAllocationPage
@@ -20,11 +29,24 @@ namespace Graphics
 		~BufferAllocationPage();
 
 		void Allocate(uint64_t _size, uint64_t alignment, BufferAllocation& allocation);
+		void Deallocate(const BufferAllocation& allocation);
 		bool HasSpace(uint64_t _size, uint64_t alignment) const noexcept;
+		bool IsEmpty() const noexcept;
+
+		uint64_t GetPageSize() const noexcept;
+		uint64_t GetUsedSize() const noexcept;
+		uint64_t GetLargestFreeBlockSize() const noexcept;
+		D3D12_HEAP_TYPE GetHeapType() const noexcept;
+
+		const SegregatedFitStatistics& GetStatistics() const noexcept;
 
 	private:
+		static constexpr uint64_t SUB_ALLOCATION_GRANULARITY = 256;
+
+		static uint64_t CalculateGranularity(uint64_t _pageSize) noexcept;
+
 		uint64_t pageSize;
-		uint64_t offset;
+		SegregatedFitAllocator subAllocator;
 
 		uint8_t* currentCPUAddress;
 		D3D12_GPU_VIRTUAL_ADDRESS currentGPUAddress;
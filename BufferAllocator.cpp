@@ -10,69 +10,350 @@ Graphics::BufferAllocator& Graphics::BufferAllocator::GetInstance()
 void Graphics::BufferAllocator::Allocate(ID3D12Device* device, size_t size, size_t alignment, D3D12_HEAP_TYPE heapType, BufferAllocation& allocation)
 {
 	if (size > pageSize)
-		throw std::exception("BufferAllocator::Allocate: Bad allocation");
-
-	if (heapType == D3D12_HEAP_TYPE_DEFAULT)
 	{
-		Allocate(device, size, alignment, heapType, false, false, emptyDefaultPages, usedDefaultPages, currentDefaultPage, allocation);
+		AllocateDedicated(device, size, heapType, D3D12_RESOURCE_FLAG_NONE, false, allocation);
+
+		return;
 	}
+
+	uint32_t shardId = GetThreadShardId();
+	auto& shard = sharedPageShards[shardId];
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	if (heapType == D3D12_HEAP_TYPE_DEFAULT)
+		Allocate(device, size, alignment, heapType, shard.emptyDefaultPages, shard.usedDefaultPages, shard.currentDefaultPage, allocation);
 	else if (heapType == D3D12_HEAP_TYPE_UPLOAD)
-	{
-		Allocate(device, size, alignment, heapType, false, false, emptyUploadPages, usedUploadPages, currentUploadPage, allocation);
-	}
+		Allocate(device, size, alignment, heapType, shard.emptyUploadPages, shard.usedUploadPages, shard.currentUploadPage, allocation);
+
+	allocation.shardId = shardId;
 }
 
 void Graphics::BufferAllocator::AllocateCustomBuffer(ID3D12Device* device, size_t size, size_t alignment, BufferAllocation& allocation)
 {
-	if (size > pageSize)
-		throw std::exception("BufferAllocator::AllocateCustomBuffer: Bad allocation");
+	if (alignment > D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+		throw std::exception("BufferAllocator::AllocateCustomBuffer: Unsupported alignment");
 
-	Allocate(device, size, alignment, D3D12_HEAP_TYPE_DEFAULT, false, true, emptyCustomPages, usedCustomPages, currentCustomPage, allocation);
+	AllocatePlaced(device, size, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST, allocation);
 }
 
 void Graphics::BufferAllocator::AllocateUnorderedAccess(ID3D12Device* device, size_t size, size_t alignment, BufferAllocation& allocation)
 {
-	if (size > pageSize)
-		throw std::exception("BufferAllocator::AllocateUnorderedAccess: Bad allocation");
+	if (alignment > D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+		throw std::exception("BufferAllocator::AllocateUnorderedAccess: Unsupported alignment");
 
-	Allocate(device, size, alignment, D3D12_HEAP_TYPE_DEFAULT, true, true, emptyUnorderedPages, usedUnorderedPages, currentUnorderedPage, allocation);
+	AllocatePlaced(device, size, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, allocation);
 }
 
 void Graphics::BufferAllocator::AllocateTemporary(ID3D12Device* device, size_t size, D3D12_HEAP_TYPE heapType, BufferAllocation& allocation)
 {
-	tempUploadPages.push_back(std::shared_ptr<BufferAllocationPage>(new BufferAllocationPage(device, heapType, D3D12_RESOURCE_FLAG_NONE, size)));
+	std::shared_ptr<BufferAllocationPage> tempUploadPage(new BufferAllocationPage(device, heapType, D3D12_RESOURCE_FLAG_NONE, size));
+	tempUploadPage->Allocate(size, 1, allocation);
 
-	tempUploadPages.back()->Allocate(size, 1, allocation);
+	{
+		std::lock_guard<std::mutex> lock(tempUploadMutex);
+
+		tempUploadPages.push_back(tempUploadPage);
+	}
+
+	counters.AddPage(TEMPORARY_CATEGORY, size);
+	counters.AddAllocation(TEMPORARY_CATEGORY, size);
+}
+
+void Graphics::BufferAllocator::Deallocate(BufferAllocation& allocation)
+{
+	if (allocation.heapPage != nullptr)
+	{
+		DeallocatePlaced(allocation);
+	}
+	else if (allocation.page != nullptr)
+	{
+		if (!DeallocateDedicated(allocation))
+		{
+			std::lock_guard<std::mutex> lock(sharedPageShards[allocation.shardId].mutex);
+
+			allocation.page->Deallocate(allocation);
+
+			counters.RemoveAllocation(GetSharedCategory(allocation.page->GetHeapType()), allocation.nonAlignedSizeInBytes);
+		}
+	}
+	else
+	{
+		throw std::exception("BufferAllocator::Deallocate: Invalid allocation");
+	}
+
+	allocation = {};
 }
 
 void Graphics::BufferAllocator::ReleaseTemporaryBuffers()
 {
+	std::lock_guard<std::mutex> lock(tempUploadMutex);
+
+	for (const auto& page : tempUploadPages)
+	{
+		counters.RemoveAllocation(TEMPORARY_CATEGORY, page->GetPageSize());
+		counters.RemovePage(TEMPORARY_CATEGORY, page->GetPageSize());
+	}
+
 	tempUploadPages.clear();
 }
 
-void Graphics::BufferAllocator::Allocate(ID3D12Device* device, size_t size, size_t alignment, D3D12_HEAP_TYPE heapType, bool unorderedAccess , bool isUniqueBuffer,
-	BufferAllocationPagePool& emptyPagePool, BufferAllocationPagePool& usedPagePool, std::shared_ptr<BufferAllocationPage>& currentPage, BufferAllocation& allocation)
+Graphics::BufferMemoryReport Graphics::BufferAllocator::GetMemoryReport() const
 {
-	if (!currentPage || !currentPage->HasSpace(size, alignment) || isUniqueBuffer)
-		SetNewPageAsCurrent(device, heapType, unorderedAccess, emptyPagePool, usedPagePool, currentPage);
+	BufferMemoryReport report{};
+
+	for (const auto& shard : sharedPageShards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		for (const auto* pagePool : { &shard.usedDefaultPages, &shard.usedUploadPages, &shard.emptyDefaultPages, &shard.emptyUploadPages })
+		{
+			report.sharedPagesCount += pagePool->size();
+
+			for (const auto& page : *pagePool)
+				report.sharedPagesBytes += page->GetPageSize();
+		}
+	}
+
+	for (uint32_t sizeClass = 0; sizeClass < SIZE_CLASSES_COUNT; sizeClass++)
+	{
+		std::lock_guard<std::mutex> lock(heapPageMutexes[sizeClass]);
+
+		report.heapPagesCount += heapPages[sizeClass].size();
+
+		for (const auto& heapPage : heapPages[sizeClass])
+			report.heapPagesBytes += heapPage->GetHeapSize();
+	}
+
+	std::lock_guard<std::mutex> dedicatedLock(dedicatedMutex);
+
+	report.placedBuffersCount = placedBuffersCount;
+
+	for (const auto& dedicatedAllocation : dedicatedAllocations)
+		AddDedicatedBufferUsage(report, dedicatedAllocation.page->GetPageSize(), dedicatedAllocation.isUniqueBuffer, pageSize);
+
+	FinalizeBufferMemoryReport(report, pageSize);
+
+	return report;
+}
+
+Graphics::AllocatorTelemetry Graphics::BufferAllocator::GetTelemetry() const
+{
+	AllocatorTelemetry telemetry;
+	counters.FillTelemetry("BufferAllocator", telemetry);
+
+	for (const auto& shard : sharedPageShards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		for (const auto* pagePool : { &shard.usedDefaultPages, &shard.usedUploadPages, &shard.emptyDefaultPages, &shard.emptyUploadPages })
+			for (const auto& page : *pagePool)
+				AddPageUsage(telemetry.categories[GetSharedCategory(page->GetHeapType())], page->GetUsedSize(), page->GetLargestFreeBlockSize());
+	}
+
+	for (uint32_t sizeClass = 0; sizeClass < SIZE_CLASSES_COUNT; sizeClass++)
+	{
+		std::lock_guard<std::mutex> lock(heapPageMutexes[sizeClass]);
+
+		for (const auto& heapPage : heapPages[sizeClass])
+			AddPageUsage(telemetry.categories[PLACED_CATEGORY], heapPage->GetUsedSize(), heapPage->GetLargestFreeBlockSize());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(dedicatedMutex);
+
+		for (const auto& dedicatedAllocation : dedicatedAllocations)
+			AddPageUsage(telemetry.categories[DEDICATED_CATEGORY], dedicatedAllocation.page->GetUsedSize(), dedicatedAllocation.page->GetLargestFreeBlockSize());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(tempUploadMutex);
+
+		for (const auto& page : tempUploadPages)
+			AddPageUsage(telemetry.categories[TEMPORARY_CATEGORY], page->GetUsedSize(), page->GetLargestFreeBlockSize());
+	}
+
+	FinalizeAllocatorTelemetry(telemetry);
+
+	return telemetry;
+}
+
+void Graphics::BufferAllocator::Allocate(ID3D12Device* device, size_t size, size_t alignment, D3D12_HEAP_TYPE heapType, BufferAllocationPagePool& emptyPagePool,
+	BufferAllocationPagePool& usedPagePool, std::shared_ptr<BufferAllocationPage>& currentPage, BufferAllocation& allocation)
+{
+	if (!currentPage || !currentPage->HasSpace(size, alignment))
+	{
+		if (!FindPageWithSpace(size, alignment, usedPagePool, currentPage))
+			SetNewPageAsCurrent(device, heapType, emptyPagePool, usedPagePool, currentPage);
+	}
 
 	currentPage->Allocate(size, alignment, allocation);
+
+	counters.AddAllocation(GetSharedCategory(heapType), size);
+}
+
+void Graphics::BufferAllocator::AllocatePlaced(ID3D12Device* device, size_t size, D3D12_RESOURCE_FLAGS resourceFlags, D3D12_RESOURCE_STATES initialState,
+	BufferAllocation& allocation)
+{
+	uint32_t sizeClass = GetSizeClass(size);
+
+	if (sizeClass >= SIZE_CLASSES_COUNT)
+	{
+		AllocateDedicated(device, size, D3D12_HEAP_TYPE_DEFAULT, resourceFlags, true, allocation);
+
+		return;
+	}
+
+	auto& heapPagePool = heapPages[sizeClass];
+
+	std::lock_guard<std::mutex> lock(heapPageMutexes[sizeClass]);
+
+	auto heapPageIt = std::find_if(heapPagePool.begin(), heapPagePool.end(), [](const std::shared_ptr<BufferHeapPage>& heapPage) { return heapPage->HasSpace(); });
+
+	if (heapPageIt == heapPagePool.end())
+	{
+		heapPagePool.push_back(std::shared_ptr<BufferHeapPage>(new BufferHeapPage(device, MIN_SIZE_CLASS << sizeClass, pageSize)));
+		heapPageIt = std::prev(heapPagePool.end());
+
+		counters.AddPage(PLACED_CATEGORY, pageSize);
+	}
+
+	(*heapPageIt)->Allocate(device, size, resourceFlags, initialState, allocation);
+
+	placedBuffersCount++;
+
+	counters.AddAllocation(PLACED_CATEGORY, size);
 }
 
-void Graphics::BufferAllocator::SetNewPageAsCurrent(ID3D12Device* device, D3D12_HEAP_TYPE heapType, bool unorderedAccess, BufferAllocationPagePool& emptyPagePool,
+void Graphics::BufferAllocator::AllocateDedicated(ID3D12Device* device, size_t size, D3D12_HEAP_TYPE heapType, D3D12_RESOURCE_FLAGS resourceFlags, bool isUniqueBuffer,
+	BufferAllocation& allocation)
+{
+	auto dedicatedSize = AlignSize(size, static_cast<size_t>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT));
+
+	std::shared_ptr<BufferAllocationPage> dedicatedPage(new BufferAllocationPage(device, heapType, resourceFlags, dedicatedSize));
+	dedicatedPage->Allocate(size, 1, allocation);
+
+	{
+		std::lock_guard<std::mutex> lock(dedicatedMutex);
+
+		dedicatedAllocations.push_back({ dedicatedPage, isUniqueBuffer });
+	}
+
+	counters.AddPage(DEDICATED_CATEGORY, dedicatedSize);
+	counters.AddAllocation(DEDICATED_CATEGORY, size);
+}
+
+void Graphics::BufferAllocator::DeallocatePlaced(BufferAllocation& allocation)
+{
+	uint32_t sizeClass = GetSizeClass(allocation.heapPage->GetSlotSize());
+	auto& heapPagePool = heapPages[sizeClass];
+
+	std::lock_guard<std::mutex> lock(heapPageMutexes[sizeClass]);
+
+	auto heapPageIt = std::find_if(heapPagePool.begin(), heapPagePool.end(),
+		[&allocation](const std::shared_ptr<BufferHeapPage>& heapPage) { return heapPage.get() == allocation.heapPage; });
+
+	if (heapPageIt == heapPagePool.end())
+		throw std::exception("BufferAllocator::DeallocatePlaced: Heap page is not found");
+
+	(*heapPageIt)->Deallocate(allocation);
+
+	placedBuffersCount--;
+
+	counters.RemoveAllocation(PLACED_CATEGORY, allocation.nonAlignedSizeInBytes);
+
+	// Keep one empty heap per size class so that churned buffers do not recreate heaps every time
+	if ((*heapPageIt)->IsEmpty() && heapPagePool.size() > 1)
+	{
+		counters.RemovePage(PLACED_CATEGORY, (*heapPageIt)->GetHeapSize());
+
+		heapPagePool.erase(heapPageIt);
+	}
+}
+
+bool Graphics::BufferAllocator::DeallocateDedicated(const BufferAllocation& allocation)
+{
+	// The page is released after the lock, destroying a committed resource does not need it
+	std::shared_ptr<BufferAllocationPage> dedicatedPage;
+
+	std::lock_guard<std::mutex> lock(dedicatedMutex);
+
+	auto dedicatedIt = std::find_if(dedicatedAllocations.begin(), dedicatedAllocations.end(),
+		[&allocation](const DedicatedAllocation& dedicatedAllocation) { return dedicatedAllocation.page.get() == allocation.page; });
+
+	if (dedicatedIt == dedicatedAllocations.end())
+		return false;
+
+	counters.RemoveAllocation(DEDICATED_CATEGORY, allocation.nonAlignedSizeInBytes);
+	counters.RemovePage(DEDICATED_CATEGORY, dedicatedIt->page->GetPageSize());
+
+	dedicatedPage = dedicatedIt->page;
+	dedicatedAllocations.erase(dedicatedIt);
+
+	return true;
+}
+
+bool Graphics::BufferAllocator::FindPageWithSpace(size_t size, size_t alignment, const BufferAllocationPagePool& usedPagePool,
+	std::shared_ptr<BufferAllocationPage>& currentPage) const
+{
+	for (const auto& page : usedPagePool)
+	{
+		if (page != currentPage && page->HasSpace(size, alignment))
+		{
+			currentPage = page;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Graphics::BufferAllocator::SetNewPageAsCurrent(ID3D12Device* device, D3D12_HEAP_TYPE heapType, BufferAllocationPagePool& emptyPagePool,
 	BufferAllocationPagePool& usedPagePool, std::shared_ptr<BufferAllocationPage>& currentPage)
 {
 	if (emptyPagePool.empty())
 	{
-		currentPage = std::shared_ptr<BufferAllocationPage>(new BufferAllocationPage(device, heapType,
-			(unorderedAccess) ? D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS : D3D12_RESOURCE_FLAG_NONE, pageSize));
+		currentPage = std::shared_ptr<BufferAllocationPage>(new BufferAllocationPage(device, heapType, D3D12_RESOURCE_FLAG_NONE, pageSize));
 
 		usedPagePool.push_back(currentPage);
+
+		counters.AddPage(GetSharedCategory(heapType), pageSize);
 	}
 	else
 	{
 		currentPage = emptyPagePool.front();
 
 		emptyPagePool.pop_front();
+		usedPagePool.push_back(currentPage);
 	}
 }
+
+uint32_t Graphics::BufferAllocator::GetSizeClass(size_t size) noexcept
+{
+	if (size <= MIN_SIZE_CLASS)
+		return 0;
+
+	unsigned long mostSignificantBit;
+	_BitScanReverse64(&mostSignificantBit, static_cast<uint64_t>(size - 1));
+
+	unsigned long minSizeClassBit;
+	_BitScanReverse64(&minSizeClassBit, static_cast<uint64_t>(MIN_SIZE_CLASS));
+
+	return static_cast<uint32_t>(mostSignificantBit + 1 - minSizeClassBit);
+}
+
+uint32_t Graphics::BufferAllocator::GetThreadShardId() noexcept
+{
+	static std::atomic<uint32_t> nextShardId = 0;
+
+	// Threads are bound round-robin on their first allocation and keep the shard for their whole lifetime
+	thread_local uint32_t threadShardId = nextShardId.fetch_add(1, std::memory_order_relaxed) % SHARED_PAGE_SHARDS_COUNT;
+
+	return threadShardId;
+}
+
+Graphics::BufferAllocator::TelemetryCategory Graphics::BufferAllocator::GetSharedCategory(D3D12_HEAP_TYPE heapType) noexcept
+{
+	return (heapType == D3D12_HEAP_TYPE_UPLOAD) ? SHARED_UPLOAD_CATEGORY : SHARED_DEFAULT_CATEGORY;
+}
@@ -2,9 +2,13 @@
 
 #include "GraphicsHelper.h"
 #include "BufferAllocationPage.h"
+#include "BufferHeapPage.h"
+#include "AllocatorTelemetry.h"
 
 namespace Graphics
 {
+	// Safe to call from several threads. Shared pages are split into shards and every thread allocates from the shard it is bound to,
+	// so the current page of that shard serves as the thread's cache of reserved memory. Placed heaps are locked per size class.
 	class BufferAllocator
 	{
 	public:
@@ -15,10 +19,15 @@ namespace Graphics
 		void AllocateUnorderedAccess(ID3D12Device* device, size_t size, size_t alignment, BufferAllocation& allocation);
 		void AllocateTemporary(ID3D12Device* device, size_t size, D3D12_HEAP_TYPE heapType, BufferAllocation& allocation);
 
+		void Deallocate(BufferAllocation& allocation);
+
 		void ReleaseTemporaryBuffers();
 
+		BufferMemoryReport GetMemoryReport() const;
+		AllocatorTelemetry GetTelemetry() const;
+
 	private:
-		BufferAllocator() {};
+		BufferAllocator() : placedBuffersCount(0), counters({ "SharedDefault", "SharedUpload", "Placed", "Dedicated", "Temporary" }) {};
 		~BufferAllocator() {};
 
 		BufferAllocator(const BufferAllocator&) = delete;
@@ -26,30 +35,74 @@ namespace Graphics
 		BufferAllocator& operator=(const BufferAllocator&) = delete;
 		BufferAllocator& operator=(BufferAllocator&&) = delete;
 
+		static constexpr size_t MIN_SIZE_CLASS = 64 * _KB;
+		static constexpr uint32_t SIZE_CLASSES_COUNT = 5;
+		static constexpr uint32_t SHARED_PAGE_SHARDS_COUNT = 4;
+
+		enum TelemetryCategory : size_t
+		{
+			SHARED_DEFAULT_CATEGORY,
+			SHARED_UPLOAD_CATEGORY,
+			PLACED_CATEGORY,
+			DEDICATED_CATEGORY,
+			TEMPORARY_CATEGORY
+		};
+
 		using BufferAllocationPagePool = std::deque<std::shared_ptr<BufferAllocationPage>>;
+		using BufferHeapPagePool = std::deque<std::shared_ptr<BufferHeapPage>>;
+
+		struct DedicatedAllocation
+		{
+			std::shared_ptr<BufferAllocationPage> page;
+			bool isUniqueBuffer;
+		};
+
+		struct SharedPageShard
+		{
+			BufferAllocationPagePool usedDefaultPages;
+			BufferAllocationPagePool usedUploadPages;
+
+			BufferAllocationPagePool emptyDefaultPages;
+			BufferAllocationPagePool emptyUploadPages;
 
-		void Allocate(ID3D12Device* device, size_t size, size_t alignment, D3D12_HEAP_TYPE heapType, bool unorderedAccess, bool isUniqueBuffer, BufferAllocationPagePool& emptyPagePool,
+			std::shared_ptr<BufferAllocationPage> currentDefaultPage;
+			std::shared_ptr<BufferAllocationPage> currentUploadPage;
+
+			mutable std::mutex mutex;
+		};
+
+		void Allocate(ID3D12Device* device, size_t size, size_t alignment, D3D12_HEAP_TYPE heapType, BufferAllocationPagePool& emptyPagePool,
 			BufferAllocationPagePool& usedPagePool, std::shared_ptr<BufferAllocationPage>& currentPage, BufferAllocation& allocation);
+		void AllocatePlaced(ID3D12Device* device, size_t size, D3D12_RESOURCE_FLAGS resourceFlags, D3D12_RESOURCE_STATES initialState, BufferAllocation& allocation);
+		void AllocateDedicated(ID3D12Device* device, size_t size, D3D12_HEAP_TYPE heapType, D3D12_RESOURCE_FLAGS resourceFlags, bool isUniqueBuffer,
+			BufferAllocation& allocation);
+
+		void DeallocatePlaced(BufferAllocation& allocation);
+		bool DeallocateDedicated(const BufferAllocation& allocation);
+
+		bool FindPageWithSpace(size_t size, size_t alignment, const BufferAllocationPagePool& usedPagePool, std::shared_ptr<BufferAllocationPage>& currentPage) const;
+
+		void SetNewPageAsCurrent(ID3D12Device* device, D3D12_HEAP_TYPE heapType, BufferAllocationPagePool& emptyPagePool, BufferAllocationPagePool& usedPagePool,
+			std::shared_ptr<BufferAllocationPage>& currentPage);
+
+		static uint32_t GetSizeClass(size_t size) noexcept;
+		static uint32_t GetThreadShardId() noexcept;
+		static TelemetryCategory GetSharedCategory(D3D12_HEAP_TYPE heapType) noexcept;
+
+		std::array<SharedPageShard, SHARED_PAGE_SHARDS_COUNT> sharedPageShards;
 
-		void SetNewPageAsCurrent(ID3D12Device* device, D3D12_HEAP_TYPE heapType, bool unorderedAccess, BufferAllocationPagePool& emptyPagePool,
-			BufferAllocationPagePool& usedPagePool, std::shared_ptr<BufferAllocationPage>& currentPage);
+		std::array<BufferHeapPagePool, SIZE_CLASSES_COUNT> heapPages;
+		mutable std::array<std::mutex, SIZE_CLASSES_COUNT> heapPageMutexes;
 
-		BufferAllocationPagePool usedDefaultPages;
-		BufferAllocationPagePool usedUploadPages;
-		BufferAllocationPagePool usedCustomPages;
-		BufferAllocationPagePool usedUnorderedPages;
+		std::vector<DedicatedAllocation> dedicatedAllocations;
+		mutable std::mutex dedicatedMutex;
 
-		BufferAllocationPagePool emptyDefaultPages;
-		BufferAllocationPagePool emptyUploadPages;
-		BufferAllocationPagePool emptyCustomPages;
-		BufferAllocationPagePool emptyUnorderedPages;
+		std::atomic<size_t> placedBuffersCount;
 
-		std::shared_ptr<BufferAllocationPage> currentDefaultPage;
-		std::shared_ptr<BufferAllocationPage> currentUploadPage;
-		std::shared_ptr<BufferAllocationPage> currentCustomPage;
-		std::shared_ptr<BufferAllocationPage> currentUnorderedPage;
+		AllocatorCounters counters;
 
 		BufferAllocationPagePool tempUploadPages;
+		mutable std::mutex tempUploadMutex;
 
 		const size_t pageSize = 2 * _MB;
 	};
@@ -0,0 +1,95 @@
+#include "BufferHeapPage.h"
+
+Graphics::BufferHeapPage::BufferHeapPage(ID3D12Device* device, uint64_t _slotSize, uint64_t _heapSize)
+	: slotSize(_slotSize), heapSize(_heapSize)
+{
+	if (slotSize == 0 || slotSize % D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT != 0 || heapSize < slotSize)
+		throw std::exception("BufferHeapPage::BufferHeapPage: Invalid slot size");
+
+	D3D12_HEAP_DESC heapDesc{};
+	heapDesc.SizeInBytes = heapSize;
+	heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+	SetupHeapProperties(heapDesc.Properties, D3D12_HEAP_TYPE_DEFAULT);
+
+	ThrowIfFailed(device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap)), "BufferHeapPage::BufferHeapPage: Heap creating error");
+
+	uint32_t slotsCount = static_cast<uint32_t>(heapSize / slotSize);
+
+	slotResources.resize(slotsCount);
+	freeSlots.reserve(slotsCount);
+
+	for (uint32_t slotId = slotsCount; slotId > 0; slotId--)
+		freeSlots.push_back(slotId - 1);
+}
+
+Graphics::BufferHeapPage::~BufferHeapPage()
+{
+	slotResources.clear();
+}
+
+void Graphics::BufferHeapPage::Allocate(ID3D12Device* device, uint64_t _size, D3D12_RESOURCE_FLAGS resourceFlags, D3D12_RESOURCE_STATES initialState,
+	BufferAllocation& allocation)
+{
+	if (!HasSpace() || _size > slotSize)
+		throw std::exception("BufferHeapPage::Allocate: Bad allocation");
+
+	uint32_t slotId = freeSlots.back();
+
+	D3D12_RESOURCE_DESC resourceDesc;
+	SetupResourceBufferDesc(resourceDesc, _size, resourceFlags);
+
+	ThrowIfFailed(device->CreatePlacedResource(heap.Get(), slotId * slotSize, &resourceDesc, initialState, nullptr, IID_PPV_ARGS(&slotResources[slotId])),
+		"BufferHeapPage::Allocate: Placed resource creating error");
+
+	freeSlots.pop_back();
+
+	allocation.cpuAddress = nullptr;
+	allocation.gpuAddress = slotResources[slotId]->GetGPUVirtualAddress();
+	allocation.gpuPageOffset = 0;
+	allocation.nonAlignedSizeInBytes = _size;
+	allocation.bufferResource = slotResources[slotId].Get();
+	allocation.page = nullptr;
+	allocation.heapPage = this;
+	allocation.heapSlot = slotId;
+}
+
+void Graphics::BufferHeapPage::Deallocate(const BufferAllocation& allocation)
+{
+	if (allocation.heapPage != this || allocation.heapSlot >= slotResources.size() || slotResources[allocation.heapSlot].Get() == nullptr)
+		throw std::exception("BufferHeapPage::Deallocate: Invalid allocation");
+
+	slotResources[allocation.heapSlot].Reset();
+	freeSlots.push_back(allocation.heapSlot);
+}
+
+bool Graphics::BufferHeapPage::HasSpace() const noexcept
+{
+	return !freeSlots.empty();
+}
+
+bool Graphics::BufferHeapPage::IsEmpty() const noexcept
+{
+	return freeSlots.size() == slotResources.size();
+}
+
+uint64_t Graphics::BufferHeapPage::GetSlotSize() const noexcept
+{
+	return slotSize;
+}
+
+uint64_t Graphics::BufferHeapPage::GetHeapSize() const noexcept
+{
+	return heapSize;
+}
+
+uint64_t Graphics::BufferHeapPage::GetUsedSize() const noexcept
+{
+	return (slotResources.size() - freeSlots.size()) * slotSize;
+}
+
+uint64_t Graphics::BufferHeapPage::GetLargestFreeBlockSize() const noexcept
+{
+	// Slots never merge, so a free slot is the largest block a request can get here
+	return HasSpace() ? slotSize : 0;
+}
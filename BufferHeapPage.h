@@ -0,0 +1,38 @@
+#pragma once
+
+#include "BufferAllocationPage.h"
+
+namespace Graphics
+{
+	// Default heap split into equal slots of one size class. Each slot holds its own placed buffer, so buffers sharing a heap
+	// keep independent resource states and never overlap in memory.
+	class BufferHeapPage
+	{
+	public:
+		BufferHeapPage(ID3D12Device* device, uint64_t _slotSize, uint64_t _heapSize = 2 * _MB);
+		~BufferHeapPage();
+
+		void Allocate(ID3D12Device* device, uint64_t _size, D3D12_RESOURCE_FLAGS resourceFlags, D3D12_RESOURCE_STATES initialState, BufferAllocation& allocation);
+		void Deallocate(const BufferAllocation& allocation);
+
+		bool HasSpace() const noexcept;
+		bool IsEmpty() const noexcept;
+
+		uint64_t GetSlotSize() const noexcept;
+		uint64_t GetHeapSize() const noexcept;
+		uint64_t GetUsedSize() const noexcept;
+		uint64_t GetLargestFreeBlockSize() const noexcept;
+
+	private:
+		BufferHeapPage(const BufferHeapPage&) = delete;
+		BufferHeapPage& operator=(const BufferHeapPage&) = delete;
+
+		uint64_t slotSize;
+		uint64_t heapSize;
+
+		std::vector<uint32_t> freeSlots;
+		std::vector<ComPtr<ID3D12Resource>> slotResources;
+
+		ComPtr<ID3D12Heap> heap;
+	};
+}
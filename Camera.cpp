@@ -1,15 +1,14 @@
 #include "Camera.h"
 
-Graphics::Camera::Camera(float fovAngleY, float aspectRatio, float _zNear, float _zFar)
+Graphics::Camera::Camera(float fovAngleY, float _aspectRatio, float _zNear, float _zFar)
 	: viewProjection{}, view{}, projection{}, invViewProjection{}, invView{}, invProjection{},
 	position{ 0.0f, 0.0f, 0.0f }, lookAtPoint{ 0.0f, 0.0f, 1.0f }, upVector{ 0.0f, 1.0f, 0.0f },
-	zNear(_zNear), zFar(_zFar), fovY(fovAngleY), frustum{}
+	zNear(_zNear), zFar(_zFar), fovY(fovAngleY), aspectRatio(_aspectRatio), zLinearizeCoeff{}, isViewDirty(true), isProjectionDirty(true),
+	viewVersion(0), projectionVersion(0), frustum{}, frustumVertices{}, worldFrustumVertices{}, cameraStatistics{}
 {
-	projection = XMMatrixPerspectiveFovLH(fovAngleY, aspectRatio, zNear, zFar);
-	invProjection = XMMatrixInverse(nullptr, projection);
+	Update();
 
-	UpdateMatrices();
-	UpdateFrustum(viewProjection, frustum);
+	cameraStatistics = {};
 }
 
 Graphics::Camera::~Camera()
@@ -19,19 +18,52 @@ Graphics::Camera::~Camera()
 
 void Graphics::Camera::Move(float3 _position)
 {
+	if (position.x == _position.x && position.y == _position.y && position.z == _position.z)
+		return;
+
 	position = _position;
+	isViewDirty = true;
 }
 
 void Graphics::Camera::MoveRelative(float3 velocity)
 {
+	if (velocity.x == 0.0f && velocity.y == 0.0f && velocity.z == 0.0f)
+		return;
+
 	position.x += velocity.x;
 	position.y += velocity.y;
 	position.z += velocity.z;
+	isViewDirty = true;
 }
 
 void Graphics::Camera::LookAt(float3 target)
 {
+	if (lookAtPoint.x == target.x && lookAtPoint.y == target.y && lookAtPoint.z == target.z)
+		return;
+
 	lookAtPoint = target;
+	isViewDirty = true;
+}
+
+void Graphics::Camera::SetUpVector(float3 _upVector)
+{
+	if (upVector.x == _upVector.x && upVector.y == _upVector.y && upVector.z == _upVector.z)
+		return;
+
+	upVector = _upVector;
+	isViewDirty = true;
+}
+
+void Graphics::Camera::SetPerspective(float fovAngleY, float _aspectRatio, float _zNear, float _zFar)
+{
+	if (fovY == fovAngleY && aspectRatio == _aspectRatio && zNear == _zNear && zFar == _zFar)
+		return;
+
+	fovY = fovAngleY;
+	aspectRatio = _aspectRatio;
+	zNear = _zNear;
+	zFar = _zFar;
+	isProjectionDirty = true;
 }
 
 bool Graphics::Camera::BoundingBoxInScope(const BoundingBox& boundingBox) const
@@ -50,6 +82,113 @@ bool Graphics::Camera::BoundingBoxInScope(const BoundingBox& boundingBox) const
 	return true;
 }
 
+Graphics::FrustumIntersection Graphics::Camera::ClassifyBoundingBox(const BoundingBox& boundingBox, uint32_t& planeMask, uint32_t& lastRejectingPlane,
+	size_t& planeTestsCount) const
+{
+	floatN minCornerPoint = XMLoadFloat3(&boundingBox.minCornerPoint);
+	floatN maxCornerPoint = XMLoadFloat3(&boundingBox.maxCornerPoint);
+	floatN center = (maxCornerPoint + minCornerPoint) * 0.5f;
+	floatN extents = (maxCornerPoint - minCornerPoint) * 0.5f;
+
+	auto testPlane = [&](uint32_t planeId, float& distance, float& radius)
+	{
+		planeTestsCount++;
+
+		distance = XMVectorGetX(XMPlaneDotCoord(frustum[planeId], center));
+		radius = XMVectorGetX(XMVector3Dot(XMVectorAbs(frustum[planeId]), extents));
+	};
+
+	float distance{};
+	float radius{};
+
+	if (lastRejectingPlane < frustum.size() && (planeMask & (1U << lastRejectingPlane)) != 0)
+	{
+		testPlane(lastRejectingPlane, distance, radius);
+
+		if (distance + radius < 0.0f)
+			return FrustumIntersection::FRUSTUM_OUTSIDE;
+
+		if (distance - radius >= 0.0f)
+			planeMask &= ~(1U << lastRejectingPlane);
+	}
+
+	for (uint32_t planeId = 0; planeId < frustum.size(); planeId++)
+	{
+		if (planeId == lastRejectingPlane || (planeMask & (1U << planeId)) == 0)
+			continue;
+
+		testPlane(planeId, distance, radius);
+
+		if (distance + radius < 0.0f)
+		{
+			lastRejectingPlane = planeId;
+
+			return FrustumIntersection::FRUSTUM_OUTSIDE;
+		}
+
+		if (distance - radius >= 0.0f)
+			planeMask &= ~(1U << planeId);
+	}
+
+	return (planeMask == 0) ? FrustumIntersection::FRUSTUM_INSIDE : FrustumIntersection::FRUSTUM_INTERSECTING;
+}
+
+Graphics::FrustumIntersection Graphics::Camera::ClassifyBoundingSphere(const BoundingSphere& boundingSphere, uint32_t& planeMask,
+	size_t& planeTestsCount) const
+{
+	floatN center = XMLoadFloat3(&boundingSphere.center);
+
+	for (uint32_t planeId = 0; planeId < frustum.size(); planeId++)
+	{
+		if ((planeMask & (1U << planeId)) == 0)
+			continue;
+
+		planeTestsCount++;
+
+		float distance = XMVectorGetX(XMPlaneDotCoord(frustum[planeId], center));
+
+		if (distance + boundingSphere.radius < 0.0f)
+			return FrustumIntersection::FRUSTUM_OUTSIDE;
+
+		if (distance - boundingSphere.radius >= 0.0f)
+			planeMask &= ~(1U << planeId);
+	}
+
+	return (planeMask == 0) ? FrustumIntersection::FRUSTUM_INSIDE : FrustumIntersection::FRUSTUM_INTERSECTING;
+}
+
+Graphics::FrustumIntersection Graphics::Camera::ClassifyOrientedBoundingBox(const OrientedBoundingBox& orientedBoundingBox, uint32_t& planeMask,
+	size_t& planeTestsCount) const
+{
+	floatN center = XMLoadFloat3(&orientedBoundingBox.center);
+	floatN axisX = XMLoadFloat3(&orientedBoundingBox.axes[0]);
+	floatN axisY = XMLoadFloat3(&orientedBoundingBox.axes[1]);
+	floatN axisZ = XMLoadFloat3(&orientedBoundingBox.axes[2]);
+
+	for (uint32_t planeId = 0; planeId < frustum.size(); planeId++)
+	{
+		if ((planeMask & (1U << planeId)) == 0)
+			continue;
+
+		planeTestsCount++;
+
+		const floatN& plane = frustum[planeId];
+
+		float distance = XMVectorGetX(XMPlaneDotCoord(plane, center));
+		float radius = orientedBoundingBox.extents.x * std::abs(XMVectorGetX(XMVector3Dot(plane, axisX))) +
+			orientedBoundingBox.extents.y * std::abs(XMVectorGetX(XMVector3Dot(plane, axisY))) +
+			orientedBoundingBox.extents.z * std::abs(XMVectorGetX(XMVector3Dot(plane, axisZ)));
+
+		if (distance + radius < 0.0f)
+			return FrustumIntersection::FRUSTUM_OUTSIDE;
+
+		if (distance - radius >= 0.0f)
+			planeMask &= ~(1U << planeId);
+	}
+
+	return (planeMask == 0) ? FrustumIntersection::FRUSTUM_INSIDE : FrustumIntersection::FRUSTUM_INTERSECTING;
+}
+
 const float4x4& Graphics::Camera::GetView() const
 {
 	return view;
@@ -95,6 +234,11 @@ const std::array<floatN, 8>& Graphics::Camera::GetFrustumVertices() const
 	return frustumVertices;
 }
 
+const std::array<floatN, 8>& Graphics::Camera::GetWorldFrustumVertices() const
+{
+	return worldFrustumVertices;
+}
+
 const float& Graphics::Camera::GetZNear() const
 {
 	return zNear;
@@ -110,45 +254,115 @@ const float& Graphics::Camera::GetFovY() const
 	return fovY;
 }
 
+const float& Graphics::Camera::GetAspectRatio() const
+{
+	return aspectRatio;
+}
+
+const float2& Graphics::Camera::GetZLinearizeCoeff() const
+{
+	return zLinearizeCoeff;
+}
+
+float Graphics::Camera::LinearizeZ(float nonLinearZ) const
+{
+	return 1.0f / (nonLinearZ * zLinearizeCoeff.x + zLinearizeCoeff.y);
+}
+
+float Graphics::Camera::UnlinearizeZ(float linearZ) const
+{
+	return (1.0f / linearZ - zLinearizeCoeff.y) / zLinearizeCoeff.x;
+}
+
+uint64_t Graphics::Camera::GetViewVersion() const noexcept
+{
+	return viewVersion;
+}
+
+uint64_t Graphics::Camera::GetProjectionVersion() const noexcept
+{
+	return projectionVersion;
+}
+
 void Graphics::Camera::Update()
 {
-	UpdateMatrices();
+	cameraStatistics.updatesRequested++;
+
+	if (!isViewDirty && !isProjectionDirty)
+	{
+		cameraStatistics.updatesSkipped++;
+
+		return;
+	}
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	if (isProjectionDirty)
+		UpdateProjectionMatrices();
+
+	if (isViewDirty)
+		UpdateViewMatrices();
+
+	viewProjection = XMMatrixMultiply(view, projection);
+	invViewProjection = XMMatrixInverse(nullptr, viewProjection);
+
 	UpdateFrustum(viewProjection, frustum);
+
+	for (size_t vertexId = 0; vertexId < frustumVertices.size(); vertexId++)
+		worldFrustumVertices[vertexId] = XMVector4Transform(frustumVertices[vertexId], invView);
+
+	cameraStatistics.updateTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+const Graphics::CameraStatistics& Graphics::Camera::GetCameraStatistics() const noexcept
+{
+	return cameraStatistics;
 }
 
-void Graphics::Camera::UpdateMatrices()
+void Graphics::Camera::ResetCameraStatistics() noexcept
+{
+	cameraStatistics = {};
+}
+
+void Graphics::Camera::UpdateViewMatrices()
 {
 	view = XMMatrixLookAtLH(XMLoadFloat3(&position), XMLoadFloat3(&lookAtPoint), XMLoadFloat3(&upVector));
-	viewProjection = XMMatrixMultiply(view, projection);
 	invView = XMMatrixInverse(nullptr, view);
-	invViewProjection = XMMatrixInverse(nullptr, viewProjection);
+
+	isViewDirty = false;
+	viewVersion++;
+	cameraStatistics.viewUpdates++;
 }
 
-void Graphics::Camera::UpdateFrustum(const float4x4& _viewProjection, Frustum& _frustum)
+void Graphics::Camera::UpdateProjectionMatrices()
 {
-	for (size_t halfFrustumId = 0; halfFrustumId < _frustum.size() / 2; halfFrustumId++)
-	{
-		floatN frustumPlane = _viewProjection.r[3] + _viewProjection.r[halfFrustumId];
-		_frustum[halfFrustumId * 2] = XMPlaneNormalizeEst(frustumPlane);
-
-		frustumPlane = _viewProjection.r[3] - _viewProjection.r[halfFrustumId];
-		_frustum[halfFrustumId * 2 + 1] = XMPlaneNormalizeEst(frustumPlane);
-	}
+	projection = XMMatrixPerspectiveFovLH(fovY, aspectRatio, zNear, zFar);
+	invProjection = XMMatrixInverse(nullptr, projection);
+	zLinearizeCoeff = { (1.0f - zFar / zNear) / zFar, 1.0f / zNear };
 
 	FrustumVertices(frustum, frustumVertices);
+
+	isProjectionDirty = false;
+	projectionVersion++;
+	cameraStatistics.projectionUpdates++;
 }
 
-float UnlinearizeZ(float z)
+void Graphics::Camera::UpdateFrustum(const float4x4& _viewProjection, Frustum& _frustum)
 {
-	float zNear = 0.01f;
-	float zFar = 1024.0f;
+	// DirectXMath multiplies row vectors, so the clip coordinates are dot products with the columns. Clip depth runs from 0 to w,
+	// which leaves the near plane as the z column alone.
+	float4x4 transposedViewProjection = XMMatrixTranspose(_viewProjection);
 
-	z = zNear + (zFar - zNear) * z;
+	for (size_t halfFrustumId = 0; halfFrustumId < _frustum.size() / 2; halfFrustumId++)
+	{
+		const floatN& column = transposedViewProjection.r[halfFrustumId];
 
-	float Pz = (1.0f - zFar / zNear) / zFar;
-	float Pw = 1.0f / zNear;
+		floatN frustumPlane = halfFrustumId == 2 ? column : transposedViewProjection.r[3] + column;
+		_frustum[halfFrustumId * 2] = XMPlaneNormalizeEst(frustumPlane);
 
-	return (1.0f / z - Pw) / Pz;
+		frustumPlane = transposedViewProjection.r[3] - column;
+		_frustum[halfFrustumId * 2 + 1] = XMPlaneNormalizeEst(frustumPlane);
+	}
 }
 
 void Graphics::Camera::FrustumVertices(const Frustum& _frustum, std::array<floatN, 8>& _frustumVertices)
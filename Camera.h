@@ -4,6 +4,22 @@
 
 namespace Graphics
 {
+	enum class FrustumIntersection
+	{
+		FRUSTUM_OUTSIDE,
+		FRUSTUM_INTERSECTING,
+		FRUSTUM_INSIDE
+	};
+
+	struct CameraStatistics
+	{
+		size_t updatesRequested;
+		size_t updatesSkipped;
+		size_t viewUpdates;
+		size_t projectionUpdates;
+		float updateTime;
+	};
+
 	class Camera
 	{
 	public:
@@ -14,8 +30,14 @@ namespace Graphics
 		void MoveRelative(float3 velocity);
 
 		void LookAt(float3 target);
+		void SetUpVector(float3 _upVector);
+		void SetPerspective(float fovAngleY, float _aspectRatio, float _zNear, float _zFar);
 
 		bool BoundingBoxInScope(const BoundingBox& boundingBox) const;
+		FrustumIntersection ClassifyBoundingBox(const BoundingBox& boundingBox, uint32_t& planeMask, uint32_t& lastRejectingPlane,
+			size_t& planeTestsCount) const;
+		FrustumIntersection ClassifyBoundingSphere(const BoundingSphere& boundingSphere, uint32_t& planeMask, size_t& planeTestsCount) const;
+		FrustumIntersection ClassifyOrientedBoundingBox(const OrientedBoundingBox& orientedBoundingBox, uint32_t& planeMask, size_t& planeTestsCount) const;
 
 		const float4x4& GetView() const;
 		const float4x4& GetProjection() const;
@@ -28,19 +50,34 @@ namespace Graphics
 
 		using Frustum = std::array<floatN, 6>;
 
+		static constexpr uint32_t FRUSTUM_ALL_PLANES_MASK = 0x3F;
+
 		const Frustum& GetFrustum() const;
 		const std::array<floatN, 8>& GetFrustumVertices() const;
+		const std::array<floatN, 8>& GetWorldFrustumVertices() const;
 
 		const float& GetZNear() const;
 		const float& GetZFar() const;
 		const float& GetFovY() const;
+		const float& GetAspectRatio() const;
+		const float2& GetZLinearizeCoeff() const;
+
+		float LinearizeZ(float nonLinearZ) const;
+		float UnlinearizeZ(float linearZ) const;
+
+		uint64_t GetViewVersion() const noexcept;
+		uint64_t GetProjectionVersion() const noexcept;
 
 		void Update();
 
+		const CameraStatistics& GetCameraStatistics() const noexcept;
+		void ResetCameraStatistics() noexcept;
+
 	private:
 		Camera() = delete;
 
-		void UpdateMatrices();
+		void UpdateViewMatrices();
+		void UpdateProjectionMatrices();
 
 		void UpdateFrustum(const float4x4& _viewProjection, Frustum& _frustum);
 		void FrustumVertices(const Frustum& _frustum, std::array<floatN, 8>& _frustumVertices);
@@ -61,9 +98,19 @@ namespace Graphics
 		float zNear;
 		float zFar;
 		float fovY;
+		float aspectRatio;
+		float2 zLinearizeCoeff;
+
+		bool isViewDirty;
+		bool isProjectionDirty;
+		uint64_t viewVersion;
+		uint64_t projectionVersion;
 
 		Frustum frustum;
 
 		std::array<floatN, 8> frustumVertices;
+		std::array<floatN, 8> worldFrustumVertices;
+
+		CameraStatistics cameraStatistics;
 	};
 }
@@ -91,8 +91,10 @@ void Graphics::Cloth::Update(ID3D12GraphicsCommandList* commandList) const
 
 void Graphics::Cloth::Draw(ID3D12GraphicsCommandList* commandList, const Material* material) const
 {
+	resourceManager.BeginResourceBarrierBatch();
 	resourceManager.SetUAVBarrier(commandList, vertexBufferId);
 	resourceManager.SetResourceBarrier(commandList, vertexBufferId, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+	resourceManager.FlushResourceBarriers(commandList);
 
 	if (material != nullptr)
 		if (material->IsComposed())
@@ -1,7 +1,8 @@
 #include "ComputeObject.h"
 
 Graphics::ComputeObject::ComputeObject()
-	: computeShader{}, threadGroupCountX(1), threadGroupCountY(1), threadGroupCountZ(1), isComposed(false)
+	: computeShader{}, stagedResourceDescriptors{}, stagedFrameIndex(UINT64_MAX), threadGroupCountX(1), threadGroupCountY(1), threadGroupCountZ(1),
+	isComposed(false)
 {
 
 }
@@ -16,8 +17,6 @@ Graphics::ConstantBufferId Graphics::ComputeObject::SetConstantBuffer(size_t reg
 	registerSet.constantBufferRegisterIndices.push_back(registerIndex);
 	indexSet.constantBufferIndices.push_back(resourceManager.CreateConstantBuffer(bufferData, bufferSize));
 
-	constantBufferAddresses.push_back(resourceManager.GetConstantBuffer(indexSet.constantBufferIndices.back()).constantBufferViewDesc.BufferLocation);
-
 	return indexSet.constantBufferIndices.back();
 }
 
@@ -40,8 +39,6 @@ void Graphics::ComputeObject::AssignConstantBuffer(size_t registerIndex, Constan
 {
 	registerSet.constantBufferRegisterIndices.push_back(registerIndex);
 	indexSet.constantBufferIndices.push_back(constantBufferId);
-
-	constantBufferAddresses.push_back(resourceManager.GetConstantBuffer(constantBufferId).constantBufferViewDesc.BufferLocation);
 }
 
 void Graphics::ComputeObject::AssignTexture(size_t registerIndex, TextureId textureId)
@@ -124,29 +121,32 @@ void Graphics::ComputeObject::Compose(ID3D12Device* device)
 
 	CreateGraphicsPipelineState(device, rootSignature.Get(), computeShader, &pipelineState);
 
+	resourceDescriptors.clear();
+	stagedFrameIndex = UINT64_MAX;
+
 	for (auto& textureIndex : indexSet.textureIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetTexture(textureIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetTexture(textureIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& rwTextureIndex : indexSet.rwTextureReadOnlyIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRWTexture(rwTextureIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRWTexture(rwTextureIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& renderTargetIndex : indexSet.renderTargetIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRenderTarget(renderTargetIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRenderTarget(renderTargetIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& depthStencilIndex : indexSet.depthStencilIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetDepthStencil(depthStencilIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetDepthStencil(depthStencilIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& bufferIndex : indexSet.bufferIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetBuffer(bufferIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetBuffer(bufferIndex).shaderResourceDescriptorAllocation.descriptorBase);
 	
 	for (auto& rwBufferIndex : indexSet.rwBufferReadOnlyIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRWBuffer(rwBufferIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRWBuffer(rwBufferIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& rwTextureIndex : indexSet.rwTextureIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRWTexture(rwTextureIndex).unorderedAccessDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRWTexture(rwTextureIndex).unorderedAccessDescriptorAllocation.descriptorBase);
 
 	for (auto& rwBufferIndex : indexSet.rwBufferIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRWBuffer(rwBufferIndex).unorderedAccessDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRWBuffer(rwBufferIndex).unorderedAccessDescriptorAllocation.descriptorBase);
 	
 	isComposed = true;
 }
@@ -170,11 +170,13 @@ void Graphics::ComputeObject::Present(ID3D12GraphicsCommandList* commandList) co
 
 	uint32_t rootParameterIndex{};
 
-	for (auto& constantBufferAddress : constantBufferAddresses)
-		commandList->SetComputeRootConstantBufferView(rootParameterIndex++, constantBufferAddress);
+	for (auto& constantBufferIndex : indexSet.constantBufferIndices)
+		commandList->SetComputeRootConstantBufferView(rootParameterIndex++, resourceManager.GetConstantBufferAddress(constantBufferIndex));
 
-	for (auto& firstResourceDescriptorBase : firstResourceDescriptorBases)
-		commandList->SetComputeRootDescriptorTable(rootParameterIndex++, firstResourceDescriptorBase);
+	const auto& stagedDescriptors = StageResourceDescriptors();
+
+	for (size_t descriptorId = 0; descriptorId < resourceDescriptors.size(); descriptorId++)
+		commandList->SetComputeRootDescriptorTable(rootParameterIndex++, { stagedDescriptors.gpuDescriptorBase.ptr + descriptorId * stagedDescriptors.descriptorIncrementSize });
 
 	commandList->Dispatch(threadGroupCountX, threadGroupCountY, threadGroupCountZ);
 }
@@ -310,3 +312,14 @@ void Graphics::ComputeObject::CreateGraphicsPipelineState(ID3D12Device* device,
 	ThrowIfFailed(device->CreateComputePipelineState(&pipelineStateDesc, IID_PPV_ARGS(pipelineState)),
 		"ComputeObject::CreateComputePipelineState: Compute Pipeline State creating failed!");
 }
+
+const Graphics::DescriptorAllocation& Graphics::ComputeObject::StageResourceDescriptors() const
+{
+	if (!resourceDescriptors.empty() && stagedFrameIndex != resourceManager.GetDescriptorFrameIndex())
+	{
+		resourceManager.StageDescriptors(resourceDescriptors, stagedResourceDescriptors);
+		stagedFrameIndex = resourceManager.GetDescriptorFrameIndex();
+	}
+
+	return stagedResourceDescriptors;
+}
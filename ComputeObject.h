@@ -74,15 +74,18 @@ namespace Graphics
 
 		void CreateGraphicsPipelineState(ID3D12Device* device, ID3D12RootSignature* rootSignature, D3D12_SHADER_BYTECODE _computeShader, ID3D12PipelineState** pipelineState);
 
+		const DescriptorAllocation& StageResourceDescriptors() const;
+
 		D3D12_SHADER_BYTECODE computeShader;
 
 		RegisterSet registerSet;
 		IndexSet indexSet;
 
-		std::vector<D3D12_GPU_VIRTUAL_ADDRESS> constantBufferAddresses;
 		std::vector<D3D12_STATIC_SAMPLER_DESC> samplerDescs;
 		
-		std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> firstResourceDescriptorBases;
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> resourceDescriptors;
+		mutable DescriptorAllocation stagedResourceDescriptors;
+		mutable uint64_t stagedFrameIndex;
 		
 		ComPtr<ID3D12RootSignature> rootSignature;
 		ComPtr<ID3D12PipelineState> pipelineState;
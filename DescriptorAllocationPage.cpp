@@ -1,45 +1,147 @@
 #include "DescriptorAllocationPage.h"
 
 Graphics::DescriptorAllocationPage::DescriptorAllocationPage(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE _descriptorHeapType,
-	bool isUAVShaderNonVisible, uint32_t _numDescriptors)
-	: numDescriptors(_numDescriptors), descriptorHeapType(_descriptorHeapType), descriptorBaseOffset(0u), gpuDescriptorBaseOffset(0u)
+	bool _isShaderVisible, uint32_t _numDescriptors, uint32_t _numTransientDescriptors)
+	: numDescriptors(_numDescriptors), numTransientDescriptors(_numTransientDescriptors), subAllocator(_numDescriptors - _numTransientDescriptors, 1),
+	descriptorBaseOffset(0u), gpuDescriptorBaseOffset(0u), descriptorHeapType(_descriptorHeapType), isShaderVisible(_isShaderVisible)
 {
+	if (numTransientDescriptors != 0 && !isShaderVisible)
+		throw std::exception("DescriptorAllocationPage::DescriptorAllocationPage: Transient descriptors require a shader visible heap");
+
 	D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc{};
 	descriptorHeapDesc.NumDescriptors = numDescriptors;
 	descriptorHeapDesc.Type = descriptorHeapType;
+	descriptorHeapDesc.Flags = isShaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 
-	if (descriptorHeapType == D3D12_DESCRIPTOR_HEAP_TYPE_RTV || descriptorHeapType == D3D12_DESCRIPTOR_HEAP_TYPE_DSV ||
-		descriptorHeapType == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV && isUAVShaderNonVisible)
-		descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-	else
-		descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	
 	ThrowIfFailed(device->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&descriptorHeap)),
 		"DescriptorAllocationPage::DescriptorAllocationPage: Descriptor Heap creating error");
 
-	numFreeHandles = numDescriptors;
 	descriptorIncrementSize =  device->GetDescriptorHandleIncrementSize(descriptorHeapType);
 
 	descriptorBaseOffset = descriptorHeap->GetCPUDescriptorHandleForHeapStart().ptr;
-	gpuDescriptorBaseOffset = descriptorHeap->GetGPUDescriptorHandleForHeapStart().ptr;
+
+	if (isShaderVisible)
+		gpuDescriptorBaseOffset = descriptorHeap->GetGPUDescriptorHandleForHeapStart().ptr;
+
+	if (numTransientDescriptors != 0)
+		transientRing = std::shared_ptr<UploadRing>(new UploadRing(numTransientDescriptors));
 }
 
 void Graphics::DescriptorAllocationPage::Allocate(uint32_t _numDescriptors, DescriptorAllocation& allocation)
 {
-	if (numFreeHandles < _numDescriptors)
+	if (!HasSpace(_numDescriptors))
 		throw std::exception("DescriptorAllocationPage::Allocate: Bad allocation");
 
-	allocation.descriptorBase.ptr = descriptorBaseOffset;
-	allocation.gpuDescriptorBase.ptr = gpuDescriptorBaseOffset;
-	allocation.descriptorIncrementSize = descriptorIncrementSize;
-	allocation.descriptorHeap = descriptorHeap.Get();
+	subAllocator.Allocate(_numDescriptors, 1, allocation.subAllocation);
+
+	FillAllocation(allocation.subAllocation.offset, allocation);
+}
+
+void Graphics::DescriptorAllocationPage::Deallocate(const DescriptorAllocation& allocation)
+{
+	if (allocation.page != this)
+		throw std::exception("DescriptorAllocationPage::Deallocate: Allocation belongs to another page");
 
-	descriptorBaseOffset += static_cast<SIZE_T>(static_cast<INT64>(_numDescriptors) * static_cast<INT64>(descriptorIncrementSize));
-	gpuDescriptorBaseOffset += static_cast<UINT64>(static_cast<INT64>(_numDescriptors) * static_cast<INT64>(descriptorIncrementSize));
-	numFreeHandles -= _numDescriptors;
+	subAllocator.Deallocate(allocation.subAllocation);
 }
 
 bool Graphics::DescriptorAllocationPage::HasSpace(uint32_t _numDescriptors) const noexcept
 {
-	return numFreeHandles > _numDescriptors;
+	return _numDescriptors != 0 && subAllocator.CanAllocate(_numDescriptors, 1);
+}
+
+bool Graphics::DescriptorAllocationPage::IsEmpty() const noexcept
+{
+	return subAllocator.IsEmpty();
+}
+
+bool Graphics::DescriptorAllocationPage::AllocateTransient(uint32_t _numDescriptors, DescriptorAllocation& allocation) noexcept
+{
+	uint64_t ringOffset;
+
+	if (transientRing == nullptr || _numDescriptors == 0 || !transientRing->Allocate(_numDescriptors, 1, ringOffset))
+		return false;
+
+	// The ring follows the static region, its allocations are never returned one by one
+	FillAllocation(subAllocator.GetCapacity() + ringOffset, allocation);
+	allocation.page = nullptr;
+	allocation.subAllocation = { subAllocator.GetCapacity() + ringOffset, _numDescriptors, SegregatedFitAllocator::INVALID_BLOCK };
+
+	return true;
+}
+
+void Graphics::DescriptorAllocationPage::FinishFrame(uint64_t fenceValue)
+{
+	if (transientRing != nullptr)
+		transientRing->FinishFrame(fenceValue);
+}
+
+void Graphics::DescriptorAllocationPage::ReleaseCompletedFrames(uint64_t completedFenceValue) noexcept
+{
+	if (transientRing != nullptr)
+		transientRing->ReleaseCompletedFrames(completedFenceValue);
+}
+
+uint64_t Graphics::DescriptorAllocationPage::GetFrameIndex() const noexcept
+{
+	return (transientRing != nullptr) ? transientRing->GetFrameIndex() : 0;
+}
+
+ID3D12DescriptorHeap* Graphics::DescriptorAllocationPage::GetDescriptorHeap() const noexcept
+{
+	return descriptorHeap.Get();
+}
+
+D3D12_DESCRIPTOR_HEAP_TYPE Graphics::DescriptorAllocationPage::GetDescriptorHeapType() const noexcept
+{
+	return descriptorHeapType;
+}
+
+UINT Graphics::DescriptorAllocationPage::GetDescriptorIncrementSize() const noexcept
+{
+	return descriptorIncrementSize;
+}
+
+uint32_t Graphics::DescriptorAllocationPage::GetStaticDescriptorsCount() const noexcept
+{
+	return numDescriptors - numTransientDescriptors;
+}
+
+uint32_t Graphics::DescriptorAllocationPage::GetTransientDescriptorsCount() const noexcept
+{
+	return numTransientDescriptors;
+}
+
+uint64_t Graphics::DescriptorAllocationPage::GetUsedDescriptorsCount() const noexcept
+{
+	return subAllocator.GetUsedSize();
+}
+
+uint64_t Graphics::DescriptorAllocationPage::GetLargestFreeBlockSize() const noexcept
+{
+	return subAllocator.GetLargestFreeBlockSize();
+}
+
+uint64_t Graphics::DescriptorAllocationPage::GetUsedTransientDescriptorsCount() const noexcept
+{
+	return (transientRing != nullptr) ? transientRing->GetUsedSize() : 0;
+}
+
+uint64_t Graphics::DescriptorAllocationPage::GetPeakTransientDescriptorsCount() const noexcept
+{
+	return (transientRing != nullptr) ? transientRing->GetStatistics().peakUsedSize : 0;
+}
+
+const Graphics::SegregatedFitStatistics& Graphics::DescriptorAllocationPage::GetStatistics() const noexcept
+{
+	return subAllocator.GetStatistics();
+}
+
+void Graphics::DescriptorAllocationPage::FillAllocation(uint64_t offset, DescriptorAllocation& allocation) noexcept
+{
+	allocation.descriptorBase.ptr = descriptorBaseOffset + static_cast<SIZE_T>(offset * descriptorIncrementSize);
+	allocation.gpuDescriptorBase.ptr = isShaderVisible ? gpuDescriptorBaseOffset + static_cast<UINT64>(offset * descriptorIncrementSize) : 0;
+	allocation.descriptorIncrementSize = descriptorIncrementSize;
+	allocation.descriptorHeap = descriptorHeap.Get();
+	allocation.page = this;
 }
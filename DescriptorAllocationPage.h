@@ -1,35 +1,70 @@
 #pragma once
 
 #include "GraphicsHelper.h"
+#include "SegregatedFitAllocator.h"
+#include "UploadRing.h"
 
 namespace Graphics
 {
+	class DescriptorAllocationPage;
+
 	struct DescriptorAllocation
 	{
 		UINT descriptorIncrementSize;
 		D3D12_CPU_DESCRIPTOR_HANDLE descriptorBase;
 		D3D12_GPU_DESCRIPTOR_HANDLE gpuDescriptorBase;
 		ID3D12DescriptorHeap* descriptorHeap;
+		DescriptorAllocationPage* page;
+		SegregatedFitAllocation subAllocation;
 	};
 
+	// Descriptor heap with a free-listed static region at its start. Shader visible heaps may reserve the rest of the heap
+	// as a ring for descriptors that live only for one frame.
 	class DescriptorAllocationPage
 	{
 	public:
-		DescriptorAllocationPage(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE _descriptorHeapType, bool isUAVShaderNonVisible, uint32_t _numDescriptors);
+		DescriptorAllocationPage(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE _descriptorHeapType, bool _isShaderVisible, uint32_t _numDescriptors,
+			uint32_t _numTransientDescriptors = 0);
 		~DescriptorAllocationPage() {};
 
 		void Allocate(uint32_t _numDescriptors, DescriptorAllocation& allocation);
+		void Deallocate(const DescriptorAllocation& allocation);
 		bool HasSpace(uint32_t _numDescriptors) const noexcept;
+		bool IsEmpty() const noexcept;
+
+		bool AllocateTransient(uint32_t _numDescriptors, DescriptorAllocation& allocation) noexcept;
+		void FinishFrame(uint64_t fenceValue);
+		void ReleaseCompletedFrames(uint64_t completedFenceValue) noexcept;
+		uint64_t GetFrameIndex() const noexcept;
+
+		ID3D12DescriptorHeap* GetDescriptorHeap() const noexcept;
+
+		D3D12_DESCRIPTOR_HEAP_TYPE GetDescriptorHeapType() const noexcept;
+		UINT GetDescriptorIncrementSize() const noexcept;
+		uint32_t GetStaticDescriptorsCount() const noexcept;
+		uint32_t GetTransientDescriptorsCount() const noexcept;
+		uint64_t GetUsedDescriptorsCount() const noexcept;
+		uint64_t GetLargestFreeBlockSize() const noexcept;
+		uint64_t GetUsedTransientDescriptorsCount() const noexcept;
+		uint64_t GetPeakTransientDescriptorsCount() const noexcept;
+
+		const SegregatedFitStatistics& GetStatistics() const noexcept;
 
 	private:
+		void FillAllocation(uint64_t offset, DescriptorAllocation& allocation) noexcept;
+
 		uint32_t numDescriptors;
-		uint32_t numFreeHandles;
+		uint32_t numTransientDescriptors;
 		UINT descriptorIncrementSize;
 
+		SegregatedFitAllocator subAllocator;
+		std::shared_ptr<UploadRing> transientRing;
+
 		ComPtr<ID3D12DescriptorHeap> descriptorHeap;
 
 		SIZE_T descriptorBaseOffset;
 		UINT64 gpuDescriptorBaseOffset;
 		D3D12_DESCRIPTOR_HEAP_TYPE descriptorHeapType;
+		bool isShaderVisible;
 	};
 }
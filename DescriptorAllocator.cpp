@@ -7,49 +7,373 @@ Graphics::DescriptorAllocator& Graphics::DescriptorAllocator::GetInstance()
     return thisInstance;
 }
 
-void Graphics::DescriptorAllocator::Allocate(ID3D12Device* device, bool isUAVShaderNonVisible, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
-    DescriptorAllocation& allocation)
+void Graphics::DescriptorAllocator::Initialize(ID3D12Device* device)
 {
-    if (isUAVShaderNonVisible)
-        Allocate(device, true, numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, usedUavShaderNonVisibleDescriptorHeapPages,
-            emptyUavShaderNonVisibleDescriptorHeapPages, currentUavShaderNonVisibleDescriptorHeapPage, allocation);
-    else if (descriptorType == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)
-        Allocate(device, false, numDescriptors, descriptorType, usedCbvSrvUavDescriptorHeapPages, emptyCbvSrvUavDescriptorHeapPages,
-            currentCbvSrvUavDescriptorHeapPage, allocation);
-    else if (descriptorType == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER)
-        Allocate(device, false, numDescriptors, descriptorType, usedSamplerDescriptorHeapPages, emptySamplerDescriptorHeapPages,
-            currentSamplerDescriptorHeapPage, allocation);
-    else if (descriptorType == D3D12_DESCRIPTOR_HEAP_TYPE_RTV)
-        Allocate(device, false, numDescriptors, descriptorType, usedRtvDescriptorHeapPages, emptyRtvDescriptorHeapPages,
-            currentRtvDescriptorHeapPage, allocation);
-    else if (descriptorType == D3D12_DESCRIPTOR_HEAP_TYPE_DSV)
-        Allocate(device, false, numDescriptors, descriptorType, usedDsvDescriptorHeapPages, emptyDsvDescriptorHeapPages,
-            currentDsvDescriptorHeapPage, allocation);
+    std::lock_guard<std::mutex> lock(shaderVisibleMutex);
+
+    if (shaderVisibleDescriptorHeapPage != nullptr)
+        return;
+
+    shaderVisibleDescriptorHeapPage = std::shared_ptr<DescriptorAllocationPage>(new DescriptorAllocationPage(device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, true,
+        SHADER_VISIBLE_DESCRIPTORS_COUNT, TRANSIENT_DESCRIPTORS_COUNT));
+
+    {
+        std::lock_guard<std::mutex> statisticsLock(statisticsMutex);
+
+        statistics.pagesCount++;
+    }
+
+    UINT descriptorIncrementSize = shaderVisibleDescriptorHeapPage->GetDescriptorIncrementSize();
+
+    counters.AddPage(SHADER_VISIBLE_STATIC_CATEGORY, static_cast<uint64_t>(shaderVisibleDescriptorHeapPage->GetStaticDescriptorsCount()) * descriptorIncrementSize);
+    counters.AddPage(SHADER_VISIBLE_TRANSIENT_CATEGORY, static_cast<uint64_t>(TRANSIENT_DESCRIPTORS_COUNT) * descriptorIncrementSize);
 }
 
-void Graphics::DescriptorAllocator::Allocate(ID3D12Device* device, bool isUAVShaderNonVisible, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
-    DescriptorHeapPool& usedHeapPool, DescriptorHeapPool& emptyHeapPool, std::shared_ptr<DescriptorAllocationPage>& currentPage,
+void Graphics::DescriptorAllocator::Allocate(ID3D12Device* device, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
     DescriptorAllocation& allocation)
 {
-    if (currentPage.get() == nullptr || !currentPage->HasSpace(numDescriptors))
-        SetNewPageAsCurrent(device, isUAVShaderNonVisible, numDescriptors, descriptorType, usedHeapPool, emptyHeapPool, currentPage);
+    if (descriptorType < 0 || descriptorType >= D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES)
+        throw std::exception("DescriptorAllocator::Allocate: Unknown descriptor heap type");
+
+    if (numDescriptors == 1)
+    {
+        auto& cachedDescriptors = GetThreadCache().descriptors[descriptorType];
+
+        if (cachedDescriptors.empty())
+            RefillThreadCache(device, descriptorType, cachedDescriptors);
+
+        allocation = cachedDescriptors.back();
+        cachedDescriptors.pop_back();
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(heapPoolMutexes[descriptorType]);
+
+        AllocateFromPool(device, numDescriptors, descriptorType, allocation);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+
+        statistics.persistentDescriptorsCount += numDescriptors;
+
+        if (numDescriptors == 1)
+            statistics.cachedDescriptorsCount--;
+    }
+
+    counters.AddAllocation(descriptorType, static_cast<uint64_t>(numDescriptors) * allocation.descriptorIncrementSize);
+}
+
+void Graphics::DescriptorAllocator::AllocateShaderVisible(uint32_t numDescriptors, DescriptorAllocation& allocation)
+{
+    {
+        std::lock_guard<std::mutex> lock(shaderVisibleMutex);
+
+        CheckShaderVisiblePage();
+
+        shaderVisibleDescriptorHeapPage->Allocate(numDescriptors, allocation);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+
+        statistics.shaderVisibleDescriptorsCount += numDescriptors;
+    }
+
+    counters.AddAllocation(SHADER_VISIBLE_STATIC_CATEGORY, static_cast<uint64_t>(numDescriptors) * allocation.descriptorIncrementSize);
+}
+
+void Graphics::DescriptorAllocator::AllocateTransient(uint32_t numDescriptors, DescriptorAllocation& allocation)
+{
+    {
+        std::lock_guard<std::mutex> lock(shaderVisibleMutex);
+
+        CheckShaderVisiblePage();
+
+        if (!shaderVisibleDescriptorHeapPage->AllocateTransient(numDescriptors, allocation))
+            throw std::exception("DescriptorAllocator::AllocateTransient: Descriptor ring is full");
+    }
+
+    std::lock_guard<std::mutex> lock(statisticsMutex);
 
-    currentPage->Allocate(numDescriptors, allocation);
+    statistics.transientDescriptorsCount += numDescriptors;
 }
 
-void Graphics::DescriptorAllocator::SetNewPageAsCurrent(ID3D12Device* device, bool isUAVShaderNonVisible, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
-    DescriptorHeapPool& usedHeapPool, DescriptorHeapPool& emptyHeapPool, std::shared_ptr<DescriptorAllocationPage>& currentPage)
+void Graphics::DescriptorAllocator::Deallocate(DescriptorAllocation& allocation)
 {
-    if (emptyHeapPool.empty())
+    if (allocation.page == nullptr)
+        throw std::exception("DescriptorAllocator::Deallocate: Invalid allocation");
+
+    size_t numDescriptors = static_cast<size_t>(allocation.subAllocation.size);
+    uint64_t requestedBytes = static_cast<uint64_t>(numDescriptors) * allocation.descriptorIncrementSize;
+
+    if (allocation.page == shaderVisibleDescriptorHeapPage.get())
     {
-        currentPage = std::shared_ptr<DescriptorAllocationPage>(new DescriptorAllocationPage(device, descriptorType, isUAVShaderNonVisible, numDescriptorsPerHeap));
+        {
+            std::lock_guard<std::mutex> lock(shaderVisibleMutex);
+
+            allocation.page->Deallocate(allocation);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+
+            statistics.shaderVisibleDescriptorsCount -= numDescriptors;
+        }
+
+        counters.RemoveAllocation(SHADER_VISIBLE_STATIC_CATEGORY, requestedBytes);
 
-        usedHeapPool.push_back(currentPage);
+        allocation = {};
+
+        return;
+    }
+
+    auto descriptorType = allocation.page->GetDescriptorHeapType();
+
+    if (numDescriptors == 1)
+    {
+        auto& cachedDescriptors = GetThreadCache().descriptors[descriptorType];
+        cachedDescriptors.push_back(allocation);
+
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+
+            statistics.persistentDescriptorsCount--;
+            statistics.cachedDescriptorsCount++;
+        }
+
+        // Threads that mostly release, like the one retiring completed frames, give the surplus back instead of hoarding it
+        if (cachedDescriptors.size() > THREAD_CACHE_CAPACITY)
+            DrainThreadCache(descriptorType, cachedDescriptors, THREAD_CACHE_CAPACITY / 2);
     }
     else
     {
-        currentPage = emptyHeapPool.front();
+        {
+            std::lock_guard<std::mutex> lock(heapPoolMutexes[descriptorType]);
+
+            allocation.page->Deallocate(allocation);
+        }
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
 
-        emptyHeapPool.pop_front();
+        statistics.persistentDescriptorsCount -= numDescriptors;
     }
+
+    counters.RemoveAllocation(descriptorType, requestedBytes);
+
+    allocation = {};
+}
+
+void Graphics::DescriptorAllocator::FlushThreadCache()
+{
+    auto& threadCache = GetThreadCache();
+
+    for (size_t descriptorType = 0; descriptorType < threadCache.descriptors.size(); descriptorType++)
+        DrainThreadCache(static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(descriptorType), threadCache.descriptors[descriptorType], 0);
+}
+
+void Graphics::DescriptorAllocator::StageDescriptors(ID3D12Device* device, const std::vector<D3D12_CPU_DESCRIPTOR_HANDLE>& sourceDescriptors,
+    DescriptorAllocation& allocation)
+{
+    uint32_t numDescriptors = static_cast<uint32_t>(sourceDescriptors.size());
+
+    AllocateTransient(numDescriptors, allocation);
+
+    // Every source is a single descriptor, the destination is one contiguous table in the ring
+    device->CopyDescriptors(1, &allocation.descriptorBase, &numDescriptors, numDescriptors, sourceDescriptors.data(), nullptr,
+        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+
+    statistics.stagedTablesCount++;
+}
+
+void Graphics::DescriptorAllocator::FinishFrame(uint64_t fenceValue)
+{
+    std::lock_guard<std::mutex> lock(shaderVisibleMutex);
+
+    CheckShaderVisiblePage();
+
+    shaderVisibleDescriptorHeapPage->FinishFrame(fenceValue);
+}
+
+void Graphics::DescriptorAllocator::ReleaseCompletedFrames(uint64_t completedFenceValue) noexcept
+{
+    std::lock_guard<std::mutex> lock(shaderVisibleMutex);
+
+    if (shaderVisibleDescriptorHeapPage != nullptr)
+        shaderVisibleDescriptorHeapPage->ReleaseCompletedFrames(completedFenceValue);
+}
+
+uint64_t Graphics::DescriptorAllocator::GetFrameIndex() const noexcept
+{
+    std::lock_guard<std::mutex> lock(shaderVisibleMutex);
+
+    return (shaderVisibleDescriptorHeapPage != nullptr) ? shaderVisibleDescriptorHeapPage->GetFrameIndex() : 0;
+}
+
+ID3D12DescriptorHeap* Graphics::DescriptorAllocator::GetShaderVisibleDescriptorHeap() const noexcept
+{
+    return (shaderVisibleDescriptorHeapPage != nullptr) ? shaderVisibleDescriptorHeapPage->GetDescriptorHeap() : nullptr;
+}
+
+Graphics::DescriptorAllocatorStatistics Graphics::DescriptorAllocator::GetStatistics() const noexcept
+{
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+
+    return statistics;
+}
+
+Graphics::AllocatorTelemetry Graphics::DescriptorAllocator::GetTelemetry() const
+{
+    AllocatorTelemetry telemetry;
+    counters.FillTelemetry("DescriptorAllocator", telemetry);
+
+    const std::array<const DescriptorHeapPool*, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES> heapPools =
+        { &cbvSrvUavDescriptorHeapPages, &samplerDescriptorHeapPages, &rtvDescriptorHeapPages, &dsvDescriptorHeapPages };
+
+    for (size_t descriptorType = 0; descriptorType < heapPools.size(); descriptorType++)
+    {
+        std::lock_guard<std::mutex> lock(heapPoolMutexes[descriptorType]);
+
+        // Descriptors held by thread caches count as used, the pools can't hand them out until the caches drain
+        for (const auto& page : *heapPools[descriptorType])
+        {
+            uint64_t descriptorIncrementSize = page->GetDescriptorIncrementSize();
+
+            AddPageUsage(telemetry.categories[page->GetDescriptorHeapType()], page->GetUsedDescriptorsCount() * descriptorIncrementSize,
+                page->GetLargestFreeBlockSize() * descriptorIncrementSize);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(shaderVisibleMutex);
+
+    if (shaderVisibleDescriptorHeapPage != nullptr)
+    {
+        const auto& page = shaderVisibleDescriptorHeapPage;
+        uint64_t descriptorIncrementSize = page->GetDescriptorIncrementSize();
+
+        AddPageUsage(telemetry.categories[SHADER_VISIBLE_STATIC_CATEGORY], page->GetUsedDescriptorsCount() * descriptorIncrementSize,
+            page->GetLargestFreeBlockSize() * descriptorIncrementSize);
+
+        // Ring allocations are never freed one by one, so its usage is sampled here instead of counted per allocation
+        auto& transientTelemetry = telemetry.categories[SHADER_VISIBLE_TRANSIENT_CATEGORY];
+        uint64_t usedTransientBytes = page->GetUsedTransientDescriptorsCount() * descriptorIncrementSize;
+
+        transientTelemetry.requestedBytes = usedTransientBytes;
+        transientTelemetry.peakRequestedBytes = page->GetPeakTransientDescriptorsCount() * descriptorIncrementSize;
+
+        AddPageUsage(transientTelemetry, usedTransientBytes, transientTelemetry.reservedBytes - usedTransientBytes);
+    }
+
+    FinalizeAllocatorTelemetry(telemetry);
+
+    return telemetry;
+}
+
+Graphics::DescriptorAllocator::ThreadCache::~ThreadCache()
+{
+    auto& descriptorAllocator = DescriptorAllocator::GetInstance();
+
+    for (size_t descriptorType = 0; descriptorType < descriptors.size(); descriptorType++)
+        descriptorAllocator.DrainThreadCache(static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(descriptorType), descriptors[descriptorType], 0);
+}
+
+Graphics::DescriptorAllocator::ThreadCache& Graphics::DescriptorAllocator::GetThreadCache()
+{
+    thread_local ThreadCache threadCache;
+
+    return threadCache;
+}
+
+void Graphics::DescriptorAllocator::AllocateFromPool(ID3D12Device* device, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
+    DescriptorAllocation& allocation)
+{
+    auto& heapPool = GetDescriptorHeapPool(descriptorType);
+
+    auto pageIt = std::find_if(heapPool.begin(), heapPool.end(),
+        [numDescriptors](const std::shared_ptr<DescriptorAllocationPage>& page) { return page->HasSpace(numDescriptors); });
+
+    if (pageIt == heapPool.end())
+    {
+        heapPool.push_back(std::shared_ptr<DescriptorAllocationPage>(new DescriptorAllocationPage(device, descriptorType, false,
+            std::max(numDescriptors, numDescriptorsPerHeap))));
+
+        pageIt = std::prev(heapPool.end());
+
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+
+            statistics.pagesCount++;
+        }
+
+        counters.AddPage(descriptorType, static_cast<uint64_t>((*pageIt)->GetStaticDescriptorsCount()) * (*pageIt)->GetDescriptorIncrementSize());
+    }
+
+    (*pageIt)->Allocate(numDescriptors, allocation);
+}
+
+void Graphics::DescriptorAllocator::RefillThreadCache(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
+    std::vector<DescriptorAllocation>& cachedDescriptors)
+{
+    {
+        std::lock_guard<std::mutex> lock(heapPoolMutexes[descriptorType]);
+
+        for (size_t descriptorId = 0; descriptorId < THREAD_CACHE_REFILL_COUNT; descriptorId++)
+        {
+            DescriptorAllocation allocation{};
+            AllocateFromPool(device, 1, descriptorType, allocation);
+
+            cachedDescriptors.push_back(allocation);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+
+    statistics.cachedDescriptorsCount += THREAD_CACHE_REFILL_COUNT;
+    statistics.threadCacheRefillsCount++;
+}
+
+void Graphics::DescriptorAllocator::DrainThreadCache(D3D12_DESCRIPTOR_HEAP_TYPE descriptorType, std::vector<DescriptorAllocation>& cachedDescriptors,
+    size_t keptDescriptorsCount)
+{
+    if (cachedDescriptors.size() <= keptDescriptorsCount)
+        return;
+
+    // The oldest descriptors go back first, the recently released ones are the most likely to be reused by this thread
+    size_t drainedDescriptorsCount = cachedDescriptors.size() - keptDescriptorsCount;
+    auto drainedEndIt = cachedDescriptors.begin() + drainedDescriptorsCount;
+
+    {
+        std::lock_guard<std::mutex> lock(heapPoolMutexes[descriptorType]);
+
+        for (auto cachedDescriptorIt = cachedDescriptors.begin(); cachedDescriptorIt != drainedEndIt; cachedDescriptorIt++)
+            cachedDescriptorIt->page->Deallocate(*cachedDescriptorIt);
+    }
+
+    cachedDescriptors.erase(cachedDescriptors.begin(), drainedEndIt);
+
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+
+    statistics.cachedDescriptorsCount -= drainedDescriptorsCount;
+}
+
+Graphics::DescriptorAllocator::DescriptorHeapPool& Graphics::DescriptorAllocator::GetDescriptorHeapPool(D3D12_DESCRIPTOR_HEAP_TYPE descriptorType)
+{
+    if (descriptorType == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)
+        return cbvSrvUavDescriptorHeapPages;
+    else if (descriptorType == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER)
+        return samplerDescriptorHeapPages;
+    else if (descriptorType == D3D12_DESCRIPTOR_HEAP_TYPE_RTV)
+        return rtvDescriptorHeapPages;
+    else if (descriptorType == D3D12_DESCRIPTOR_HEAP_TYPE_DSV)
+        return dsvDescriptorHeapPages;
+
+    throw std::exception("DescriptorAllocator::GetDescriptorHeapPool: Unknown descriptor heap type");
+}
+
+void Graphics::DescriptorAllocator::CheckShaderVisiblePage() const
+{
+    if (shaderVisibleDescriptorHeapPage == nullptr)
+        throw std::exception("DescriptorAllocator::CheckShaderVisiblePage: Allocator is not initialized");
 }
@@ -2,18 +2,52 @@
 
 #include "GraphicsHelper.h"
 #include "DescriptorAllocationPage.h"
+#include "AllocatorTelemetry.h"
 
 namespace Graphics
 {
+	struct DescriptorAllocatorStatistics
+	{
+		size_t persistentDescriptorsCount;
+		size_t shaderVisibleDescriptorsCount;
+		size_t transientDescriptorsCount;
+		size_t stagedTablesCount;
+		size_t pagesCount;
+		size_t cachedDescriptorsCount;
+		size_t threadCacheRefillsCount;
+	};
+
+	// Views are created in non shader visible pages with free lists. The only shader visible heap holds a static region for descriptors
+	// that have to stay bound and a per-frame ring the descriptor tables are copied into at bind time. Views may be created from any
+	// thread: single descriptors come from a per-thread cache that is refilled and drained in batches under the lock of its heap type.
 	class DescriptorAllocator
 	{
 	public:
 		static DescriptorAllocator& GetInstance();
 
-		void Allocate(ID3D12Device* device, bool isUAVShaderNonVisible, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType, DescriptorAllocation& allocation);
+		void Initialize(ID3D12Device* device);
+
+		void Allocate(ID3D12Device* device, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType, DescriptorAllocation& allocation);
+		void AllocateShaderVisible(uint32_t numDescriptors, DescriptorAllocation& allocation);
+		void AllocateTransient(uint32_t numDescriptors, DescriptorAllocation& allocation);
+		void Deallocate(DescriptorAllocation& allocation);
+
+		// Returns the descriptors cached by the calling thread, threads also do it on exit
+		void FlushThreadCache();
+
+		void StageDescriptors(ID3D12Device* device, const std::vector<D3D12_CPU_DESCRIPTOR_HANDLE>& sourceDescriptors, DescriptorAllocation& allocation);
+
+		void FinishFrame(uint64_t fenceValue);
+		void ReleaseCompletedFrames(uint64_t completedFenceValue) noexcept;
+		uint64_t GetFrameIndex() const noexcept;
+
+		ID3D12DescriptorHeap* GetShaderVisibleDescriptorHeap() const noexcept;
+
+		DescriptorAllocatorStatistics GetStatistics() const noexcept;
+		AllocatorTelemetry GetTelemetry() const;
 
 	private:
-		DescriptorAllocator() {};
+		DescriptorAllocator() : statistics{}, counters({ "CbvSrvUav", "Sampler", "Rtv", "Dsv", "ShaderVisibleStatic", "ShaderVisibleTransient" }) {};
 		~DescriptorAllocator() {};
 
 		DescriptorAllocator(const DescriptorAllocator&) = delete;
@@ -23,29 +57,48 @@ namespace Graphics
 
 		using DescriptorHeapPool = std::deque<std::shared_ptr<DescriptorAllocationPage>>;
 
-		void Allocate(ID3D12Device* device, bool isUAVShaderNonVisible, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType, DescriptorHeapPool& usedHeapPool,
-			DescriptorHeapPool& emptyHeapPool, std::shared_ptr<DescriptorAllocationPage>& currentPage, DescriptorAllocation& allocation);
-
-		void SetNewPageAsCurrent(ID3D12Device* device, bool isUAVShaderNonVisible, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
-			DescriptorHeapPool& usedHeapPool, DescriptorHeapPool& emptyHeapPool, std::shared_ptr<DescriptorAllocationPage>& currentPage);
-
-		DescriptorHeapPool usedCbvSrvUavDescriptorHeapPages;
-		DescriptorHeapPool usedSamplerDescriptorHeapPages;
-		DescriptorHeapPool usedRtvDescriptorHeapPages;
-		DescriptorHeapPool usedDsvDescriptorHeapPages;
-		DescriptorHeapPool usedUavShaderNonVisibleDescriptorHeapPages;
-
-		DescriptorHeapPool emptyCbvSrvUavDescriptorHeapPages;
-		DescriptorHeapPool emptySamplerDescriptorHeapPages;
-		DescriptorHeapPool emptyRtvDescriptorHeapPages;
-		DescriptorHeapPool emptyDsvDescriptorHeapPages;
-		DescriptorHeapPool emptyUavShaderNonVisibleDescriptorHeapPages;
-
-		std::shared_ptr<DescriptorAllocationPage> currentCbvSrvUavDescriptorHeapPage;
-		std::shared_ptr<DescriptorAllocationPage> currentSamplerDescriptorHeapPage;
-		std::shared_ptr<DescriptorAllocationPage> currentRtvDescriptorHeapPage;
-		std::shared_ptr<DescriptorAllocationPage> currentDsvDescriptorHeapPage;
-		std::shared_ptr<DescriptorAllocationPage> currentUavShaderNonVisibleDescriptorHeapPage;
+		// CPU pool categories follow D3D12_DESCRIPTOR_HEAP_TYPE order
+		enum TelemetryCategory : size_t
+		{
+			SHADER_VISIBLE_STATIC_CATEGORY = D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES,
+			SHADER_VISIBLE_TRANSIENT_CATEGORY
+		};
+
+		struct ThreadCache
+		{
+			~ThreadCache();
+
+			std::array<std::vector<DescriptorAllocation>, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES> descriptors;
+		};
+
+		static ThreadCache& GetThreadCache();
+
+		void AllocateFromPool(ID3D12Device* device, uint32_t numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType, DescriptorAllocation& allocation);
+		void RefillThreadCache(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE descriptorType, std::vector<DescriptorAllocation>& cachedDescriptors);
+		void DrainThreadCache(D3D12_DESCRIPTOR_HEAP_TYPE descriptorType, std::vector<DescriptorAllocation>& cachedDescriptors, size_t keptDescriptorsCount);
+
+		DescriptorHeapPool& GetDescriptorHeapPool(D3D12_DESCRIPTOR_HEAP_TYPE descriptorType);
+		void CheckShaderVisiblePage() const;
+
+		static constexpr uint32_t SHADER_VISIBLE_DESCRIPTORS_COUNT = 16384;
+		static constexpr uint32_t TRANSIENT_DESCRIPTORS_COUNT = 12288;
+		static constexpr size_t THREAD_CACHE_REFILL_COUNT = 32;
+		static constexpr size_t THREAD_CACHE_CAPACITY = 128;
+
+		DescriptorHeapPool cbvSrvUavDescriptorHeapPages;
+		DescriptorHeapPool samplerDescriptorHeapPages;
+		DescriptorHeapPool rtvDescriptorHeapPages;
+		DescriptorHeapPool dsvDescriptorHeapPages;
+
+		mutable std::array<std::mutex, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES> heapPoolMutexes;
+
+		std::shared_ptr<DescriptorAllocationPage> shaderVisibleDescriptorHeapPage;
+		mutable std::mutex shaderVisibleMutex;
+
+		DescriptorAllocatorStatistics statistics;
+		mutable std::mutex statisticsMutex;
+
+		AllocatorCounters counters;
 
 		uint32_t numDescriptorsPerHeap = 256;
 	};
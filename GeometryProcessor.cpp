@@ -60,12 +60,16 @@ float3 Graphics::GeometryProcessor::CalculateBarycentric(float3 position0, float
 
 bool Graphics::GeometryProcessor::CheckPointInTriangle(float3 position0, float3 position1, float3 position2, float3 point)
 {
-	float3 barycentric = GeometryProcessor::CalculateBarycentric(position0, position1, position2, point);
+	floatN vertex0 = XMLoadFloat3(&position0);
+	floatN vertex1 = XMLoadFloat3(&position1);
+	floatN vertex2 = XMLoadFloat3(&position2);
+	floatN testedPoint = XMLoadFloat3(&point);
 
-	if (barycentric.x + barycentric.y + barycentric.z <= 1.0f)
-		return true;
+	floatN edgeCross0 = XMVector3Cross(vertex1 - vertex0, testedPoint - vertex0);
+	floatN edgeCross1 = XMVector3Cross(vertex2 - vertex1, testedPoint - vertex1);
+	floatN edgeCross2 = XMVector3Cross(vertex0 - vertex2, testedPoint - vertex2);
 
-	return false;
+	return XMVectorGetX(XMVector3Dot(edgeCross0, edgeCross1)) >= 0.0f && XMVectorGetX(XMVector3Dot(edgeCross1, edgeCross2)) >= 0.0f;
 }
 
 bool Graphics::GeometryProcessor::CheckTriangleInPolygon(float3 position0, float3 position1, float3 position2, float3 polygonNormal)
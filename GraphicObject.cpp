@@ -1,7 +1,8 @@
 #include "GraphicObject.h"
 
 Graphics::GraphicObject::GraphicObject()
-	: boundingBox{}, layer(RenderingLayer::RENDERING_LAYER_OPAQUE), renderable(nullptr), material(nullptr)
+	: worldMatrix(XMMatrixIdentity()), localBoundingBox{}, localBoundingSphere{}, localOrientedBoundingBox{}, boundingBox{}, boundingSphere{},
+	orientedBoundingBox{}, layer(RenderingLayer::RENDERING_LAYER_OPAQUE), instanceParameters{}, renderable(nullptr), material(nullptr)
 {
 
 }
@@ -16,7 +17,13 @@ void Graphics::GraphicObject::AssignRenderableEntity(const IRenderable* renderab
 	renderable = renderableEntity;
 
 	if (renderable != nullptr)
-		boundingBox = renderable->GetBoundingBox();
+	{
+		localBoundingBox = renderable->GetBoundingBox();
+		localBoundingSphere = renderable->GetBoundingSphere();
+		localOrientedBoundingBox = renderable->GetOrientedBoundingBox();
+
+		RecalculateWorldBounds();
+	}
 }
 
 void Graphics::GraphicObject::AssignMaterial(const Material* newMaterial)
@@ -28,25 +35,157 @@ void Graphics::GraphicObject::AssignMaterial(const Material* newMaterial)
 	material = newMaterial;
 }
 
+void Graphics::GraphicObject::AddLevelOfDetail(const IRenderable* renderableEntity, float maxScreenSize)
+{
+	if (renderableEntity == nullptr)
+		return;
+
+	if (renderable == nullptr)
+		throw std::exception("Graphics::GraphicObject::AddLevelOfDetail: Base renderable entity is not assigned");
+
+	if (!levelsOfDetail.empty() && levelsOfDetail.back().maxScreenSize <= maxScreenSize)
+		throw std::exception("Graphics::GraphicObject::AddLevelOfDetail: Levels of detail must be added in decreasing screen size order");
+
+	levelsOfDetail.push_back({ renderableEntity, maxScreenSize });
+}
+
 void Graphics::GraphicObject::SetRenderingLayer(RenderingLayer renderingLayer)
 {
 	layer = renderingLayer;
 }
 
+void Graphics::GraphicObject::SetInstanceParameters(const float4& _instanceParameters)
+{
+	instanceParameters = _instanceParameters;
+}
+
+void Graphics::GraphicObject::SetWorldMatrix(const float4x4& _worldMatrix)
+{
+	worldMatrix = _worldMatrix;
+}
+
+void Graphics::GraphicObject::UpdateWorldBounds(const BoundingBox& worldBoundingBox)
+{
+	boundingBox = worldBoundingBox;
+
+	floatN scale = XMVectorMax(XMVectorMax(XMVector3Length(worldMatrix.r[0]), XMVector3Length(worldMatrix.r[1])), XMVector3Length(worldMatrix.r[2]));
+
+	XMStoreFloat3(&boundingSphere.center, XMVector3TransformCoord(XMLoadFloat3(&localBoundingSphere.center), worldMatrix));
+	boundingSphere.radius = localBoundingSphere.radius * XMVectorGetX(scale);
+
+	XMStoreFloat3(&orientedBoundingBox.center, XMVector3TransformCoord(XMLoadFloat3(&localOrientedBoundingBox.center), worldMatrix));
+
+	std::array<float, 3> extentsScale{};
+
+	for (uint32_t axisId = 0; axisId < 3; axisId++)
+	{
+		floatN axis = XMVector3TransformNormal(XMLoadFloat3(&localOrientedBoundingBox.axes[axisId]), worldMatrix);
+		float axisLength = XMVectorGetX(XMVector3Length(axis));
+
+		extentsScale[axisId] = axisLength;
+		XMStoreFloat3(&orientedBoundingBox.axes[axisId], axisLength > 0.0f ? axis / axisLength : axis);
+	}
+
+	orientedBoundingBox.extents = { localOrientedBoundingBox.extents.x * extentsScale[0], localOrientedBoundingBox.extents.y * extentsScale[1],
+		localOrientedBoundingBox.extents.z * extentsScale[2] };
+}
+
+const float4x4& Graphics::GraphicObject::GetWorldMatrix() const noexcept
+{
+	return worldMatrix;
+}
+
+const Graphics::BoundingBox& Graphics::GraphicObject::GetLocalBoundingBox() const noexcept
+{
+	return localBoundingBox;
+}
+
 const Graphics::BoundingBox& Graphics::GraphicObject::GetBoundingBox() const noexcept
 {
 	return boundingBox;
 }
 
+const Graphics::BoundingSphere& Graphics::GraphicObject::GetBoundingSphere() const noexcept
+{
+	return boundingSphere;
+}
+
+const Graphics::OrientedBoundingBox& Graphics::GraphicObject::GetOrientedBoundingBox() const noexcept
+{
+	return orientedBoundingBox;
+}
+
 const Graphics::RenderingLayer& Graphics::GraphicObject::GetRenderingLayer() const noexcept
 {
 	return layer;
 }
 
+uint32_t Graphics::GraphicObject::GetLevelsOfDetailCount() const noexcept
+{
+	return static_cast<uint32_t>(levelsOfDetail.size()) + 1;
+}
+
+float Graphics::GraphicObject::GetLevelOfDetailScreenSize(uint32_t levelOfDetail) const
+{
+	if (levelOfDetail == 0)
+		return FLT_MAX;
+
+	if (levelOfDetail > levelsOfDetail.size())
+		throw std::exception("Graphics::GraphicObject::GetLevelOfDetailScreenSize: Level of detail is out of range");
+
+	return levelsOfDetail[levelOfDetail - 1].maxScreenSize;
+}
+
+void Graphics::GraphicObject::RecalculateWorldBounds()
+{
+	std::array<floatN, 8> boundingBoxVertices;
+	BoundingBoxVertices(localBoundingBox, boundingBoxVertices);
+
+	floatN minCornerPoint = XMVector3TransformCoord(boundingBoxVertices[0], worldMatrix);
+	floatN maxCornerPoint = minCornerPoint;
+
+	for (auto& vertex : boundingBoxVertices)
+	{
+		floatN worldVertex = XMVector3TransformCoord(vertex, worldMatrix);
+
+		minCornerPoint = XMVectorMin(minCornerPoint, worldVertex);
+		maxCornerPoint = XMVectorMax(maxCornerPoint, worldVertex);
+	}
+
+	BoundingBox worldBoundingBox{};
+	XMStoreFloat3(&worldBoundingBox.minCornerPoint, minCornerPoint);
+	XMStoreFloat3(&worldBoundingBox.maxCornerPoint, maxCornerPoint);
+
+	UpdateWorldBounds(worldBoundingBox);
+}
+
+const float4& Graphics::GraphicObject::GetInstanceParameters() const noexcept
+{
+	return instanceParameters;
+}
+
+const Graphics::Material* Graphics::GraphicObject::GetMaterial() const noexcept
+{
+	return material;
+}
+
+const Graphics::IRenderable* Graphics::GraphicObject::GetRenderable(uint32_t levelOfDetail) const noexcept
+{
+	if (levelOfDetail == 0 || levelOfDetail > levelsOfDetail.size())
+		return renderable;
+
+	return levelsOfDetail[levelOfDetail - 1].renderable;
+}
+
 void Graphics::GraphicObject::Execute(ID3D12GraphicsCommandList* commandList) const
 {
 	if (renderable != nullptr)
 		renderable->Update(commandList);
+
+	// Any level may be picked for the next draw, so every one of them is kept up to date
+	for (auto& levelOfDetail : levelsOfDetail)
+		if (levelOfDetail.renderable != renderable)
+			levelOfDetail.renderable->Update(commandList);
 }
 
 void Graphics::GraphicObject::Draw(ID3D12GraphicsCommandList* commandList) const
@@ -54,3 +193,11 @@ void Graphics::GraphicObject::Draw(ID3D12GraphicsCommandList* commandList) const
 	if (renderable != nullptr)
 		renderable->Draw(commandList, material);
 }
+
+void Graphics::GraphicObject::Draw(ID3D12GraphicsCommandList* commandList, uint32_t levelOfDetail, DrawStateCache& drawStateCache) const
+{
+	const IRenderable* levelRenderable = GetRenderable(levelOfDetail);
+
+	if (levelRenderable != nullptr)
+		levelRenderable->Draw(commandList, material, drawStateCache);
+}
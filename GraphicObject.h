@@ -25,20 +25,55 @@ namespace Graphics
 		void AssignRenderableEntity(const IRenderable* renderableEntity);
 		void AssignMaterial(const Material* newMaterial);
 
+		void AddLevelOfDetail(const IRenderable* renderableEntity, float maxScreenSize);
 		void SetRenderingLayer(RenderingLayer renderingLayer);
+		void SetInstanceParameters(const float4& _instanceParameters);
 
+		void SetWorldMatrix(const float4x4& _worldMatrix);
+		void UpdateWorldBounds(const BoundingBox& worldBoundingBox);
+
+		const float4x4& GetWorldMatrix() const noexcept;
+		const BoundingBox& GetLocalBoundingBox() const noexcept;
 		const BoundingBox& GetBoundingBox() const noexcept;
+		const BoundingSphere& GetBoundingSphere() const noexcept;
+		const OrientedBoundingBox& GetOrientedBoundingBox() const noexcept;
 		const RenderingLayer& GetRenderingLayer() const noexcept;
+		const float4& GetInstanceParameters() const noexcept;
+		const Material* GetMaterial() const noexcept;
+		const IRenderable* GetRenderable(uint32_t levelOfDetail) const noexcept;
+
+		uint32_t GetLevelsOfDetailCount() const noexcept;
+		float GetLevelOfDetailScreenSize(uint32_t levelOfDetail) const;
 
 		void Execute(ID3D12GraphicsCommandList* commandList) const;
 		void Draw(ID3D12GraphicsCommandList* commandList) const;
+		void Draw(ID3D12GraphicsCommandList* commandList, uint32_t levelOfDetail, DrawStateCache& drawStateCache) const;
 
 	private:
+		void RecalculateWorldBounds();
+
+		struct LevelOfDetail
+		{
+			const IRenderable* renderable;
+			float maxScreenSize;
+		};
+
+		float4x4 worldMatrix;
+
+		BoundingBox localBoundingBox;
+		BoundingSphere localBoundingSphere;
+		OrientedBoundingBox localOrientedBoundingBox;
+
 		BoundingBox boundingBox;
+		BoundingSphere boundingSphere;
+		OrientedBoundingBox orientedBoundingBox;
 
 		RenderingLayer layer;
+		float4 instanceParameters;
 
 		const Material* material;
 		const IRenderable* renderable;
+
+		std::vector<LevelOfDetail> levelsOfDetail;
 	};
 }
@@ -294,6 +294,30 @@ bool Graphics::CheckBoxInBox(const float3& sourceBoxSize, const float3& destinat
 	return false;
 }
 
+bool Graphics::CheckBoxIntersectsBox(const BoundingBox& firstBox, const BoundingBox& secondBox) noexcept
+{
+	if (firstBox.minCornerPoint.x <= secondBox.maxCornerPoint.x &&
+		firstBox.maxCornerPoint.x >= secondBox.minCornerPoint.x &&
+		firstBox.minCornerPoint.y <= secondBox.maxCornerPoint.y &&
+		firstBox.maxCornerPoint.y >= secondBox.minCornerPoint.y &&
+		firstBox.minCornerPoint.z <= secondBox.maxCornerPoint.z &&
+		firstBox.maxCornerPoint.z >= secondBox.minCornerPoint.z)
+		return true;
+
+	return false;
+}
+
+bool Graphics::CheckSphereIntersectsBox(const BoundingSphere& sphere, const BoundingBox& box) noexcept
+{
+	if (sphere.radius < 0.0f)
+		return false;
+
+	floatN center = XMLoadFloat3(&sphere.center);
+	floatN closestPoint = XMVectorClamp(center, XMLoadFloat3(&box.minCornerPoint), XMLoadFloat3(&box.maxCornerPoint));
+
+	return XMVectorGetX(XMVector3LengthSq(center - closestPoint)) <= sphere.radius * sphere.radius;
+}
+
 Graphics::BoundingBox Graphics::ExpandBoundingBox(const BoundingBox& targetBox, const BoundingBox& appendableBox) noexcept
 {
 	BoundingBox expandedBoundingBox = { {std::min(targetBox.minCornerPoint.x, appendableBox.minCornerPoint.x),
@@ -323,6 +347,15 @@ float Graphics::BoundingBoxVolume(const BoundingBox& boundingBox)
 	return volume;
 }
 
+float Graphics::BoundingBoxSurfaceArea(const BoundingBox& boundingBox)
+{
+	float3 size = BoundingBoxSize(boundingBox);
+
+	float surfaceArea = 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+
+	return surfaceArea;
+}
+
 void Graphics::BoundingBoxVertices(const BoundingBox& boundingBox, std::array<floatN, 8>& vertices)
 {
 	float3 vertex = boundingBox.maxCornerPoint;
@@ -349,3 +382,234 @@ void Graphics::BoundingBoxVertices(const BoundingBox& boundingBox, std::array<fl
 	vertex = { boundingBox.maxCornerPoint.x, boundingBox.minCornerPoint.y, boundingBox.minCornerPoint.z };
 	vertices[7] = XMLoadFloat3(&vertex);
 }
+
+Graphics::BoundingSphere Graphics::BoundingBoxSphere(const BoundingBox& boundingBox) noexcept
+{
+	floatN minCornerPoint = XMLoadFloat3(&boundingBox.minCornerPoint);
+	floatN maxCornerPoint = XMLoadFloat3(&boundingBox.maxCornerPoint);
+
+	BoundingSphere boundingSphere{};
+	XMStoreFloat3(&boundingSphere.center, (minCornerPoint + maxCornerPoint) * 0.5f);
+	boundingSphere.radius = 0.5f * XMVectorGetX(XMVector3Length(maxCornerPoint - minCornerPoint));
+
+	return boundingSphere;
+}
+
+Graphics::OrientedBoundingBox Graphics::BoundingBoxOrientedBox(const BoundingBox& boundingBox) noexcept
+{
+	floatN minCornerPoint = XMLoadFloat3(&boundingBox.minCornerPoint);
+	floatN maxCornerPoint = XMLoadFloat3(&boundingBox.maxCornerPoint);
+
+	OrientedBoundingBox orientedBoundingBox{};
+	XMStoreFloat3(&orientedBoundingBox.center, (minCornerPoint + maxCornerPoint) * 0.5f);
+	XMStoreFloat3(&orientedBoundingBox.extents, (maxCornerPoint - minCornerPoint) * 0.5f);
+	orientedBoundingBox.axes = { float3(1.0f, 0.0f, 0.0f), float3(0.0f, 1.0f, 0.0f), float3(0.0f, 0.0f, 1.0f) };
+
+	return orientedBoundingBox;
+}
+
+Graphics::BoundingSphere Graphics::CalculateBoundingSphere(const float3* points, size_t pointsCount, size_t pointsStride)
+{
+	if (pointsCount == 0)
+		return { {}, 0.0f };
+
+	auto loadPoint = [points, pointsStride](size_t pointId)
+	{
+		return XMLoadFloat3(reinterpret_cast<const float3*>(reinterpret_cast<const uint8_t*>(points) + pointId * pointsStride));
+	};
+
+	auto findFarthestPoint = [&](const floatN& origin)
+	{
+		floatN farthestPoint = origin;
+		float farthestDistance = 0.0f;
+
+		for (size_t pointId = 0; pointId < pointsCount; pointId++)
+		{
+			floatN point = loadPoint(pointId);
+			float distance = XMVectorGetX(XMVector3LengthSq(point - origin));
+
+			if (distance > farthestDistance)
+			{
+				farthestPoint = point;
+				farthestDistance = distance;
+			}
+		}
+
+		return farthestPoint;
+	};
+
+	floatN firstPoint = findFarthestPoint(loadPoint(0));
+	floatN secondPoint = findFarthestPoint(firstPoint);
+
+	floatN center = (firstPoint + secondPoint) * 0.5f;
+	float radius = 0.5f * XMVectorGetX(XMVector3Length(secondPoint - firstPoint));
+
+	for (size_t pointId = 0; pointId < pointsCount; pointId++)
+	{
+		floatN offset = loadPoint(pointId) - center;
+		float distance = XMVectorGetX(XMVector3Length(offset));
+
+		if (distance <= radius)
+			continue;
+
+		float newRadius = 0.5f * (radius + distance);
+		center = center + offset * ((newRadius - radius) / distance);
+		radius = newRadius;
+	}
+
+	BoundingSphere boundingSphere{};
+	XMStoreFloat3(&boundingSphere.center, center);
+	boundingSphere.radius = radius;
+
+	return boundingSphere;
+}
+
+Graphics::OrientedBoundingBox Graphics::CalculateOrientedBoundingBox(const float3* points, size_t pointsCount, size_t pointsStride)
+{
+	if (pointsCount == 0)
+		return BoundingBoxOrientedBox({ {}, {} });
+
+	auto getPoint = [points, pointsStride](size_t pointId) -> const float3&
+	{
+		return *reinterpret_cast<const float3*>(reinterpret_cast<const uint8_t*>(points) + pointId * pointsStride);
+	};
+
+	std::array<double, 3> mean{};
+
+	for (size_t pointId = 0; pointId < pointsCount; pointId++)
+	{
+		const float3& point = getPoint(pointId);
+
+		mean[0] += point.x;
+		mean[1] += point.y;
+		mean[2] += point.z;
+	}
+
+	for (auto& meanComponent : mean)
+		meanComponent /= static_cast<double>(pointsCount);
+
+	std::array<std::array<double, 3>, 3> covariance{};
+
+	for (size_t pointId = 0; pointId < pointsCount; pointId++)
+	{
+		const float3& point = getPoint(pointId);
+		std::array<double, 3> offset = { point.x - mean[0], point.y - mean[1], point.z - mean[2] };
+
+		for (uint32_t rowId = 0; rowId < 3; rowId++)
+			for (uint32_t columnId = 0; columnId < 3; columnId++)
+				covariance[rowId][columnId] += offset[rowId] * offset[columnId];
+	}
+
+	std::array<std::array<double, 3>, 3> eigenVectors = { std::array<double, 3>{ 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+
+	for (uint32_t sweepId = 0; sweepId < 32; sweepId++)
+	{
+		double offDiagonal = covariance[0][1] * covariance[0][1] + covariance[0][2] * covariance[0][2] + covariance[1][2] * covariance[1][2];
+
+		if (offDiagonal < 1e-18)
+			break;
+
+		for (auto [p, q] : { std::pair<uint32_t, uint32_t>{ 0, 1 }, { 0, 2 }, { 1, 2 } })
+		{
+			if (std::abs(covariance[p][q]) < 1e-18)
+				continue;
+
+			double theta = (covariance[q][q] - covariance[p][p]) / (2.0 * covariance[p][q]);
+			double tangent = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+			double cosine = 1.0 / std::sqrt(tangent * tangent + 1.0);
+			double sine = tangent * cosine;
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				double kp = covariance[k][p];
+				double kq = covariance[k][q];
+
+				covariance[k][p] = cosine * kp - sine * kq;
+				covariance[k][q] = sine * kp + cosine * kq;
+			}
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				double pk = covariance[p][k];
+				double qk = covariance[q][k];
+
+				covariance[p][k] = cosine * pk - sine * qk;
+				covariance[q][k] = sine * pk + cosine * qk;
+			}
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				double kp = eigenVectors[k][p];
+				double kq = eigenVectors[k][q];
+
+				eigenVectors[k][p] = cosine * kp - sine * kq;
+				eigenVectors[k][q] = sine * kp + cosine * kq;
+			}
+		}
+	}
+
+	std::array<floatN, 3> axes;
+
+	for (uint32_t axisId = 0; axisId < 2; axisId++)
+		axes[axisId] = XMVector3Normalize(XMVectorSet(static_cast<float>(eigenVectors[0][axisId]), static_cast<float>(eigenVectors[1][axisId]),
+			static_cast<float>(eigenVectors[2][axisId]), 0.0f));
+
+	axes[2] = XMVector3Normalize(XMVector3Cross(axes[0], axes[1]));
+
+	floatN minProjection = XMVectorReplicate(FLT_MAX);
+	floatN maxProjection = XMVectorReplicate(-FLT_MAX);
+	BoundingBox boundingBox = { getPoint(0), getPoint(0) };
+
+	for (size_t pointId = 0; pointId < pointsCount; pointId++)
+	{
+		const float3& point = getPoint(pointId);
+		floatN position = XMLoadFloat3(&point);
+
+		floatN projection = XMVectorSet(XMVectorGetX(XMVector3Dot(position, axes[0])), XMVectorGetX(XMVector3Dot(position, axes[1])),
+			XMVectorGetX(XMVector3Dot(position, axes[2])), 0.0f);
+
+		minProjection = XMVectorMin(minProjection, projection);
+		maxProjection = XMVectorMax(maxProjection, projection);
+
+		boundingBox = ExpandBoundingBox(boundingBox, { point, point });
+	}
+
+	float3 extents;
+	XMStoreFloat3(&extents, (maxProjection - minProjection) * 0.5f);
+
+	if (8.0f * extents.x * extents.y * extents.z >= BoundingBoxVolume(boundingBox))
+		return BoundingBoxOrientedBox(boundingBox);
+
+	float3 centerProjection;
+	XMStoreFloat3(&centerProjection, (maxProjection + minProjection) * 0.5f);
+
+	OrientedBoundingBox orientedBoundingBox{};
+	XMStoreFloat3(&orientedBoundingBox.center, axes[0] * centerProjection.x + axes[1] * centerProjection.y + axes[2] * centerProjection.z);
+	orientedBoundingBox.extents = extents;
+
+	for (uint32_t axisId = 0; axisId < 3; axisId++)
+		XMStoreFloat3(&orientedBoundingBox.axes[axisId], axes[axisId]);
+
+	return orientedBoundingBox;
+}
+
+bool Graphics::IntersectRayBoundingBox(const floatN& rayOrigin, const floatN& rayInverseDirection, const BoundingBox& boundingBox, float maxDistance,
+	float& entryDistance) noexcept
+{
+	floatN slabDistances0 = (XMLoadFloat3(&boundingBox.minCornerPoint) - rayOrigin) * rayInverseDirection;
+	floatN slabDistances1 = (XMLoadFloat3(&boundingBox.maxCornerPoint) - rayOrigin) * rayInverseDirection;
+
+	float3 nearDistances, farDistances;
+	XMStoreFloat3(&nearDistances, XMVectorMin(slabDistances0, slabDistances1));
+	XMStoreFloat3(&farDistances, XMVectorMax(slabDistances0, slabDistances1));
+
+	float nearDistance = (std::max)({ nearDistances.x, nearDistances.y, nearDistances.z, 0.0f });
+	float farDistance = (std::min)({ farDistances.x, farDistances.y, farDistances.z, maxDistance });
+
+	if (nearDistance > farDistance)
+		return false;
+
+	entryDistance = nearDistance;
+
+	return true;
+}
@@ -46,6 +46,13 @@ namespace Graphics
 		float radius;
 	};
 
+	using OrientedBoundingBox = struct
+	{
+		float3 center;
+		float3 extents;
+		std::array<float3, 3> axes;
+	};
+
 	enum class UIHorizontalAlign
 	{
 		UI_ALIGN_LEFT,
@@ -98,11 +105,20 @@ namespace Graphics
 	bool CheckPointInBox(const float3& point, const BoundingBox& box);
 	bool CheckBoxInBox(const BoundingBox& sourceBox, const BoundingBox& destinationBox) noexcept;
 	bool CheckBoxInBox(const float3& sourceBoxSize, const float3& destinationBoxSize) noexcept;
+	bool CheckBoxIntersectsBox(const BoundingBox& firstBox, const BoundingBox& secondBox) noexcept;
+	bool CheckSphereIntersectsBox(const BoundingSphere& sphere, const BoundingBox& box) noexcept;
 	BoundingBox ExpandBoundingBox(const BoundingBox& targetBox, const BoundingBox& appendableBox) noexcept;
 
 	float3 BoundingBoxSize(const BoundingBox& boundingBox);
 	float BoundingBoxVolume(const BoundingBox& boundingBox);
+	float BoundingBoxSurfaceArea(const BoundingBox& boundingBox);
 	void BoundingBoxVertices(const BoundingBox& boundingBox, std::array<floatN, 8>& vertices);
+	BoundingSphere BoundingBoxSphere(const BoundingBox& boundingBox) noexcept;
+	OrientedBoundingBox BoundingBoxOrientedBox(const BoundingBox& boundingBox) noexcept;
+	BoundingSphere CalculateBoundingSphere(const float3* points, size_t pointsCount, size_t pointsStride);
+	OrientedBoundingBox CalculateOrientedBoundingBox(const float3* points, size_t pointsCount, size_t pointsStride);
+	bool IntersectRayBoundingBox(const floatN& rayOrigin, const floatN& rayInverseDirection, const BoundingBox& boundingBox, float maxDistance,
+		float& entryDistance) noexcept;
 	
 	template<typename T>
 	constexpr T AlignSize(const T size, const T alignment) noexcept
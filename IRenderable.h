@@ -11,7 +11,35 @@ namespace Graphics
 
 		virtual const BoundingBox& GetBoundingBox() const noexcept = 0;
 
+		virtual BoundingSphere GetBoundingSphere() const noexcept
+		{
+			return BoundingBoxSphere(GetBoundingBox());
+		}
+
+		virtual OrientedBoundingBox GetOrientedBoundingBox() const noexcept
+		{
+			return BoundingBoxOrientedBox(GetBoundingBox());
+		}
+
 		virtual void Update(ID3D12GraphicsCommandList* commandList) const = 0;
 		virtual void Draw(ID3D12GraphicsCommandList* commandList, const Material* material) const = 0;
+
+		virtual void Draw(ID3D12GraphicsCommandList* commandList, const Material* material, DrawStateCache& drawStateCache) const
+		{
+			Draw(commandList, material);
+
+			drawStateCache.Invalidate();
+		}
+
+		virtual bool SupportsInstancing() const noexcept
+		{
+			return false;
+		}
+
+		virtual void DrawInstanced(ID3D12GraphicsCommandList* commandList, const Material* material, DrawStateCache& drawStateCache,
+			const D3D12_VERTEX_BUFFER_VIEW& instanceBufferView, uint32_t instancesCount) const
+		{
+			throw std::exception("IRenderable::DrawInstanced: renderable does not support instancing");
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "GraphicObject.h"
+#include "Camera.h"
+
+namespace Graphics
+{
+	using ObjectPtrPool = std::vector<const GraphicObject*>;
+
+	struct CullingStatistics
+	{
+		size_t planeTests;
+		size_t nodesVisited;
+		size_t nodesCulled;
+		size_t objectsTested;
+		size_t objectsVisible;
+		size_t objectsPrefiltered;
+		size_t sphereRejections;
+		size_t boxRejections;
+		size_t orientedBoxRejections;
+		bool previousFrameReused;
+	};
+
+	struct Ray
+	{
+		float3 origin;
+		float3 direction;
+		float maxDistance;
+	};
+
+	struct RayHit
+	{
+		const GraphicObject* object;
+		float distance;
+	};
+
+	struct RayQueryStatistics
+	{
+		size_t raysCast;
+		size_t nodesVisited;
+		size_t boundingBoxTests;
+		size_t hits;
+	};
+
+	struct ObjectOverlap
+	{
+		uint32_t queryId;
+		const GraphicObject* object;
+	};
+
+	struct RangeQueryStatistics
+	{
+		size_t queries;
+		size_t nodesVisited;
+		size_t overlapTests;
+		size_t overlaps;
+	};
+
+	struct VisibleObjectsLists
+	{
+		ObjectPtrPool visibleObjectsList;
+		ObjectPtrPool visibleTransparentObjectsList;
+		ObjectPtrPool visibleEffectObjectsList;
+	};
+
+	enum class SpatialIndexType
+	{
+		SPATIAL_INDEX_OCTREE,
+		SPATIAL_INDEX_BVH
+	};
+
+	class ISpatialIndex
+	{
+	public:
+		virtual ~ISpatialIndex() {};
+
+		virtual void AddObject(const GraphicObject* newObject, bool isDynamic) = 0;
+		virtual void UpdateObjects(const ObjectPtrPool& movedObjects) = 0;
+
+		virtual void PrepareVisibleObjectsList(const Camera& targetCamera, ObjectPtrPool& visibleObjectsList, ObjectPtrPool& visibleTransparentObjectsList,
+			ObjectPtrPool& visibleEffectObjectsList) = 0;
+
+		virtual void PrepareVisibleObjectsLists(const std::vector<const Camera*>& cameras, std::vector<VisibleObjectsLists>& visibleObjectsLists)
+		{
+			if (cameras.size() > MAX_VIEWS_COUNT)
+				throw std::exception("ISpatialIndex::PrepareVisibleObjectsLists: Too many views");
+
+			CullingStatistics sequentialCullingStatistics{};
+
+			visibleObjectsLists.resize(cameras.size());
+
+			for (size_t viewId = 0; viewId < cameras.size(); viewId++)
+			{
+				VisibleObjectsLists& viewObjectsLists = visibleObjectsLists[viewId];
+
+				viewObjectsLists.visibleObjectsList.clear();
+				viewObjectsLists.visibleTransparentObjectsList.clear();
+				viewObjectsLists.visibleEffectObjectsList.clear();
+
+				PrepareVisibleObjectsList(*cameras[viewId], viewObjectsLists.visibleObjectsList, viewObjectsLists.visibleTransparentObjectsList,
+					viewObjectsLists.visibleEffectObjectsList);
+
+				const CullingStatistics& viewCullingStatistics = GetCullingStatistics();
+
+				sequentialCullingStatistics.planeTests += viewCullingStatistics.planeTests;
+				sequentialCullingStatistics.nodesVisited += viewCullingStatistics.nodesVisited;
+				sequentialCullingStatistics.nodesCulled += viewCullingStatistics.nodesCulled;
+				sequentialCullingStatistics.objectsTested += viewCullingStatistics.objectsTested;
+				sequentialCullingStatistics.objectsVisible += viewCullingStatistics.objectsVisible;
+				sequentialCullingStatistics.objectsPrefiltered += viewCullingStatistics.objectsPrefiltered;
+				sequentialCullingStatistics.sphereRejections += viewCullingStatistics.sphereRejections;
+				sequentialCullingStatistics.boxRejections += viewCullingStatistics.boxRejections;
+				sequentialCullingStatistics.orientedBoxRejections += viewCullingStatistics.orientedBoxRejections;
+			}
+
+			multiViewCullingStatistics = sequentialCullingStatistics;
+		}
+
+		virtual const CullingStatistics& GetCullingStatistics() const noexcept = 0;
+
+		const CullingStatistics& GetMultiViewCullingStatistics() const noexcept
+		{
+			return multiViewCullingStatistics;
+		}
+
+		static constexpr uint32_t MAX_VIEWS_COUNT = 8;
+
+		static bool IsObjectVisible(const Camera& targetCamera, const GraphicObject* object, uint32_t planeMask, uint32_t& lastRejectingPlane,
+			CullingStatistics& _cullingStatistics)
+		{
+			if (planeMask == 0)
+				return true;
+
+			auto intersection = targetCamera.ClassifyBoundingSphere(object->GetBoundingSphere(), planeMask, _cullingStatistics.planeTests);
+
+			if (intersection == FrustumIntersection::FRUSTUM_OUTSIDE)
+			{
+				_cullingStatistics.sphereRejections++;
+
+				return false;
+			}
+
+			if (intersection == FrustumIntersection::FRUSTUM_INSIDE)
+				return true;
+
+			intersection = targetCamera.ClassifyBoundingBox(object->GetBoundingBox(), planeMask, lastRejectingPlane, _cullingStatistics.planeTests);
+
+			if (intersection == FrustumIntersection::FRUSTUM_OUTSIDE)
+			{
+				_cullingStatistics.boxRejections++;
+
+				return false;
+			}
+
+			if (intersection == FrustumIntersection::FRUSTUM_INSIDE)
+				return true;
+
+			if (targetCamera.ClassifyOrientedBoundingBox(object->GetOrientedBoundingBox(), planeMask, _cullingStatistics.planeTests) ==
+				FrustumIntersection::FRUSTUM_OUTSIDE)
+			{
+				_cullingStatistics.orientedBoxRejections++;
+
+				return false;
+			}
+
+			return true;
+		}
+
+		static void PushVisibleObject(const GraphicObject* object, ObjectPtrPool& visibleObjectsList, ObjectPtrPool& visibleTransparentObjectsList,
+			ObjectPtrPool& visibleEffectObjectsList)
+		{
+			if (object->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_OPAQUE)
+				visibleObjectsList.push_back(object);
+			else if (object->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_TRANSPARENT)
+				visibleTransparentObjectsList.push_back(object);
+			else
+				visibleEffectObjectsList.push_back(object);
+		}
+
+	protected:
+		CullingStatistics multiViewCullingStatistics{};
+	};
+}
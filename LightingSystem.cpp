@@ -105,6 +105,9 @@ void Graphics::LightingSystem::ComposeLightBuffer(ID3D12Device* device, ID3D12Gr
 
 void Graphics::LightingSystem::SetPointLight(ID3D12GraphicsCommandList* commandList, const PointLightId& pointLightId, const PointLight& pointLight)
 {
+	if (pointLightId.value < pointLights.size())
+		pointLights[pointLightId.value] = pointLight;
+
 	pointLightConstBuffer.position = pointLight.GetPosition();
 	pointLightConstBuffer.radius = pointLight.GetRadius();
 	pointLightConstBuffer.color = pointLight.GetColor();
@@ -118,6 +121,14 @@ void Graphics::LightingSystem::SetPointLight(ID3D12GraphicsCommandList* commandL
 
 void Graphics::LightingSystem::SetPointLight(ID3D12GraphicsCommandList* commandList, const PointLightId& pointLightId, float3 position, float3 color, float radius, float intensity)
 {
+	if (pointLightId.value < pointLights.size())
+	{
+		pointLights[pointLightId.value].Move(position);
+		pointLights[pointLightId.value].SetColor(color);
+		pointLights[pointLightId.value].SetRadius(radius);
+		pointLights[pointLightId.value].SetIntensity(intensity);
+	}
+
 	pointLightConstBuffer.position = position;
 	pointLightConstBuffer.radius = radius;
 	pointLightConstBuffer.color = color;
@@ -129,6 +140,17 @@ void Graphics::LightingSystem::SetPointLight(ID3D12GraphicsCommandList* commandL
 	setPointLightCO->Present(commandList);
 }
 
+void Graphics::LightingSystem::GetPointLightsBoundingSpheres(std::vector<BoundingSphere>& boundingSpheres, bool shadowCastersOnly) const
+{
+	boundingSpheres.clear();
+
+	for (auto& pointLight : pointLights)
+		if (!shadowCastersOnly || pointLight.IsShadowCaster())
+			boundingSpheres.push_back(pointLight.GetBoundingSphere());
+		else
+			boundingSpheres.push_back({ pointLight.GetPosition(), -1.0f });
+}
+
 void Graphics::LightingSystem::UpdateCluster(ID3D12GraphicsCommandList* commandList)
 {
 	if (pointLights.empty())
@@ -138,22 +160,25 @@ void Graphics::LightingSystem::UpdateCluster(ID3D12GraphicsCommandList* commandL
 
 	calculateClusterCoordinatesCO->Present(commandList);
 	
+	resourceManager.BeginResourceBarrierBatch();
 	resourceManager.SetUAVBarrier(commandList, pointLightBufferId);
 	resourceManager.SetUAVBarrier(commandList, clusterDataBufferId);
-
 	resourceManager.SetResourceBarrier(commandList, pointLightClusterId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	resourceManager.FlushResourceBarriers(commandList);
 
 	uint32_t clearValue[4]{};
 
-	commandList->ClearUnorderedAccessViewUint(resourceManager.GetRWTexture(pointLightClusterId).unorderedAccessDescriptorAllocation.gpuDescriptorBase,
-		resourceManager.GetRWTexture(pointLightClusterId).shaderNonVisibleDescriptorAllocation.descriptorBase,
+	commandList->ClearUnorderedAccessViewUint(resourceManager.GetRWTexture(pointLightClusterId).shaderVisibleDescriptorAllocation.gpuDescriptorBase,
+		resourceManager.GetRWTexture(pointLightClusterId).unorderedAccessDescriptorAllocation.descriptorBase,
 		resourceManager.GetRWTexture(pointLightClusterId).textureAllocation.textureResource, clearValue, 0, nullptr);
 
 	distributePointLightCO->Present(commandList);
 
+	resourceManager.BeginResourceBarrierBatch();
 	resourceManager.SetUAVBarrier(commandList, pointLightClusterId);
 	resourceManager.SetResourceBarrier(commandList, pointLightClusterId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 	resourceManager.SetResourceBarrier(commandList, pointLightBufferId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	resourceManager.FlushResourceBarriers(commandList);
 }
 
 void Graphics::LightingSystem::Clear()
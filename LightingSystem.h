@@ -27,6 +27,8 @@ namespace Graphics
 
 		void SetPointLight(ID3D12GraphicsCommandList* commandList, const PointLightId& pointLightId, const PointLight& pointLight);
 		void SetPointLight(ID3D12GraphicsCommandList* commandList, const PointLightId& pointLightId, float3 position, float3 color, float radius, float intensity);
+
+		void GetPointLightsBoundingSpheres(std::vector<BoundingSphere>& boundingSpheres, bool shadowCastersOnly) const;
 		
 		void UpdateCluster(ID3D12GraphicsCommandList* commandList);
 
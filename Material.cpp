@@ -1,8 +1,8 @@
 #include "Material.h"
 
 Graphics::Material::Material()
-	: shaderList{}, vertexFormat{}, primitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE), renderTargetFormat{}, depthStencilFormat{},
-	cullMode(D3D12_CULL_MODE_NONE), blendDesc{}, useDepthBuffer(false), isComposed(false)
+	: shaderList{}, stagedResourceDescriptors{}, stagedFrameIndex(UINT64_MAX), vertexFormat{}, primitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE),
+	renderTargetFormat{}, depthStencilFormat{}, cullMode(D3D12_CULL_MODE_NONE), blendDesc{}, useDepthBuffer(false), useInstancing(false), isComposed(false)
 {
 	SetupBlendDesc(blendDesc);
 }
@@ -17,8 +17,6 @@ Graphics::ConstantBufferId Graphics::Material::SetConstantBuffer(size_t register
 	registerSet.constantBufferRegisterIndices.push_back(registerIndex);
 	indexSet.constantBufferIndices.push_back(resourceManager.CreateConstantBuffer(bufferData, bufferSize));
 
-	constantBufferAddresses.push_back(resourceManager.GetConstantBuffer(indexSet.constantBufferIndices.back()).constantBufferViewDesc.BufferLocation);
-
 	return indexSet.constantBufferIndices.back();
 }
 
@@ -42,8 +40,6 @@ void Graphics::Material::AssignConstantBuffer(size_t registerIndex, ConstantBuff
 {
 	registerSet.constantBufferRegisterIndices.push_back(registerIndex);
 	indexSet.constantBufferIndices.push_back(constantBufferId);
-
-	constantBufferAddresses.push_back(resourceManager.GetConstantBuffer(constantBufferId).constantBufferViewDesc.BufferLocation);
 }
 
 void Graphics::Material::AssignTexture(ID3D12GraphicsCommandList* commandList, size_t registerIndex, TextureId textureId, bool asPixelShaderResource)
@@ -162,6 +158,11 @@ void Graphics::Material::SetDepthStencilFormat(uint32_t depthBit)
 	depthStencilFormat = (depthBit == 32) ? DXGI_FORMAT_D32_FLOAT : DXGI_FORMAT_D24_UNORM_S8_UINT;
 }
 
+void Graphics::Material::SetInstancing(bool _useInstancing)
+{
+	useInstancing = _useInstancing;
+}
+
 void Graphics::Material::SetDepthTest(bool _useDepthBuffer)
 {
 	useDepthBuffer = _useDepthBuffer;
@@ -196,6 +197,9 @@ void Graphics::Material::Compose(ID3D12Device* device)
 	if (inputElementDescs.empty())
 		CreateInputElementDescs(vertexFormat, inputElementDescs);
 
+	if (useInstancing)
+		CreateInstanceInputElementDescs(inputElementDescs);
+
 	D3D12_RASTERIZER_DESC rasterizerDesc;
 	SetupRasterizerDesc(rasterizerDesc, cullMode);
 
@@ -216,29 +220,32 @@ void Graphics::Material::Compose(ID3D12Device* device)
 	CreateGraphicsPipelineState(device, { inputElementDescs.data() , static_cast<uint32_t>(inputElementDescs.size()) }, rootSignature.Get(), rasterizerDesc,
 		blendDesc, depthStencilDesc, renderTargetFormat, depthStencilFormat, shaderList, &pipelineState);
 
+	resourceDescriptors.clear();
+	stagedFrameIndex = UINT64_MAX;
+
 	for (auto& textureIndex : indexSet.textureIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetTexture(textureIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetTexture(textureIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& rwTextureIndex : indexSet.rwTextureReadOnlyIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRWTexture(rwTextureIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRWTexture(rwTextureIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& renderTargetIndex : indexSet.renderTargetIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRenderTarget(renderTargetIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRenderTarget(renderTargetIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& depthStencilIndex : indexSet.depthStencilIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetDepthStencil(depthStencilIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetDepthStencil(depthStencilIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& bufferIndex : indexSet.bufferIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetBuffer(bufferIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetBuffer(bufferIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& rwBufferIndex : indexSet.rwBufferReadOnlyIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRWBuffer(rwBufferIndex).shaderResourceDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRWBuffer(rwBufferIndex).shaderResourceDescriptorAllocation.descriptorBase);
 
 	for (auto& rwTextureIndex : indexSet.rwTextureIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRWTexture(rwTextureIndex).unorderedAccessDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRWTexture(rwTextureIndex).unorderedAccessDescriptorAllocation.descriptorBase);
 
 	for (auto& rwBufferIndex : indexSet.rwBufferIndices)
-		firstResourceDescriptorBases.push_back(resourceManager.GetRWBuffer(rwBufferIndex).unorderedAccessDescriptorAllocation.gpuDescriptorBase);
+		resourceDescriptors.push_back(resourceManager.GetRWBuffer(rwBufferIndex).unorderedAccessDescriptorAllocation.descriptorBase);
 
 	isComposed = true;
 }
@@ -248,6 +255,11 @@ bool Graphics::Material::IsComposed() const noexcept
 	return isComposed;
 }
 
+bool Graphics::Material::IsInstancingEnabled() const noexcept
+{
+	return useInstancing;
+}
+
 void Graphics::Material::Present(ID3D12GraphicsCommandList* commandList) const
 {
 	commandList->SetPipelineState(pipelineState.Get());
@@ -255,11 +267,97 @@ void Graphics::Material::Present(ID3D12GraphicsCommandList* commandList) const
 
 	uint32_t rootParameterIndex{};
 
-	for (auto& constantBufferAddress: constantBufferAddresses)
-		commandList->SetGraphicsRootConstantBufferView(rootParameterIndex++, constantBufferAddress);
+	for (auto& constantBufferIndex : indexSet.constantBufferIndices)
+		commandList->SetGraphicsRootConstantBufferView(rootParameterIndex++, resourceManager.GetConstantBufferAddress(constantBufferIndex));
+
+	const auto& stagedDescriptors = StageResourceDescriptors();
+
+	for (size_t descriptorId = 0; descriptorId < resourceDescriptors.size(); descriptorId++)
+		commandList->SetGraphicsRootDescriptorTable(rootParameterIndex++, { stagedDescriptors.gpuDescriptorBase.ptr + descriptorId * stagedDescriptors.descriptorIncrementSize });
+}
+
+void Graphics::Material::Present(ID3D12GraphicsCommandList* commandList, DrawStateCache& drawStateCache) const
+{
+	if (drawStateCache.pipelineState != pipelineState.Get())
+	{
+		commandList->SetPipelineState(pipelineState.Get());
+
+		drawStateCache.pipelineState = pipelineState.Get();
+		drawStateCache.pipelineStateChanges++;
+	}
+	else
+		drawStateCache.bindsSkipped++;
+
+	if (drawStateCache.rootSignature != rootSignature.Get())
+	{
+		commandList->SetGraphicsRootSignature(rootSignature.Get());
+
+		drawStateCache.rootSignature = rootSignature.Get();
+		drawStateCache.rootArguments.clear();
+		drawStateCache.rootSignatureChanges++;
+	}
+	else
+		drawStateCache.bindsSkipped++;
+
+	size_t rootParametersCount = indexSet.constantBufferIndices.size() + resourceDescriptors.size();
+
+	if (drawStateCache.rootArguments.size() < rootParametersCount)
+		drawStateCache.rootArguments.resize(rootParametersCount, UINT64_MAX);
+
+	uint32_t rootParameterIndex{};
+
+	for (auto& constantBufferIndex : indexSet.constantBufferIndices)
+	{
+		D3D12_GPU_VIRTUAL_ADDRESS constantBufferAddress = resourceManager.GetConstantBufferAddress(constantBufferIndex);
+
+		if (drawStateCache.rootArguments[rootParameterIndex] != constantBufferAddress)
+		{
+			commandList->SetGraphicsRootConstantBufferView(rootParameterIndex, constantBufferAddress);
+
+			drawStateCache.rootArguments[rootParameterIndex] = constantBufferAddress;
+			drawStateCache.rootArgumentChanges++;
+		}
+		else
+			drawStateCache.bindsSkipped++;
+
+		rootParameterIndex++;
+	}
+
+	const auto& stagedDescriptors = StageResourceDescriptors();
+
+	for (size_t descriptorId = 0; descriptorId < resourceDescriptors.size(); descriptorId++)
+	{
+		D3D12_GPU_DESCRIPTOR_HANDLE tableDescriptorBase{ stagedDescriptors.gpuDescriptorBase.ptr + descriptorId * stagedDescriptors.descriptorIncrementSize };
+
+		if (drawStateCache.rootArguments[rootParameterIndex] != tableDescriptorBase.ptr)
+		{
+			commandList->SetGraphicsRootDescriptorTable(rootParameterIndex, tableDescriptorBase);
+
+			drawStateCache.rootArguments[rootParameterIndex] = tableDescriptorBase.ptr;
+			drawStateCache.rootArgumentChanges++;
+		}
+		else
+			drawStateCache.bindsSkipped++;
+
+		rootParameterIndex++;
+	}
+}
+
+ID3D12PipelineState* Graphics::Material::GetPipelineState() const noexcept
+{
+	return pipelineState.Get();
+}
 
-	for (auto& firstTextureDescriptorBase : firstResourceDescriptorBases)
-		commandList->SetGraphicsRootDescriptorTable(rootParameterIndex++, firstTextureDescriptorBase);
+const Graphics::DescriptorAllocation& Graphics::Material::StageResourceDescriptors() const
+{
+	// Tables are copied into the shader visible ring once per frame and shared by every draw of the material
+	if (!resourceDescriptors.empty() && stagedFrameIndex != resourceManager.GetDescriptorFrameIndex())
+	{
+		resourceManager.StageDescriptors(resourceDescriptors, stagedResourceDescriptors);
+		stagedFrameIndex = resourceManager.GetDescriptorFrameIndex();
+	}
+
+	return stagedResourceDescriptors;
 }
 
 void Graphics::Material::CreateInputElementDescs(VertexFormat format, std::vector<D3D12_INPUT_ELEMENT_DESC>& inputElementDescs) const noexcept
@@ -280,6 +378,20 @@ void Graphics::Material::CreateInputElementDescs(VertexFormat format, std::vecto
 		inputElementDescs.push_back({ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 });
 }
 
+void Graphics::Material::CreateInstanceInputElementDescs(std::vector<D3D12_INPUT_ELEMENT_DESC>& inputElementDescs) const noexcept
+{
+	for (auto& inputElementDesc : inputElementDescs)
+		if (inputElementDesc.InputSlot == INSTANCE_INPUT_SLOT)
+			return;
+
+	for (uint32_t rowId = 0; rowId < 4; rowId++)
+		inputElementDescs.push_back({ "INSTANCE_WORLD", rowId, DXGI_FORMAT_R32G32B32A32_FLOAT, INSTANCE_INPUT_SLOT, (rowId == 0) ? 0 : D3D12_APPEND_ALIGNED_ELEMENT,
+			D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 });
+
+	inputElementDescs.push_back({ "INSTANCE_PARAMETERS", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, INSTANCE_INPUT_SLOT, D3D12_APPEND_ALIGNED_ELEMENT,
+		D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 });
+}
+
 void Graphics::Material::CreateResourceRootDescriptorTables(const RegisterSet& _registerSet, std::vector<D3D12_DESCRIPTOR_RANGE>& descriptorRanges,
 	std::vector<D3D12_ROOT_DESCRIPTOR_TABLE>& rootDescriptorTables)
 {
@@ -5,6 +5,40 @@
 
 namespace Graphics
 {
+	struct DrawStateCache
+	{
+		ID3D12PipelineState* pipelineState;
+		ID3D12RootSignature* rootSignature;
+		std::vector<uint64_t> rootArguments;
+
+		D3D_PRIMITIVE_TOPOLOGY primitiveTopology;
+		D3D12_GPU_VIRTUAL_ADDRESS vertexBufferLocation;
+		D3D12_GPU_VIRTUAL_ADDRESS indexBufferLocation;
+
+		size_t pipelineStateChanges;
+		size_t rootSignatureChanges;
+		size_t rootArgumentChanges;
+		size_t inputAssemblerChanges;
+		size_t bindsSkipped;
+
+		void Invalidate() noexcept
+		{
+			pipelineState = nullptr;
+			rootSignature = nullptr;
+			rootArguments.clear();
+
+			primitiveTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+			vertexBufferLocation = 0;
+			indexBufferLocation = 0;
+		}
+	};
+
+	struct InstanceData
+	{
+		float4x4 world;
+		float4 parameters;
+	};
+
 	class Material
 	{
 	public:
@@ -35,6 +69,7 @@ namespace Graphics
 			D3D12_INPUT_CLASSIFICATION inputClassification = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, uint32_t instanceDataStepRate = 0);
 
 		void SetVertexFormat(VertexFormat format);
+		void SetInstancing(bool _useInstancing);
 		void SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE type);
 		void SetRenderTargetFormat(size_t renderTargetIndex, DXGI_FORMAT format);
 		void SetDepthStencilFormat(uint32_t depthBit);
@@ -49,8 +84,14 @@ namespace Graphics
 		void Compose(ID3D12Device* device);
 
 		bool IsComposed() const noexcept;
+		bool IsInstancingEnabled() const noexcept;
 
 		void Present(ID3D12GraphicsCommandList* commandList) const;
+		void Present(ID3D12GraphicsCommandList* commandList, DrawStateCache& drawStateCache) const;
+
+		ID3D12PipelineState* GetPipelineState() const noexcept;
+
+		static constexpr uint32_t INSTANCE_INPUT_SLOT = 1;
 
 	private:
 		using RegisterSet = struct
@@ -80,6 +121,7 @@ namespace Graphics
 		};
 
 		void CreateInputElementDescs(VertexFormat format, std::vector<D3D12_INPUT_ELEMENT_DESC>& inputElementDescs) const noexcept;
+		void CreateInstanceInputElementDescs(std::vector<D3D12_INPUT_ELEMENT_DESC>& inputElementDescs) const noexcept;
 		void CreateResourceRootDescriptorTables(const RegisterSet& _registerSet, std::vector<D3D12_DESCRIPTOR_RANGE>& descriptorRanges,
 			std::vector<D3D12_ROOT_DESCRIPTOR_TABLE>& rootDescriptorTables);
 
@@ -93,15 +135,18 @@ namespace Graphics
 			const D3D12_RASTERIZER_DESC& rasterizerDesc, const D3D12_BLEND_DESC& blendDesc, const D3D12_DEPTH_STENCIL_DESC& depthStencilDesc,
 			const std::array<DXGI_FORMAT, 8>& rtvFormat, DXGI_FORMAT dsvFormat, const ShaderList& shaderList, ID3D12PipelineState** pipelineState);
 
+		const DescriptorAllocation& StageResourceDescriptors() const;
+
 		ShaderList shaderList;
 
 		RegisterSet registerSet;
 		IndexSet indexSet;
 
-		std::vector<D3D12_GPU_VIRTUAL_ADDRESS> constantBufferAddresses;
 		std::vector<D3D12_STATIC_SAMPLER_DESC> samplerDescs;
 
-		std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> firstResourceDescriptorBases;
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> resourceDescriptors;
+		mutable DescriptorAllocation stagedResourceDescriptors;
+		mutable uint64_t stagedFrameIndex;
 
 		VertexFormat vertexFormat;
 		D3D12_PRIMITIVE_TOPOLOGY_TYPE primitiveTopologyType;
@@ -116,6 +161,7 @@ namespace Graphics
 		D3D12_BLEND_DESC blendDesc;
 
 		bool useDepthBuffer;
+		bool useInstancing;
 
 		ComPtr<ID3D12RootSignature> rootSignature;
 		ComPtr<ID3D12PipelineState> pipelineState;
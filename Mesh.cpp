@@ -5,7 +5,7 @@
 #include "OBJLoader.h"
 
 Graphics::Mesh::Mesh(std::filesystem::path filePath, PolygonFormat targetPolygonFormat, VertexFormat targetVertexFormat, bool recalculateNormals, bool smoothNormals, bool enableOptimization)
-	: indicesCount{}, primitiveTopology{}, polygonFormat(targetPolygonFormat), vertexFormat(VertexFormat::UNDEFINED), boundingBox{}, vertexBufferView{}, indexBufferView{}
+	: indicesCount{}, primitiveTopology{}, polygonFormat(targetPolygonFormat), vertexFormat(VertexFormat::UNDEFINED), boundingBox{}, boundingSphere{}, orientedBoundingBox{}, vertexBufferView{}, indexBufferView{}
 {
 	std::unique_ptr<IMeshLoader> meshLoader;
 
@@ -31,6 +31,13 @@ Graphics::Mesh::Mesh(std::filesystem::path filePath, PolygonFormat targetPolygon
 	meshProcessor.Compose(targetVertexFormat, enableOptimization, vertexFormat);
 
 	boundingBox = meshProcessor.GetBoundingBox();
+	boundingSphere = meshProcessor.GetBoundingSphere();
+	orientedBoundingBox = meshProcessor.GetOrientedBoundingBox();
+
+	triangleHierarchy = std::shared_ptr<TriangleHierarchy>(new TriangleHierarchy());
+
+	if (!meshProcessor.BuildTriangleHierarchy(*triangleHierarchy))
+		triangleHierarchy.reset();
 
 	std::vector<uint32_t> verticesData;
 	std::vector<uint32_t> indicesData;
@@ -55,11 +62,22 @@ Graphics::Mesh::Mesh(std::filesystem::path filePath, PolygonFormat targetPolygon
 }
 
 Graphics::Mesh::Mesh(PolygonFormat targetPolygonFormat, VertexFormat targetVertexFormat, const void* verticesData, size_t verticesDataSize, const void* indicesData, size_t indicesDataSize)
-	: indicesCount(0), primitiveTopology{}, polygonFormat(targetPolygonFormat), vertexFormat(targetVertexFormat), boundingBox{}, vertexBufferView{}, indexBufferView{}
+	: indicesCount(0), primitiveTopology{}, polygonFormat(targetPolygonFormat), vertexFormat(targetVertexFormat), boundingBox{}, boundingSphere{}, orientedBoundingBox{}, vertexBufferView{}, indexBufferView{}
 {
 	CalculateBoundingBox(verticesData, verticesDataSize, vertexFormat, boundingBox);
 
 	auto vertexStride = VertexStride(vertexFormat);
+
+	boundingSphere = CalculateBoundingSphere(reinterpret_cast<const float3*>(verticesData), verticesDataSize / vertexStride, vertexStride);
+	orientedBoundingBox = CalculateOrientedBoundingBox(reinterpret_cast<const float3*>(verticesData), verticesDataSize / vertexStride, vertexStride);
+
+	if (polygonFormat == PolygonFormat::TRIANGLE)
+	{
+		triangleHierarchy = std::shared_ptr<TriangleHierarchy>(new TriangleHierarchy());
+		triangleHierarchy->Build(reinterpret_cast<const float3*>(verticesData), verticesDataSize / vertexStride, vertexStride,
+			reinterpret_cast<const uint32_t*>(indicesData), indicesDataSize / sizeof(uint32_t));
+	}
+
 	vertexBufferId = resourceManager.CreateVertexBuffer(verticesData, verticesDataSize, vertexStride);
 	indexBufferId = resourceManager.CreateIndexBuffer(indicesData, indicesDataSize, 4);
 
@@ -111,6 +129,21 @@ const Graphics::BoundingBox& Graphics::Mesh::GetBoundingBox() const noexcept
 	return boundingBox;
 }
 
+Graphics::BoundingSphere Graphics::Mesh::GetBoundingSphere() const noexcept
+{
+	return boundingSphere;
+}
+
+Graphics::OrientedBoundingBox Graphics::Mesh::GetOrientedBoundingBox() const noexcept
+{
+	return orientedBoundingBox;
+}
+
+Graphics::TriangleHierarchy* Graphics::Mesh::GetTriangleHierarchy() const noexcept
+{
+	return triangleHierarchy.get();
+}
+
 void Graphics::Mesh::SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY targetPrimitiveTopology, D3D_PRIMITIVE_TOPOLOGY& resultPrimitiveTopology)
 {
 	if (polygonFormat == PolygonFormat::N_GON)
@@ -162,6 +195,74 @@ void Graphics::Mesh::Draw(ID3D12GraphicsCommandList* commandList, const Material
 		}
 }
 
+void Graphics::Mesh::Draw(ID3D12GraphicsCommandList* commandList, const Material* material, DrawStateCache& drawStateCache) const
+{
+	if (material != nullptr)
+		if (material->IsComposed())
+		{
+			SetInputAssemblerState(commandList, drawStateCache);
+
+			material->Present(commandList, drawStateCache);
+
+			commandList->DrawIndexedInstanced(indicesCount, 1, 0, 0, 0);
+		}
+}
+
+bool Graphics::Mesh::SupportsInstancing() const noexcept
+{
+	return true;
+}
+
+void Graphics::Mesh::DrawInstanced(ID3D12GraphicsCommandList* commandList, const Material* material, DrawStateCache& drawStateCache,
+	const D3D12_VERTEX_BUFFER_VIEW& instanceBufferView, uint32_t instancesCount) const
+{
+	if (material != nullptr)
+		if (material->IsComposed())
+		{
+			SetInputAssemblerState(commandList, drawStateCache);
+
+			commandList->IASetVertexBuffers(Material::INSTANCE_INPUT_SLOT, 1, &instanceBufferView);
+			drawStateCache.inputAssemblerChanges++;
+
+			material->Present(commandList, drawStateCache);
+
+			commandList->DrawIndexedInstanced(indicesCount, instancesCount, 0, 0, 0);
+		}
+}
+
+void Graphics::Mesh::SetInputAssemblerState(ID3D12GraphicsCommandList* commandList, DrawStateCache& drawStateCache) const
+{
+	if (drawStateCache.primitiveTopology != primitiveTopology)
+	{
+		commandList->IASetPrimitiveTopology(primitiveTopology);
+
+		drawStateCache.primitiveTopology = primitiveTopology;
+		drawStateCache.inputAssemblerChanges++;
+	}
+	else
+		drawStateCache.bindsSkipped++;
+
+	if (drawStateCache.vertexBufferLocation != vertexBufferView.BufferLocation)
+	{
+		commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+
+		drawStateCache.vertexBufferLocation = vertexBufferView.BufferLocation;
+		drawStateCache.inputAssemblerChanges++;
+	}
+	else
+		drawStateCache.bindsSkipped++;
+
+	if (drawStateCache.indexBufferLocation != indexBufferView.BufferLocation)
+	{
+		commandList->IASetIndexBuffer(&indexBufferView);
+
+		drawStateCache.indexBufferLocation = indexBufferView.BufferLocation;
+		drawStateCache.inputAssemblerChanges++;
+	}
+	else
+		drawStateCache.bindsSkipped++;
+}
+
 void Graphics::Mesh::CalculateBoundingBox(const void* verticesData, size_t verticesDataSize, VertexFormat _vertexFormat, BoundingBox& result)
 {
 	auto vertexStride = VertexStride(_vertexFormat);
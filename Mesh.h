@@ -4,6 +4,7 @@
 #include "Material.h"
 #include "IRenderable.h"
 #include "GeometryStructures.h"
+#include "TriangleHierarchy.h"
 
 namespace Graphics
 {
@@ -20,16 +21,25 @@ namespace Graphics
 		VertexBufferId GetVertexBufferId() const noexcept;
 		IndexBufferId GetIndexBufferId() const noexcept;
 		const BoundingBox& GetBoundingBox() const noexcept override;
+		BoundingSphere GetBoundingSphere() const noexcept override;
+		OrientedBoundingBox GetOrientedBoundingBox() const noexcept override;
+		TriangleHierarchy* GetTriangleHierarchy() const noexcept;
 		
 		void SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY targetPrimitiveTopology, D3D_PRIMITIVE_TOPOLOGY& resultPrimitiveTopology);
 
 		void Update(ID3D12GraphicsCommandList* commandList) const override;
 		void Draw(ID3D12GraphicsCommandList* commandList, const Material* material) const override;
+		void Draw(ID3D12GraphicsCommandList* commandList, const Material* material, DrawStateCache& drawStateCache) const override;
+
+		bool SupportsInstancing() const noexcept override;
+		void DrawInstanced(ID3D12GraphicsCommandList* commandList, const Material* material, DrawStateCache& drawStateCache,
+			const D3D12_VERTEX_BUFFER_VIEW& instanceBufferView, uint32_t instancesCount) const override;
 
 	private:
 		Mesh() = delete;
 
 		void CalculateBoundingBox(const void* verticesData, size_t verticesDataSize, VertexFormat _vertexFormat, BoundingBox& result);
+		void SetInputAssemblerState(ID3D12GraphicsCommandList* commandList, DrawStateCache& drawStateCache) const;
 
 		VertexBufferId vertexBufferId;
 		IndexBufferId indexBufferId;
@@ -40,6 +50,9 @@ namespace Graphics
 		PolygonFormat polygonFormat;
 		VertexFormat vertexFormat;
 		BoundingBox boundingBox;
+		BoundingSphere boundingSphere;
+		OrientedBoundingBox orientedBoundingBox;
+		std::shared_ptr<TriangleHierarchy> triangleHierarchy;
 
 		D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
 		D3D12_INDEX_BUFFER_VIEW indexBufferView;
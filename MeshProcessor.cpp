@@ -84,6 +84,32 @@ Graphics::BoundingBox Graphics::MeshProcessor::GetBoundingBox() const noexcept
 	return result;
 }
 
+Graphics::BoundingSphere Graphics::MeshProcessor::GetBoundingSphere() const
+{
+	return CalculateBoundingSphere(meshData.positions.data(), meshData.positions.size(), sizeof(float3));
+}
+
+Graphics::OrientedBoundingBox Graphics::MeshProcessor::GetOrientedBoundingBox() const
+{
+	return CalculateOrientedBoundingBox(meshData.positions.data(), meshData.positions.size(), sizeof(float3));
+}
+
+bool Graphics::MeshProcessor::BuildTriangleHierarchy(TriangleHierarchy& triangleHierarchy) const
+{
+	if (composedMeshVertices.empty() || composedMeshIndices.empty() || currentPolygonFormat != PolygonFormat::TRIANGLE)
+		return false;
+
+	std::vector<float3> positions;
+	positions.reserve(composedMeshVertices.size());
+
+	for (auto& vertexPtr : composedMeshVertices)
+		positions.push_back(vertexPtr->position);
+
+	triangleHierarchy.Build(positions.data(), positions.size(), sizeof(float3), composedMeshIndices.data(), composedMeshIndices.size());
+
+	return true;
+}
+
 void Graphics::MeshProcessor::CalculateNormals(bool smooth)
 {
 	meshData.normals.clear();
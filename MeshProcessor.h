@@ -2,6 +2,7 @@
 
 #include "GraphicsHelper.h"
 #include "GeometryStructures.h"
+#include "TriangleHierarchy.h"
 
 namespace Graphics
 {
@@ -15,6 +16,9 @@ namespace Graphics
 		bool GetComposedData(std::vector<std::shared_ptr<Vertex>>& composedVertices, std::vector<uint32_t>& indices);
 		bool GetRawComposedData(std::vector<uint32_t>& rawVertexBuffer, std::vector<uint32_t>& rawIndexBuffer);
 		BoundingBox GetBoundingBox() const noexcept;
+		BoundingSphere GetBoundingSphere() const;
+		OrientedBoundingBox GetOrientedBoundingBox() const;
+		bool BuildTriangleHierarchy(TriangleHierarchy& triangleHierarchy) const;
 
 		void CalculateNormals(bool smooth);
 		void CalculateTangents();
@@ -0,0 +1,318 @@
+#include "OcclusionCuller.h"
+
+Graphics::OcclusionCuller::OcclusionCuller(uint32_t _width, uint32_t _height)
+	: width(AlignSize((std::max)(_width, 4u), 4u)), height((std::max)(_height, 4u)), occludersVersion(0), viewProjection{}, zNear(0.0f), occlusionStatistics{}
+{
+	uint32_t levelWidth = width;
+	uint32_t levelHeight = height;
+
+	depthLevels.push_back({ levelWidth, levelHeight, {}, std::vector<float>(static_cast<size_t>(levelWidth) * levelHeight, 1.0f) });
+
+	while (levelWidth > 1 || levelHeight > 1)
+	{
+		levelWidth = (std::max)((levelWidth + 1) / 2, 1u);
+		levelHeight = (std::max)((levelHeight + 1) / 2, 1u);
+
+		size_t texelsCount = static_cast<size_t>(levelWidth) * levelHeight;
+
+		depthLevels.push_back({ levelWidth, levelHeight, std::vector<float>(texelsCount, 1.0f), std::vector<float>(texelsCount, 1.0f) });
+	}
+}
+
+Graphics::OcclusionCuller::~OcclusionCuller()
+{
+
+}
+
+void Graphics::OcclusionCuller::AddOccluder(const void* verticesData, size_t verticesDataSize, VertexFormat vertexFormat, const void* indicesData, size_t indicesDataSize)
+{
+	if ((vertexFormat & VertexFormat::POSITION) != VertexFormat::POSITION)
+		throw std::exception("OcclusionCuller::AddOccluder: Occluder vertices must contain positions");
+
+	if (indicesDataSize % (3 * sizeof(uint32_t)) != 0)
+		throw std::exception("OcclusionCuller::AddOccluder: Occluder must be a triangle list");
+
+	auto vertexStride = VertexStride(vertexFormat);
+	size_t verticesCount = verticesDataSize / vertexStride;
+
+	if (verticesCount == 0)
+		return;
+
+	Occluder occluder{};
+	occluder.positions.reserve(verticesCount);
+
+	for (size_t vertexId = 0; vertexId < verticesCount; vertexId++)
+		occluder.positions.push_back(*(reinterpret_cast<const float3*>(reinterpret_cast<const uint8_t*>(verticesData) + vertexId * vertexStride)));
+
+	const uint32_t* indices = reinterpret_cast<const uint32_t*>(indicesData);
+	occluder.indices.assign(indices, indices + indicesDataSize / sizeof(uint32_t));
+
+	for (auto& index : occluder.indices)
+		if (index >= verticesCount)
+			throw std::exception("OcclusionCuller::AddOccluder: Index out of range");
+
+	occluder.boundingBox = { occluder.positions.front(), occluder.positions.front() };
+
+	for (auto& position : occluder.positions)
+		occluder.boundingBox = ExpandBoundingBox(occluder.boundingBox, { position, position });
+
+	occluders.push_back(std::move(occluder));
+	occludersVersion++;
+}
+
+void Graphics::OcclusionCuller::ClearOccluders()
+{
+	occluders.clear();
+	occludersVersion++;
+}
+
+bool Graphics::OcclusionCuller::HasOccluders() const noexcept
+{
+	return !occluders.empty();
+}
+
+uint64_t Graphics::OcclusionCuller::GetOccludersVersion() const noexcept
+{
+	return occludersVersion;
+}
+
+void Graphics::OcclusionCuller::RasterizeOccluders(const Camera& targetCamera)
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	occlusionStatistics = {};
+
+	viewProjection = targetCamera.GetViewProjection();
+	zNear = targetCamera.GetZNear();
+
+	auto& depthBuffer = depthLevels.front().maxDepth;
+	std::fill(depthBuffer.begin(), depthBuffer.end(), 1.0f);
+
+	const floatN screenScale = XMVectorSet(0.5f * width, -0.5f * height, 1.0f, 1.0f);
+	const floatN screenOffset = XMVectorSet(0.5f * width, 0.5f * height, 0.0f, 0.0f);
+
+	for (auto& occluder : occluders)
+	{
+		if (!targetCamera.BoundingBoxInScope(occluder.boundingBox))
+			continue;
+
+		screenVertices.resize(occluder.positions.size());
+
+		for (size_t vertexId = 0; vertexId < occluder.positions.size(); vertexId++)
+		{
+			floatN clipPosition = XMVector4Transform(XMVectorSetW(XMLoadFloat3(&occluder.positions[vertexId]), 1.0f), viewProjection);
+			float clipW = XMVectorGetW(clipPosition);
+
+			if (clipW < zNear)
+			{
+				screenVertices[vertexId] = { 0.0f, 0.0f, 0.0f, -1.0f };
+
+				continue;
+			}
+
+			floatN screenPosition = XMVectorMultiplyAdd(XMVectorDivide(clipPosition, XMVectorReplicate(clipW)), screenScale, screenOffset);
+			XMStoreFloat4(&screenVertices[vertexId], XMVectorSetW(screenPosition, clipW));
+		}
+
+		for (size_t indexId = 0; indexId < occluder.indices.size(); indexId += 3)
+		{
+			const float4& vertex0 = screenVertices[occluder.indices[indexId]];
+			const float4& vertex1 = screenVertices[occluder.indices[indexId + 1]];
+			const float4& vertex2 = screenVertices[occluder.indices[indexId + 2]];
+
+			if (vertex0.w < 0.0f || vertex1.w < 0.0f || vertex2.w < 0.0f)
+				continue;
+
+			RasterizeTriangle(vertex0, vertex1, vertex2);
+		}
+
+		occlusionStatistics.occludersRasterized++;
+	}
+
+	BuildDepthHierarchy();
+
+	occlusionStatistics.rasterizationTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void Graphics::OcclusionCuller::FilterVisibleObjects(ObjectPtrPool& visibleObjectsList, ObjectPtrPool& visibleTransparentObjectsList, ObjectPtrPool& visibleEffectObjectsList)
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	FilterObjects(visibleObjectsList);
+	FilterObjects(visibleTransparentObjectsList);
+	FilterObjects(visibleEffectObjectsList);
+
+	occlusionStatistics.testingTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+bool Graphics::OcclusionCuller::IsOccluded(const BoundingBox& boundingBox) const
+{
+	std::array<floatN, 8> boundingBoxVertices;
+	BoundingBoxVertices(boundingBox, boundingBoxVertices);
+
+	float3 screenMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float3 screenMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	for (auto& vertex : boundingBoxVertices)
+	{
+		floatN clipPosition = XMVector4Transform(XMVectorSetW(vertex, 1.0f), viewProjection);
+		float clipW = XMVectorGetW(clipPosition);
+
+		if (clipW < zNear)
+			return false;
+
+		float screenX = (XMVectorGetX(clipPosition) / clipW * 0.5f + 0.5f) * width;
+		float screenY = (0.5f - XMVectorGetY(clipPosition) / clipW * 0.5f) * height;
+		float depth = XMVectorGetZ(clipPosition) / clipW;
+
+		screenMin = { (std::min)(screenMin.x, screenX), (std::min)(screenMin.y, screenY), (std::min)(screenMin.z, depth) };
+		screenMax = { (std::max)(screenMax.x, screenX), (std::max)(screenMax.y, screenY), (std::max)(screenMax.z, depth) };
+	}
+
+	if (screenMax.x < 0.0f || screenMax.y < 0.0f || screenMin.x >= static_cast<float>(width) || screenMin.y >= static_cast<float>(height))
+		return false;
+
+	if (screenMin.z <= depthLevels.back().minDepth.front())
+		return false;
+
+	uint32_t minX = static_cast<uint32_t>((std::max)(screenMin.x, 0.0f));
+	uint32_t minY = static_cast<uint32_t>((std::max)(screenMin.y, 0.0f));
+	uint32_t maxX = (std::min)(static_cast<uint32_t>(screenMax.x), width - 1);
+	uint32_t maxY = (std::min)(static_cast<uint32_t>(screenMax.y), height - 1);
+
+	uint32_t levelId = 0;
+
+	while (levelId + 1 < depthLevels.size() &&
+		((maxX >> levelId) - (minX >> levelId) + 1 > MAX_TEXELS_PER_AXIS || (maxY >> levelId) - (minY >> levelId) + 1 > MAX_TEXELS_PER_AXIS))
+		levelId++;
+
+	const DepthLevel& depthLevel = depthLevels[levelId];
+
+	for (uint32_t texelY = minY >> levelId; texelY <= maxY >> levelId; texelY++)
+		for (uint32_t texelX = minX >> levelId; texelX <= maxX >> levelId; texelX++)
+			if (screenMin.z <= depthLevel.maxDepth[static_cast<size_t>(texelY) * depthLevel.width + texelX])
+				return false;
+
+	return true;
+}
+
+const Graphics::OcclusionStatistics& Graphics::OcclusionCuller::GetOcclusionStatistics() const noexcept
+{
+	return occlusionStatistics;
+}
+
+void Graphics::OcclusionCuller::RasterizeTriangle(const float4& vertex0, const float4& vertex1, const float4& vertex2)
+{
+	float area = (vertex1.x - vertex0.x) * (vertex2.y - vertex0.y) - (vertex1.y - vertex0.y) * (vertex2.x - vertex0.x);
+
+	if (std::abs(area) < FLT_EPSILON)
+		return;
+
+	const float4& v0 = vertex0;
+	const float4& v1 = area > 0.0f ? vertex1 : vertex2;
+	const float4& v2 = area > 0.0f ? vertex2 : vertex1;
+	area = std::abs(area);
+
+	int32_t minX = (std::max)(static_cast<int32_t>(std::floor((std::min)({ v0.x, v1.x, v2.x }))), 0);
+	int32_t minY = (std::max)(static_cast<int32_t>(std::floor((std::min)({ v0.y, v1.y, v2.y }))), 0);
+	int32_t maxX = (std::min)(static_cast<int32_t>(std::ceil((std::max)({ v0.x, v1.x, v2.x }))), static_cast<int32_t>(width) - 1);
+	int32_t maxY = (std::min)(static_cast<int32_t>(std::ceil((std::max)({ v0.y, v1.y, v2.y }))), static_cast<int32_t>(height) - 1);
+
+	if (minX > maxX || minY > maxY)
+		return;
+
+	minX &= ~3;
+
+	float edgeA0 = v1.y - v2.y, edgeB0 = v2.x - v1.x, edgeC0 = -(edgeA0 * v1.x + edgeB0 * v1.y);
+	float edgeA1 = v2.y - v0.y, edgeB1 = v0.x - v2.x, edgeC1 = -(edgeA1 * v2.x + edgeB1 * v2.y);
+	float edgeA2 = v0.y - v1.y, edgeB2 = v1.x - v0.x, edgeC2 = -(edgeA2 * v0.x + edgeB2 * v0.y);
+
+	float depthA = (v0.z * edgeA0 + v1.z * edgeA1 + v2.z * edgeA2) / area;
+	float depthB = (v0.z * edgeB0 + v1.z * edgeB1 + v2.z * edgeB2) / area;
+	float depthC = (v0.z * edgeC0 + v1.z * edgeC1 + v2.z * edgeC2) / area;
+
+	const floatN pixelOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+	const floatN zero = XMVectorZero();
+
+	const floatN edgeStep0 = XMVectorReplicate(edgeA0);
+	const floatN edgeStep1 = XMVectorReplicate(edgeA1);
+	const floatN edgeStep2 = XMVectorReplicate(edgeA2);
+	const floatN depthStep = XMVectorReplicate(depthA);
+
+	auto& depthBuffer = depthLevels.front().maxDepth;
+
+	for (int32_t y = minY; y <= maxY; y++)
+	{
+		float pixelY = static_cast<float>(y) + 0.5f;
+
+		floatN rowEdge0 = XMVectorReplicate(edgeB0 * pixelY + edgeC0);
+		floatN rowEdge1 = XMVectorReplicate(edgeB1 * pixelY + edgeC1);
+		floatN rowEdge2 = XMVectorReplicate(edgeB2 * pixelY + edgeC2);
+		floatN rowDepth = XMVectorReplicate(depthB * pixelY + depthC);
+
+		for (int32_t x = minX; x <= maxX; x += 4)
+		{
+			floatN pixelX = XMVectorAdd(XMVectorReplicate(static_cast<float>(x)), pixelOffsets);
+
+			floatN edge0 = XMVectorMultiplyAdd(edgeStep0, pixelX, rowEdge0);
+			floatN edge1 = XMVectorMultiplyAdd(edgeStep1, pixelX, rowEdge1);
+			floatN edge2 = XMVectorMultiplyAdd(edgeStep2, pixelX, rowEdge2);
+
+			floatN insideMask = XMVectorAndInt(XMVectorAndInt(XMVectorGreaterOrEqual(edge0, zero), XMVectorGreaterOrEqual(edge1, zero)),
+				XMVectorGreaterOrEqual(edge2, zero));
+
+			if (XMVector4EqualInt(insideMask, zero))
+				continue;
+
+			float4* texels = reinterpret_cast<float4*>(&depthBuffer[static_cast<size_t>(y) * width + x]);
+
+			floatN currentDepth = XMLoadFloat4(texels);
+			floatN triangleDepth = XMVectorMultiplyAdd(depthStep, pixelX, rowDepth);
+
+			XMStoreFloat4(texels, XMVectorSelect(currentDepth, XMVectorMin(currentDepth, triangleDepth), insideMask));
+		}
+	}
+
+	occlusionStatistics.trianglesRasterized++;
+}
+
+void Graphics::OcclusionCuller::BuildDepthHierarchy()
+{
+	for (size_t levelId = 1; levelId < depthLevels.size(); levelId++)
+	{
+		const DepthLevel& sourceLevel = depthLevels[levelId - 1];
+		DepthLevel& targetLevel = depthLevels[levelId];
+
+		const auto& sourceMinDepth = levelId == 1 ? sourceLevel.maxDepth : sourceLevel.minDepth;
+
+		for (uint32_t y = 0; y < targetLevel.height; y++)
+		{
+			size_t sourceRow0 = static_cast<size_t>(2 * y) * sourceLevel.width;
+			size_t sourceRow1 = static_cast<size_t>((std::min)(2 * y + 1, sourceLevel.height - 1)) * sourceLevel.width;
+
+			for (uint32_t x = 0; x < targetLevel.width; x++)
+			{
+				uint32_t sourceX0 = 2 * x;
+				uint32_t sourceX1 = (std::min)(2 * x + 1, sourceLevel.width - 1);
+
+				size_t targetTexelId = static_cast<size_t>(y) * targetLevel.width + x;
+
+				targetLevel.minDepth[targetTexelId] = (std::min)({ sourceMinDepth[sourceRow0 + sourceX0], sourceMinDepth[sourceRow0 + sourceX1],
+					sourceMinDepth[sourceRow1 + sourceX0], sourceMinDepth[sourceRow1 + sourceX1] });
+				targetLevel.maxDepth[targetTexelId] = (std::max)({ sourceLevel.maxDepth[sourceRow0 + sourceX0], sourceLevel.maxDepth[sourceRow0 + sourceX1],
+					sourceLevel.maxDepth[sourceRow1 + sourceX0], sourceLevel.maxDepth[sourceRow1 + sourceX1] });
+			}
+		}
+	}
+}
+
+void Graphics::OcclusionCuller::FilterObjects(ObjectPtrPool& objectsList)
+{
+	auto occludedObjectsBegin = std::remove_if(objectsList.begin(), objectsList.end(),
+		[this](const GraphicObject* object) { return IsOccluded(object->GetBoundingBox()); });
+
+	occlusionStatistics.objectsTested += objectsList.size();
+	occlusionStatistics.objectsOccluded += std::distance(occludedObjectsBegin, objectsList.end());
+
+	objectsList.erase(occludedObjectsBegin, objectsList.end());
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "ISpatialIndex.h"
+
+namespace Graphics
+{
+	struct OcclusionStatistics
+	{
+		size_t occludersRasterized;
+		size_t trianglesRasterized;
+		size_t objectsTested;
+		size_t objectsOccluded;
+		float rasterizationTime;
+		float testingTime;
+	};
+
+	class OcclusionCuller
+	{
+	public:
+		OcclusionCuller(uint32_t _width = 256, uint32_t _height = 128);
+		~OcclusionCuller();
+
+		void AddOccluder(const void* verticesData, size_t verticesDataSize, VertexFormat vertexFormat, const void* indicesData, size_t indicesDataSize);
+		void ClearOccluders();
+
+		bool HasOccluders() const noexcept;
+		uint64_t GetOccludersVersion() const noexcept;
+
+		void RasterizeOccluders(const Camera& targetCamera);
+		void FilterVisibleObjects(ObjectPtrPool& visibleObjectsList, ObjectPtrPool& visibleTransparentObjectsList, ObjectPtrPool& visibleEffectObjectsList);
+
+		bool IsOccluded(const BoundingBox& boundingBox) const;
+
+		const OcclusionStatistics& GetOcclusionStatistics() const noexcept;
+
+	private:
+		OcclusionCuller(const OcclusionCuller&) = delete;
+		OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+		static constexpr uint32_t MAX_TEXELS_PER_AXIS = 4;
+
+		struct Occluder
+		{
+			std::vector<float3> positions;
+			std::vector<uint32_t> indices;
+			BoundingBox boundingBox;
+		};
+
+		struct DepthLevel
+		{
+			uint32_t width;
+			uint32_t height;
+			std::vector<float> minDepth;
+			std::vector<float> maxDepth;
+		};
+
+		void RasterizeTriangle(const float4& vertex0, const float4& vertex1, const float4& vertex2);
+		void BuildDepthHierarchy();
+		void FilterObjects(ObjectPtrPool& objectsList);
+
+		uint32_t width;
+		uint32_t height;
+
+		std::vector<Occluder> occluders;
+		uint64_t occludersVersion;
+
+		std::vector<DepthLevel> depthLevels;
+		std::vector<float4> screenVertices;
+
+		float4x4 viewProjection;
+		float zNear;
+
+		OcclusionStatistics occlusionStatistics;
+	};
+}
@@ -1,9 +1,13 @@
 #include "Octree.h"
 
 Graphics::Octree::Octree(uint32_t _depth, BoundingBox rootBoundingBox)
-	: depth(_depth)
+	: depth(_depth), isTemporalCoherenceEnabled(true), cullingStatistics{}, rayQueryStatistics{}, rangeQueryStatistics{}
 {
+	packetRayStacks.resize(static_cast<size_t>(depth) + 1);
+	rangeSphereStacks.resize(static_cast<size_t>(depth) + 1);
+
 	root.boundingBox = rootBoundingBox;
+	root.lastRejectingPlane = 0;
 	CreateNodeChain(depth, &root);
 }
 
@@ -28,29 +32,230 @@ void Graphics::Octree::AddObject(const GraphicObject* newObject, bool isDynamic)
 	PushObjectToNode(&root, newObject, isDynamic);
 }
 
+void Graphics::Octree::UpdateObjects(const ObjectPtrPool& movedObjects)
+{
+	for (auto& movedObject : movedObjects)
+	{
+		auto objectNodeIt = objectNodes.find(movedObject);
+
+		if (objectNodeIt == objectNodes.end())
+			continue;
+
+		Node* node = objectNodeIt->second;
+		objectNodes.erase(objectNodeIt);
+
+		if (RemoveObject(node->dynamicObjects, movedObject))
+			AddObject(movedObject, true);
+		else if (RemoveObject(node->objects, movedObject))
+			AddObject(movedObject, false);
+	}
+}
+
 void Graphics::Octree::PrepareVisibleObjectsList(const Camera& targetCamera, ObjectPtrPool& visibleObjectsList,
 	ObjectPtrPool& visibleTransparentObjectsList, ObjectPtrPool& visibleEffectObjectsList)
 {
-	for (auto& currentObject : root.objects)
-		if (targetCamera.BoundingBoxInScope(currentObject->GetBoundingBox()))
-			if (currentObject->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_OPAQUE)
-				visibleObjectsList.push_back(currentObject);
-			else if (currentObject->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_TRANSPARENT)
-				visibleTransparentObjectsList.push_back(currentObject);
-			else
-				visibleEffectObjectsList.push_back(currentObject);
-
-	for (auto& currentObject : root.dynamicObjects)
-		if (targetCamera.BoundingBoxInScope(currentObject->GetBoundingBox()))
-			if (currentObject->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_OPAQUE)
-				visibleObjectsList.push_back(currentObject);
-			else if (currentObject->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_TRANSPARENT)
-				visibleTransparentObjectsList.push_back(currentObject);
-			else
-				visibleEffectObjectsList.push_back(currentObject);
+	cullingStatistics = {};
+
+	PrepareVisibleObjectsList(root.objects, targetCamera, Camera::FRUSTUM_ALL_PLANES_MASK, visibleObjectsList, visibleTransparentObjectsList,
+		visibleEffectObjectsList);
+	PrepareVisibleObjectsList(root.dynamicObjects, targetCamera, Camera::FRUSTUM_ALL_PLANES_MASK, visibleObjectsList, visibleTransparentObjectsList,
+		visibleEffectObjectsList);
+
+	for (auto& nextNode : root.nextNodes)
+		PrepareVisibleObjectsList(nextNode.get(), targetCamera, Camera::FRUSTUM_ALL_PLANES_MASK, visibleObjectsList, visibleTransparentObjectsList,
+			visibleEffectObjectsList);
+}
+
+void Graphics::Octree::PrepareVisibleObjectsLists(const std::vector<const Camera*>& cameras, std::vector<VisibleObjectsLists>& visibleObjectsLists)
+{
+	if (cameras.size() > MAX_VIEWS_COUNT)
+		throw std::exception("Octree::PrepareVisibleObjectsLists: Too many views");
+
+	multiViewCullingStatistics = {};
+
+	visibleObjectsLists.resize(cameras.size());
+
+	for (auto& viewObjectsLists : visibleObjectsLists)
+	{
+		viewObjectsLists.visibleObjectsList.clear();
+		viewObjectsLists.visibleTransparentObjectsList.clear();
+		viewObjectsLists.visibleEffectObjectsList.clear();
+	}
+
+	if (cameras.empty())
+		return;
+
+	uint32_t viewMask = (1U << cameras.size()) - 1;
+
+	ViewPlaneMasks planeMasks;
+	planeMasks.fill(Camera::FRUSTUM_ALL_PLANES_MASK);
+
+	PrepareVisibleObjectsLists(root.objects, cameras, viewMask, planeMasks, visibleObjectsLists);
+	PrepareVisibleObjectsLists(root.dynamicObjects, cameras, viewMask, planeMasks, visibleObjectsLists);
 
 	for (auto& nextNode : root.nextNodes)
-		PrepareVisibleObjectsList(nextNode.get(), targetCamera, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+		PrepareVisibleObjectsLists(nextNode.get(), cameras, viewMask, planeMasks, visibleObjectsLists);
+}
+
+const Graphics::CullingStatistics& Graphics::Octree::GetCullingStatistics() const noexcept
+{
+	return cullingStatistics;
+}
+
+void Graphics::Octree::SetTemporalCoherence(bool isEnabled) noexcept
+{
+	isTemporalCoherenceEnabled = isEnabled;
+}
+
+bool Graphics::Octree::RaycastNearest(const Ray& ray, RayHit& result)
+{
+	RayQuery rayQuery;
+
+	if (!MakeRayQuery(ray, rayQuery))
+		return false;
+
+	rayQueryStatistics.raysCast++;
+
+	RayHit nearestHit = { nullptr, rayQuery.maxDistance };
+	CastRay(&root, rayQuery, nearestHit, nullptr);
+
+	if (nearestHit.object == nullptr)
+		return false;
+
+	rayQueryStatistics.hits++;
+	result = nearestHit;
+
+	return true;
+}
+
+void Graphics::Octree::RaycastAll(const Ray& ray, std::vector<RayHit>& results)
+{
+	results.clear();
+
+	RayQuery rayQuery;
+
+	if (!MakeRayQuery(ray, rayQuery))
+		return;
+
+	rayQueryStatistics.raysCast++;
+
+	RayHit nearestHit = { nullptr, rayQuery.maxDistance };
+	CastRay(&root, rayQuery, nearestHit, &results);
+
+	std::sort(results.begin(), results.end(), [](const RayHit& leftHit, const RayHit& rightHit) { return leftHit.distance < rightHit.distance; });
+
+	rayQueryStatistics.hits += results.size();
+}
+
+bool Graphics::Octree::SegmentNearest(const float3& startPoint, const float3& endPoint, RayHit& result)
+{
+	Ray ray;
+
+	if (!MakeSegmentRay(startPoint, endPoint, ray))
+		return false;
+
+	return RaycastNearest(ray, result);
+}
+
+void Graphics::Octree::SegmentAll(const float3& startPoint, const float3& endPoint, std::vector<RayHit>& results)
+{
+	Ray ray;
+
+	if (!MakeSegmentRay(startPoint, endPoint, ray))
+	{
+		results.clear();
+
+		return;
+	}
+
+	RaycastAll(ray, results);
+}
+
+void Graphics::Octree::RaycastPacket(const std::vector<Ray>& rays, std::vector<RayHit>& results)
+{
+	results.resize(rays.size());
+	packetRayQueries.resize(rays.size());
+	packetRootRays.clear();
+
+	for (uint32_t rayId = 0; rayId < rays.size(); rayId++)
+	{
+		results[rayId] = { nullptr, rays[rayId].maxDistance };
+
+		if (MakeRayQuery(rays[rayId], packetRayQueries[rayId]))
+			packetRootRays.push_back({ rayId, 0.0f });
+	}
+
+	rayQueryStatistics.raysCast += packetRootRays.size();
+
+	CastRayPacket(&root, 0, packetRootRays, results);
+
+	for (auto& result : results)
+		if (result.object != nullptr)
+			rayQueryStatistics.hits++;
+}
+
+const Graphics::RayQueryStatistics& Graphics::Octree::GetRayQueryStatistics() const noexcept
+{
+	return rayQueryStatistics;
+}
+
+void Graphics::Octree::ResetRayQueryStatistics() noexcept
+{
+	rayQueryStatistics = {};
+}
+
+size_t Graphics::Octree::QuerySphere(const BoundingSphere& sphere, const GraphicObject** results, size_t resultsCapacity)
+{
+	size_t resultsCount = 0;
+
+	rangeQueryStatistics.queries++;
+
+	QueryRange(&root, [&sphere](const BoundingBox& boundingBox) { return CheckSphereIntersectsBox(sphere, boundingBox); }, results, resultsCapacity,
+		resultsCount);
+
+	rangeQueryStatistics.overlaps += resultsCount;
+
+	return resultsCount;
+}
+
+size_t Graphics::Octree::QueryBoundingBox(const BoundingBox& boundingBox, const GraphicObject** results, size_t resultsCapacity)
+{
+	size_t resultsCount = 0;
+
+	rangeQueryStatistics.queries++;
+
+	QueryRange(&root, [&boundingBox](const BoundingBox& testedBoundingBox) { return CheckBoxIntersectsBox(boundingBox, testedBoundingBox); }, results,
+		resultsCapacity, resultsCount);
+
+	rangeQueryStatistics.overlaps += resultsCount;
+
+	return resultsCount;
+}
+
+size_t Graphics::Octree::QuerySpheres(const BoundingSphere* spheres, size_t spheresCount, ObjectOverlap* results, size_t resultsCapacity)
+{
+	size_t resultsCount = 0;
+
+	rangeRootSpheres.resize(spheresCount);
+	std::iota(rangeRootSpheres.begin(), rangeRootSpheres.end(), 0);
+
+	rangeQueryStatistics.queries += spheresCount;
+
+	QuerySpheres(&root, 0, rangeRootSpheres, spheres, results, resultsCapacity, resultsCount);
+
+	rangeQueryStatistics.overlaps += resultsCount;
+
+	return resultsCount;
+}
+
+const Graphics::RangeQueryStatistics& Graphics::Octree::GetRangeQueryStatistics() const noexcept
+{
+	return rangeQueryStatistics;
+}
+
+void Graphics::Octree::ResetRangeQueryStatistics() noexcept
+{
+	rangeQueryStatistics = {};
 }
 
 void Graphics::Octree::CreateNodeChain(uint32_t currentDepth, Node* currentNode)
@@ -68,6 +273,7 @@ void Graphics::Octree::CreateNodeChain(uint32_t currentDepth, Node* currentNode)
 	{
 		currentNode->nextNodes[nextNodeId] = std::make_shared<Node>();
 		currentNode->nextNodes[nextNodeId]->boundingBox = boundingBoxes[nextNodeId];
+		currentNode->nextNodes[nextNodeId]->lastRejectingPlane = 0;
 
 		CreateNodeChain(currentDepth - 1, currentNode->nextNodes[nextNodeId].get());
 	}
@@ -97,7 +303,11 @@ void Graphics::Octree::SplitBoundingBox(const BoundingBox& boundingBox, std::arr
 void Graphics::Octree::AddObject(Node* currentNode, const GraphicObject* newObject, bool isDynamic)
 {
 	if (currentNode->nextNodes[0] == nullptr)
+	{
+		PushObjectToNode(currentNode, newObject, isDynamic);
+
 		return;
+	}
 
 	for (auto& nextNode : currentNode->nextNodes)
 		if (CheckBoxInBox(newObject->GetBoundingBox(), nextNode->boundingBox))
@@ -113,35 +323,394 @@ void Graphics::Octree::AddObject(Node* currentNode, const GraphicObject* newObje
 void Graphics::Octree::PushObjectToNode(Node* node, const GraphicObject* newObject, bool isDynamic)
 {
 	if (isDynamic)
-		node->dynamicObjects.push_back(newObject);
+		node->dynamicObjects.push_back({ newObject, 0 });
 	else
-		node->objects.push_back(newObject);
+		node->objects.push_back({ newObject, 0 });
+
+	objectNodes[newObject] = node;
 }
 
-void Graphics::Octree::PrepareVisibleObjectsList(const Node* currentNode, const Camera& targetCamera, ObjectPtrPool& visibleObjectsList,
+void Graphics::Octree::PrepareVisibleObjectsList(Node* currentNode, const Camera& targetCamera, uint32_t planeMask, ObjectPtrPool& visibleObjectsList,
 	ObjectPtrPool& visibleTransparentObjectsList, ObjectPtrPool& visibleEffectObjectsList)
 {
 	if (currentNode == nullptr)
 		return;
 
-	for (auto& currentObject : currentNode->objects)
-		if (targetCamera.BoundingBoxInScope(currentObject->GetBoundingBox()))
-			if (currentObject->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_OPAQUE)
-				visibleObjectsList.push_back(currentObject);
-			else if (currentObject->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_TRANSPARENT)
-				visibleTransparentObjectsList.push_back(currentObject);
-			else
-				visibleEffectObjectsList.push_back(currentObject);
-
-	for (auto& currentObject : currentNode->dynamicObjects)
-		if (targetCamera.BoundingBoxInScope(currentObject->GetBoundingBox()))
-			if (currentObject->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_OPAQUE)
-				visibleObjectsList.push_back(currentObject);
-			else if (currentObject->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_TRANSPARENT)
-				visibleTransparentObjectsList.push_back(currentObject);
-			else
-				visibleEffectObjectsList.push_back(currentObject);
+	cullingStatistics.nodesVisited++;
+
+	if (planeMask != 0)
+	{
+		uint32_t lastRejectingPlane = isTemporalCoherenceEnabled ? currentNode->lastRejectingPlane : 0;
+
+		auto intersection = targetCamera.ClassifyBoundingBox(currentNode->boundingBox, planeMask, lastRejectingPlane, cullingStatistics.planeTests);
+
+		if (isTemporalCoherenceEnabled)
+			currentNode->lastRejectingPlane = lastRejectingPlane;
+
+		if (intersection == FrustumIntersection::FRUSTUM_OUTSIDE)
+		{
+			cullingStatistics.nodesCulled++;
+
+			return;
+		}
+	}
+
+	PrepareVisibleObjectsList(currentNode->objects, targetCamera, planeMask, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+	PrepareVisibleObjectsList(currentNode->dynamicObjects, targetCamera, planeMask, visibleObjectsList, visibleTransparentObjectsList,
+		visibleEffectObjectsList);
 
 	for (auto& nextNode : currentNode->nextNodes)
-		PrepareVisibleObjectsList(nextNode.get(), targetCamera, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+		PrepareVisibleObjectsList(nextNode.get(), targetCamera, planeMask, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+}
+
+void Graphics::Octree::PrepareVisibleObjectsList(CulledObjectPool& objects, const Camera& targetCamera, uint32_t planeMask, ObjectPtrPool& visibleObjectsList,
+	ObjectPtrPool& visibleTransparentObjectsList, ObjectPtrPool& visibleEffectObjectsList)
+{
+	for (auto& currentObject : objects)
+	{
+		if (planeMask != 0)
+		{
+			cullingStatistics.objectsTested++;
+
+			uint32_t lastRejectingPlane = isTemporalCoherenceEnabled ? currentObject.lastRejectingPlane : 0;
+			bool isVisible = IsObjectVisible(targetCamera, currentObject.object, planeMask, lastRejectingPlane, cullingStatistics);
+
+			if (isTemporalCoherenceEnabled)
+				currentObject.lastRejectingPlane = lastRejectingPlane;
+
+			if (!isVisible)
+				continue;
+		}
+
+		cullingStatistics.objectsVisible++;
+
+		PushVisibleObject(currentObject.object, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+	}
+}
+
+void Graphics::Octree::PrepareVisibleObjectsLists(Node* currentNode, const std::vector<const Camera*>& cameras, uint32_t viewMask,
+	const ViewPlaneMasks& planeMasks, std::vector<VisibleObjectsLists>& visibleObjectsLists)
+{
+	if (currentNode == nullptr)
+		return;
+
+	multiViewCullingStatistics.nodesVisited++;
+
+	ViewPlaneMasks nodePlaneMasks = planeMasks;
+
+	for (uint32_t viewId = 0; viewId < cameras.size(); viewId++)
+	{
+		if ((viewMask & (1U << viewId)) == 0 || nodePlaneMasks[viewId] == 0)
+			continue;
+
+		uint32_t lastRejectingPlane = currentNode->lastRejectingPlane;
+
+		if (cameras[viewId]->ClassifyBoundingBox(currentNode->boundingBox, nodePlaneMasks[viewId], lastRejectingPlane,
+			multiViewCullingStatistics.planeTests) == FrustumIntersection::FRUSTUM_OUTSIDE)
+			viewMask &= ~(1U << viewId);
+	}
+
+	if (viewMask == 0)
+	{
+		multiViewCullingStatistics.nodesCulled++;
+
+		return;
+	}
+
+	PrepareVisibleObjectsLists(currentNode->objects, cameras, viewMask, nodePlaneMasks, visibleObjectsLists);
+	PrepareVisibleObjectsLists(currentNode->dynamicObjects, cameras, viewMask, nodePlaneMasks, visibleObjectsLists);
+
+	for (auto& nextNode : currentNode->nextNodes)
+		PrepareVisibleObjectsLists(nextNode.get(), cameras, viewMask, nodePlaneMasks, visibleObjectsLists);
+}
+
+void Graphics::Octree::PrepareVisibleObjectsLists(CulledObjectPool& objects, const std::vector<const Camera*>& cameras, uint32_t viewMask,
+	const ViewPlaneMasks& planeMasks, std::vector<VisibleObjectsLists>& visibleObjectsLists)
+{
+	for (auto& currentObject : objects)
+	{
+		multiViewCullingStatistics.objectsTested++;
+
+		for (uint32_t viewId = 0; viewId < cameras.size(); viewId++)
+		{
+			if ((viewMask & (1U << viewId)) == 0)
+				continue;
+
+			uint32_t lastRejectingPlane = currentObject.lastRejectingPlane;
+
+			if (!IsObjectVisible(*cameras[viewId], currentObject.object, planeMasks[viewId], lastRejectingPlane, multiViewCullingStatistics))
+				continue;
+
+			multiViewCullingStatistics.objectsVisible++;
+
+			VisibleObjectsLists& viewObjectsLists = visibleObjectsLists[viewId];
+
+			PushVisibleObject(currentObject.object, viewObjectsLists.visibleObjectsList, viewObjectsLists.visibleTransparentObjectsList,
+				viewObjectsLists.visibleEffectObjectsList);
+		}
+	}
+}
+
+bool Graphics::Octree::RemoveObject(CulledObjectPool& objects, const GraphicObject* object)
+{
+	auto objectIt = std::find_if(objects.begin(), objects.end(), [object](const CulledObject& culledObject) { return culledObject.object == object; });
+
+	if (objectIt == objects.end())
+		return false;
+
+	*objectIt = objects.back();
+	objects.pop_back();
+
+	return true;
+}
+
+bool Graphics::Octree::MakeRayQuery(const Ray& ray, RayQuery& rayQuery)
+{
+	floatN direction = XMLoadFloat3(&ray.direction);
+
+	if (XMVector3Equal(direction, XMVectorZero()))
+		return false;
+
+	rayQuery.origin = XMLoadFloat3(&ray.origin);
+	rayQuery.inverseDirection = XMVectorReciprocal(XMVector3Normalize(direction));
+	rayQuery.maxDistance = ray.maxDistance;
+
+	return true;
+}
+
+bool Graphics::Octree::MakeSegmentRay(const float3& startPoint, const float3& endPoint, Ray& ray)
+{
+	floatN direction = XMLoadFloat3(&endPoint) - XMLoadFloat3(&startPoint);
+	float length = XMVectorGetX(XMVector3Length(direction));
+
+	if (length == 0.0f)
+		return false;
+
+	ray.origin = startPoint;
+	XMStoreFloat3(&ray.direction, direction / length);
+	ray.maxDistance = length;
+
+	return true;
+}
+
+void Graphics::Octree::CastRay(const Node* currentNode, const RayQuery& rayQuery, RayHit& nearestHit, std::vector<RayHit>* hits)
+{
+	rayQueryStatistics.nodesVisited++;
+
+	CastRay(currentNode->objects, rayQuery, nearestHit, hits);
+	CastRay(currentNode->dynamicObjects, rayQuery, nearestHit, hits);
+
+	if (currentNode->nextNodes[0] == nullptr)
+		return;
+
+	std::array<std::pair<float, const Node*>, 8> orderedNodes;
+	uint32_t orderedNodesCount = 0;
+
+	for (auto& nextNode : currentNode->nextNodes)
+	{
+		float entryDistance;
+
+		rayQueryStatistics.boundingBoxTests++;
+
+		if (IntersectRayBoundingBox(rayQuery.origin, rayQuery.inverseDirection, nextNode->boundingBox, hits ? rayQuery.maxDistance : nearestHit.distance,
+			entryDistance))
+			orderedNodes[orderedNodesCount++] = { entryDistance, nextNode.get() };
+	}
+
+	std::sort(orderedNodes.begin(), orderedNodes.begin() + orderedNodesCount,
+		[](const std::pair<float, const Node*>& leftNode, const std::pair<float, const Node*>& rightNode) { return leftNode.first < rightNode.first; });
+
+	for (uint32_t orderedNodeId = 0; orderedNodeId < orderedNodesCount; orderedNodeId++)
+	{
+		if (hits == nullptr && orderedNodes[orderedNodeId].first > nearestHit.distance)
+			break;
+
+		CastRay(orderedNodes[orderedNodeId].second, rayQuery, nearestHit, hits);
+	}
+}
+
+void Graphics::Octree::CastRay(const CulledObjectPool& objects, const RayQuery& rayQuery, RayHit& nearestHit, std::vector<RayHit>* hits)
+{
+	for (auto& currentObject : objects)
+	{
+		float entryDistance;
+
+		rayQueryStatistics.boundingBoxTests++;
+
+		if (!IntersectRayBoundingBox(rayQuery.origin, rayQuery.inverseDirection, currentObject.object->GetBoundingBox(),
+			hits ? rayQuery.maxDistance : nearestHit.distance, entryDistance))
+			continue;
+
+		if (hits != nullptr)
+			hits->push_back({ currentObject.object, entryDistance });
+		else
+			nearestHit = { currentObject.object, entryDistance };
+	}
+}
+
+void Graphics::Octree::CastRayPacket(const Node* currentNode, uint32_t currentDepth, PacketRayPool& activeRays, std::vector<RayHit>& results)
+{
+	activeRays.erase(std::remove_if(activeRays.begin(), activeRays.end(),
+		[&results](const PacketRayEntry& rayEntry) { return rayEntry.entryDistance > results[rayEntry.rayId].distance; }), activeRays.end());
+
+	if (activeRays.empty())
+		return;
+
+	rayQueryStatistics.nodesVisited++;
+
+	CastRayPacket(currentNode->objects, activeRays, results);
+	CastRayPacket(currentNode->dynamicObjects, activeRays, results);
+
+	if (currentNode->nextNodes[0] == nullptr)
+		return;
+
+	auto& nextNodesRays = packetRayStacks[currentDepth];
+
+	std::array<std::pair<float, uint32_t>, 8> orderedNodes;
+	uint32_t orderedNodesCount = 0;
+
+	for (uint32_t nextNodeId = 0; nextNodeId < currentNode->nextNodes.size(); nextNodeId++)
+	{
+		const BoundingBox& nextNodeBoundingBox = currentNode->nextNodes[nextNodeId]->boundingBox;
+
+		auto& nextNodeRays = nextNodesRays[nextNodeId];
+		nextNodeRays.clear();
+
+		float nearestEntryDistance = FLT_MAX;
+
+		for (auto& rayEntry : activeRays)
+		{
+			const RayQuery& rayQuery = packetRayQueries[rayEntry.rayId];
+			float entryDistance;
+
+			rayQueryStatistics.boundingBoxTests++;
+
+			if (!IntersectRayBoundingBox(rayQuery.origin, rayQuery.inverseDirection, nextNodeBoundingBox, results[rayEntry.rayId].distance, entryDistance))
+				continue;
+
+			nextNodeRays.push_back({ rayEntry.rayId, entryDistance });
+			nearestEntryDistance = (std::min)(nearestEntryDistance, entryDistance);
+		}
+
+		if (!nextNodeRays.empty())
+			orderedNodes[orderedNodesCount++] = { nearestEntryDistance, nextNodeId };
+	}
+
+	std::sort(orderedNodes.begin(), orderedNodes.begin() + orderedNodesCount,
+		[](const std::pair<float, uint32_t>& leftNode, const std::pair<float, uint32_t>& rightNode) { return leftNode.first < rightNode.first; });
+
+	for (uint32_t orderedNodeId = 0; orderedNodeId < orderedNodesCount; orderedNodeId++)
+	{
+		uint32_t nextNodeId = orderedNodes[orderedNodeId].second;
+
+		CastRayPacket(currentNode->nextNodes[nextNodeId].get(), currentDepth + 1, nextNodesRays[nextNodeId], results);
+	}
+}
+
+void Graphics::Octree::CastRayPacket(const CulledObjectPool& objects, const PacketRayPool& activeRays, std::vector<RayHit>& results)
+{
+	for (auto& currentObject : objects)
+		for (auto& rayEntry : activeRays)
+		{
+			const RayQuery& rayQuery = packetRayQueries[rayEntry.rayId];
+			RayHit& nearestHit = results[rayEntry.rayId];
+			float entryDistance;
+
+			rayQueryStatistics.boundingBoxTests++;
+
+			if (IntersectRayBoundingBox(rayQuery.origin, rayQuery.inverseDirection, currentObject.object->GetBoundingBox(), nearestHit.distance,
+				entryDistance))
+				nearestHit = { currentObject.object, entryDistance };
+		}
+}
+
+template<typename OverlapTest>
+void Graphics::Octree::QueryRange(const Node* currentNode, const OverlapTest& overlapTest, const GraphicObject** results, size_t resultsCapacity,
+	size_t& resultsCount)
+{
+	rangeQueryStatistics.nodesVisited++;
+
+	QueryRange(currentNode->objects, overlapTest, results, resultsCapacity, resultsCount);
+	QueryRange(currentNode->dynamicObjects, overlapTest, results, resultsCapacity, resultsCount);
+
+	if (currentNode->nextNodes[0] == nullptr)
+		return;
+
+	for (auto& nextNode : currentNode->nextNodes)
+	{
+		rangeQueryStatistics.overlapTests++;
+
+		if (overlapTest(nextNode->boundingBox))
+			QueryRange(nextNode.get(), overlapTest, results, resultsCapacity, resultsCount);
+	}
+}
+
+template<typename OverlapTest>
+void Graphics::Octree::QueryRange(const CulledObjectPool& objects, const OverlapTest& overlapTest, const GraphicObject** results, size_t resultsCapacity,
+	size_t& resultsCount)
+{
+	for (auto& currentObject : objects)
+	{
+		rangeQueryStatistics.overlapTests++;
+
+		if (!overlapTest(currentObject.object->GetBoundingBox()))
+			continue;
+
+		if (resultsCount < resultsCapacity)
+			results[resultsCount] = currentObject.object;
+
+		resultsCount++;
+	}
+}
+
+void Graphics::Octree::QuerySpheres(const Node* currentNode, uint32_t currentDepth, const std::vector<uint32_t>& activeSpheres, const BoundingSphere* spheres,
+	ObjectOverlap* results, size_t resultsCapacity, size_t& resultsCount)
+{
+	rangeQueryStatistics.nodesVisited++;
+
+	QuerySpheres(currentNode->objects, activeSpheres, spheres, results, resultsCapacity, resultsCount);
+	QuerySpheres(currentNode->dynamicObjects, activeSpheres, spheres, results, resultsCapacity, resultsCount);
+
+	if (currentNode->nextNodes[0] == nullptr)
+		return;
+
+	auto& nextNodeSpheres = rangeSphereStacks[currentDepth];
+
+	for (auto& nextNode : currentNode->nextNodes)
+	{
+		nextNodeSpheres.clear();
+
+		for (auto& sphereId : activeSpheres)
+		{
+			rangeQueryStatistics.overlapTests++;
+
+			if (CheckSphereIntersectsBox(spheres[sphereId], nextNode->boundingBox))
+				nextNodeSpheres.push_back(sphereId);
+		}
+
+		if (!nextNodeSpheres.empty())
+			QuerySpheres(nextNode.get(), currentDepth + 1, nextNodeSpheres, spheres, results, resultsCapacity, resultsCount);
+	}
+}
+
+void Graphics::Octree::QuerySpheres(const CulledObjectPool& objects, const std::vector<uint32_t>& activeSpheres, const BoundingSphere* spheres,
+	ObjectOverlap* results, size_t resultsCapacity, size_t& resultsCount)
+{
+	for (auto& currentObject : objects)
+	{
+		const BoundingBox& objectBoundingBox = currentObject.object->GetBoundingBox();
+
+		for (auto& sphereId : activeSpheres)
+		{
+			rangeQueryStatistics.overlapTests++;
+
+			if (!CheckSphereIntersectsBox(spheres[sphereId], objectBoundingBox))
+				continue;
+
+			if (resultsCount < resultsCapacity)
+				results[resultsCount] = { sphereId, currentObject.object };
+
+			resultsCount++;
+		}
+	}
 }
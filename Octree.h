@@ -1,45 +1,136 @@
 #pragma once
 
-#include "GraphicObject.h"
-#include "Camera.h"
+#include "ISpatialIndex.h"
 
 namespace Graphics
 {
-	using ObjectPtrPool = std::vector<const GraphicObject*>;
-
-	struct Octree
+	struct Octree final : public ISpatialIndex
 	{
 	public:
 		Octree(uint32_t _depth, BoundingBox rootBoundingBox);
 		~Octree();
 
-		void AddObject(const GraphicObject* newObject, bool isDynamic);
+		void AddObject(const GraphicObject* newObject, bool isDynamic) override;
+		void UpdateObjects(const ObjectPtrPool& movedObjects) override;
+
 		void PrepareVisibleObjectsList(const Camera& targetCamera, ObjectPtrPool& visibleObjectsList, ObjectPtrPool& visibleTransparentObjectsList,
-			ObjectPtrPool& visibleEffectObjectsList);
-		
+			ObjectPtrPool& visibleEffectObjectsList) override;
+
+		void PrepareVisibleObjectsLists(const std::vector<const Camera*>& cameras, std::vector<VisibleObjectsLists>& visibleObjectsLists) override;
+
+		const CullingStatistics& GetCullingStatistics() const noexcept override;
+
+		void SetTemporalCoherence(bool isEnabled) noexcept;
+
+		bool RaycastNearest(const Ray& ray, RayHit& result);
+		void RaycastAll(const Ray& ray, std::vector<RayHit>& results);
+		bool SegmentNearest(const float3& startPoint, const float3& endPoint, RayHit& result);
+		void SegmentAll(const float3& startPoint, const float3& endPoint, std::vector<RayHit>& results);
+		void RaycastPacket(const std::vector<Ray>& rays, std::vector<RayHit>& results);
+
+		const RayQueryStatistics& GetRayQueryStatistics() const noexcept;
+		void ResetRayQueryStatistics() noexcept;
+
+		size_t QuerySphere(const BoundingSphere& sphere, const GraphicObject** results, size_t resultsCapacity);
+		size_t QueryBoundingBox(const BoundingBox& boundingBox, const GraphicObject** results, size_t resultsCapacity);
+		size_t QuerySpheres(const BoundingSphere* spheres, size_t spheresCount, ObjectOverlap* results, size_t resultsCapacity);
+
+		const RangeQueryStatistics& GetRangeQueryStatistics() const noexcept;
+		void ResetRangeQueryStatistics() noexcept;
+
 	private:
 		Octree() = delete;
 
+		struct CulledObject
+		{
+			const GraphicObject* object;
+			uint32_t lastRejectingPlane;
+		};
+
+		using CulledObjectPool = std::vector<CulledObject>;
+
 		struct Node
 		{
 			BoundingBox boundingBox;
 
-			ObjectPtrPool objects;
-			ObjectPtrPool dynamicObjects;
+			CulledObjectPool objects;
+			CulledObjectPool dynamicObjects;
 			std::array<std::shared_ptr<Node>, 8> nextNodes;
+
+			uint32_t lastRejectingPlane;
+		};
+
+		struct RayQuery
+		{
+			floatN origin;
+			floatN inverseDirection;
+			float maxDistance;
 		};
 
+		struct PacketRayEntry
+		{
+			uint32_t rayId;
+			float entryDistance;
+		};
+
+		using PacketRayPool = std::vector<PacketRayEntry>;
+
 		void CreateNodeChain(uint32_t currentDepth, Node* currentNode);
 		void SplitBoundingBox(const BoundingBox& boundingBox, std::array<BoundingBox, 8>& splittedBoundingBox);
 
 		void AddObject(Node* currentNode, const GraphicObject* newObject, bool isDynamic);
 		void PushObjectToNode(Node* node, const GraphicObject* newObject, bool isDynamic);
 
-		void PrepareVisibleObjectsList(const Node* currentNode, const Camera& targetCamera, ObjectPtrPool& visibleObjectsList,
+		void PrepareVisibleObjectsList(Node* currentNode, const Camera& targetCamera, uint32_t planeMask, ObjectPtrPool& visibleObjectsList,
+			ObjectPtrPool& visibleTransparentObjectsList, ObjectPtrPool& visibleEffectObjectsList);
+		void PrepareVisibleObjectsList(CulledObjectPool& objects, const Camera& targetCamera, uint32_t planeMask, ObjectPtrPool& visibleObjectsList,
 			ObjectPtrPool& visibleTransparentObjectsList, ObjectPtrPool& visibleEffectObjectsList);
 
+		using ViewPlaneMasks = std::array<uint32_t, MAX_VIEWS_COUNT>;
+
+		void PrepareVisibleObjectsLists(Node* currentNode, const std::vector<const Camera*>& cameras, uint32_t viewMask, const ViewPlaneMasks& planeMasks,
+			std::vector<VisibleObjectsLists>& visibleObjectsLists);
+		void PrepareVisibleObjectsLists(CulledObjectPool& objects, const std::vector<const Camera*>& cameras, uint32_t viewMask,
+			const ViewPlaneMasks& planeMasks, std::vector<VisibleObjectsLists>& visibleObjectsLists);
+
+		bool RemoveObject(CulledObjectPool& objects, const GraphicObject* object);
+
+		static bool MakeRayQuery(const Ray& ray, RayQuery& rayQuery);
+		static bool MakeSegmentRay(const float3& startPoint, const float3& endPoint, Ray& ray);
+
+		void CastRay(const Node* currentNode, const RayQuery& rayQuery, RayHit& nearestHit, std::vector<RayHit>* hits);
+		void CastRay(const CulledObjectPool& objects, const RayQuery& rayQuery, RayHit& nearestHit, std::vector<RayHit>* hits);
+		void CastRayPacket(const Node* currentNode, uint32_t currentDepth, PacketRayPool& activeRays, std::vector<RayHit>& results);
+		void CastRayPacket(const CulledObjectPool& objects, const PacketRayPool& activeRays, std::vector<RayHit>& results);
+
+		template<typename OverlapTest>
+		void QueryRange(const Node* currentNode, const OverlapTest& overlapTest, const GraphicObject** results, size_t resultsCapacity, size_t& resultsCount);
+		template<typename OverlapTest>
+		void QueryRange(const CulledObjectPool& objects, const OverlapTest& overlapTest, const GraphicObject** results, size_t resultsCapacity,
+			size_t& resultsCount);
+
+		void QuerySpheres(const Node* currentNode, uint32_t currentDepth, const std::vector<uint32_t>& activeSpheres, const BoundingSphere* spheres,
+			ObjectOverlap* results, size_t resultsCapacity, size_t& resultsCount);
+		void QuerySpheres(const CulledObjectPool& objects, const std::vector<uint32_t>& activeSpheres, const BoundingSphere* spheres, ObjectOverlap* results,
+			size_t resultsCapacity, size_t& resultsCount);
+
 		Node root;
 
+		std::unordered_map<const GraphicObject*, Node*> objectNodes;
+
 		uint32_t depth;
+		bool isTemporalCoherenceEnabled;
+
+		CullingStatistics cullingStatistics;
+		RayQueryStatistics rayQueryStatistics;
+
+		std::vector<RayQuery> packetRayQueries;
+		PacketRayPool packetRootRays;
+		std::vector<std::array<PacketRayPool, 8>> packetRayStacks;
+
+		RangeQueryStatistics rangeQueryStatistics;
+
+		std::vector<uint32_t> rangeRootSpheres;
+		std::vector<std::vector<uint32_t>> rangeSphereStacks;
 	};
 }
@@ -189,18 +189,10 @@ const bool& Graphics::ParticleSystem::IsComposed() const noexcept
 
 void Graphics::ParticleSystem::Update(ID3D12GraphicsCommandList* commandList) const
 {
-	std::array<D3D12_RESOURCE_BARRIER, 2> resourceBarriers{};
-	resourceBarriers[0].Transition.pResource = resourceManager.GetRWBuffer(indexBufferId).bufferAllocation.bufferResource;
-	resourceBarriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_INDEX_BUFFER;
-	resourceBarriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-	resourceBarriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-
-	resourceBarriers[1].Transition.pResource = resourceManager.GetRWBuffer(particleBufferId).bufferAllocation.bufferResource;
-	resourceBarriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
-	resourceBarriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-	resourceBarriers[1].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-
-	commandList->ResourceBarrier(static_cast<UINT>(resourceBarriers.size()), resourceBarriers.data());
+	resourceManager.BeginResourceBarrierBatch();
+	resourceManager.SetResourceBarrier(commandList, indexBufferId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	resourceManager.SetResourceBarrier(commandList, particleBufferId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	resourceManager.FlushResourceBarriers(commandList);
 
 	//sortParticleSystemCO->Present(commandList);
 	updateParticleSystemCO->Present(commandList);
@@ -211,24 +203,12 @@ void Graphics::ParticleSystem::Draw(ID3D12GraphicsCommandList* commandList, cons
 	if (material != nullptr)
 		if (material->IsComposed())
 		{
-			std::array<D3D12_RESOURCE_BARRIER, 4> resourceBarriers{};
-			resourceBarriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-			resourceBarriers[0].UAV.pResource = resourceManager.GetRWBuffer(indexBufferId).bufferAllocation.bufferResource;
-
-			resourceBarriers[1].Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-			resourceBarriers[1].UAV.pResource = resourceManager.GetRWBuffer(particleBufferId).bufferAllocation.bufferResource;
-
-			resourceBarriers[2].Transition.pResource = resourceBarriers[0].UAV.pResource;
-			resourceBarriers[2].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-			resourceBarriers[2].Transition.StateAfter = D3D12_RESOURCE_STATE_INDEX_BUFFER;
-			resourceBarriers[2].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-
-			resourceBarriers[3].Transition.pResource = resourceBarriers[1].UAV.pResource;
-			resourceBarriers[3].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-			resourceBarriers[3].Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
-			resourceBarriers[3].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-
-			commandList->ResourceBarrier(static_cast<UINT>(resourceBarriers.size()), resourceBarriers.data());
+			resourceManager.BeginResourceBarrierBatch();
+			resourceManager.SetUAVBarrier(commandList, indexBufferId);
+			resourceManager.SetUAVBarrier(commandList, particleBufferId);
+			resourceManager.SetResourceBarrier(commandList, indexBufferId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_INDEX_BUFFER);
+			resourceManager.SetResourceBarrier(commandList, particleBufferId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+			resourceManager.FlushResourceBarriers(commandList);
 
 			commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
 			commandList->IASetIndexBuffer(&indexBufferView);
@@ -42,6 +42,11 @@ const bool& Graphics::PointLight::IsShadowCaster() const
 	return isShadowCaster;
 }
 
+Graphics::BoundingSphere Graphics::PointLight::GetBoundingSphere() const
+{
+	return { position, radius };
+}
+
 void Graphics::PointLight::Move(float3 newPosition)
 {
 	position = newPosition;
@@ -18,6 +18,8 @@ namespace Graphics
 
 		const bool& IsShadowCaster() const;
 
+		BoundingSphere GetBoundingSphere() const;
+
 		void Move(float3 newPosition);
 
 		void SetColor(float3 newColor);
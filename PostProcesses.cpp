@@ -7,7 +7,7 @@
 #include "Resources/Shaders/HDRToneMappingPS.hlsl.h"
 
 Graphics::PostProcesses::PostProcesses()
-	: sceneViewport{}, isAAEnabled{}, isHDREnabled{}, isComposed{}, aaConstantBuffer{}, hdrConstantBuffer{}
+	: presentRenderTargetDescriptor{}, sceneViewport{}, isAAEnabled{}, isHDREnabled{}, isComposed{}, renderTargetAliasingReport{}, aaConstantBuffer{}, hdrConstantBuffer{}
 {
 
 }
@@ -59,45 +59,34 @@ void Graphics::PostProcesses::Initialize(ID3D12Device* device, ID3D12GraphicsCom
 
 	screenQuadMesh = std::shared_ptr<Mesh>(new Mesh(PolygonFormat::TRIANGLE, VertexFormat::POSITION | VertexFormat::TEXCOORD, &vertices, sizeof(vertices), &indices, sizeof(indices)));
 
-	for (uint32_t renderTargetId = 0; renderTargetId < INTERMEDIATE_8B_RENDER_TARGET_COUNT; renderTargetId++)
-	{
-		intermediate8bTargetId[renderTargetId] = resourceManager.CreateRenderTarget(GraphicsSettings::GetResolutionX(), GraphicsSettings::GetResolutionY(),
-			DXGI_FORMAT_R8G8B8A8_UNORM);
-
-		intermediate8bTargetDescriptor[renderTargetId] = resourceManager.GetRenderTargetDescriptorBase(intermediate8bTargetId[renderTargetId]);
-	}
+	uint64_t width = GraphicsSettings::GetResolutionX();
+	uint32_t height = GraphicsSettings::GetResolutionY();
 
-	for (uint32_t renderTargetId = 0; renderTargetId < INTERMEDIATE_8B_HALF_RENDER_TARGET_COUNT; renderTargetId++)
+	// Only the targets the chain renders to are created, each alive over the passes that write or read it:
+	// the AA output until tone mapping reads it, the bright pass output until tone mapping and the horizontal blur output until the vertical blur
+	std::vector<AliasedRenderTargetDesc> renderTargetDescs
 	{
-		intermediate8bHalfTargetId[renderTargetId] = resourceManager.CreateRenderTarget(GraphicsSettings::GetResolutionX() / 2, GraphicsSettings::GetResolutionY() / 2,
-			DXGI_FORMAT_R8G8B8A8_UNORM);
+		{ width / 4, height / 4, DXGI_FORMAT_R8G8B8A8_UNORM, BRIGHT_PASS, TONE_MAPPING_PASS },
+		{ width / 4, height / 4, DXGI_FORMAT_R8G8B8A8_UNORM, GAUSSIAN_BLUR_X_PASS, GAUSSIAN_BLUR_Y_PASS },
+		{ width, height, DXGI_FORMAT_R16G16B16A16_FLOAT, AA_PASS, TONE_MAPPING_PASS }
+	};
+	std::vector<RenderTargetId> renderTargetIds;
 
-		intermediate8bHalfTargetDescriptor[renderTargetId] = resourceManager.GetRenderTargetDescriptorBase(intermediate8bHalfTargetId[renderTargetId]);
-	}
+	resourceManager.CreateAliasedRenderTargets(renderTargetDescs, renderTargetIds, renderTargetAliasingReport);
+
+	auto renderTargetIdIt = renderTargetIds.begin();
 
 	for (uint32_t renderTargetId = 0; renderTargetId < INTERMEDIATE_8B_QUART_RENDER_TARGET_COUNT; renderTargetId++)
 	{
-		intermediate8bQuartTargetId[renderTargetId] = resourceManager.CreateRenderTarget(GraphicsSettings::GetResolutionX() / 4, GraphicsSettings::GetResolutionY() / 4,
-			DXGI_FORMAT_R8G8B8A8_UNORM);
-
+		intermediate8bQuartTargetId[renderTargetId] = *renderTargetIdIt++;
 		intermediate8bQuartTargetDescriptor[renderTargetId] = resourceManager.GetRenderTargetDescriptorBase(intermediate8bQuartTargetId[renderTargetId]);
 	}
 
 	for (uint32_t renderTargetId = 0; renderTargetId < INTERMEDIATE_16B_RENDER_TARGET_COUNT; renderTargetId++)
 	{
-		intermediate16bTargetId[renderTargetId] = resourceManager.CreateRenderTarget(GraphicsSettings::GetResolutionX(), GraphicsSettings::GetResolutionY(),
-			DXGI_FORMAT_R16G16B16A16_FLOAT);
-
+		intermediate16bTargetId[renderTargetId] = *renderTargetIdIt++;
 		intermediate16bTargetDescriptor[renderTargetId] = resourceManager.GetRenderTargetDescriptorBase(intermediate16bTargetId[renderTargetId]);
 	}
-
-	for (uint32_t renderTargetId = 0; renderTargetId < INTERMEDIATE_32B_RENDER_TARGET_COUNT; renderTargetId++)
-	{
-		intermediate32bTargetId[renderTargetId] = resourceManager.CreateRenderTarget(GraphicsSettings::GetResolutionX(), GraphicsSettings::GetResolutionY(),
-			DXGI_FORMAT_R32G32B32A32_FLOAT);
-
-		intermediate32bTargetDescriptor[renderTargetId] = resourceManager.GetRenderTargetDescriptorBase(intermediate32bTargetId[renderTargetId]);
-	}
 }
 
 void Graphics::PostProcesses::EnableAA()
@@ -144,6 +133,7 @@ void Graphics::PostProcesses::Compose(ID3D12Device* device, ID3D12GraphicsComman
 		antiAliasing->AssignRenderableEntity(screenQuadMesh.get());
 
 		aaSrcRenderTargetId = srcRenderTarget;
+		aaDestRenderTargetId = intermediate16bTargetId[0];
 		aaDestRenderTargetDescriptor = &intermediate16bTargetDescriptor[0];
 		srcRenderTarget = intermediate16bTargetId[0];
 		finalDestRenderTargetDescriptor = aaDestRenderTargetDescriptor;
@@ -219,7 +209,7 @@ void Graphics::PostProcesses::Compose(ID3D12Device* device, ID3D12GraphicsComman
 		}
 
 		hdrSrcRenderTargetId = srcRenderTarget;
-		hdrDestRenderTargetDescriptor = &intermediate8bTargetDescriptor[0];
+		hdrDestRenderTargetDescriptor = &presentRenderTargetDescriptor;
 		srcRenderTarget = intermediate16bTargetId[0];
 		finalDestRenderTargetDescriptor = hdrDestRenderTargetDescriptor;
 	}
@@ -259,15 +249,24 @@ void Graphics::PostProcesses::PresentProcessChain(ID3D12GraphicsCommandList* com
 	resourceManager.SetResourceBarrier(commandList, sceneDepthStencilId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_DEPTH_WRITE);
 }
 
+const Graphics::TextureAliasingReport& Graphics::PostProcesses::GetRenderTargetAliasingReport() const noexcept
+{
+	return renderTargetAliasingReport;
+}
+
 void Graphics::PostProcesses::ProcessAA(ID3D12GraphicsCommandList* commandList, const RenderTargetId& srcRenderTargetId, const D3D12_CPU_DESCRIPTOR_HANDLE* destRenderTargetDescriptor)
 {
 	commandList->RSSetViewports(1, &sceneViewport);
 	commandList->RSSetScissorRects(1, &sceneScissorRect);
 
 	{
-		auto beforeResourceState = resourceManager.GetRenderTarget(srcRenderTargetId).currentResourceState;
+		auto beforeResourceState = resourceManager.GetResourceState(srcRenderTargetId);
 		resourceManager.SetResourceBarrier(commandList, srcRenderTargetId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
+		// Without HDR the chain ends here and renders straight into the final target
+		if (destRenderTargetDescriptor != finalDestRenderTargetDescriptor)
+			resourceManager.AcquireAliasedRenderTarget(commandList, aaDestRenderTargetId);
+
 		commandList->OMSetRenderTargets(1, destRenderTargetDescriptor, false, nullptr);
 		antiAliasing->Draw(commandList);
 
@@ -282,6 +281,7 @@ void Graphics::PostProcesses::ProcessHDR(ID3D12GraphicsCommandList* commandList,
 
 	{
 		resourceManager.SetResourceBarrier(commandList, srcRenderTargetId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		resourceManager.AcquireAliasedRenderTarget(commandList, intermediate8bQuartTargetId[0]);
 
 		commandList->OMSetRenderTargets(1, &intermediate8bQuartTargetDescriptor[0], false, nullptr);
 		brightPass->Draw(commandList);
@@ -289,33 +289,37 @@ void Graphics::PostProcesses::ProcessHDR(ID3D12GraphicsCommandList* commandList,
 
 	{
 		resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[0], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		resourceManager.AcquireAliasedRenderTarget(commandList, intermediate8bQuartTargetId[1]);
 
 		commandList->OMSetRenderTargets(1, &intermediate8bQuartTargetDescriptor[1], false, nullptr);
 		gaussianBlurX->Draw(commandList);
-
-		resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[0], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	}
 
 	{
+		resourceManager.BeginResourceBarrierBatch();
+		resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[0], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_RENDER_TARGET);
 		resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[1], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		resourceManager.FlushResourceBarriers(commandList);
 
 		commandList->OMSetRenderTargets(1, &intermediate8bQuartTargetDescriptor[0], false, nullptr);
 		gaussianBlurY->Draw(commandList);
-
-		resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[1], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	}
 
 	commandList->RSSetViewports(1, &sceneViewport);
 	commandList->RSSetScissorRects(1, &sceneScissorRect);
 
 	{
+		resourceManager.BeginResourceBarrierBatch();
+		resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[1], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_RENDER_TARGET);
 		resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[0], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		resourceManager.FlushResourceBarriers(commandList);
 
 		commandList->OMSetRenderTargets(1, destRenderTargetDescriptor, false, nullptr);
 		toneMapping->Draw(commandList);
-
-		resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[0], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	}
 
+	resourceManager.BeginResourceBarrierBatch();
+	resourceManager.SetResourceBarrier(commandList, intermediate8bQuartTargetId[0], D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	resourceManager.SetResourceBarrier(commandList, srcRenderTargetId, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+	resourceManager.FlushResourceBarriers(commandList);
 }
@@ -24,6 +24,8 @@ namespace Graphics
 		void UpdateHDR(ID3D12GraphicsCommandList* commandList, float3 shiftVector, float middleGray, float whiteCutoff, float brightPassThreshold, float brightPassOffset);
 		void PresentProcessChain(ID3D12GraphicsCommandList* commandList, const D3D12_CPU_DESCRIPTOR_HANDLE* destRenderTargetDescriptor);
 
+		const TextureAliasingReport& GetRenderTargetAliasingReport() const noexcept;
+
 	private:
 		PostProcesses();
 		~PostProcesses() {}
@@ -41,21 +43,23 @@ namespace Graphics
 		TextureId noiseTextureId;
 		TextureId diffuseTextureId;
 
-		static const uint32_t INTERMEDIATE_8B_RENDER_TARGET_COUNT = 2;
-		static const uint32_t INTERMEDIATE_8B_HALF_RENDER_TARGET_COUNT = 2;
 		static const uint32_t INTERMEDIATE_8B_QUART_RENDER_TARGET_COUNT = 2;
-		static const uint32_t INTERMEDIATE_16B_RENDER_TARGET_COUNT = 4;
-		static const uint32_t INTERMEDIATE_32B_RENDER_TARGET_COUNT = 2;
+		static const uint32_t INTERMEDIATE_16B_RENDER_TARGET_COUNT = 1;
+
+		// Pass order of the chain, used as lifetimes of the aliased intermediate targets
+		static const uint32_t AA_PASS = 0;
+		static const uint32_t BRIGHT_PASS = 1;
+		static const uint32_t GAUSSIAN_BLUR_X_PASS = 2;
+		static const uint32_t GAUSSIAN_BLUR_Y_PASS = 3;
+		static const uint32_t TONE_MAPPING_PASS = 4;
 
 		RenderTargetId sceneRenderTargetId;
 		RenderTargetId normalRenderTargetId;
-		RenderTargetId intermediate8bTargetId[INTERMEDIATE_8B_RENDER_TARGET_COUNT];
-		RenderTargetId intermediate8bHalfTargetId[INTERMEDIATE_8B_HALF_RENDER_TARGET_COUNT];
 		RenderTargetId intermediate8bQuartTargetId[INTERMEDIATE_8B_QUART_RENDER_TARGET_COUNT];
 		RenderTargetId intermediate16bTargetId[INTERMEDIATE_16B_RENDER_TARGET_COUNT];
-		RenderTargetId intermediate32bTargetId[INTERMEDIATE_32B_RENDER_TARGET_COUNT];
 
 		RenderTargetId aaSrcRenderTargetId;
+		RenderTargetId aaDestRenderTargetId;
 		RenderTargetId hdrSrcRenderTargetId;
 
 		DepthStencilId sceneDepthStencilId;
@@ -63,11 +67,9 @@ namespace Graphics
 		D3D12_CPU_DESCRIPTOR_HANDLE sceneRenderTargetDescriptor;
 		D3D12_CPU_DESCRIPTOR_HANDLE normalRenderTargetDescriptor;
 		D3D12_CPU_DESCRIPTOR_HANDLE sceneDepthStencilDescriptor;
-		D3D12_CPU_DESCRIPTOR_HANDLE intermediate8bTargetDescriptor[INTERMEDIATE_8B_RENDER_TARGET_COUNT];
-		D3D12_CPU_DESCRIPTOR_HANDLE intermediate8bHalfTargetDescriptor[INTERMEDIATE_8B_HALF_RENDER_TARGET_COUNT];
 		D3D12_CPU_DESCRIPTOR_HANDLE intermediate8bQuartTargetDescriptor[INTERMEDIATE_8B_QUART_RENDER_TARGET_COUNT];
 		D3D12_CPU_DESCRIPTOR_HANDLE intermediate16bTargetDescriptor[INTERMEDIATE_16B_RENDER_TARGET_COUNT];
-		D3D12_CPU_DESCRIPTOR_HANDLE intermediate32bTargetDescriptor[INTERMEDIATE_32B_RENDER_TARGET_COUNT];
+		D3D12_CPU_DESCRIPTOR_HANDLE presentRenderTargetDescriptor;
 
 		D3D12_CPU_DESCRIPTOR_HANDLE* aaDestRenderTargetDescriptor;
 		D3D12_CPU_DESCRIPTOR_HANDLE* hdrDestRenderTargetDescriptor;
@@ -95,6 +97,8 @@ namespace Graphics
 		bool isHDREnabled;
 		bool isComposed;
 
+		TextureAliasingReport renderTargetAliasingReport;
+
 		using AAConstantBuffer = struct
 		{
 			float2 pixelSize;
@@ -0,0 +1,188 @@
+#include "PotentiallyVisibleSet.h"
+
+Graphics::PotentiallyVisibleSet::PotentiallyVisibleSet(uint32_t _cellsPerAxis)
+	: cellsPerAxis((std::max)(_cellsPerAxis, 1u)), wordsPerCell(0), volume{}, cellSize{}, statistics{}
+{
+
+}
+
+Graphics::PotentiallyVisibleSet::~PotentiallyVisibleSet()
+{
+
+}
+
+void Graphics::PotentiallyVisibleSet::Bake(const ObjectPtrPool& staticObjects, OcclusionCuller& occlusionCuller, float zNear, float zFar)
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	statistics = {};
+
+	objects = staticObjects;
+	objectIndices.clear();
+	cellsBits.clear();
+
+	if (objects.empty())
+		return;
+
+	for (uint32_t objectId = 0; objectId < objects.size(); objectId++)
+		objectIndices.insert({ objects[objectId], objectId });
+
+	volume = objects.front()->GetBoundingBox();
+
+	for (auto& object : objects)
+		volume = ExpandBoundingBox(volume, object->GetBoundingBox());
+
+	float3 volumeSize = BoundingBoxSize(volume);
+	cellSize = { volumeSize.x / cellsPerAxis, volumeSize.y / cellsPerAxis, volumeSize.z / cellsPerAxis };
+
+	size_t cellsCount = static_cast<size_t>(cellsPerAxis) * cellsPerAxis * cellsPerAxis;
+	wordsPerCell = (objects.size() + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	cellsBits.assign(cellsCount * wordsPerCell, 0);
+
+	size_t visibleObjectsCount = 0;
+
+	for (uint32_t cellZ = 0; cellZ < cellsPerAxis; cellZ++)
+		for (uint32_t cellY = 0; cellY < cellsPerAxis; cellY++)
+			for (uint32_t cellX = 0; cellX < cellsPerAxis; cellX++)
+			{
+				size_t cellId = (static_cast<size_t>(cellZ) * cellsPerAxis + cellY) * cellsPerAxis + cellX;
+				uint64_t* cellBits = &cellsBits[cellId * wordsPerCell];
+
+				BoundingBox cellBoundingBox = GetCellBoundingBox(cellX, cellY, cellZ);
+				float3 cellBoundingBoxSize = BoundingBoxSize(cellBoundingBox);
+
+				for (uint32_t sampleId = 0; sampleId < 9; sampleId++)
+				{
+					float3 samplePosition = { cellBoundingBox.minCornerPoint.x + cellBoundingBoxSize.x * 0.5f,
+						cellBoundingBox.minCornerPoint.y + cellBoundingBoxSize.y * 0.5f, cellBoundingBox.minCornerPoint.z + cellBoundingBoxSize.z * 0.5f };
+
+					if (sampleId != 0)
+					{
+						uint32_t cornerId = sampleId - 1;
+
+						samplePosition.x = cellBoundingBox.minCornerPoint.x + cellBoundingBoxSize.x * ((cornerId & 1) ? 1.0f - SAMPLE_INSET : SAMPLE_INSET);
+						samplePosition.y = cellBoundingBox.minCornerPoint.y + cellBoundingBoxSize.y * ((cornerId & 2) ? 1.0f - SAMPLE_INSET : SAMPLE_INSET);
+						samplePosition.z = cellBoundingBox.minCornerPoint.z + cellBoundingBoxSize.z * ((cornerId & 4) ? 1.0f - SAMPLE_INSET : SAMPLE_INSET);
+					}
+
+					SampleVisibility(samplePosition, cellBoundingBox, occlusionCuller, zNear, zFar, cellBits);
+				}
+
+				for (size_t wordId = 0; wordId < wordsPerCell; wordId++)
+					visibleObjectsCount += std::bitset<BITS_PER_WORD>(cellBits[wordId]).count();
+			}
+
+	statistics.cellsCount = cellsCount;
+	statistics.objectsCount = objects.size();
+	statistics.samplesCount = cellsCount * 9;
+	statistics.storageSize = cellsBits.size() * sizeof(uint64_t);
+	statistics.averageVisibleObjects = visibleObjectsCount / cellsCount;
+	statistics.bakeTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+bool Graphics::PotentiallyVisibleSet::FindCell(const float3& position, uint32_t& cellId) const
+{
+	if (cellsBits.empty() || !CheckPointInBox(position, volume))
+		return false;
+
+	auto getCellCoordinate = [this](float coordinate, float minCoordinate, float size)
+	{
+		if (size <= 0.0f)
+			return 0u;
+
+		return (std::min)(static_cast<uint32_t>((coordinate - minCoordinate) / size), cellsPerAxis - 1);
+	};
+
+	uint32_t cellX = getCellCoordinate(position.x, volume.minCornerPoint.x, cellSize.x);
+	uint32_t cellY = getCellCoordinate(position.y, volume.minCornerPoint.y, cellSize.y);
+	uint32_t cellZ = getCellCoordinate(position.z, volume.minCornerPoint.z, cellSize.z);
+
+	cellId = (cellZ * cellsPerAxis + cellY) * cellsPerAxis + cellX;
+
+	return true;
+}
+
+void Graphics::PotentiallyVisibleSet::GetCellObjects(uint32_t cellId, ObjectPtrPool& cellObjects) const
+{
+	cellObjects.clear();
+
+	const uint64_t* cellBits = &cellsBits[static_cast<size_t>(cellId) * wordsPerCell];
+
+	for (size_t wordId = 0; wordId < wordsPerCell; wordId++)
+	{
+		uint64_t word = cellBits[wordId];
+
+		while (word != 0)
+		{
+			unsigned long bitId;
+			_BitScanForward64(&bitId, word);
+
+			cellObjects.push_back(objects[wordId * BITS_PER_WORD + bitId]);
+
+			word &= word - 1;
+		}
+	}
+}
+
+size_t Graphics::PotentiallyVisibleSet::GetObjectsCount() const noexcept
+{
+	return objects.size();
+}
+
+bool Graphics::PotentiallyVisibleSet::IsObjectBaked(const GraphicObject* object) const noexcept
+{
+	return objectIndices.find(object) != objectIndices.end();
+}
+
+const Graphics::PotentiallyVisibleSetStatistics& Graphics::PotentiallyVisibleSet::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+Graphics::BoundingBox Graphics::PotentiallyVisibleSet::GetCellBoundingBox(uint32_t cellX, uint32_t cellY, uint32_t cellZ) const
+{
+	float3 minCornerPoint = { volume.minCornerPoint.x + cellSize.x * cellX, volume.minCornerPoint.y + cellSize.y * cellY,
+		volume.minCornerPoint.z + cellSize.z * cellZ };
+
+	return { minCornerPoint, { minCornerPoint.x + cellSize.x, minCornerPoint.y + cellSize.y, minCornerPoint.z + cellSize.z } };
+}
+
+void Graphics::PotentiallyVisibleSet::SampleVisibility(const float3& samplePosition, const BoundingBox& cellBoundingBox, OcclusionCuller& occlusionCuller,
+	float zNear, float zFar, uint64_t* cellBits)
+{
+	static const std::array<std::pair<float3, float3>, 6> cubeFaces =
+	{
+		std::pair<float3, float3>{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
+		{ { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+		{ { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+		{ { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f } }
+	};
+
+	for (auto& cubeFace : cubeFaces)
+	{
+		Camera faceCamera(XM_PIDIV2, 1.0f, zNear, zFar);
+		faceCamera.Move(samplePosition);
+		faceCamera.LookAt({ samplePosition.x + cubeFace.first.x, samplePosition.y + cubeFace.first.y, samplePosition.z + cubeFace.first.z });
+		faceCamera.SetUpVector(cubeFace.second);
+		faceCamera.Update();
+
+		occlusionCuller.RasterizeOccluders(faceCamera);
+
+		for (size_t objectId = 0; objectId < objects.size(); objectId++)
+		{
+			uint64_t objectBit = 1ULL << (objectId % BITS_PER_WORD);
+			uint64_t& cellWord = cellBits[objectId / BITS_PER_WORD];
+
+			if ((cellWord & objectBit) != 0)
+				continue;
+
+			const BoundingBox& objectBoundingBox = objects[objectId]->GetBoundingBox();
+
+			if (CheckBoxIntersectsBox(objectBoundingBox, cellBoundingBox) ||
+				(faceCamera.BoundingBoxInScope(objectBoundingBox) && !occlusionCuller.IsOccluded(objectBoundingBox)))
+				cellWord |= objectBit;
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "OcclusionCuller.h"
+
+namespace Graphics
+{
+	struct PotentiallyVisibleSetStatistics
+	{
+		float bakeTime;
+		size_t cellsCount;
+		size_t objectsCount;
+		size_t samplesCount;
+		size_t storageSize;
+		size_t averageVisibleObjects;
+	};
+
+	class PotentiallyVisibleSet
+	{
+	public:
+		PotentiallyVisibleSet(uint32_t _cellsPerAxis);
+		~PotentiallyVisibleSet();
+
+		void Bake(const ObjectPtrPool& staticObjects, OcclusionCuller& occlusionCuller, float zNear, float zFar);
+
+		bool FindCell(const float3& position, uint32_t& cellId) const;
+		void GetCellObjects(uint32_t cellId, ObjectPtrPool& cellObjects) const;
+
+		size_t GetObjectsCount() const noexcept;
+		bool IsObjectBaked(const GraphicObject* object) const noexcept;
+
+		const PotentiallyVisibleSetStatistics& GetStatistics() const noexcept;
+
+	private:
+		PotentiallyVisibleSet() = delete;
+		PotentiallyVisibleSet(const PotentiallyVisibleSet&) = delete;
+		PotentiallyVisibleSet& operator=(const PotentiallyVisibleSet&) = delete;
+
+		static constexpr uint32_t BITS_PER_WORD = 64;
+		static constexpr float SAMPLE_INSET = 0.1f;
+
+		BoundingBox GetCellBoundingBox(uint32_t cellX, uint32_t cellY, uint32_t cellZ) const;
+		void SampleVisibility(const float3& samplePosition, const BoundingBox& cellBoundingBox, OcclusionCuller& occlusionCuller, float zNear, float zFar,
+			uint64_t* cellBits);
+
+		uint32_t cellsPerAxis;
+		size_t wordsPerCell;
+
+		BoundingBox volume;
+		float3 cellSize;
+
+		ObjectPtrPool objects;
+		std::unordered_map<const GraphicObject*, uint32_t> objectIndices;
+		std::vector<uint64_t> cellsBits;
+
+		PotentiallyVisibleSetStatistics statistics;
+	};
+}
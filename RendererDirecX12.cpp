@@ -83,6 +83,8 @@ void Graphics::RendererDirectX12::Initialize(HWND& windowHandler)
 
 	ThrowIfFailed(commandList->Close(), "RendererDirectX12::Initialize: Command List closing error!");
 
+	resourceManager.SynchronizeUploads(commandQueue.Get());
+
 	ID3D12CommandList* commandLists[] = { commandList.Get() };
 
 	commandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
@@ -168,6 +170,8 @@ void Graphics::RendererDirectX12::FrameRender()
 
 	ThrowIfFailed(commandList->Close(), "RendererDirectX12::FrameRender: Command List closing error!");
 
+	resourceManager.SynchronizeUploads(commandQueue.Get());
+
 	ID3D12CommandList* commandLists[] = { commandList.Get() };
 
 	commandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
@@ -187,6 +191,9 @@ void Graphics::RendererDirectX12::PrepareNextFrame()
 	auto currentFenceValue = fenceValues[bufferIndex];
 	ThrowIfFailed(commandQueue->Signal(fence.Get(), currentFenceValue), "RendererDirectX12::PrepareNextFrame: Signal error!");
 
+	resourceManager.FinishUploadFrame(currentFenceValue);
+	resourceManager.FinishResourceBarrierFrame();
+
 	bufferIndex = swapChain->GetCurrentBackBufferIndex();
 
 	if (fence->GetCompletedValue() < fenceValues[bufferIndex])
@@ -196,6 +203,9 @@ void Graphics::RendererDirectX12::PrepareNextFrame()
 	}
 
 	fenceValues[bufferIndex] = currentFenceValue + 1;
+
+	resourceManager.ReleaseCompletedUploads(fence->GetCompletedValue());
+	resourceManager.ReleaseCompletedResources(fence->GetCompletedValue());
 }
 
 void Graphics::RendererDirectX12::WaitForGpu()
@@ -205,6 +215,9 @@ void Graphics::RendererDirectX12::WaitForGpu()
 
 	WaitForSingleObjectEx(fenceEvent, INFINITE, false);
 
+	resourceManager.ReleaseCompletedUploads(fence->GetCompletedValue());
+	resourceManager.ReleaseCompletedResources(fence->GetCompletedValue());
+
 	fenceValues[bufferIndex]++;
 }
 
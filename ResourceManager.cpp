@@ -13,8 +13,7 @@ void Graphics::ResourceManager::Initialize(ID3D12Device* _device)
 	
 	CreateCommandQueue(device, &commandQueue);
 
-	ThrowIfFailed(device->CreateFence(fenceValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)), "ResourceManager::Initialize: Fence creating error!");
-	fenceValue++;
+	ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)), "ResourceManager::Initialize: Fence creating error!");
 
 	fenceEvent = CreateEvent(nullptr, false, false, nullptr);
 	if (fenceEvent == nullptr)
@@ -25,6 +24,21 @@ void Graphics::ResourceManager::Initialize(ID3D12Device* _device)
 
 	ThrowIfFailed(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator.Get(), nullptr, IID_PPV_ARGS(&commandList)),
 		"ResourceManager::Initialize: Command List creating error!");
+
+	uploadRingPage = std::shared_ptr<BufferAllocationPage>(new BufferAllocationPage(device, D3D12_HEAP_TYPE_UPLOAD, D3D12_RESOURCE_FLAG_NONE, UPLOAD_RING_SIZE));
+	uploadRingPage->Allocate(UPLOAD_RING_SIZE, 1, uploadRingAllocation);
+
+	uploadRing = std::shared_ptr<UploadRing>(new UploadRing(UPLOAD_RING_SIZE));
+
+	stagingRingPage = std::shared_ptr<BufferAllocationPage>(new BufferAllocationPage(device, D3D12_HEAP_TYPE_UPLOAD, D3D12_RESOURCE_FLAG_NONE, STAGING_RING_SIZE));
+	stagingRingPage->Allocate(STAGING_RING_SIZE, 1, stagingRingAllocation);
+
+	stagingRing = std::shared_ptr<UploadRing>(new UploadRing(STAGING_RING_SIZE));
+	uploadBatcher = std::shared_ptr<UploadBatcher>(new UploadBatcher(1, MAX_UPLOAD_BATCH_SIZE, MAX_UPLOAD_BATCH_COUNT, UPLOAD_TIMING_MODEL));
+
+	stateTracker = std::shared_ptr<ResourceStateTracker>(new ResourceStateTracker());
+
+	descriptorAllocator.Initialize(device);
 }
 
 Graphics::VertexBufferId Graphics::ResourceManager::CreateVertexBuffer(const void* data, size_t dataSize, size_t vertexStride)
@@ -32,8 +46,10 @@ Graphics::VertexBufferId Graphics::ResourceManager::CreateVertexBuffer(const voi
 	BufferAllocation vertexBufferAllocation{};
 	bufferAllocator.Allocate(device, dataSize, 64 * _KB, D3D12_HEAP_TYPE_DEFAULT, vertexBufferAllocation);
 
+	std::unique_lock<std::recursive_mutex> uploadLock(uploadMutex);
+
 	BufferAllocation uploadBufferAllocation{};
-	bufferAllocator.AllocateTemporary(device, dataSize, D3D12_HEAP_TYPE_UPLOAD, uploadBufferAllocation);
+	AllocateStagingMemory(dataSize, 4, uploadBufferAllocation);
 
 	if (vertexBufferAllocation.bufferResource == nullptr)
 		throw std::exception("ResourceManager::CreateVertexBuffer: Vertex Buffer Resource is null!");
@@ -43,13 +59,17 @@ Graphics::VertexBufferId Graphics::ResourceManager::CreateVertexBuffer(const voi
 
 	std::copy(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + dataSize, uploadBufferAllocation.cpuAddress);
 
+	TrackResource(vertexBufferAllocation.bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
+	SetUploadResourceBarrier(vertexBufferAllocation.bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
+
 	commandList->CopyBufferRegion(vertexBufferAllocation.bufferResource, vertexBufferAllocation.gpuPageOffset, uploadBufferAllocation.bufferResource,
-		0, uploadBufferAllocation.bufferResource->GetDesc().Width);
+		uploadBufferAllocation.gpuPageOffset, dataSize);
 
-	SetResourceBarrier(commandList.Get(), vertexBufferAllocation.bufferResource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST,
-		D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+	SetUploadResourceBarrier(vertexBufferAllocation.bufferResource, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
 
-	ExecuteGPUCommands();
+	RecordUpload(dataSize);
+
+	uploadLock.unlock();
 
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
 	vertexBufferView.BufferLocation = vertexBufferAllocation.gpuAddress;
@@ -59,11 +79,8 @@ Graphics::VertexBufferId Graphics::ResourceManager::CreateVertexBuffer(const voi
 	VertexBuffer vertexBuffer{};
 	vertexBuffer.vertexBufferAllocation = vertexBufferAllocation;
 	vertexBuffer.vertexBufferView = vertexBufferView;
-	vertexBuffer.currentResourceState = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
-
-	vertexBufferPool.push_back(vertexBuffer);
 
-	return VertexBufferId(vertexBufferPool.size() - 1);
+	return vertexBufferPool.Insert(vertexBuffer);
 }
 
 Graphics::VertexBufferId Graphics::ResourceManager::CreateDynamicVertexBuffer(const void* data, size_t dataSize, size_t vertexStride)
@@ -74,6 +91,8 @@ Graphics::VertexBufferId Graphics::ResourceManager::CreateDynamicVertexBuffer(co
 	if (vertexBufferAllocation.bufferResource == nullptr)
 		throw std::exception("ResourceManager::CreateDynamicVertexBuffer: Vertex Buffer Resource is null!");
 
+	TrackResource(vertexBufferAllocation.bufferResource, D3D12_RESOURCE_STATE_GENERIC_READ);
+
 	std::copy(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + dataSize, vertexBufferAllocation.cpuAddress);
 
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
@@ -84,11 +103,8 @@ Graphics::VertexBufferId Graphics::ResourceManager::CreateDynamicVertexBuffer(co
 	VertexBuffer vertexBuffer{};
 	vertexBuffer.vertexBufferAllocation = vertexBufferAllocation;
 	vertexBuffer.vertexBufferView = vertexBufferView;
-	vertexBuffer.currentResourceState = D3D12_RESOURCE_STATE_GENERIC_READ;
 
-	vertexBufferPool.push_back(vertexBuffer);
-
-	return VertexBufferId(vertexBufferPool.size() - 1);
+	return vertexBufferPool.Insert(vertexBuffer);
 }
 
 Graphics::IndexBufferId Graphics::ResourceManager::CreateIndexBuffer(const void* data, size_t dataSize, size_t indexStride)
@@ -96,8 +112,10 @@ Graphics::IndexBufferId Graphics::ResourceManager::CreateIndexBuffer(const void*
 	BufferAllocation indexBufferAllocation{};
 	bufferAllocator.Allocate(device, dataSize, 64 * _KB, D3D12_HEAP_TYPE_DEFAULT, indexBufferAllocation);
 	
+	std::unique_lock<std::recursive_mutex> uploadLock(uploadMutex);
+
 	BufferAllocation uploadBufferAllocation{};
-	bufferAllocator.AllocateTemporary(device, dataSize, D3D12_HEAP_TYPE_UPLOAD, uploadBufferAllocation);
+	AllocateStagingMemory(dataSize, 4, uploadBufferAllocation);
 
 	if (indexBufferAllocation.bufferResource == nullptr)
 		throw std::exception("ResourceManager::CreateIndexBuffer: Index Buffer Resource is null!");
@@ -107,28 +125,30 @@ Graphics::IndexBufferId Graphics::ResourceManager::CreateIndexBuffer(const void*
 
 	std::copy(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + dataSize, uploadBufferAllocation.cpuAddress);
 
+	TrackResource(indexBufferAllocation.bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
+
 	D3D12_INDEX_BUFFER_VIEW indexBufferView{};
 	indexBufferView.BufferLocation = indexBufferAllocation.gpuAddress;
 	indexBufferView.SizeInBytes = static_cast<uint32_t>(dataSize);
 	indexBufferView.Format = (indexStride == 4) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
 
+	SetUploadResourceBarrier(indexBufferAllocation.bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
+
 	commandList->CopyBufferRegion(indexBufferAllocation.bufferResource, indexBufferAllocation.gpuPageOffset, uploadBufferAllocation.bufferResource,
-		0, uploadBufferAllocation.bufferResource->GetDesc().Width);
+		uploadBufferAllocation.gpuPageOffset, dataSize);
 
-	SetResourceBarrier(commandList.Get(), indexBufferAllocation.bufferResource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST,
-		D3D12_RESOURCE_STATE_INDEX_BUFFER);
+	SetUploadResourceBarrier(indexBufferAllocation.bufferResource, D3D12_RESOURCE_STATE_INDEX_BUFFER);
 
-	ExecuteGPUCommands();
+	RecordUpload(dataSize);
+
+	uploadLock.unlock();
 
 	IndexBuffer indexBuffer{};
 	indexBuffer.indicesCount = static_cast<uint32_t>(dataSize / indexStride);
 	indexBuffer.indexBufferView = indexBufferView;
 	indexBuffer.indexBufferAllocation = indexBufferAllocation;
-	indexBuffer.currentResourceState = D3D12_RESOURCE_STATE_INDEX_BUFFER;
 	
-	indexBufferPool.push_back(indexBuffer);
-
-	return IndexBufferId(indexBufferPool.size() - 1);
+	return indexBufferPool.Insert(indexBuffer);
 }
 
 Graphics::ConstantBufferId Graphics::ResourceManager::CreateConstantBuffer(const void* data, size_t dataSize)
@@ -139,8 +159,10 @@ Graphics::ConstantBufferId Graphics::ResourceManager::CreateConstantBuffer(const
 	if (constantBufferAllocation.bufferResource == nullptr)
 		throw std::exception("ResourceManager::CreateConstantBuffer: Buffer Resource is null!");
 
+	TrackResource(constantBufferAllocation.bufferResource, D3D12_RESOURCE_STATE_GENERIC_READ);
+
 	DescriptorAllocation constantBufferDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, constantBufferDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, constantBufferDescriptorAllocation);
 
 	D3D12_CONSTANT_BUFFER_VIEW_DESC constantBufferViewDesc{};
 	constantBufferViewDesc.BufferLocation = constantBufferAllocation.gpuAddress;
@@ -154,11 +176,9 @@ Graphics::ConstantBufferId Graphics::ResourceManager::CreateConstantBuffer(const
 	constantBuffer.uploadBufferAllocation = constantBufferAllocation;
 	constantBuffer.bufferDescriptorAllocation = constantBufferDescriptorAllocation;
 	constantBuffer.constantBufferViewDesc = constantBufferViewDesc;
-	constantBuffer.currentResourceState = D3D12_RESOURCE_STATE_GENERIC_READ;
-
-	constantBufferPool.push_back(constantBuffer);
+	constantBuffer.gpuAddress = constantBufferAllocation.gpuAddress;
 
-	return ConstantBufferId(constantBufferPool.size() - 1);
+	return constantBufferPool.Insert(constantBuffer);
 }
 
 Graphics::TextureId Graphics::ResourceManager::CreateTexture(const std::filesystem::path& fileName)
@@ -179,9 +199,6 @@ Graphics::TextureId Graphics::ResourceManager::CreateTexture(const std::vector<u
 	TextureAllocation textureAllocation{};
 	textureAllocator.Allocate(device, resourceFlags, nullptr, textureInfo, textureAllocation);
 
-	TextureAllocation uploadTextureAllocation{};
-	textureAllocator.AllocateTemporaryUpload(device, resourceFlags, textureInfo, uploadTextureAllocation);
-
 	D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
 	shaderResourceViewDesc.Format = textureInfo.format;
 	shaderResourceViewDesc.ViewDimension = textureInfo.srvDimension;
@@ -222,19 +239,34 @@ Graphics::TextureId Graphics::ResourceManager::CreateTexture(const std::vector<u
 	if (textureAllocation.textureResource == nullptr)
 		throw std::exception("ResourceManager::CreateTexture: Texture Resource is null!");
 
-	if (uploadTextureAllocation.textureResource == nullptr)
-		throw std::exception("ResourceManager::CreateTexture: Upload Texture Resource is null!");
+	TrackResource(textureAllocation.textureResource, D3D12_RESOURCE_STATE_COMMON);
 
-	SetResourceBarrier(commandList.Get(), textureAllocation.textureResource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+	auto textureDesc = textureAllocation.textureResource->GetDesc();
+	uint64_t uploadSize = 0;
 
-	UploadTexture(uploadTextureAllocation.textureResource, textureAllocation.textureResource, textureInfo, data, uploadTextureAllocation.cpuAddress);
+	device->GetCopyableFootprints(&textureDesc, 0, textureInfo.depth * textureInfo.mipLevels, 0, nullptr, nullptr, nullptr, &uploadSize);
 
-	SetResourceBarrier(commandList.Get(), textureAllocation.textureResource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
+	std::unique_lock<std::recursive_mutex> uploadLock(uploadMutex);
 
-	ExecuteGPUCommands();
+	BufferAllocation uploadBufferAllocation{};
+	AllocateStagingMemory(uploadSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, uploadBufferAllocation);
+
+	if (uploadBufferAllocation.bufferResource == nullptr)
+		throw std::exception("ResourceManager::CreateTexture: Upload Buffer Resource is null!");
+
+	SetUploadResourceBarrier(textureAllocation.textureResource, D3D12_RESOURCE_STATE_COPY_DEST);
+
+	UploadTexture(uploadBufferAllocation.bufferResource, uploadBufferAllocation.gpuPageOffset, textureAllocation.textureResource, textureInfo, data,
+		uploadBufferAllocation.cpuAddress);
+
+	SetUploadResourceBarrier(textureAllocation.textureResource, D3D12_RESOURCE_STATE_COMMON);
+
+	RecordUpload(uploadSize);
+
+	uploadLock.unlock();
 
 	DescriptorAllocation shaderResourceDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
 	device->CreateShaderResourceView(textureAllocation.textureResource, &shaderResourceViewDesc, shaderResourceDescriptorAllocation.descriptorBase);
 
 	Texture texture{};
@@ -242,11 +274,8 @@ Graphics::TextureId Graphics::ResourceManager::CreateTexture(const std::vector<u
 	texture.info = textureInfo;
 	texture.textureAllocation = textureAllocation;
 	texture.shaderResourceDescriptorAllocation = shaderResourceDescriptorAllocation;
-	texture.currentResourceState = D3D12_RESOURCE_STATE_COMMON;
-
-	texturePool.push_back(texture);
 
-	return TextureId(texturePool.size() - 1);
+	return texturePool.Insert(texture);
 }
 
 Graphics::BufferId Graphics::ResourceManager::CreateBuffer(const void* data, size_t dataSize, size_t bufferStride, size_t numElements, DXGI_FORMAT format)
@@ -254,8 +283,10 @@ Graphics::BufferId Graphics::ResourceManager::CreateBuffer(const void* data, siz
 	BufferAllocation bufferAllocation{};
 	bufferAllocator.AllocateCustomBuffer(device, dataSize, 64 * _KB, bufferAllocation);
 
+	std::unique_lock<std::recursive_mutex> uploadLock(uploadMutex);
+
 	BufferAllocation uploadBufferAllocation{};
-	bufferAllocator.AllocateTemporary(device, dataSize, D3D12_HEAP_TYPE_UPLOAD, uploadBufferAllocation);
+	AllocateStagingMemory(dataSize, 4, uploadBufferAllocation);
 
 	if (bufferAllocation.bufferResource == nullptr)
 		throw std::exception("ResourceManager::CreateBuffer: Buffer Resource is null!");
@@ -265,10 +296,15 @@ Graphics::BufferId Graphics::ResourceManager::CreateBuffer(const void* data, siz
 
 	std::copy(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + dataSize, uploadBufferAllocation.cpuAddress);
 
+	TrackResource(bufferAllocation.bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
+	SetUploadResourceBarrier(bufferAllocation.bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
+
 	commandList->CopyBufferRegion(bufferAllocation.bufferResource, bufferAllocation.gpuPageOffset, uploadBufferAllocation.bufferResource,
-		0, uploadBufferAllocation.bufferResource->GetDesc().Width);
+		uploadBufferAllocation.gpuPageOffset, dataSize);
 
-	ExecuteGPUCommands();
+	RecordUpload(dataSize);
+
+	uploadLock.unlock();
 
 	D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
 	shaderResourceViewDesc.Format = (bufferStride == 0) ? format : (bufferStride == 1) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_UNKNOWN;
@@ -279,24 +315,21 @@ Graphics::BufferId Graphics::ResourceManager::CreateBuffer(const void* data, siz
 	shaderResourceViewDesc.Buffer.StructureByteStride = static_cast<uint32_t>(bufferStride);
 
 	DescriptorAllocation shaderResourceDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
 	device->CreateShaderResourceView(bufferAllocation.bufferResource, &shaderResourceViewDesc, shaderResourceDescriptorAllocation.descriptorBase);
 
 	Buffer buffer{};
 	buffer.bufferAllocation = bufferAllocation;
 	buffer.shaderResourceViewDesc = shaderResourceViewDesc;
 	buffer.shaderResourceDescriptorAllocation = shaderResourceDescriptorAllocation;
-	buffer.currentResourceState = D3D12_RESOURCE_STATE_COPY_DEST;
-
-	bufferPool.push_back(buffer);
 
-	return BufferId(bufferPool.size() - 1);
+	return bufferPool.Insert(buffer);
 }
 
 Graphics::SamplerId Graphics::ResourceManager::CreateSampler(const D3D12_SAMPLER_DESC& samplerDesc)
 {
 	DescriptorAllocation samplerDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, samplerDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, samplerDescriptorAllocation);
 
 	device->CreateSampler(&samplerDesc, samplerDescriptorAllocation.descriptorBase);
 
@@ -304,9 +337,7 @@ Graphics::SamplerId Graphics::ResourceManager::CreateSampler(const D3D12_SAMPLER
 	sampler.samplerDesc = samplerDesc;
 	sampler.samplerDescriptorAllocation = samplerDescriptorAllocation;
 
-	samplerPool.push_back(sampler);
-
-	return SamplerId(samplerPool.size() - 1);
+	return samplerPool.Insert(sampler);
 }
 
 Graphics::RenderTargetId Graphics::ResourceManager::CreateRenderTarget(uint64_t width, uint32_t height, DXGI_FORMAT format)
@@ -329,37 +360,51 @@ Graphics::RenderTargetId Graphics::ResourceManager::CreateRenderTarget(uint64_t
 	if (textureAllocation.textureResource == nullptr)
 		throw std::exception("ResourceManager::CreateRenderTarget: Texture Resource is null!");
 
-	D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
-	shaderResourceViewDesc.Format = format;
-	shaderResourceViewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	shaderResourceViewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	shaderResourceViewDesc.Texture2D.MipLevels = 1;
+	return InsertRenderTarget(textureInfo, textureAllocation);
+}
 
-	DescriptorAllocation shaderResourceDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
-	device->CreateShaderResourceView(textureAllocation.textureResource, &shaderResourceViewDesc, shaderResourceDescriptorAllocation.descriptorBase);
+void Graphics::ResourceManager::CreateAliasedRenderTargets(const std::vector<AliasedRenderTargetDesc>& renderTargetDescs, std::vector<RenderTargetId>& renderTargetIds,
+	TextureAliasingReport& aliasingReport)
+{
+	TextureAliasingPlanner aliasingPlanner;
 
-	D3D12_RENDER_TARGET_VIEW_DESC renderTargetViewDesc{};
-	renderTargetViewDesc.Format = format;
-	renderTargetViewDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
-	
-	DescriptorAllocation renderTargetDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, renderTargetDescriptorAllocation);
+	std::vector<AliasedTextureRequest> textureRequests(renderTargetDescs.size());
 
-	device->CreateRenderTargetView(textureAllocation.textureResource, &renderTargetViewDesc, renderTargetDescriptorAllocation.descriptorBase);
+	for (size_t renderTargetId = 0; renderTargetId < renderTargetDescs.size(); renderTargetId++)
+	{
+		const auto& renderTargetDesc = renderTargetDescs[renderTargetId];
+		auto& textureRequest = textureRequests[renderTargetId];
+
+		textureRequest.resourceFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+		textureRequest.clearValue.Format = renderTargetDesc.format;
+		textureRequest.textureInfo.width = renderTargetDesc.width;
+		textureRequest.textureInfo.height = renderTargetDesc.height;
+		textureRequest.textureInfo.depth = 1;
+		textureRequest.textureInfo.mipLevels = 1;
+		textureRequest.textureInfo.format = renderTargetDesc.format;
+		textureRequest.textureInfo.dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+		textureRequest.textureInfo.srvDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+
+		auto allocationInfo = textureAllocator.GetAllocationInfo(device, textureRequest.resourceFlags, textureRequest.textureInfo);
+
+		aliasingPlanner.AddResource(allocationInfo.SizeInBytes, allocationInfo.Alignment, renderTargetDesc.firstPass, renderTargetDesc.lastPass);
+	}
 
-	RenderTarget renderTarget{};
-	renderTarget.shaderResourceViewDesc = shaderResourceViewDesc;
-	renderTarget.renderTargetViewDesc = renderTargetViewDesc;
-	renderTarget.info = textureInfo;
-	renderTarget.textureAllocation = textureAllocation;
-	renderTarget.renderTargetDescriptorAllocation = renderTargetDescriptorAllocation;
-	renderTarget.shaderResourceDescriptorAllocation = shaderResourceDescriptorAllocation;
-	renderTarget.currentResourceState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	aliasingPlanner.Plan();
+
+	for (size_t renderTargetId = 0; renderTargetId < renderTargetDescs.size(); renderTargetId++)
+		textureRequests[renderTargetId].offset = aliasingPlanner.GetOffset(renderTargetId);
+
+	std::vector<TextureAllocation> textureAllocations;
+	textureAllocator.AllocateAliased(device, aliasingPlanner.GetHeapSize(), aliasingPlanner.GetHeapAlignment(), textureRequests, textureAllocations);
 
-	renderTargetPool.push_back(renderTarget);
+	renderTargetIds.clear();
+	renderTargetIds.reserve(renderTargetDescs.size());
 
-	return RenderTargetId(renderTargetPool.size() - 1);
+	for (size_t renderTargetId = 0; renderTargetId < renderTargetDescs.size(); renderTargetId++)
+		renderTargetIds.push_back(InsertRenderTarget(textureRequests[renderTargetId].textureInfo, textureAllocations[renderTargetId]));
+
+	aliasingReport = aliasingPlanner.GetReport();
 }
 
 Graphics::DepthStencilId Graphics::ResourceManager::CreateDepthStencil(uint64_t width, uint32_t height, uint32_t depthBit)
@@ -384,6 +429,8 @@ Graphics::DepthStencilId Graphics::ResourceManager::CreateDepthStencil(uint64_t
 	if (textureAllocation.textureResource == nullptr)
 		throw std::exception("ResourceManager::CreateDepthStencil: Texture Resource is null!");
 
+	TrackResource(textureAllocation.textureResource, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
 	D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
 	shaderResourceViewDesc.Format = (depthBit == 32) ? DXGI_FORMAT_R32_FLOAT : DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
 	shaderResourceViewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
@@ -391,7 +438,7 @@ Graphics::DepthStencilId Graphics::ResourceManager::CreateDepthStencil(uint64_t
 	shaderResourceViewDesc.Texture2D.MipLevels = 1;
 
 	DescriptorAllocation shaderResourceDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
 	device->CreateShaderResourceView(textureAllocation.textureResource, &shaderResourceViewDesc, shaderResourceDescriptorAllocation.descriptorBase);
 
 	D3D12_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
@@ -399,7 +446,7 @@ Graphics::DepthStencilId Graphics::ResourceManager::CreateDepthStencil(uint64_t
 	depthStencilViewDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
 
 	DescriptorAllocation depthStencilDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, depthStencilDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, depthStencilDescriptorAllocation);
 	device->CreateDepthStencilView(textureAllocation.textureResource, &depthStencilViewDesc, depthStencilDescriptorAllocation.descriptorBase);
 
 	DepthStencil depthStencil{};
@@ -409,11 +456,8 @@ Graphics::DepthStencilId Graphics::ResourceManager::CreateDepthStencil(uint64_t
 	depthStencil.textureAllocation = textureAllocation;
 	depthStencil.depthStencilDescriptorAllocation = depthStencilDescriptorAllocation;
 	depthStencil.shaderResourceDescriptorAllocation = shaderResourceDescriptorAllocation;
-	depthStencil.currentResourceState = D3D12_RESOURCE_STATE_DEPTH_WRITE;
-
-	depthStencilPool.push_back(depthStencil);
 
-	return DepthStencilId(depthStencilPool.size() - 1);
+	return depthStencilPool.Insert(depthStencil);
 }
 
 Graphics::RWTextureId Graphics::ResourceManager::CreateRWTexture(const TextureInfo& textureInfo)
@@ -424,6 +468,8 @@ Graphics::RWTextureId Graphics::ResourceManager::CreateRWTexture(const TextureIn
 	if (textureAllocation.textureResource == nullptr)
 		throw std::exception("ResourceManager::CreateRWTexture: Texture Resource is null!");
 
+	TrackResource(textureAllocation.textureResource, D3D12_RESOURCE_STATE_COMMON);
+
 	D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
 	shaderResourceViewDesc.Format = textureInfo.format;
 	shaderResourceViewDesc.ViewDimension = textureInfo.srvDimension;
@@ -464,21 +510,24 @@ Graphics::RWTextureId Graphics::ResourceManager::CreateRWTexture(const TextureIn
 	}
 	
 	DescriptorAllocation shaderResourceDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
 	device->CreateShaderResourceView(textureAllocation.textureResource, &shaderResourceViewDesc, shaderResourceDescriptorAllocation.descriptorBase);
 
 	DescriptorAllocation unorderedAccessDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, unorderedAccessDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, unorderedAccessDescriptorAllocation);
 	device->CreateUnorderedAccessView(textureAllocation.textureResource, nullptr, &unorderedAccessViewDesc, unorderedAccessDescriptorAllocation.descriptorBase);
 	
-	DescriptorAllocation shaderNonVisibleDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, true, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderNonVisibleDescriptorAllocation);
-	device->CreateUnorderedAccessView(textureAllocation.textureResource, nullptr, &unorderedAccessViewDesc, shaderNonVisibleDescriptorAllocation.descriptorBase);
+	DescriptorAllocation shaderVisibleDescriptorAllocation{};
+	descriptorAllocator.AllocateShaderVisible(1, shaderVisibleDescriptorAllocation);
+	device->CreateUnorderedAccessView(textureAllocation.textureResource, nullptr, &unorderedAccessViewDesc, shaderVisibleDescriptorAllocation.descriptorBase);
 
-	SetResourceBarrier(commandList.Get(), textureAllocation.textureResource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_COMMON,
-		D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	std::unique_lock<std::recursive_mutex> uploadLock(uploadMutex);
 
-	ExecuteGPUCommands();
+	SetUploadResourceBarrier(textureAllocation.textureResource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+	RecordUpload(0);
+
+	uploadLock.unlock();
 
 	RWTexture rwTexture{};
 	rwTexture.shaderResourceViewDesc = shaderResourceViewDesc;
@@ -487,12 +536,9 @@ Graphics::RWTextureId Graphics::ResourceManager::CreateRWTexture(const TextureIn
 	rwTexture.textureAllocation = textureAllocation;
 	rwTexture.unorderedAccessDescriptorAllocation = unorderedAccessDescriptorAllocation;
 	rwTexture.shaderResourceDescriptorAllocation = shaderResourceDescriptorAllocation;
-	rwTexture.shaderNonVisibleDescriptorAllocation = shaderNonVisibleDescriptorAllocation;
-	rwTexture.currentResourceState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-
-	rwTexturePool.push_back(rwTexture);
+	rwTexture.shaderVisibleDescriptorAllocation = shaderVisibleDescriptorAllocation;
 
-	return RWTextureId(rwTexturePool.size() - 1);
+	return rwTexturePool.Insert(rwTexture);
 }
 
 Graphics::RWBufferId Graphics::ResourceManager::CreateRWBuffer(const void* initialData, size_t dataSize, size_t bufferStride, size_t numElements, DXGI_FORMAT format,
@@ -501,8 +547,10 @@ Graphics::RWBufferId Graphics::ResourceManager::CreateRWBuffer(const void* initi
 	BufferAllocation bufferAllocation{};
 	bufferAllocator.AllocateUnorderedAccess(device, dataSize, 64 * _KB, bufferAllocation);
 
+	std::unique_lock<std::recursive_mutex> uploadLock(uploadMutex);
+
 	BufferAllocation uploadBufferAllocation{};
-	bufferAllocator.AllocateTemporary(device, dataSize, D3D12_HEAP_TYPE_UPLOAD, uploadBufferAllocation);
+	AllocateStagingMemory(dataSize, 4, uploadBufferAllocation);
 
 	if (bufferAllocation.bufferResource == nullptr)
 		throw std::exception("ResourceManager::CreateRWBuffer: RWBuffer Resource is null!");
@@ -510,18 +558,20 @@ Graphics::RWBufferId Graphics::ResourceManager::CreateRWBuffer(const void* initi
 	if (uploadBufferAllocation.bufferResource == nullptr)
 		throw std::exception("ResourceManager::CreateRWBuffer: Upload Buffer Resource is null!");
 
+	TrackResource(bufferAllocation.bufferResource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
 	std::copy(reinterpret_cast<const uint8_t*>(initialData), reinterpret_cast<const uint8_t*>(initialData) + dataSize, uploadBufferAllocation.cpuAddress);
 
-	SetResourceBarrier(commandList.Get(), bufferAllocation.bufferResource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
-		D3D12_RESOURCE_STATE_COPY_DEST);
+	SetUploadResourceBarrier(bufferAllocation.bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
 
 	commandList->CopyBufferRegion(bufferAllocation.bufferResource, bufferAllocation.gpuPageOffset, uploadBufferAllocation.bufferResource,
-		0, uploadBufferAllocation.bufferResource->GetDesc().Width);
+		uploadBufferAllocation.gpuPageOffset, dataSize);
 
-	SetResourceBarrier(commandList.Get(), bufferAllocation.bufferResource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST,
-		D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	SetUploadResourceBarrier(bufferAllocation.bufferResource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 
-	ExecuteGPUCommands();
+	RecordUpload(dataSize);
+
+	uploadLock.unlock();
 
 	D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
 	shaderResourceViewDesc.Format = (bufferStride == 0) ? format : (bufferStride == 1) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_UNKNOWN;
@@ -532,7 +582,7 @@ Graphics::RWBufferId Graphics::ResourceManager::CreateRWBuffer(const void* initi
 	shaderResourceViewDesc.Buffer.StructureByteStride = (bufferStride > 1) ? static_cast<uint32_t>(bufferStride) : 0u;
 
 	DescriptorAllocation shaderResourceDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
 	device->CreateShaderResourceView(bufferAllocation.bufferResource, &shaderResourceViewDesc, shaderResourceDescriptorAllocation.descriptorBase);
 
 	D3D12_UNORDERED_ACCESS_VIEW_DESC unorderedAccessViewDesc{};
@@ -543,16 +593,16 @@ Graphics::RWBufferId Graphics::ResourceManager::CreateRWBuffer(const void* initi
 	unorderedAccessViewDesc.Buffer.StructureByteStride = (bufferStride > 1) ? static_cast<uint32_t>(bufferStride) : 0u;
 	
 	DescriptorAllocation unorderedAccessDescriptorAllocation{};
-	descriptorAllocator.Allocate(device, false, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, unorderedAccessDescriptorAllocation);
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, unorderedAccessDescriptorAllocation);
 
-	DescriptorAllocation shaderNonVisibleDescriptorAllocation{};
+	DescriptorAllocation shaderVisibleDescriptorAllocation{};
 	
 	if (bufferStride <= 1)
 	{
-		descriptorAllocator.Allocate(device, true, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderNonVisibleDescriptorAllocation);
+		descriptorAllocator.AllocateShaderVisible(1, shaderVisibleDescriptorAllocation);
 
 		device->CreateUnorderedAccessView(bufferAllocation.bufferResource, nullptr, &unorderedAccessViewDesc, unorderedAccessDescriptorAllocation.descriptorBase);
-		device->CreateUnorderedAccessView(bufferAllocation.bufferResource, nullptr, &unorderedAccessViewDesc, shaderNonVisibleDescriptorAllocation.descriptorBase);
+		device->CreateUnorderedAccessView(bufferAllocation.bufferResource, nullptr, &unorderedAccessViewDesc, shaderVisibleDescriptorAllocation.descriptorBase);
 	}
 	else
 	{
@@ -576,12 +626,9 @@ Graphics::RWBufferId Graphics::ResourceManager::CreateRWBuffer(const void* initi
 	rwBuffer.unorderedAccessViewDesc = unorderedAccessViewDesc;
 	rwBuffer.unorderedAccessDescriptorAllocation = unorderedAccessDescriptorAllocation;
 	rwBuffer.shaderResourceDescriptorAllocation = shaderResourceDescriptorAllocation;
-	rwBuffer.shaderNonVisibleDescriptorAllocation = shaderNonVisibleDescriptorAllocation;
-	rwBuffer.currentResourceState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+	rwBuffer.shaderVisibleDescriptorAllocation = shaderVisibleDescriptorAllocation;
 	
-	rwBufferPool.push_back(rwBuffer);
-
-	return RWBufferId(rwBufferPool.size() - 1);
+	return rwBufferPool.Insert(rwBuffer);
 }
 
 void Graphics::ResourceManager::CreateSwapChainBuffers(IDXGISwapChain4* swapChain, uint32_t buffersCount)
@@ -590,7 +637,7 @@ void Graphics::ResourceManager::CreateSwapChainBuffers(IDXGISwapChain4* swapChai
 	{
 		DescriptorAllocation renderTargetDescriptorAllocation{};
 
-		descriptorAllocator.Allocate(device, false, buffersCount, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, renderTargetDescriptorAllocation);
+		descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, renderTargetDescriptorAllocation);
 		swapChainDescriptorBases.push_back(renderTargetDescriptorAllocation.descriptorBase);
 
 		swapChainBuffers.push_back(nullptr);
@@ -598,58 +645,58 @@ void Graphics::ResourceManager::CreateSwapChainBuffers(IDXGISwapChain4* swapChai
 
 		device->CreateRenderTargetView(swapChainBuffers.back().Get(), nullptr, swapChainDescriptorBases.back());
 
-		swapChainStates.push_back(D3D12_RESOURCE_STATE_PRESENT);
+		TrackResource(swapChainBuffers.back().Get(), D3D12_RESOURCE_STATE_PRESENT);
 	}
 }
 
 const Graphics::VertexBuffer& Graphics::ResourceManager::GetVertexBuffer(const VertexBufferId& resourceId) const
 {
-	return vertexBufferPool[resourceId.value];
+	return vertexBufferPool.Get(resourceId);
 }
 
 const Graphics::IndexBuffer& Graphics::ResourceManager::GetIndexBuffer(const IndexBufferId& resourceId) const
 {
-	return indexBufferPool[resourceId.value];
+	return indexBufferPool.Get(resourceId);
 }
 
 const Graphics::ConstantBuffer& Graphics::ResourceManager::GetConstantBuffer(const ConstantBufferId& resourceId) const
 {
-	return constantBufferPool[resourceId.value];
+	return constantBufferPool.Get(resourceId);
 }
 
 const Graphics::Texture& Graphics::ResourceManager::GetTexture(const TextureId& resourceId) const
 {
-	return texturePool[resourceId.value];
+	return texturePool.Get(resourceId);
 }
 
 const Graphics::Buffer& Graphics::ResourceManager::GetBuffer(const BufferId& resourceId) const
 {
-	return bufferPool[resourceId.value];
+	return bufferPool.Get(resourceId);
 }
 
 const Graphics::Sampler& Graphics::ResourceManager::GetSampler(const SamplerId& resourceId) const
 {
-	return samplerPool[resourceId.value];
+	return samplerPool.Get(resourceId);
 }
 
 const Graphics::RenderTarget& Graphics::ResourceManager::GetRenderTarget(const RenderTargetId& resourceId) const
 {
-	return renderTargetPool[resourceId.value];
+	return renderTargetPool.Get(resourceId);
 }
 
 const Graphics::DepthStencil& Graphics::ResourceManager::GetDepthStencil(const DepthStencilId& resourceId) const
 {
-	return depthStencilPool[resourceId.value];
+	return depthStencilPool.Get(resourceId);
 }
 
 const Graphics::RWTexture& Graphics::ResourceManager::GetRWTexture(const RWTextureId& resourceId) const
 {
-	return rwTexturePool[resourceId.value];
+	return rwTexturePool.Get(resourceId);
 }
 
 const Graphics::RWBuffer& Graphics::ResourceManager::GetRWBuffer(const RWBufferId& resourceId) const
 {
-	return rwBufferPool[resourceId.value];
+	return rwBufferPool.Get(resourceId);
 }
 
 const D3D12_CPU_DESCRIPTOR_HANDLE& Graphics::ResourceManager::GetSwapChainDescriptorBase(uint32_t bufferId) const
@@ -664,8 +711,15 @@ ID3D12Resource* Graphics::ResourceManager::GetSwapChainBuffer(uint32_t bufferId)
 
 void Graphics::ResourceManager::ResetSwapChainBuffers(IDXGISwapChain4* swapChain)
 {
-	for (auto& swapChainBuffer : swapChainBuffers)
-		swapChainBuffer.Reset();
+	{
+		std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+		for (auto& swapChainBuffer : swapChainBuffers)
+		{
+			stateTracker->UnregisterResource(swapChainBuffer.Get());
+			swapChainBuffer.Reset();
+		}
+	}
 
 	DXGI_SWAP_CHAIN_DESC1 swapChainDesc{};
 	swapChain->GetDesc1(&swapChainDesc);
@@ -677,231 +731,546 @@ void Graphics::ResourceManager::ResetSwapChainBuffers(IDXGISwapChain4* swapChain
 	{
 		swapChain->GetBuffer(swapChainBufferId, IID_PPV_ARGS(&swapChainBuffers[swapChainBufferId]));
 		device->CreateRenderTargetView(swapChainBuffers[swapChainBufferId].Get(), nullptr, swapChainDescriptorBases[swapChainBufferId]);
+
+		TrackResource(swapChainBuffers[swapChainBufferId].Get(), D3D12_RESOURCE_STATE_PRESENT);
 	}
 }
 
-D3D12_VERTEX_BUFFER_VIEW Graphics::ResourceManager::GetVertexBufferView(const VertexBufferId& resourceId) const
+D3D12_VERTEX_BUFFER_VIEW Graphics::ResourceManager::GetVertexBufferView(const VertexBufferId& resourceId)
 {
-	return vertexBufferPool[resourceId.value].vertexBufferView;
+	auto& vertexBuffer = vertexBufferPool.Get(resourceId);
+
+	if (vertexBuffer.isRingBacked && vertexBuffer.uploadFrame != uploadRing->GetFrameIndex())
+	{
+		UploadAllocation uploadAllocation{};
+		UploadDynamicData(vertexBuffer.dynamicData, DYNAMIC_VERTEX_DATA_ALIGNMENT, uploadAllocation);
+
+		vertexBuffer.vertexBufferView.BufferLocation = uploadAllocation.gpuAddress;
+		vertexBuffer.uploadFrame = uploadRing->GetFrameIndex();
+	}
+
+	return vertexBuffer.vertexBufferView;
 }
 
 D3D12_INDEX_BUFFER_VIEW Graphics::ResourceManager::GetIndexBufferView(const IndexBufferId& resourceId) const
 {
-	return indexBufferPool[resourceId.value].indexBufferView;
+	return indexBufferPool.Get(resourceId).indexBufferView;
 }
 
 const D3D12_CPU_DESCRIPTOR_HANDLE& Graphics::ResourceManager::GetRenderTargetDescriptorBase(const RenderTargetId& resourceId) const
 {
-	return renderTargetPool[resourceId.value].renderTargetDescriptorAllocation.descriptorBase;
+	return renderTargetPool.Get(resourceId).renderTargetDescriptorAllocation.descriptorBase;
 }
 
 const D3D12_CPU_DESCRIPTOR_HANDLE& Graphics::ResourceManager::GetDepthStencilDescriptorBase(const DepthStencilId& resourceId) const
 {
-	return depthStencilPool[resourceId.value].depthStencilDescriptorAllocation.descriptorBase;
+	return depthStencilPool.Get(resourceId).depthStencilDescriptorAllocation.descriptorBase;
 }
 
-ID3D12DescriptorHeap* Graphics::ResourceManager::GetShaderResourceViewDescriptorHeap()
+void Graphics::ResourceManager::StageDescriptors(const std::vector<D3D12_CPU_DESCRIPTOR_HANDLE>& sourceDescriptors, DescriptorAllocation& allocation)
+{
+	descriptorAllocator.StageDescriptors(device, sourceDescriptors, allocation);
+}
+
+uint64_t Graphics::ResourceManager::GetDescriptorFrameIndex() const noexcept
+{
+	return descriptorAllocator.GetFrameIndex();
+}
+
+Graphics::DescriptorAllocatorStatistics Graphics::ResourceManager::GetDescriptorStatistics() const noexcept
 {
-	if (texturePool.empty())
-		return nullptr;
+	return descriptorAllocator.GetStatistics();
+}
 
-	return texturePool.front().shaderResourceDescriptorAllocation.descriptorHeap;
+ID3D12DescriptorHeap* Graphics::ResourceManager::GetShaderResourceViewDescriptorHeap()
+{
+	return descriptorAllocator.GetShaderVisibleDescriptorHeap();
 }
 
 void Graphics::ResourceManager::GetTextureDataFromGPU(TextureId textureId, std::vector<float4>& rawTextureData)
 {
-	auto& resource = texturePool[textureId.value];
+	auto& resource = texturePool.Get(textureId);
 
-	GetTextureDataFromGPU(resource.textureAllocation.textureResource, resource.info, resource.currentResourceState, rawTextureData);
+	GetTextureDataFromGPU(resource.textureAllocation.textureResource, resource.info, rawTextureData);
 }
 
 void Graphics::ResourceManager::GetTextureDataFromGPU(RenderTargetId textureId, std::vector<float4>& rawTextureData)
 {
-	auto& resource = renderTargetPool[textureId.value];
+	auto& resource = renderTargetPool.Get(textureId);
 
-	GetTextureDataFromGPU(resource.textureAllocation.textureResource, resource.info, resource.currentResourceState, rawTextureData);
+	GetTextureDataFromGPU(resource.textureAllocation.textureResource, resource.info, rawTextureData);
 }
 
 void Graphics::ResourceManager::GetTextureDataFromGPU(DepthStencilId textureId, std::vector<float4>& rawTextureData)
 {
-	auto& resource = depthStencilPool[textureId.value];
+	auto& resource = depthStencilPool.Get(textureId);
 
-	GetTextureDataFromGPU(resource.textureAllocation.textureResource, resource.info, resource.currentResourceState, rawTextureData);
+	GetTextureDataFromGPU(resource.textureAllocation.textureResource, resource.info, rawTextureData);
 }
 
 void Graphics::ResourceManager::GetTextureDataFromGPU(RWTextureId textureId, std::vector<float4>& rawTextureData)
 {
-	auto& resource = rwTexturePool[textureId.value];
+	auto& resource = rwTexturePool.Get(textureId);
 
-	GetTextureDataFromGPU(resource.textureAllocation.textureResource, resource.info, resource.currentResourceState, rawTextureData);
+	GetTextureDataFromGPU(resource.textureAllocation.textureResource, resource.info, rawTextureData);
 }
 
 void Graphics::ResourceManager::GetBufferDataFromGPU(VertexBufferId bufferId, std::vector<uint8_t>& rawBufferData)
 {
-	auto& resource = vertexBufferPool[bufferId.value];
+	auto& resource = vertexBufferPool.Get(bufferId);
+
+	if (resource.isRingBacked)
+	{
+		rawBufferData = resource.dynamicData;
+
+		return;
+	}
 
-	GetBufferDataFromGPU(resource.vertexBufferAllocation.bufferResource, resource.vertexBufferAllocation.nonAlignedSizeInBytes, resource.currentResourceState,
-		rawBufferData);
+	GetBufferDataFromGPU(resource.vertexBufferAllocation.bufferResource, resource.vertexBufferAllocation.nonAlignedSizeInBytes, rawBufferData);
 }
 
 void Graphics::ResourceManager::GetBufferDataFromGPU(IndexBufferId bufferId, std::vector<uint8_t>& rawBufferData)
 {
-	auto& resource = indexBufferPool[bufferId.value];
+	auto& resource = indexBufferPool.Get(bufferId);
 
-	GetBufferDataFromGPU(resource.indexBufferAllocation.bufferResource, resource.indexBufferAllocation.nonAlignedSizeInBytes, resource.currentResourceState,
-		rawBufferData);
+	GetBufferDataFromGPU(resource.indexBufferAllocation.bufferResource, resource.indexBufferAllocation.nonAlignedSizeInBytes, rawBufferData);
 }
 
 void Graphics::ResourceManager::GetBufferDataFromGPU(ConstantBufferId bufferId, std::vector<uint8_t>& rawBufferData)
 {
-	auto& resource = constantBufferPool[bufferId.value];
+	auto& resource = constantBufferPool.Get(bufferId);
 
-	GetBufferDataFromGPU(resource.uploadBufferAllocation.bufferResource, resource.uploadBufferAllocation.nonAlignedSizeInBytes, resource.currentResourceState,
-		rawBufferData);
+	if (resource.isRingBacked)
+	{
+		rawBufferData = resource.dynamicData;
+
+		return;
+	}
+
+	GetBufferDataFromGPU(resource.uploadBufferAllocation.bufferResource, resource.uploadBufferAllocation.nonAlignedSizeInBytes, rawBufferData);
 }
 
 void Graphics::ResourceManager::GetBufferDataFromGPU(BufferId bufferId, std::vector<uint8_t>& rawBufferData)
 {
-	auto& resource = bufferPool[bufferId.value];
+	auto& resource = bufferPool.Get(bufferId);
 
-	GetBufferDataFromGPU(resource.bufferAllocation.bufferResource, resource.bufferAllocation.nonAlignedSizeInBytes, resource.currentResourceState, rawBufferData);
+	GetBufferDataFromGPU(resource.bufferAllocation.bufferResource, resource.bufferAllocation.nonAlignedSizeInBytes, rawBufferData);
 }
 
 void Graphics::ResourceManager::GetBufferDataFromGPU(RWBufferId bufferId, std::vector<uint8_t>& rawBufferData)
 {
-	auto& resource = rwBufferPool[bufferId.value];
+	auto& resource = rwBufferPool.Get(bufferId);
 
-	GetBufferDataFromGPU(resource.bufferAllocation.bufferResource, resource.bufferAllocation.nonAlignedSizeInBytes, resource.currentResourceState, rawBufferData);
+	GetBufferDataFromGPU(resource.bufferAllocation.bufferResource, resource.bufferAllocation.nonAlignedSizeInBytes, rawBufferData);
 }
 
 void Graphics::ResourceManager::UpdateDynamicVertexBuffer(const VertexBufferId& resourceId, const void* data, size_t dataSize)
 {
-	std::copy(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + dataSize,
-		vertexBufferPool[resourceId.value].vertexBufferAllocation.cpuAddress);
+	auto& vertexBuffer = vertexBufferPool.Get(resourceId);
+
+	if (dataSize > vertexBuffer.vertexBufferAllocation.nonAlignedSizeInBytes)
+		throw std::exception("ResourceManager::UpdateDynamicVertexBuffer: Data size exceeds buffer size");
+
+	vertexBuffer.dynamicData.assign(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + dataSize);
+
+	// The data goes to a fresh part of the upload ring, so frames still in flight keep reading their own copy
+	UploadAllocation uploadAllocation{};
+	UploadDynamicData(vertexBuffer.dynamicData, DYNAMIC_VERTEX_DATA_ALIGNMENT, uploadAllocation);
+
+	vertexBuffer.vertexBufferView.BufferLocation = uploadAllocation.gpuAddress;
+	vertexBuffer.vertexBufferView.SizeInBytes = static_cast<uint32_t>(dataSize);
+	vertexBuffer.uploadFrame = uploadRing->GetFrameIndex();
+	vertexBuffer.isRingBacked = true;
 }
 
 void Graphics::ResourceManager::UpdateConstantBuffer(const ConstantBufferId& resourceId, const void* data, size_t dataSize)
 {
-	std::copy(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + dataSize,
-		constantBufferPool[resourceId.value].uploadBufferAllocation.cpuAddress);
+	auto& constantBuffer = constantBufferPool.Get(resourceId);
+
+	if (dataSize > constantBuffer.constantBufferViewDesc.SizeInBytes)
+		throw std::exception("ResourceManager::UpdateConstantBuffer: Data size exceeds buffer size");
+
+	constantBuffer.dynamicData.assign(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + dataSize);
+
+	UploadAllocation uploadAllocation{};
+	UploadDynamicData(constantBuffer.dynamicData, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, uploadAllocation);
+
+	constantBuffer.gpuAddress = uploadAllocation.gpuAddress;
+	constantBuffer.uploadFrame = uploadRing->GetFrameIndex();
+	constantBuffer.isRingBacked = true;
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const VertexBufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
-	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+D3D12_GPU_VIRTUAL_ADDRESS Graphics::ResourceManager::GetConstantBufferAddress(const ConstantBufferId& resourceId)
 {
-	auto& resource = vertexBufferPool[resourceId.value];
+	auto& constantBuffer = constantBufferPool.Get(resourceId);
+
+	// Data written in an earlier frame may already be overwritten in the ring, so it is copied again for the current frame
+	if (constantBuffer.isRingBacked && constantBuffer.uploadFrame != uploadRing->GetFrameIndex())
+	{
+		UploadAllocation uploadAllocation{};
+		UploadDynamicData(constantBuffer.dynamicData, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, uploadAllocation);
 
-	SetResourceBarrier(_commandList, resource.vertexBufferAllocation.bufferResource, resourceBarrierFlags, resource.currentResourceState, resourceBarrierStateAfter);
+		constantBuffer.gpuAddress = uploadAllocation.gpuAddress;
+		constantBuffer.uploadFrame = uploadRing->GetFrameIndex();
+	}
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		resource.currentResourceState = resourceBarrierStateAfter;
+	return constantBuffer.gpuAddress;
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const IndexBufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
-	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+void Graphics::ResourceManager::AllocateUploadMemory(size_t size, size_t alignment, UploadAllocation& allocation)
 {
-	auto& resource = indexBufferPool[resourceId.value];
+	uint64_t offset;
 
-	SetResourceBarrier(_commandList, resource.indexBufferAllocation.bufferResource, resourceBarrierFlags, resource.currentResourceState, resourceBarrierStateAfter);
+	if (!uploadRing->Allocate(size, alignment, offset))
+		throw std::exception("ResourceManager::AllocateUploadMemory: Upload ring is full");
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		resource.currentResourceState = resourceBarrierStateAfter;
+	allocation.cpuAddress = uploadRingAllocation.cpuAddress + offset;
+	allocation.gpuAddress = uploadRingAllocation.gpuAddress + offset;
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const TextureId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
-	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+void Graphics::ResourceManager::FinishUploadFrame(uint64_t frameFenceValue)
 {
-	auto& resource = texturePool[resourceId.value];
+	uploadRing->FinishFrame(frameFenceValue);
+	descriptorAllocator.FinishFrame(frameFenceValue);
+
+	vertexBufferPool.AssignReleaseFence(frameFenceValue);
+	indexBufferPool.AssignReleaseFence(frameFenceValue);
+	constantBufferPool.AssignReleaseFence(frameFenceValue);
+	texturePool.AssignReleaseFence(frameFenceValue);
+	bufferPool.AssignReleaseFence(frameFenceValue);
+	samplerPool.AssignReleaseFence(frameFenceValue);
+	renderTargetPool.AssignReleaseFence(frameFenceValue);
+	depthStencilPool.AssignReleaseFence(frameFenceValue);
+	rwTexturePool.AssignReleaseFence(frameFenceValue);
+	rwBufferPool.AssignReleaseFence(frameFenceValue);
+}
+
+void Graphics::ResourceManager::ReleaseCompletedUploads(uint64_t completedFenceValue)
+{
+	uploadRing->ReleaseCompletedFrames(completedFenceValue);
+	descriptorAllocator.ReleaseCompletedFrames(completedFenceValue);
+}
+
+void Graphics::ResourceManager::ReleaseCompletedResources(uint64_t completedFenceValue)
+{
+	vertexBufferPool.ReleaseCompleted(completedFenceValue, [this](VertexBuffer& resource) { ReleaseBufferAllocation(resource.vertexBufferAllocation); });
+	indexBufferPool.ReleaseCompleted(completedFenceValue, [this](IndexBuffer& resource) { ReleaseBufferAllocation(resource.indexBufferAllocation); });
+
+	constantBufferPool.ReleaseCompleted(completedFenceValue, [this](ConstantBuffer& resource)
+	{
+		ReleaseBufferAllocation(resource.uploadBufferAllocation);
+		ReleaseDescriptorAllocation(resource.bufferDescriptorAllocation);
+	});
+
+	texturePool.ReleaseCompleted(completedFenceValue, [this](Texture& resource)
+	{
+		ReleaseTextureAllocation(resource.textureAllocation);
+		ReleaseDescriptorAllocation(resource.shaderResourceDescriptorAllocation);
+	});
+
+	bufferPool.ReleaseCompleted(completedFenceValue, [this](Buffer& resource)
+	{
+		ReleaseBufferAllocation(resource.bufferAllocation);
+		ReleaseDescriptorAllocation(resource.shaderResourceDescriptorAllocation);
+	});
 
-	SetResourceBarrier(_commandList, resource.textureAllocation.textureResource, resourceBarrierFlags, resource.currentResourceState, resourceBarrierStateAfter);
+	samplerPool.ReleaseCompleted(completedFenceValue, [this](Sampler& resource) { ReleaseDescriptorAllocation(resource.samplerDescriptorAllocation); });
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		resource.currentResourceState = resourceBarrierStateAfter;
+	renderTargetPool.ReleaseCompleted(completedFenceValue, [this](RenderTarget& resource)
+	{
+		ReleaseTextureAllocation(resource.textureAllocation);
+		ReleaseDescriptorAllocation(resource.shaderResourceDescriptorAllocation);
+		ReleaseDescriptorAllocation(resource.renderTargetDescriptorAllocation);
+	});
+
+	depthStencilPool.ReleaseCompleted(completedFenceValue, [this](DepthStencil& resource)
+	{
+		ReleaseTextureAllocation(resource.textureAllocation);
+		ReleaseDescriptorAllocation(resource.shaderResourceDescriptorAllocation);
+		ReleaseDescriptorAllocation(resource.depthStencilDescriptorAllocation);
+	});
+
+	rwTexturePool.ReleaseCompleted(completedFenceValue, [this](RWTexture& resource)
+	{
+		ReleaseTextureAllocation(resource.textureAllocation);
+		ReleaseDescriptorAllocation(resource.shaderResourceDescriptorAllocation);
+		ReleaseDescriptorAllocation(resource.unorderedAccessDescriptorAllocation);
+		ReleaseDescriptorAllocation(resource.shaderVisibleDescriptorAllocation);
+	});
+
+	rwBufferPool.ReleaseCompleted(completedFenceValue, [this](RWBuffer& resource)
+	{
+		ReleaseBufferAllocation(resource.bufferAllocation);
+		ReleaseDescriptorAllocation(resource.shaderResourceDescriptorAllocation);
+		ReleaseDescriptorAllocation(resource.unorderedAccessDescriptorAllocation);
+		ReleaseDescriptorAllocation(resource.shaderVisibleDescriptorAllocation);
+	});
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const BufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
-	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+Graphics::ResourcePoolStatistics Graphics::ResourceManager::GetResourcePoolStatistics() const noexcept
 {
-	auto& resource = bufferPool[resourceId.value];
+	ResourcePoolStatistics statistics{};
 
-	SetResourceBarrier(_commandList, resource.bufferAllocation.bufferResource, resourceBarrierFlags, resource.currentResourceState, resourceBarrierStateAfter);
+	auto accumulate = [&statistics](const ResourcePoolStatistics& poolStatistics)
+	{
+		statistics.insertionsCount += poolStatistics.insertionsCount;
+		statistics.releasesCount += poolStatistics.releasesCount;
+		statistics.destructionsCount += poolStatistics.destructionsCount;
+		statistics.reusedSlotsCount += poolStatistics.reusedSlotsCount;
+	};
+
+	accumulate(vertexBufferPool.GetStatistics());
+	accumulate(indexBufferPool.GetStatistics());
+	accumulate(constantBufferPool.GetStatistics());
+	accumulate(texturePool.GetStatistics());
+	accumulate(bufferPool.GetStatistics());
+	accumulate(samplerPool.GetStatistics());
+	accumulate(renderTargetPool.GetStatistics());
+	accumulate(depthStencilPool.GetStatistics());
+	accumulate(rwTexturePool.GetStatistics());
+	accumulate(rwBufferPool.GetStatistics());
+
+	return statistics;
+}
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		resource.currentResourceState = resourceBarrierStateAfter;
+const Graphics::UploadRingStatistics& Graphics::ResourceManager::GetUploadRingStatistics() const noexcept
+{
+	return uploadRing->GetStatistics();
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const RenderTargetId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
-	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+Graphics::UploadTicket Graphics::ResourceManager::GetUploadTicket() const noexcept
 {
-	auto& resource = renderTargetPool[resourceId.value];
+	std::lock_guard<std::recursive_mutex> uploadLock(uploadMutex);
 
-	SetResourceBarrier(_commandList, resource.textureAllocation.textureResource, resourceBarrierFlags, resource.currentResourceState, resourceBarrierStateAfter);
+	if (uploadBatcher->HasPendingUploads())
+		return { uploadBatcher->GetCurrentBatchId() };
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		resource.currentResourceState = resourceBarrierStateAfter;
+	return { uploadBatcher->GetLastFlushedBatchId() };
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const DepthStencilId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
-	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+Graphics::UploadTicket Graphics::ResourceManager::FlushUploads()
 {
-	auto& resource = depthStencilPool[resourceId.value];
+	std::lock_guard<std::recursive_mutex> uploadLock(uploadMutex);
 
-	SetResourceBarrier(_commandList, resource.textureAllocation.textureResource, resourceBarrierFlags, resource.currentResourceState, resourceBarrierStateAfter);
+	if (uploadBatcher->HasPendingUploads())
+		SubmitUploadBatch(true);
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		resource.currentResourceState = resourceBarrierStateAfter;
+	return { uploadBatcher->GetLastFlushedBatchId() };
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const RWTextureId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+bool Graphics::ResourceManager::IsUploadComplete(const UploadTicket& ticket) const
+{
+	std::lock_guard<std::recursive_mutex> uploadLock(uploadMutex);
+
+	return uploadBatcher->IsComplete(ticket, fence->GetCompletedValue());
+}
+
+void Graphics::ResourceManager::WaitForUpload(const UploadTicket& ticket)
+{
+	std::lock_guard<std::recursive_mutex> uploadLock(uploadMutex);
+
+	if (ticket.batchId == uploadBatcher->GetCurrentBatchId())
+		SubmitUploadBatch(true);
+
+	if (fence->GetCompletedValue() < ticket.batchId)
+	{
+		ThrowIfFailed(fence->SetEventOnCompletion(ticket.batchId, fenceEvent), "ResourceManager::WaitForUpload: Fence error!");
+
+		WaitForSingleObjectEx(fenceEvent, INFINITE, false);
+
+		uploadBatcher->RegisterWait();
+	}
+
+	stagingRing->ReleaseCompletedFrames(fence->GetCompletedValue());
+}
+
+void Graphics::ResourceManager::SynchronizeUploads(ID3D12CommandQueue* queue)
+{
+	std::lock_guard<std::recursive_mutex> uploadLock(uploadMutex);
+
+	UploadTicket ticket = FlushUploads();
+
+	// The wait is queued on the GPU, the CPU keeps recording while the copies are in flight
+	if (!IsUploadComplete(ticket))
+		ThrowIfFailed(queue->Wait(fence.Get(), ticket.batchId), "ResourceManager::SynchronizeUploads: Queue wait error!");
+}
+
+const Graphics::UploadBatchStatistics& Graphics::ResourceManager::GetUploadBatchStatistics() const noexcept
+{
+	return uploadBatcher->GetStatistics();
+}
+
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const VertexBufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
 	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
 {
-	auto& resource = rwTexturePool[resourceId.value];
+	SetResourceBarrier(_commandList, vertexBufferPool.Get(resourceId).vertexBufferAllocation.bufferResource, resourceBarrierFlags, resourceBarrierStateAfter);
+}
 
-	SetResourceBarrier(_commandList, resource.textureAllocation.textureResource, resourceBarrierFlags, resource.currentResourceState, resourceBarrierStateAfter);
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const IndexBufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+{
+	SetResourceBarrier(_commandList, indexBufferPool.Get(resourceId).indexBufferAllocation.bufferResource, resourceBarrierFlags, resourceBarrierStateAfter);
+}
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		resource.currentResourceState = resourceBarrierStateAfter;
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const TextureId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+{
+	SetResourceBarrier(_commandList, texturePool.Get(resourceId).textureAllocation.textureResource, resourceBarrierFlags, resourceBarrierStateAfter);
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const RWBufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const BufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
 	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
 {
-	auto& resource = rwBufferPool[resourceId.value];
+	SetResourceBarrier(_commandList, bufferPool.Get(resourceId).bufferAllocation.bufferResource, resourceBarrierFlags, resourceBarrierStateAfter);
+}
 
-	SetResourceBarrier(_commandList, resource.bufferAllocation.bufferResource, resourceBarrierFlags, resource.currentResourceState, resourceBarrierStateAfter);
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const RenderTargetId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+{
+	SetResourceBarrier(_commandList, renderTargetPool.Get(resourceId).textureAllocation.textureResource, resourceBarrierFlags, resourceBarrierStateAfter);
+}
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		resource.currentResourceState = resourceBarrierStateAfter;
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const DepthStencilId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+{
+	SetResourceBarrier(_commandList, depthStencilPool.Get(resourceId).textureAllocation.textureResource, resourceBarrierFlags, resourceBarrierStateAfter);
 }
 
-void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, size_t swapChainBufferId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const RWTextureId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
 	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
 {
-	SetResourceBarrier(_commandList, swapChainBuffers[swapChainBufferId].Get(), resourceBarrierFlags, swapChainStates[swapChainBufferId], resourceBarrierStateAfter);
+	SetResourceBarrier(_commandList, rwTexturePool.Get(resourceId).textureAllocation.textureResource, resourceBarrierFlags, resourceBarrierStateAfter);
+}
 
-	if (resourceBarrierFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
-		swapChainStates[swapChainBufferId] = resourceBarrierStateAfter;
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const RWBufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+{
+	SetResourceBarrier(_commandList, rwBufferPool.Get(resourceId).bufferAllocation.bufferResource, resourceBarrierFlags, resourceBarrierStateAfter);
+}
+
+void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, size_t swapChainBufferId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
+	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+{
+	SetResourceBarrier(_commandList, swapChainBuffers[swapChainBufferId].Get(), resourceBarrierFlags, resourceBarrierStateAfter);
 }
 
 void Graphics::ResourceManager::SetUAVBarrier(ID3D12GraphicsCommandList* _commandList, const RWTextureId& resourceId)
 {
-	SetUAVBarrier(_commandList, rwTexturePool[resourceId.value].textureAllocation.textureResource);
+	SetUAVBarrier(_commandList, rwTexturePool.Get(resourceId).textureAllocation.textureResource);
 }
 
 void Graphics::ResourceManager::SetUAVBarrier(ID3D12GraphicsCommandList* _commandList, const RWBufferId& resourceId)
 {
-	SetUAVBarrier(_commandList, rwBufferPool[resourceId.value].bufferAllocation.bufferResource);
+	SetUAVBarrier(_commandList, rwBufferPool.Get(resourceId).bufferAllocation.bufferResource);
+}
+
+void Graphics::ResourceManager::AcquireAliasedRenderTarget(ID3D12GraphicsCommandList* _commandList, const RenderTargetId& resourceId)
+{
+	auto resource = renderTargetPool.Get(resourceId).textureAllocation.textureResource;
+
+	CheckResourceBarrierBatch(_commandList);
+
+	std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+	stateTracker->SetAliasingBarrier(nullptr, resource);
+	stateTracker->TransitionResource(resource, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+	// Memory shared with other placed targets holds undefined data, a discard is the cheapest valid first write
+	stateTracker->FlushBarriers(_commandList);
+
+	_commandList->DiscardResource(resource, nullptr);
+}
+
+void Graphics::ResourceManager::BeginResourceBarrierBatch()
+{
+	if (isResourceBarrierBatchOpen)
+		throw std::exception("ResourceManager::BeginResourceBarrierBatch: Barrier batch is already open");
+
+	isResourceBarrierBatchOpen = true;
+	resourceBarrierBatchCommandList = nullptr;
+}
+
+void Graphics::ResourceManager::FlushResourceBarriers(ID3D12GraphicsCommandList* _commandList)
+{
+	CheckResourceBarrierBatch(_commandList);
+
+	{
+		std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+		stateTracker->FlushBarriers(_commandList);
+	}
+
+	isResourceBarrierBatchOpen = false;
+	resourceBarrierBatchCommandList = nullptr;
+}
+
+void Graphics::ResourceManager::SetSplitBarriersEnabled(bool isEnabled) noexcept
+{
+	std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+	stateTracker->SetSplitBarriersEnabled(isEnabled);
+}
+
+D3D12_RESOURCE_STATES Graphics::ResourceManager::GetResourceState(const RenderTargetId& resourceId) const
+{
+	return GetTrackedResourceState(renderTargetPool.Get(resourceId).textureAllocation.textureResource);
+}
+
+void Graphics::ResourceManager::FinishResourceBarrierFrame() noexcept
+{
+	std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+	stateTracker->FinishFrame();
+}
+
+const Graphics::ResourceBarrierStatistics& Graphics::ResourceManager::GetResourceBarrierStatistics() const noexcept
+{
+	return stateTracker->GetLastFrameStatistics();
 }
 
 void Graphics::ResourceManager::ReleaseTemporaryUploadBuffers()
 {
+	std::lock_guard<std::recursive_mutex> uploadLock(uploadMutex);
+
+	WaitForUpload(FlushUploads());
+
 	bufferAllocator.ReleaseTemporaryBuffers();
 	textureAllocator.ReleaseTemporaryBuffers();
 }
 
-void Graphics::ResourceManager::GetTextureDataFromGPU(ID3D12Resource* resource, const TextureInfo& textureInfo, D3D12_RESOURCE_STATES beforeResourceState,
-	std::vector<float4>& rawTextureData)
+Graphics::BufferMemoryReport Graphics::ResourceManager::GetBufferMemoryReport() const
+{
+	return bufferAllocator.GetMemoryReport();
+}
+
+std::vector<Graphics::AllocatorTelemetry> Graphics::ResourceManager::GetAllocatorTelemetry() const
 {
+	return { bufferAllocator.GetTelemetry(), textureAllocator.GetTelemetry(), descriptorAllocator.GetTelemetry() };
+}
+
+void Graphics::ResourceManager::WriteAllocatorTelemetry(const std::filesystem::path& filePath) const
+{
+	std::ofstream telemetryFile(filePath, std::ios::out | std::ios::trunc);
+
+	if (!telemetryFile.is_open())
+		throw std::exception("ResourceManager::WriteAllocatorTelemetry: Telemetry file opening error");
+
+	WriteAllocatorTelemetryJson(telemetryFile, GetAllocatorTelemetry(), GetBufferMemoryReport());
+}
+
+void Graphics::ResourceManager::UploadDynamicData(const std::vector<uint8_t>& data, size_t alignment, UploadAllocation& allocation)
+{
+	AllocateUploadMemory(data.size(), alignment, allocation);
+
+	std::copy(data.begin(), data.end(), allocation.cpuAddress);
+}
+
+void Graphics::ResourceManager::GetTextureDataFromGPU(ID3D12Resource* resource, const TextureInfo& textureInfo, std::vector<float4>& rawTextureData)
+{
+	std::lock_guard<std::recursive_mutex> uploadLock(uploadMutex);
+
+	auto beforeResourceState = GetTrackedResourceState(resource);
+
 	uint64_t rowPitch = AlignSize(textureInfo.rowPitch, 256ui64);
 
 	uint64_t requiredSize = rowPitch * textureInfo.height;
@@ -909,7 +1278,7 @@ void Graphics::ResourceManager::GetTextureDataFromGPU(ID3D12Resource* resource,
 	BufferAllocation readbackTextureAllocation{};
 	bufferAllocator.AllocateTemporary(device, requiredSize, D3D12_HEAP_TYPE_READBACK, readbackTextureAllocation);
 
-	SetResourceBarrier(commandList.Get(), resource, D3D12_RESOURCE_BARRIER_FLAG_NONE, beforeResourceState, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	SetUploadResourceBarrier(resource, D3D12_RESOURCE_STATE_COPY_SOURCE);
 
 	D3D12_TEXTURE_COPY_LOCATION srcLocation{};
 	srcLocation.pResource = resource;
@@ -928,7 +1297,7 @@ void Graphics::ResourceManager::GetTextureDataFromGPU(ID3D12Resource* resource,
 
 	commandList->CopyTextureRegion(&destLocation, 0, 0, 0, &srcLocation, nullptr);
 
-	SetResourceBarrier(commandList.Get(), resource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_SOURCE, beforeResourceState);
+	SetUploadResourceBarrier(resource, beforeResourceState);
 
 	ExecuteGPUCommands();
 
@@ -958,17 +1327,21 @@ void Graphics::ResourceManager::GetTextureDataFromGPU(ID3D12Resource* resource,
 	}
 }
 
-void Graphics::ResourceManager::GetBufferDataFromGPU(ID3D12Resource* resource, size_t requiredSize, D3D12_RESOURCE_STATES beforeResourceState, std::vector<uint8_t>& rawBufferData)
+void Graphics::ResourceManager::GetBufferDataFromGPU(ID3D12Resource* resource, size_t requiredSize, std::vector<uint8_t>& rawBufferData)
 {
+	std::lock_guard<std::recursive_mutex> uploadLock(uploadMutex);
+
+	auto beforeResourceState = GetTrackedResourceState(resource);
+
 	BufferAllocation readbackBufferAllocation{};
 	bufferAllocator.AllocateTemporary(device, requiredSize, D3D12_HEAP_TYPE_READBACK, readbackBufferAllocation);
 
-	SetResourceBarrier(commandList.Get(), resource, D3D12_RESOURCE_BARRIER_FLAG_NONE, beforeResourceState, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	SetUploadResourceBarrier(resource, D3D12_RESOURCE_STATE_COPY_SOURCE);
 
 	if (readbackBufferAllocation.bufferResource != nullptr)
 		commandList->CopyResource(readbackBufferAllocation.bufferResource, resource);
 
-	SetResourceBarrier(commandList.Get(), resource, D3D12_RESOURCE_BARRIER_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_SOURCE, beforeResourceState);
+	SetUploadResourceBarrier(resource, beforeResourceState);
 
 	ExecuteGPUCommands();
 
@@ -982,8 +1355,8 @@ void Graphics::ResourceManager::GetBufferDataFromGPU(ID3D12Resource* resource, s
 	std::copy(rawData, rawData + requiredSize, rawBufferData.data());
 }
 
-void Graphics::ResourceManager::UploadTexture(ID3D12Resource* uploadBuffer, ID3D12Resource* targetTexture, const TextureInfo& textureInfo, const std::vector<uint8_t>& data,
-	uint8_t* uploadBufferCPUAddress)
+void Graphics::ResourceManager::UploadTexture(ID3D12Resource* uploadBuffer, uint64_t uploadBufferOffset, ID3D12Resource* targetTexture, const TextureInfo& textureInfo,
+	const std::vector<uint8_t>& data, uint8_t* uploadBufferCPUAddress)
 {
 	uint32_t numSubresources = textureInfo.depth * textureInfo.mipLevels;
 
@@ -994,7 +1367,7 @@ void Graphics::ResourceManager::UploadTexture(ID3D12Resource* uploadBuffer, ID3D
 	std::vector<uint64_t> rowSizesPerByte(numSubresources);
 	uint64_t requiredSize;
 
-	device->GetCopyableFootprints(&targetTextureDesc, 0, numSubresources, 0, reinterpret_cast<D3D12_PLACED_SUBRESOURCE_FOOTPRINT*>(srcLayouts.data()), numRows.data(),
+	device->GetCopyableFootprints(&targetTextureDesc, 0, numSubresources, uploadBufferOffset, reinterpret_cast<D3D12_PLACED_SUBRESOURCE_FOOTPRINT*>(srcLayouts.data()), numRows.data(),
 		rowSizesPerByte.data(), &requiredSize);
 
 	for (uint32_t subresourceIndex = 0; subresourceIndex < numSubresources; subresourceIndex++)
@@ -1038,47 +1411,211 @@ void Graphics::ResourceManager::CopyRawDataToSubresource(const TextureInfo& srcT
 }
 
 void Graphics::ResourceManager::SetResourceBarrier(ID3D12GraphicsCommandList* commandList, ID3D12Resource* const resource, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
-	D3D12_RESOURCE_STATES resourceBarrierStateBefore, D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+	D3D12_RESOURCE_STATES resourceBarrierStateAfter)
 {
-	if (resourceBarrierStateBefore == resourceBarrierStateAfter)
-		return;
+	CheckResourceBarrierBatch(commandList);
+
+	std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
 
-	D3D12_RESOURCE_BARRIER resourceBarrier{};
-	resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	resourceBarrier.Flags = resourceBarrierFlags;
-	resourceBarrier.Transition.pResource = resource;
-	resourceBarrier.Transition.StateBefore = resourceBarrierStateBefore;
-	resourceBarrier.Transition.StateAfter = resourceBarrierStateAfter;
-	resourceBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	stateTracker->TransitionResource(resource, resourceBarrierStateAfter, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, resourceBarrierFlags);
 
-	commandList->ResourceBarrier(1, &resourceBarrier);
+	if (!isResourceBarrierBatchOpen)
+		stateTracker->FlushBarriers(commandList);
 }
 
 void Graphics::ResourceManager::SetUAVBarrier(ID3D12GraphicsCommandList* commandList, ID3D12Resource* const resource)
 {
-	D3D12_RESOURCE_BARRIER resourceBarrier{};
-	resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-	resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	resourceBarrier.UAV.pResource = resource;
+	CheckResourceBarrierBatch(commandList);
+
+	std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
 
-	commandList->ResourceBarrier(1, &resourceBarrier);
+	stateTracker->SetUAVBarrier(resource);
+
+	if (!isResourceBarrierBatchOpen)
+		stateTracker->FlushBarriers(commandList);
+}
+
+void Graphics::ResourceManager::SetUploadResourceBarrier(ID3D12Resource* const resource, D3D12_RESOURCE_STATES resourceBarrierStateAfter)
+{
+	std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+	// The render thread may have a batch open on the shared tracker, only the barriers of this resource go to the upload list
+	stateTracker->TransitionResource(resource, resourceBarrierStateAfter);
+	stateTracker->FlushBarriers(commandList.Get(), resource);
+}
+
+void Graphics::ResourceManager::CheckResourceBarrierBatch(ID3D12GraphicsCommandList* commandList)
+{
+	if (!isResourceBarrierBatchOpen)
+		return;
+
+	// Barriers of an open batch are flushed together, so they all have to target the same command list
+	if (resourceBarrierBatchCommandList == nullptr)
+		resourceBarrierBatchCommandList = commandList;
+	else if (resourceBarrierBatchCommandList != commandList)
+		throw std::exception("ResourceManager::CheckResourceBarrierBatch: Barrier batch is recorded for another command list");
+}
+
+D3D12_RESOURCE_STATES Graphics::ResourceManager::GetTrackedResourceState(ID3D12Resource* resource) const
+{
+	std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+	return stateTracker->GetResourceState(resource);
+}
+
+void Graphics::ResourceManager::TrackResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES initialState)
+{
+	auto resourceDesc = resource->GetDesc();
+
+	uint32_t arraySize = (resourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D) ? 1u : resourceDesc.DepthOrArraySize;
+
+	std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+	stateTracker->RegisterResource(resource, initialState, std::max(resourceDesc.MipLevels * arraySize, 1u));
+}
+
+void Graphics::ResourceManager::ReleaseBufferAllocation(BufferAllocation& allocation)
+{
+	{
+		std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+		stateTracker->UnregisterResource(allocation.bufferResource);
+	}
+
+	bufferAllocator.Deallocate(allocation);
+}
+
+Graphics::RenderTargetId Graphics::ResourceManager::InsertRenderTarget(const TextureInfo& textureInfo, const TextureAllocation& textureAllocation)
+{
+	auto format = textureInfo.format;
+
+	TrackResource(textureAllocation.textureResource, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc{};
+	shaderResourceViewDesc.Format = format;
+	shaderResourceViewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	shaderResourceViewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	shaderResourceViewDesc.Texture2D.MipLevels = 1;
+
+	DescriptorAllocation shaderResourceDescriptorAllocation{};
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderResourceDescriptorAllocation);
+	device->CreateShaderResourceView(textureAllocation.textureResource, &shaderResourceViewDesc, shaderResourceDescriptorAllocation.descriptorBase);
+
+	D3D12_RENDER_TARGET_VIEW_DESC renderTargetViewDesc{};
+	renderTargetViewDesc.Format = format;
+	renderTargetViewDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
+	
+	DescriptorAllocation renderTargetDescriptorAllocation{};
+	descriptorAllocator.Allocate(device, 1, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, renderTargetDescriptorAllocation);
+
+	device->CreateRenderTargetView(textureAllocation.textureResource, &renderTargetViewDesc, renderTargetDescriptorAllocation.descriptorBase);
+
+	RenderTarget renderTarget{};
+	renderTarget.shaderResourceViewDesc = shaderResourceViewDesc;
+	renderTarget.renderTargetViewDesc = renderTargetViewDesc;
+	renderTarget.info = textureInfo;
+	renderTarget.textureAllocation = textureAllocation;
+	renderTarget.renderTargetDescriptorAllocation = renderTargetDescriptorAllocation;
+	renderTarget.shaderResourceDescriptorAllocation = shaderResourceDescriptorAllocation;
+
+	return renderTargetPool.Insert(renderTarget);
+}
+
+void Graphics::ResourceManager::ReleaseTextureAllocation(TextureAllocation& allocation)
+{
+	{
+		std::lock_guard<std::mutex> stateTrackerLock(stateTrackerMutex);
+
+		stateTracker->UnregisterResource(allocation.textureResource);
+	}
+
+	textureAllocator.Deallocate(allocation);
+}
+
+void Graphics::ResourceManager::ReleaseDescriptorAllocation(DescriptorAllocation& allocation)
+{
+	// Structured read-write buffers have no shader visible copy of their view
+	if (allocation.page != nullptr)
+		descriptorAllocator.Deallocate(allocation);
 }
 
 void Graphics::ResourceManager::ExecuteGPUCommands()
 {
-	ThrowIfFailed(commandList->Close(), "ResourceManager::ExecuteGPUCommands: Command List closing error!");
+	// Readbacks need their results on the CPU right away, pending uploads are submitted in the same batch
+	SubmitUploadBatch(true);
+
+	WaitForUpload({ uploadBatcher->GetLastFlushedBatchId() });
+}
+
+void Graphics::ResourceManager::AllocateStagingMemory(size_t size, size_t alignment, BufferAllocation& allocation)
+{
+	if (size + alignment > STAGING_RING_SIZE)
+	{
+		bufferAllocator.AllocateTemporary(device, size, D3D12_HEAP_TYPE_UPLOAD, allocation);
+
+		return;
+	}
+
+	stagingRing->ReleaseCompletedFrames(fence->GetCompletedValue());
+
+	uint64_t offset;
+
+	if (!stagingRing->Allocate(size, alignment, offset))
+	{
+		// Every byte of the ring is still referenced by batches in flight, so the oldest of them has to drain first
+		if (uploadBatcher->HasPendingUploads())
+			SubmitUploadBatch(true);
+
+		WaitForUpload({ uploadBatcher->GetLastFlushedBatchId() });
+
+		if (!stagingRing->Allocate(size, alignment, offset))
+			throw std::exception("ResourceManager::AllocateStagingMemory: Staging ring is full");
+	}
+
+	allocation = stagingRingAllocation;
+	allocation.cpuAddress += offset;
+	allocation.gpuAddress += offset;
+	allocation.gpuPageOffset += offset;
+	allocation.nonAlignedSizeInBytes = size;
+}
+
+void Graphics::ResourceManager::RecordUpload(size_t size)
+{
+	uploadBatcher->RecordUpload(size);
+
+	if (uploadBatcher->IsFlushRequired())
+		SubmitUploadBatch(false);
+}
+
+void Graphics::ResourceManager::SubmitUploadBatch(bool isForced)
+{
+	ThrowIfFailed(commandList->Close(), "ResourceManager::SubmitUploadBatch: Command List closing error!");
 
 	ID3D12CommandList* commandLists[] = { commandList.Get() };
 
 	commandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
 
-	ThrowIfFailed(commandQueue->Signal(fence.Get(), fenceValue), "ResourceManager::ExecuteGPUCommands: Signal error!");
-	ThrowIfFailed(fence->SetEventOnCompletion(fenceValue, fenceEvent), "ResourceManager::ExecuteGPUCommands: Fence error!");
+	uint64_t batchId = uploadBatcher->Flush(isForced);
 
-	WaitForSingleObjectEx(fenceEvent, INFINITE, false);
+	ThrowIfFailed(commandQueue->Signal(fence.Get(), batchId), "ResourceManager::SubmitUploadBatch: Signal error!");
 
-	fenceValue++;
+	stagingRing->FinishFrame(batchId);
+
+	submittedCommandAllocators.push_back({ batchId, commandAllocator });
+
+	// The allocator of a batch still executing on the GPU can't be reset, a new one is created in that case
+	if (submittedCommandAllocators.front().first <= fence->GetCompletedValue())
+	{
+		commandAllocator = submittedCommandAllocators.front().second;
+		submittedCommandAllocators.pop_front();
+
+		ThrowIfFailed(commandAllocator->Reset(), "ResourceManager::SubmitUploadBatch: Command Allocator resetting error!");
+	}
+	else
+	{
+		ThrowIfFailed(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator)),
+			"ResourceManager::SubmitUploadBatch: Command Allocator creating error!");
+	}
 
-	ThrowIfFailed(commandAllocator->Reset(), "ResourceManager::ExecuteGPUCommands: Command Allocator resetting error!");
-	ThrowIfFailed(commandList->Reset(commandAllocator.Get(), nullptr), "ResourceManager::ExecuteGPUCommands: Command List resetting error!");
+	ThrowIfFailed(commandList->Reset(commandAllocator.Get(), nullptr), "ResourceManager::SubmitUploadBatch: Command List resetting error!");
 }
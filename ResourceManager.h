@@ -4,6 +4,11 @@
 #include "DescriptorAllocator.h"
 #include "TextureAllocator.h"
 #include "DDSLoader.h"
+#include "UploadRing.h"
+#include "UploadBatcher.h"
+#include "ResourceStateTracker.h"
+#include "ResourcePool.h"
+#include "TextureAliasingPlanner.h"
 
 namespace Graphics
 {
@@ -12,18 +17,25 @@ namespace Graphics
 	{
 	public:
 		ResourceId()
-			: value(0), category(Category)
+			: value(0), generation(0), category(Category)
 		{
 
 		}
 
 		ResourceId(size_t resourceId)
-			: value(resourceId), category(Category)
+			: value(resourceId), generation(0), category(Category)
+		{
+
+		}
+
+		ResourceId(size_t resourceId, uint32_t resourceGeneration)
+			: value(resourceId), generation(resourceGeneration), category(Category)
 		{
 
 		}
 
 		size_t value;
+		uint32_t generation;
 
 	private:
 		friend class ResourceManager;
@@ -42,11 +54,19 @@ namespace Graphics
 	using RWTextureId = typename ResourceId<8>;
 	using RWBufferId = typename ResourceId<9>;
 
+	struct UploadAllocation
+	{
+		uint8_t* cpuAddress;
+		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress;
+	};
+
 	struct VertexBuffer
 	{
 		D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
 		BufferAllocation vertexBufferAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
+		std::vector<uint8_t> dynamicData;
+		uint64_t uploadFrame;
+		bool isRingBacked;
 	};
 
 	struct IndexBuffer
@@ -54,7 +74,6 @@ namespace Graphics
 		uint32_t indicesCount;
 		D3D12_INDEX_BUFFER_VIEW indexBufferView;
 		BufferAllocation indexBufferAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
 	};
 
 	struct ConstantBuffer
@@ -62,7 +81,10 @@ namespace Graphics
 		D3D12_CONSTANT_BUFFER_VIEW_DESC constantBufferViewDesc;
 		BufferAllocation uploadBufferAllocation;
 		DescriptorAllocation bufferDescriptorAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
+		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress;
+		std::vector<uint8_t> dynamicData;
+		uint64_t uploadFrame;
+		bool isRingBacked;
 	};
 
 	struct Texture
@@ -71,7 +93,6 @@ namespace Graphics
 		TextureInfo info;
 		TextureAllocation textureAllocation;
 		DescriptorAllocation shaderResourceDescriptorAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
 	};
 
 	struct Buffer
@@ -79,7 +100,6 @@ namespace Graphics
 		D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
 		BufferAllocation bufferAllocation;
 		DescriptorAllocation shaderResourceDescriptorAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
 	};
 
 	struct Sampler
@@ -96,7 +116,16 @@ namespace Graphics
 		TextureAllocation textureAllocation;
 		DescriptorAllocation shaderResourceDescriptorAllocation;
 		DescriptorAllocation renderTargetDescriptorAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
+	};
+
+	// Lifetime is an inclusive range of pass indices of the caller's chain, firstPass greater than lastPass marks a target the chain never uses
+	struct AliasedRenderTargetDesc
+	{
+		uint64_t width;
+		uint32_t height;
+		DXGI_FORMAT format;
+		uint32_t firstPass;
+		uint32_t lastPass;
 	};
 
 	struct DepthStencil
@@ -107,7 +136,6 @@ namespace Graphics
 		TextureAllocation textureAllocation;
 		DescriptorAllocation shaderResourceDescriptorAllocation;
 		DescriptorAllocation depthStencilDescriptorAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
 	};
 
 	struct RWTexture
@@ -118,8 +146,7 @@ namespace Graphics
 		TextureAllocation textureAllocation;
 		DescriptorAllocation shaderResourceDescriptorAllocation;
 		DescriptorAllocation unorderedAccessDescriptorAllocation;
-		DescriptorAllocation shaderNonVisibleDescriptorAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
+		DescriptorAllocation shaderVisibleDescriptorAllocation;
 	};
 
 	struct RWBuffer
@@ -129,10 +156,11 @@ namespace Graphics
 		BufferAllocation bufferAllocation;
 		DescriptorAllocation shaderResourceDescriptorAllocation;
 		DescriptorAllocation unorderedAccessDescriptorAllocation;
-		DescriptorAllocation shaderNonVisibleDescriptorAllocation;
-		D3D12_RESOURCE_STATES currentResourceState;
+		DescriptorAllocation shaderVisibleDescriptorAllocation;
 	};
 
+	// Resources may be created, released and looked up from any thread, so assets can be loaded by workers. Uploads from all threads share
+	// one batched command list under a lock. Barrier batches, dynamic data and frame bookkeeping stay on the render thread.
 	class ResourceManager
 	{
 	public:
@@ -150,11 +178,36 @@ namespace Graphics
 		SamplerId CreateSampler(const D3D12_SAMPLER_DESC& samplerDesc);
 		RenderTargetId CreateRenderTarget(uint64_t width, uint32_t height, DXGI_FORMAT format);
 		DepthStencilId CreateDepthStencil(uint64_t width, uint32_t height, uint32_t depthBit);
+		void CreateAliasedRenderTargets(const std::vector<AliasedRenderTargetDesc>& renderTargetDescs, std::vector<RenderTargetId>& renderTargetIds,
+			TextureAliasingReport& aliasingReport);
 		RWTextureId CreateRWTexture(const TextureInfo& textureInfo);
 		RWBufferId CreateRWBuffer(const void* initialData, size_t dataSize, size_t bufferStride, size_t numElements, DXGI_FORMAT format, bool addCounter);
 
 		void CreateSwapChainBuffers(IDXGISwapChain4* swapChain, uint32_t buffersCount);
 
+		// The handle is stale right after the call, the resource itself is destroyed once the GPU has passed the fence value. Without
+		// a fence value the resource lives until the frame currently being recorded has completed.
+		template<uint8_t Category>
+		void Release(const ResourceId<Category>& resourceId)
+		{
+			GetPool<Category>(*this).Release(resourceId);
+		}
+
+		template<uint8_t Category>
+		void Release(const ResourceId<Category>& resourceId, uint64_t fenceValue)
+		{
+			GetPool<Category>(*this).Release(resourceId, fenceValue);
+		}
+
+		template<uint8_t Category>
+		bool IsValid(const ResourceId<Category>& resourceId) const noexcept
+		{
+			return GetPool<Category>(*this).IsValid(resourceId);
+		}
+
+		void ReleaseCompletedResources(uint64_t completedFenceValue);
+		ResourcePoolStatistics GetResourcePoolStatistics() const noexcept;
+
 		const VertexBuffer& GetVertexBuffer(const VertexBufferId& resourceId) const;
 		const IndexBuffer& GetIndexBuffer(const IndexBufferId& resourceId) const;
 		const ConstantBuffer& GetConstantBuffer(const ConstantBufferId& resourceId) const;
@@ -170,7 +223,7 @@ namespace Graphics
 		ID3D12Resource* GetSwapChainBuffer(uint32_t bufferId) const;
 		void ResetSwapChainBuffers(IDXGISwapChain4* swapChain);
 
-		D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView(const VertexBufferId& resourceId) const;
+		D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView(const VertexBufferId& resourceId);
 		D3D12_INDEX_BUFFER_VIEW GetIndexBufferView(const IndexBufferId& resourceId) const;
 
 		const D3D12_CPU_DESCRIPTOR_HANDLE& GetRenderTargetDescriptorBase(const RenderTargetId& resourceId) const;
@@ -178,6 +231,10 @@ namespace Graphics
 
 		ID3D12DescriptorHeap* GetShaderResourceViewDescriptorHeap();
 
+		void StageDescriptors(const std::vector<D3D12_CPU_DESCRIPTOR_HANDLE>& sourceDescriptors, DescriptorAllocation& allocation);
+		uint64_t GetDescriptorFrameIndex() const noexcept;
+		DescriptorAllocatorStatistics GetDescriptorStatistics() const noexcept;
+
 		void GetTextureDataFromGPU(TextureId textureId, std::vector<float4>& rawTextureData);
 		void GetTextureDataFromGPU(RenderTargetId textureId, std::vector<float4>& rawTextureData);
 		void GetTextureDataFromGPU(DepthStencilId textureId, std::vector<float4>& rawTextureData);
@@ -191,6 +248,22 @@ namespace Graphics
 		void UpdateDynamicVertexBuffer(const VertexBufferId& resourceId, const void* data, size_t dataSize);
 		void UpdateConstantBuffer(const ConstantBufferId& resourceId, const void* data, size_t dataSize);
 
+		D3D12_GPU_VIRTUAL_ADDRESS GetConstantBufferAddress(const ConstantBufferId& resourceId);
+
+		void AllocateUploadMemory(size_t size, size_t alignment, UploadAllocation& allocation);
+		void FinishUploadFrame(uint64_t frameFenceValue);
+		void ReleaseCompletedUploads(uint64_t completedFenceValue);
+
+		const UploadRingStatistics& GetUploadRingStatistics() const noexcept;
+
+		UploadTicket GetUploadTicket() const noexcept;
+		UploadTicket FlushUploads();
+		bool IsUploadComplete(const UploadTicket& ticket) const;
+		void WaitForUpload(const UploadTicket& ticket);
+		void SynchronizeUploads(ID3D12CommandQueue* queue);
+
+		const UploadBatchStatistics& GetUploadBatchStatistics() const noexcept;
+
 		void SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const VertexBufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
 			D3D12_RESOURCE_STATES resourceBarrierStateAfter);
 		void SetResourceBarrier(ID3D12GraphicsCommandList* _commandList, const IndexBufferId& resourceId, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
@@ -212,11 +285,26 @@ namespace Graphics
 
 		void SetUAVBarrier(ID3D12GraphicsCommandList* _commandList, const RWTextureId& resourceId);
 		void SetUAVBarrier(ID3D12GraphicsCommandList* _commandList, const RWBufferId& resourceId);
+		void AcquireAliasedRenderTarget(ID3D12GraphicsCommandList* _commandList, const RenderTargetId& resourceId);
+
+		void BeginResourceBarrierBatch();
+		void FlushResourceBarriers(ID3D12GraphicsCommandList* _commandList);
+		void SetSplitBarriersEnabled(bool isEnabled) noexcept;
+
+		D3D12_RESOURCE_STATES GetResourceState(const RenderTargetId& resourceId) const;
+
+		void FinishResourceBarrierFrame() noexcept;
+		const ResourceBarrierStatistics& GetResourceBarrierStatistics() const noexcept;
 
 		void ReleaseTemporaryUploadBuffers();
 
+		BufferMemoryReport GetBufferMemoryReport() const;
+		std::vector<AllocatorTelemetry> GetAllocatorTelemetry() const;
+		void WriteAllocatorTelemetry(const std::filesystem::path& filePath) const;
+
 	private:
-		ResourceManager() : device(nullptr), fenceEvent{}, fenceValue(0) {};
+		ResourceManager() : device(nullptr), fenceEvent{}, uploadRingAllocation{}, stagingRingAllocation{}, isResourceBarrierBatchOpen(false),
+			resourceBarrierBatchCommandList(nullptr) {};
 		~ResourceManager() {};
 
 		ResourceManager(const ResourceManager&) = delete;
@@ -224,43 +312,109 @@ namespace Graphics
 		ResourceManager& operator=(const ResourceManager&) = delete;
 		ResourceManager& operator=(ResourceManager&&) = delete;
 
-		void GetTextureDataFromGPU(ID3D12Resource* resource, const TextureInfo& textureInfo, D3D12_RESOURCE_STATES beforeResourceState,
-			std::vector<float4>& rawTextureData);
-		void GetBufferDataFromGPU(ID3D12Resource* resource, size_t requiredSize, D3D12_RESOURCE_STATES beforeResourceState, std::vector<uint8_t>& rawBufferData);
+		void GetTextureDataFromGPU(ID3D12Resource* resource, const TextureInfo& textureInfo, std::vector<float4>& rawTextureData);
+		void GetBufferDataFromGPU(ID3D12Resource* resource, size_t requiredSize, std::vector<uint8_t>& rawBufferData);
 
-		void UploadTexture(ID3D12Resource* uploadBuffer, ID3D12Resource* targetTexture, const TextureInfo& textureInfo, const std::vector<uint8_t>& data,
-			uint8_t* uploadBufferCPUAddress);
+		void UploadTexture(ID3D12Resource* uploadBuffer, uint64_t uploadBufferOffset, ID3D12Resource* targetTexture, const TextureInfo& textureInfo,
+			const std::vector<uint8_t>& data, uint8_t* uploadBufferCPUAddress);
 		void CopyRawDataToSubresource(const TextureInfo& srcTextureInfo, uint32_t numRows, uint16_t numSlices, uint64_t destRowPitch, uint64_t destSlicePitch,
 			uint64_t rowSizeInBytes, const uint8_t* srcAddress, uint8_t* destAddress);
 
 		void SetResourceBarrier(ID3D12GraphicsCommandList* commandList, ID3D12Resource* const resource, D3D12_RESOURCE_BARRIER_FLAGS resourceBarrierFlags,
-			D3D12_RESOURCE_STATES resourceBarrierStateBefore, D3D12_RESOURCE_STATES resourceBarrierStateAfter);
+			D3D12_RESOURCE_STATES resourceBarrierStateAfter);
 		void SetUAVBarrier(ID3D12GraphicsCommandList* commandList, ID3D12Resource* const resource);
+		void SetUploadResourceBarrier(ID3D12Resource* const resource, D3D12_RESOURCE_STATES resourceBarrierStateAfter);
+		void CheckResourceBarrierBatch(ID3D12GraphicsCommandList* commandList);
+		D3D12_RESOURCE_STATES GetTrackedResourceState(ID3D12Resource* resource) const;
+
+		void TrackResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES initialState);
+		RenderTargetId InsertRenderTarget(const TextureInfo& textureInfo, const TextureAllocation& textureAllocation);
+		void ReleaseBufferAllocation(BufferAllocation& allocation);
+		void ReleaseTextureAllocation(TextureAllocation& allocation);
+		void ReleaseDescriptorAllocation(DescriptorAllocation& allocation);
+
+		template<uint8_t Category, typename ResourceManagerType>
+		static auto& GetPool(ResourceManagerType& resourceManager) noexcept
+		{
+			if constexpr (std::is_same_v<ResourceId<Category>, VertexBufferId>)
+				return resourceManager.vertexBufferPool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, IndexBufferId>)
+				return resourceManager.indexBufferPool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, ConstantBufferId>)
+				return resourceManager.constantBufferPool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, TextureId>)
+				return resourceManager.texturePool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, BufferId>)
+				return resourceManager.bufferPool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, SamplerId>)
+				return resourceManager.samplerPool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, RenderTargetId>)
+				return resourceManager.renderTargetPool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, DepthStencilId>)
+				return resourceManager.depthStencilPool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, RWTextureId>)
+				return resourceManager.rwTexturePool;
+			else if constexpr (std::is_same_v<ResourceId<Category>, RWBufferId>)
+				return resourceManager.rwBufferPool;
+			else
+				static_assert(Category != Category, "ResourceManager::GetPool: Unknown resource category");
+		}
 
+		// The upload path below expects the caller to hold uploadMutex
 		void ExecuteGPUCommands();
 
+		void AllocateStagingMemory(size_t size, size_t alignment, BufferAllocation& allocation);
+		void RecordUpload(size_t size);
+		void SubmitUploadBatch(bool isForced);
+
+		void UploadDynamicData(const std::vector<uint8_t>& data, size_t alignment, UploadAllocation& allocation);
+
+		static constexpr size_t UPLOAD_RING_SIZE = 4 * _MB;
+		static constexpr size_t DYNAMIC_VERTEX_DATA_ALIGNMENT = 16;
+		static constexpr size_t STAGING_RING_SIZE = 32 * _MB;
+		static constexpr size_t MAX_UPLOAD_BATCH_SIZE = 16 * _MB;
+		static constexpr size_t MAX_UPLOAD_BATCH_COUNT = 256;
+		static constexpr UploadTimingModel UPLOAD_TIMING_MODEL = { 0.05f, 0.5f, 8.0f * _MB };
+
 		ID3D12Device* device;
 		ComPtr<ID3D12GraphicsCommandList> commandList;
 		ComPtr<ID3D12CommandAllocator> commandAllocator;
 		ComPtr<ID3D12CommandQueue> commandQueue;
 		ComPtr<ID3D12Fence> fence;
 		HANDLE fenceEvent;
-		uint64_t fenceValue;
-
-		std::vector<VertexBuffer> vertexBufferPool;
-		std::vector<IndexBuffer> indexBufferPool;
-		std::vector<ConstantBuffer> constantBufferPool;
-		std::vector<Texture> texturePool;
-		std::vector<Buffer> bufferPool;
-		std::vector<Sampler> samplerPool;
-		std::vector<RenderTarget> renderTargetPool;
-		std::vector<DepthStencil> depthStencilPool;
-		std::vector<RWTexture> rwTexturePool;
-		std::vector<RWBuffer> rwBufferPool;
+
+		std::deque<std::pair<uint64_t, ComPtr<ID3D12CommandAllocator>>> submittedCommandAllocators;
+
+		ResourcePool<VertexBuffer, VertexBufferId> vertexBufferPool;
+		ResourcePool<IndexBuffer, IndexBufferId> indexBufferPool;
+		ResourcePool<ConstantBuffer, ConstantBufferId> constantBufferPool;
+		ResourcePool<Texture, TextureId> texturePool;
+		ResourcePool<Buffer, BufferId> bufferPool;
+		ResourcePool<Sampler, SamplerId> samplerPool;
+		ResourcePool<RenderTarget, RenderTargetId> renderTargetPool;
+		ResourcePool<DepthStencil, DepthStencilId> depthStencilPool;
+		ResourcePool<RWTexture, RWTextureId> rwTexturePool;
+		ResourcePool<RWBuffer, RWBufferId> rwBufferPool;
 
 		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> swapChainDescriptorBases;
 		std::vector<ComPtr<ID3D12Resource>> swapChainBuffers;
-		std::vector<D3D12_RESOURCE_STATES> swapChainStates;
+
+		std::shared_ptr<BufferAllocationPage> uploadRingPage;
+		BufferAllocation uploadRingAllocation;
+		std::shared_ptr<UploadRing> uploadRing;
+
+		std::shared_ptr<BufferAllocationPage> stagingRingPage;
+		BufferAllocation stagingRingAllocation;
+		std::shared_ptr<UploadRing> stagingRing;
+		std::shared_ptr<UploadBatcher> uploadBatcher;
+
+		// Recursive because waiting for a full staging ring goes through the public upload calls
+		mutable std::recursive_mutex uploadMutex;
+
+		std::shared_ptr<ResourceStateTracker> stateTracker;
+		mutable std::mutex stateTrackerMutex;
+		bool isResourceBarrierBatchOpen;
+		ID3D12GraphicsCommandList* resourceBarrierBatchCommandList;
 
 		BufferAllocator& bufferAllocator = BufferAllocator::GetInstance();
 		DescriptorAllocator& descriptorAllocator = DescriptorAllocator::GetInstance();
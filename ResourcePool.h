@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace Graphics
+{
+	struct ResourcePoolStatistics
+	{
+		size_t insertionsCount;
+		size_t releasesCount;
+		size_t destructionsCount;
+		size_t reusedSlotsCount;
+	};
+
+	// Slot map with generation counters. A released handle goes stale immediately, while the slot itself is destroyed and handed out again
+	// only after the fence value it was released with has completed. Every call is serialized by the pool, and slots live in a deque, so
+	// a reference returned by Get stays valid while other threads insert until its own handle is released. Generations start at 1 and skip 0
+	// on wrap, so a default constructed handle never refers to a live slot.
+	template<typename T, typename IdType>
+	class ResourcePool
+	{
+	public:
+		ResourcePool()
+			: statistics{}
+		{
+
+		}
+
+		~ResourcePool()
+		{
+			slots.clear();
+		}
+
+		IdType Insert(const T& resource)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			size_t slotId;
+
+			if (!freeSlots.empty())
+			{
+				slotId = freeSlots.back();
+				freeSlots.pop_back();
+
+				statistics.reusedSlotsCount++;
+			}
+			else
+			{
+				slotId = slots.size();
+				slots.push_back({ {}, FIRST_GENERATION, false });
+			}
+
+			auto& slot = slots[slotId];
+			slot.resource = resource;
+			slot.isActive = true;
+
+			statistics.insertionsCount++;
+
+			return IdType(slotId, slot.generation);
+		}
+
+		bool IsValid(const IdType& resourceId) const noexcept
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			return IsSlotValid(resourceId);
+		}
+
+		T& Get(const IdType& resourceId)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (!IsSlotValid(resourceId))
+				throw std::runtime_error("ResourcePool::Get: Stale or invalid resource handle");
+
+			return slots[resourceId.value].resource;
+		}
+
+		const T& Get(const IdType& resourceId) const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (!IsSlotValid(resourceId))
+				throw std::runtime_error("ResourcePool::Get: Stale or invalid resource handle");
+
+			return slots[resourceId.value].resource;
+		}
+
+		// Without a fence value the release waits for the next AssignReleaseFence, which is the fence of the frame it was recorded in
+		void Release(const IdType& resourceId)
+		{
+			Release(resourceId, UNASSIGNED_FENCE_VALUE);
+		}
+
+		void Release(const IdType& resourceId, uint64_t fenceValue)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (!IsSlotValid(resourceId))
+				throw std::runtime_error("ResourcePool::Release: Stale or invalid resource handle");
+
+			auto& slot = slots[resourceId.value];
+			slot.isActive = false;
+
+			if (++slot.generation == INVALID_GENERATION)
+				slot.generation = FIRST_GENERATION;
+
+			pendingReleases.push_back({ resourceId.value, fenceValue });
+
+			statistics.releasesCount++;
+		}
+
+		void AssignReleaseFence(uint64_t fenceValue) noexcept
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			for (auto& pendingRelease : pendingReleases)
+				if (pendingRelease.fenceValue == UNASSIGNED_FENCE_VALUE)
+					pendingRelease.fenceValue = fenceValue;
+		}
+
+		// The destroy function runs under the pool lock, it must not call back into the same pool
+		template<typename DestroyFunction>
+		void ReleaseCompleted(uint64_t completedFenceValue, DestroyFunction destroyFunction)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			auto pendingReleaseIt = pendingReleases.begin();
+
+			while (pendingReleaseIt != pendingReleases.end())
+			{
+				if (pendingReleaseIt->fenceValue > completedFenceValue)
+				{
+					pendingReleaseIt++;
+
+					continue;
+				}
+
+				auto& slot = slots[pendingReleaseIt->slotId];
+
+				destroyFunction(slot.resource);
+				slot.resource = {};
+
+				freeSlots.push_back(pendingReleaseIt->slotId);
+				pendingReleaseIt = pendingReleases.erase(pendingReleaseIt);
+
+				statistics.destructionsCount++;
+			}
+		}
+
+		size_t GetActiveCount() const noexcept
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			return slots.size() - freeSlots.size() - pendingReleases.size();
+		}
+
+		size_t GetPendingReleasesCount() const noexcept
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			return pendingReleases.size();
+		}
+
+		size_t GetCapacity() const noexcept
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			return slots.size();
+		}
+
+		ResourcePoolStatistics GetStatistics() const noexcept
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			return statistics;
+		}
+
+	private:
+		ResourcePool(const ResourcePool&) = delete;
+		ResourcePool& operator=(const ResourcePool&) = delete;
+
+		static constexpr uint64_t UNASSIGNED_FENCE_VALUE = UINT64_MAX;
+		static constexpr uint32_t INVALID_GENERATION = 0;
+		static constexpr uint32_t FIRST_GENERATION = 1;
+
+		bool IsSlotValid(const IdType& resourceId) const noexcept
+		{
+			return resourceId.generation != INVALID_GENERATION && resourceId.value < slots.size() && slots[resourceId.value].isActive && slots[resourceId.value].generation == resourceId.generation;
+		}
+
+		struct Slot
+		{
+			T resource;
+			uint32_t generation;
+			bool isActive;
+		};
+
+		struct PendingRelease
+		{
+			size_t slotId;
+			uint64_t fenceValue;
+		};
+
+		std::deque<Slot> slots;
+		std::vector<size_t> freeSlots;
+		std::vector<PendingRelease> pendingReleases;
+
+		ResourcePoolStatistics statistics;
+
+		mutable std::mutex mutex;
+	};
+}
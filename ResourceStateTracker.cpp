@@ -0,0 +1,323 @@
+#include "ResourceStateTracker.h"
+
+#include <functional>
+#include <stdexcept>
+
+Graphics::ResourceStateTracker::ResourceStateTracker()
+	: isSplitBarriersEnabled(true), statistics{}, lastFrameStatistics{}
+{
+
+}
+
+Graphics::ResourceStateTracker::~ResourceStateTracker()
+{
+	trackedResources.clear();
+	pendingBarriers.clear();
+}
+
+void Graphics::ResourceStateTracker::RegisterResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES initialState, uint32_t subresourcesCount)
+{
+	if (resource == nullptr || subresourcesCount == 0)
+		throw std::runtime_error("ResourceStateTracker::RegisterResource: Invalid resource");
+
+	auto trackedResourceIt = trackedResources.find(resource);
+
+	// Sub-allocated buffers share the page resource, the first registration defines its state
+	if (trackedResourceIt != trackedResources.end())
+	{
+		trackedResourceIt->second.referencesCount++;
+
+		return;
+	}
+
+	TrackedResource trackedResource{};
+	trackedResource.state = initialState;
+	trackedResource.subresourcesCount = subresourcesCount;
+	trackedResource.referencesCount = 1;
+
+	trackedResources.insert({ resource, trackedResource });
+}
+
+void Graphics::ResourceStateTracker::UnregisterResource(ID3D12Resource* resource)
+{
+	auto& trackedResource = GetTrackedResource(resource, "ResourceStateTracker::UnregisterResource: Resource is not registered");
+
+	if (--trackedResource.referencesCount == 0)
+		trackedResources.erase(resource);
+}
+
+void Graphics::ResourceStateTracker::TransitionResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES stateAfter, uint32_t subresource,
+	D3D12_RESOURCE_BARRIER_FLAGS barrierFlags)
+{
+	auto& trackedResource = GetTrackedResource(resource, "ResourceStateTracker::TransitionResource: Resource is not registered");
+
+	statistics.transitionsRequested++;
+
+	if (barrierFlags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+	{
+		// Split barriers are only a hint, the matching end request transitions the resource anyway
+		if (!isSplitBarriersEnabled || trackedResource.hasSplitBarrier || subresource != D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES ||
+			!trackedResource.subresourceStates.empty() || IsTransitionRedundant(trackedResource.state, stateAfter))
+		{
+			statistics.barriersDropped++;
+
+			return;
+		}
+
+		AddTransition(resource, subresource, trackedResource.state, stateAfter, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+
+		trackedResource.splitState = stateAfter;
+		trackedResource.hasSplitBarrier = true;
+
+		return;
+	}
+
+	if (trackedResource.hasSplitBarrier)
+	{
+		bool isMatchingEnd = trackedResource.splitState == stateAfter && subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+		EndSplitTransition(resource, trackedResource);
+
+		if (isMatchingEnd)
+			return;
+	}
+
+	if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+	{
+		if (trackedResource.subresourceStates.empty())
+		{
+			if (IsTransitionRedundant(trackedResource.state, stateAfter))
+			{
+				statistics.barriersDropped++;
+
+				return;
+			}
+
+			AddTransition(resource, subresource, trackedResource.state, stateAfter, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+			trackedResource.state = stateAfter;
+		}
+		else
+		{
+			for (uint32_t subresourceId = 0; subresourceId < trackedResource.subresourcesCount; subresourceId++)
+			{
+				auto& subresourceState = trackedResource.subresourceStates[subresourceId];
+
+				if (IsTransitionRedundant(subresourceState, stateAfter))
+					continue;
+
+				AddTransition(resource, subresourceId, subresourceState, stateAfter, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+				subresourceState = stateAfter;
+			}
+
+			CollapseSubresourceStates(trackedResource);
+		}
+
+		return;
+	}
+
+	if (subresource >= trackedResource.subresourcesCount)
+		throw std::runtime_error("ResourceStateTracker::TransitionResource: Invalid subresource");
+
+	D3D12_RESOURCE_STATES stateBefore = trackedResource.subresourceStates.empty() ? trackedResource.state : trackedResource.subresourceStates[subresource];
+
+	if (IsTransitionRedundant(stateBefore, stateAfter))
+	{
+		statistics.barriersDropped++;
+
+		return;
+	}
+
+	if (trackedResource.subresourceStates.empty())
+		trackedResource.subresourceStates.assign(trackedResource.subresourcesCount, trackedResource.state);
+
+	AddTransition(resource, subresource, stateBefore, stateAfter, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+	trackedResource.subresourceStates[subresource] = stateAfter;
+
+	CollapseSubresourceStates(trackedResource);
+}
+
+void Graphics::ResourceStateTracker::SetUAVBarrier(ID3D12Resource* resource)
+{
+	for (auto barrierIt = pendingBarriers.rbegin(); barrierIt != pendingBarriers.rend(); barrierIt++)
+	{
+		if (barrierIt->Type == D3D12_RESOURCE_BARRIER_TYPE_UAV && barrierIt->UAV.pResource == resource)
+		{
+			statistics.barriersDropped++;
+
+			return;
+		}
+
+		if (barrierIt->Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION && barrierIt->Transition.pResource == resource)
+			break;
+	}
+
+	D3D12_RESOURCE_BARRIER resourceBarrier{};
+	resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+	resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	resourceBarrier.UAV.pResource = resource;
+
+	pendingBarriers.push_back(resourceBarrier);
+
+	statistics.uavBarriersIssued++;
+}
+
+void Graphics::ResourceStateTracker::SetAliasingBarrier(ID3D12Resource* resourceBefore, ID3D12Resource* resourceAfter)
+{
+	// Tracked states stay per resource, an aliasing barrier only orders accesses to the memory the placed resources share
+	D3D12_RESOURCE_BARRIER resourceBarrier{};
+	resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+	resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	resourceBarrier.Aliasing.pResourceBefore = resourceBefore;
+	resourceBarrier.Aliasing.pResourceAfter = resourceAfter;
+
+	pendingBarriers.push_back(resourceBarrier);
+
+	statistics.aliasingBarriersIssued++;
+}
+
+D3D12_RESOURCE_STATES Graphics::ResourceStateTracker::GetResourceState(ID3D12Resource* resource, uint32_t subresource) const
+{
+	auto trackedResourceIt = trackedResources.find(resource);
+
+	if (trackedResourceIt == trackedResources.end())
+		throw std::runtime_error("ResourceStateTracker::GetResourceState: Resource is not registered");
+
+	const auto& trackedResource = trackedResourceIt->second;
+
+	if (trackedResource.subresourceStates.empty())
+		return trackedResource.state;
+
+	if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+		throw std::runtime_error("ResourceStateTracker::GetResourceState: Subresources are in different states");
+
+	if (subresource >= trackedResource.subresourcesCount)
+		throw std::runtime_error("ResourceStateTracker::GetResourceState: Invalid subresource");
+
+	return trackedResource.subresourceStates[subresource];
+}
+
+bool Graphics::ResourceStateTracker::IsRegistered(ID3D12Resource* resource) const noexcept
+{
+	return trackedResources.find(resource) != trackedResources.end();
+}
+
+bool Graphics::ResourceStateTracker::HasPendingBarriers() const noexcept
+{
+	return !pendingBarriers.empty();
+}
+
+void Graphics::ResourceStateTracker::SetSplitBarriersEnabled(bool isEnabled) noexcept
+{
+	isSplitBarriersEnabled = isEnabled;
+}
+
+bool Graphics::ResourceStateTracker::IsSplitBarriersEnabled() const noexcept
+{
+	return isSplitBarriersEnabled;
+}
+
+void Graphics::ResourceStateTracker::FinishFrame() noexcept
+{
+	lastFrameStatistics = statistics;
+	statistics = {};
+}
+
+const Graphics::ResourceBarrierStatistics& Graphics::ResourceStateTracker::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+const Graphics::ResourceBarrierStatistics& Graphics::ResourceStateTracker::GetLastFrameStatistics() const noexcept
+{
+	return lastFrameStatistics;
+}
+
+Graphics::ResourceStateTracker::TrackedResource& Graphics::ResourceStateTracker::GetTrackedResource(ID3D12Resource* resource, const char* errorMessage)
+{
+	auto trackedResourceIt = trackedResources.find(resource);
+
+	if (trackedResourceIt == trackedResources.end())
+		throw std::runtime_error(errorMessage);
+
+	return trackedResourceIt->second;
+}
+
+void Graphics::ResourceStateTracker::EndSplitTransition(ID3D12Resource* resource, TrackedResource& trackedResource)
+{
+	AddTransition(resource, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, trackedResource.state, trackedResource.splitState, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+
+	trackedResource.state = trackedResource.splitState;
+	trackedResource.hasSplitBarrier = false;
+}
+
+void Graphics::ResourceStateTracker::AddTransition(ID3D12Resource* resource, uint32_t subresource, D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter,
+	D3D12_RESOURCE_BARRIER_FLAGS barrierFlags)
+{
+	// Nothing was recorded between the queued barrier of this subresource and the new one, so both collapse into a single transition
+	if (barrierFlags == D3D12_RESOURCE_BARRIER_FLAG_NONE)
+	{
+		for (auto barrierIt = pendingBarriers.rbegin(); barrierIt != pendingBarriers.rend(); barrierIt++)
+		{
+			if (barrierIt->Type == D3D12_RESOURCE_BARRIER_TYPE_UAV && barrierIt->UAV.pResource == resource)
+				break;
+
+			if (barrierIt->Type != D3D12_RESOURCE_BARRIER_TYPE_TRANSITION || barrierIt->Transition.pResource != resource)
+				continue;
+
+			if (barrierIt->Flags != D3D12_RESOURCE_BARRIER_FLAG_NONE || barrierIt->Transition.Subresource != subresource)
+				break;
+
+			statistics.transitionsMerged++;
+
+			if (barrierIt->Transition.StateBefore == stateAfter)
+				pendingBarriers.erase(std::next(barrierIt).base());
+			else
+				barrierIt->Transition.StateAfter = stateAfter;
+
+			return;
+		}
+	}
+
+	D3D12_RESOURCE_BARRIER resourceBarrier{};
+	resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	resourceBarrier.Flags = barrierFlags;
+	resourceBarrier.Transition.pResource = resource;
+	resourceBarrier.Transition.StateBefore = stateBefore;
+	resourceBarrier.Transition.StateAfter = stateAfter;
+	resourceBarrier.Transition.Subresource = subresource;
+
+	pendingBarriers.push_back(resourceBarrier);
+
+	if (barrierFlags != D3D12_RESOURCE_BARRIER_FLAG_NONE)
+		statistics.splitBarriersIssued++;
+}
+
+void Graphics::ResourceStateTracker::CollapseSubresourceStates(TrackedResource& trackedResource) noexcept
+{
+	auto& subresourceStates = trackedResource.subresourceStates;
+
+	if (std::adjacent_find(subresourceStates.begin(), subresourceStates.end(), std::not_equal_to<D3D12_RESOURCE_STATES>()) != subresourceStates.end())
+		return;
+
+	trackedResource.state = subresourceStates.front();
+	subresourceStates.clear();
+}
+
+bool Graphics::ResourceStateTracker::IsTransitionRedundant(D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter) noexcept
+{
+	if (stateBefore == stateAfter)
+		return true;
+
+	// A read state that is already part of the current combined read state needs no transition
+	return stateAfter != D3D12_RESOURCE_STATE_COMMON && (stateBefore & stateAfter) == stateAfter;
+}
+
+bool Graphics::ResourceStateTracker::IsBarrierOfResource(const D3D12_RESOURCE_BARRIER& barrier, ID3D12Resource* resource) noexcept
+{
+	if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+		return barrier.Transition.pResource == resource;
+	else if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_UAV)
+		return barrier.UAV.pResource == resource;
+
+	return barrier.Aliasing.pResourceBefore == resource || barrier.Aliasing.pResourceAfter == resource;
+}
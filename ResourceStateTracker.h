@@ -0,0 +1,127 @@
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <d3d12.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+namespace Graphics
+{
+	struct ResourceBarrierStatistics
+	{
+		size_t transitionsRequested;
+		size_t barriersDropped;
+		size_t transitionsMerged;
+		size_t splitBarriersIssued;
+		size_t uavBarriersIssued;
+		size_t aliasingBarriersIssued;
+		size_t barriersIssued;
+		size_t barrierCalls;
+	};
+
+	// Keeps the last known state of every registered resource and its subresources. Requested transitions are queued against that state,
+	// redundant ones are dropped, consecutive ones of the same subresource are merged and the rest goes to the command list in one call.
+	class ResourceStateTracker
+	{
+	public:
+		ResourceStateTracker();
+		~ResourceStateTracker();
+
+		void RegisterResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES initialState, uint32_t subresourcesCount);
+		void UnregisterResource(ID3D12Resource* resource);
+
+		void TransitionResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES stateAfter, uint32_t subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+			D3D12_RESOURCE_BARRIER_FLAGS barrierFlags = D3D12_RESOURCE_BARRIER_FLAG_NONE);
+		void SetUAVBarrier(ID3D12Resource* resource);
+		void SetAliasingBarrier(ID3D12Resource* resourceBefore, ID3D12Resource* resourceAfter);
+
+		template<typename CommandListType>
+		void FlushBarriers(CommandListType* commandList)
+		{
+			if (pendingBarriers.empty())
+				return;
+
+			commandList->ResourceBarrier(static_cast<uint32_t>(pendingBarriers.size()), pendingBarriers.data());
+
+			statistics.barriersIssued += pendingBarriers.size();
+			statistics.barrierCalls++;
+
+			pendingBarriers.clear();
+		}
+
+		// Sends only the barriers of one resource and keeps the rest queued, so a second command list can be recorded while a batch is open
+		template<typename CommandListType>
+		void FlushBarriers(CommandListType* commandList, ID3D12Resource* resource)
+		{
+			auto resourceBarriersIt = std::stable_partition(pendingBarriers.begin(), pendingBarriers.end(),
+				[resource](const D3D12_RESOURCE_BARRIER& barrier) { return !IsBarrierOfResource(barrier, resource); });
+
+			if (resourceBarriersIt == pendingBarriers.end())
+				return;
+
+			uint32_t barriersCount = static_cast<uint32_t>(std::distance(resourceBarriersIt, pendingBarriers.end()));
+
+			commandList->ResourceBarrier(barriersCount, &*resourceBarriersIt);
+
+			statistics.barriersIssued += barriersCount;
+			statistics.barrierCalls++;
+
+			pendingBarriers.erase(resourceBarriersIt, pendingBarriers.end());
+		}
+
+		D3D12_RESOURCE_STATES GetResourceState(ID3D12Resource* resource, uint32_t subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) const;
+		bool IsRegistered(ID3D12Resource* resource) const noexcept;
+		bool HasPendingBarriers() const noexcept;
+
+		void SetSplitBarriersEnabled(bool isEnabled) noexcept;
+		bool IsSplitBarriersEnabled() const noexcept;
+
+		void FinishFrame() noexcept;
+		const ResourceBarrierStatistics& GetStatistics() const noexcept;
+		const ResourceBarrierStatistics& GetLastFrameStatistics() const noexcept;
+
+	private:
+		ResourceStateTracker(const ResourceStateTracker&) = delete;
+		ResourceStateTracker& operator=(const ResourceStateTracker&) = delete;
+
+		struct TrackedResource
+		{
+			D3D12_RESOURCE_STATES state;
+			std::vector<D3D12_RESOURCE_STATES> subresourceStates;
+			uint32_t subresourcesCount;
+			uint32_t referencesCount;
+			D3D12_RESOURCE_STATES splitState;
+			bool hasSplitBarrier;
+		};
+
+		TrackedResource& GetTrackedResource(ID3D12Resource* resource, const char* errorMessage);
+
+		void EndSplitTransition(ID3D12Resource* resource, TrackedResource& trackedResource);
+		void AddTransition(ID3D12Resource* resource, uint32_t subresource, D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter,
+			D3D12_RESOURCE_BARRIER_FLAGS barrierFlags);
+		void CollapseSubresourceStates(TrackedResource& trackedResource) noexcept;
+
+		static bool IsTransitionRedundant(D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter) noexcept;
+		static bool IsBarrierOfResource(const D3D12_RESOURCE_BARRIER& barrier, ID3D12Resource* resource) noexcept;
+
+		std::unordered_map<ID3D12Resource*, TrackedResource> trackedResources;
+		std::vector<D3D12_RESOURCE_BARRIER> pendingBarriers;
+
+		bool isSplitBarriersEnabled;
+
+		ResourceBarrierStatistics statistics;
+		ResourceBarrierStatistics lastFrameStatistics;
+	};
+}
@@ -35,6 +35,8 @@ ECHO ON
 @IF %ERRORLEVEL% NEQ 0 (EXIT /b %ERRORLEVEL%)
 %dxcCmd% /Zi /E"main" /Vn"meshStandardVS" /Tvs_6_0 /Fh"MeshStandardVS.hlsl.h" /nologo MeshStandardVS.hlsl
 @IF %ERRORLEVEL% NEQ 0 (EXIT /b %ERRORLEVEL%)
+%dxcCmd% /Zi /E"main" /Vn"meshInstancedVS" /Tvs_6_0 /Fh"MeshInstancedVS.hlsl.h" /nologo MeshInstancedVS.hlsl
+@IF %ERRORLEVEL% NEQ 0 (EXIT /b %ERRORLEVEL%)
 %dxcCmd% /Zi /E"main" /Vn"meshStandardPS" /Tps_6_0 /Fh"MeshStandardPS.hlsl.h" /nologo MeshStandardPS.hlsl
 @IF %ERRORLEVEL% NEQ 0 (EXIT /b %ERRORLEVEL%)
 %dxcCmd% /Zi /E"main" /Vn"setPointLightCS" /Tcs_6_0 /Fh"SetPointLightCS.hlsl.h" /nologo SetPointLightCS.hlsl
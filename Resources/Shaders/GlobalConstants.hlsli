@@ -5,6 +5,7 @@ cbuffer ImmutableGlobalConstBuffer : register(b0)
 	float zNear;
 	float zFar;
 	float2 zLinearizeCoeff;
+	float4 frustumCorners[8];
 };
 
 cbuffer GlobalConstBuffer : register(b1)
@@ -18,4 +19,5 @@ cbuffer GlobalConstBuffer : register(b1)
 	float elapsedTime;
 	float previousElapsedTime;
 	float3 padding;
+	float4 worldFrustumCorners[8];
 };
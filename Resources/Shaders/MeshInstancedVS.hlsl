@@ -0,0 +1,37 @@
+#include "GlobalConstants.hlsli"
+
+struct Input
+{
+	float3 position : POSITION;
+	float3 normal : NORMAL;
+	float2 texCoord : TEXCOORD;
+	float4 instanceWorld0 : INSTANCE_WORLD0;
+	float4 instanceWorld1 : INSTANCE_WORLD1;
+	float4 instanceWorld2 : INSTANCE_WORLD2;
+	float4 instanceWorld3 : INSTANCE_WORLD3;
+	float4 instanceParameters : INSTANCE_PARAMETERS;
+};
+
+struct Output
+{
+	float4 position : SV_Position;
+	float3 normal : NORMAL;
+	float2 texCoord : TEXCOORD0;
+	float4 clipCoord : TEXCOORD1;
+	float4 worldCoord : TEXCOORD2;
+};
+
+Output main(Input input)
+{
+	Output output = (Output)0;
+	
+	float4x4 world = float4x4(input.instanceWorld0, input.instanceWorld1, input.instanceWorld2, input.instanceWorld3);
+	
+	output.worldCoord = mul(float4(input.position, 1.0f), world);
+	output.position = mul(viewProjection, output.worldCoord);
+	output.normal = normalize(mul(input.normal, (float3x3) world));
+	output.texCoord = input.texCoord;
+	output.clipCoord = output.position;
+	
+	return output;
+}
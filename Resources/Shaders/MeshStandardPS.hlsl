@@ -65,19 +65,11 @@ float3 CalculateLighting(PointLight pointLight, float3 position, float3 normal)
 
 float LinearizeZ(float nonLinearZ)
 {
-	float zNear = 0.01f;
-	float zFar = 1024.0f;
-	
-	float2 linearizeCoeff = float2((1.0f - zFar / zNear) / zFar, 1.0f / zNear);
-	
-	return 1.0f / (nonLinearZ * linearizeCoeff.x + linearizeCoeff.y);
+	return 1.0f / (nonLinearZ * zLinearizeCoeff.x + zLinearizeCoeff.y);
 }
 
 float FromNearFarTo01(float z)
 {
-	float zNear = 0.01f;
-	float zFar = 1024.0f;
-	
 	return (z - zNear) / (zFar - zNear);
 }
 
@@ -1,20 +1,32 @@
 #include "Scene.h"
 
-Graphics::Scene::Scene()
-	: mainCamera(nullptr)
+Graphics::Scene::Scene(SpatialIndexType spatialIndexType)
+	: mainCamera(nullptr), previousViewVersion(0), previousProjectionVersion(0), visibleObjectsListValid(false), previousOccludersVersion(0), cullingStatistics{},
+	minScreenSize(0.0f), levelOfDetailHysteresis(0.1f), levelOfDetailStatistics{}, instanceBufferCapacity(0), drawStatistics{}
 {
-	const uint32_t octreeDepth = 5;
-	const BoundingBox octreeBoundingBox = { {-1024.0f, -1024.0f, -1024.0f}, {1024.0f, 1024.0f, 1024.0f} };
+	if (spatialIndexType == SpatialIndexType::SPATIAL_INDEX_BVH)
+	{
+		spatialIndex = std::shared_ptr<ISpatialIndex>(new BoundingVolumeHierarchy());
+	}
+	else
+	{
+		const uint32_t octreeDepth = 5;
+		const BoundingBox octreeBoundingBox = { {-1024.0f, -1024.0f, -1024.0f}, {1024.0f, 1024.0f, 1024.0f} };
 
-	octree = std::shared_ptr<Octree>(new Octree(octreeDepth, octreeBoundingBox));
+		spatialIndex = std::shared_ptr<ISpatialIndex>(new Octree(octreeDepth, octreeBoundingBox));
+	}
 
+	occlusionCuller = std::shared_ptr<OcclusionCuller>(new OcclusionCuller());
+	boundingBoxTransformer = std::shared_ptr<BoundingBoxTransformer>(new BoundingBoxTransformer());
+	broadphase = std::shared_ptr<SweepAndPrune>(new SweepAndPrune());
 	lightingSystem = std::shared_ptr<LightingSystem>(new LightingSystem());
 	uiSystem = std::shared_ptr<UISystem>(new UISystem());
 }
 
 Graphics::Scene::~Scene()
 {
-
+	if (resourceManager.IsValid(instanceBufferId))
+		resourceManager.Release(instanceBufferId);
 }
 
 Graphics::LightingSystem* Graphics::Scene::GetLightingSystem()
@@ -27,9 +39,15 @@ Graphics::UISystem* Graphics::Scene::GetUISystem()
 	return uiSystem.get();
 }
 
+Graphics::OcclusionCuller* Graphics::Scene::GetOcclusionCuller()
+{
+	return occlusionCuller.get();
+}
+
 void Graphics::Scene::SetMainCamera(const Camera* camera)
 {
 	mainCamera = camera;
+	visibleObjectsListValid = false;
 }
 
 void Graphics::Scene::EmplaceComputeObject(const ComputeObject* object)
@@ -45,7 +63,138 @@ void Graphics::Scene::EmplaceComputeObject(const ComputeObject* object)
 
 void Graphics::Scene::EmplaceGraphicObject(const GraphicObject* object, bool isDynamic)
 {
-	octree->AddObject(object, isDynamic);
+	spatialIndex->AddObject(object, isDynamic);
+
+	if (isDynamic)
+	{
+		dynamicObjects.push_back(object);
+		broadphase->AddObject(object);
+	}
+	else
+	{
+		staticObjects.push_back(object);
+		potentiallyVisibleSet.reset();
+	}
+
+	visibleObjectsListValid = false;
+}
+
+void Graphics::Scene::MarkObjectDirty(GraphicObject* object)
+{
+	if (object == nullptr)
+		return;
+
+	dirtyObjects.insert(object);
+
+	// The baked visibility holds for the static objects where they were, a moved one could show up in cells that never saw it
+	if (potentiallyVisibleSet && potentiallyVisibleSet->IsObjectBaked(object))
+		ResetPotentiallyVisibleSet();
+}
+
+void Graphics::Scene::SetObjectWorldMatrix(GraphicObject* object, const float4x4& worldMatrix)
+{
+	if (object == nullptr)
+		return;
+
+	const float4x4& currentWorldMatrix = object->GetWorldMatrix();
+
+	if (XMVector4Equal(currentWorldMatrix.r[0], worldMatrix.r[0]) && XMVector4Equal(currentWorldMatrix.r[1], worldMatrix.r[1]) &&
+		XMVector4Equal(currentWorldMatrix.r[2], worldMatrix.r[2]) && XMVector4Equal(currentWorldMatrix.r[3], worldMatrix.r[3]))
+		return;
+
+	object->SetWorldMatrix(worldMatrix);
+	MarkObjectDirty(object);
+}
+
+void Graphics::Scene::SetMinScreenSize(float _minScreenSize)
+{
+	minScreenSize = (std::max)(_minScreenSize, 0.0f);
+	visibleObjectsListValid = false;
+}
+
+void Graphics::Scene::SetLevelOfDetailHysteresis(float _levelOfDetailHysteresis)
+{
+	levelOfDetailHysteresis = std::clamp(_levelOfDetailHysteresis, 0.0f, 0.9f);
+	visibleObjectsListValid = false;
+}
+
+void Graphics::Scene::BakePotentiallyVisibleSet(uint32_t cellsPerAxis, float zNear, float zFar)
+{
+	if (!occlusionCuller->HasOccluders())
+		throw std::exception("Graphics::Scene::BakePotentiallyVisibleSet: no occluders to bake visibility against");
+
+	UpdateDirtyObjects();
+
+	potentiallyVisibleSet = std::shared_ptr<PotentiallyVisibleSet>(new PotentiallyVisibleSet(cellsPerAxis));
+	potentiallyVisibleSet->Bake(staticObjects, *occlusionCuller, zNear, zFar);
+
+	visibleObjectsListValid = false;
+}
+
+void Graphics::Scene::ResetPotentiallyVisibleSet()
+{
+	potentiallyVisibleSet.reset();
+	visibleObjectsListValid = false;
+}
+
+void Graphics::Scene::PrepareVisibleObjectsLists(const std::vector<const Camera*>& cameras, std::vector<VisibleObjectsLists>& visibleObjectsLists)
+{
+	if (!dirtyObjects.empty())
+	{
+		UpdateDirtyObjects();
+
+		visibleObjectsListValid = false;
+	}
+
+	spatialIndex->PrepareVisibleObjectsLists(cameras, visibleObjectsLists);
+}
+
+void Graphics::Scene::FindOverlappingDynamicObjects(std::vector<ObjectPair>& overlappingPairs)
+{
+	if (!dirtyObjects.empty())
+	{
+		UpdateDirtyObjects();
+
+		visibleObjectsListValid = false;
+	}
+
+	broadphase->Update();
+	broadphase->FindOverlappingPairs(overlappingPairs);
+}
+
+const Graphics::CullingStatistics& Graphics::Scene::GetCullingStatistics() const noexcept
+{
+	return cullingStatistics;
+}
+
+const Graphics::CullingStatistics& Graphics::Scene::GetMultiViewCullingStatistics() const noexcept
+{
+	return spatialIndex->GetMultiViewCullingStatistics();
+}
+
+const Graphics::LevelOfDetailStatistics& Graphics::Scene::GetLevelOfDetailStatistics() const noexcept
+{
+	return levelOfDetailStatistics;
+}
+
+const Graphics::BoundingBoxTransformStatistics& Graphics::Scene::GetBoundingBoxTransformStatistics() const noexcept
+{
+	return boundingBoxTransformer->GetTransformStatistics();
+}
+
+const Graphics::BroadphaseStatistics& Graphics::Scene::GetBroadphaseStatistics() const noexcept
+{
+	return broadphase->GetBroadphaseStatistics();
+}
+
+const Graphics::DrawStatistics& Graphics::Scene::GetDrawStatistics() const noexcept
+{
+	return drawStatistics;
+}
+
+const Graphics::PotentiallyVisibleSetStatistics* Graphics::Scene::GetPotentiallyVisibleSetStatistics() const noexcept
+{
+	return potentiallyVisibleSet ? &potentiallyVisibleSet->GetStatistics() : nullptr;
 }
 
 void Graphics::Scene::ExecuteScripts(ID3D12GraphicsCommandList* commandList, size_t mouseX, size_t mouseY)
@@ -56,10 +205,7 @@ void Graphics::Scene::ExecuteScripts(ID3D12GraphicsCommandList* commandList, siz
 	if (mainCamera == nullptr)
 		return;
 
-	visibleObjectsList.clear();
-	visibleTransparentObjectsList.clear();
-	visibleEffectObjectsList.clear();
-	octree->PrepareVisibleObjectsList(*mainCamera, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+	PrepareVisibleObjectsList();
 
 	for (auto& visibleObject : visibleObjectsList)
 		visibleObject->Execute(commandList);
@@ -75,16 +221,402 @@ void Graphics::Scene::ExecuteScripts(ID3D12GraphicsCommandList* commandList, siz
 	uiSystem->ExecuteScripts(mouseX, mouseY);
 }
 
+void Graphics::Scene::PrepareVisibleObjectsList()
+{
+	if (CanReuseVisibleObjectsList())
+	{
+		cullingStatistics = {};
+		cullingStatistics.objectsVisible = visibleObjectsList.size() + visibleTransparentObjectsList.size() + visibleEffectObjectsList.size();
+		cullingStatistics.previousFrameReused = true;
+
+		return;
+	}
+
+	UpdateDirtyObjects();
+
+	visibleObjectsList.clear();
+	visibleTransparentObjectsList.clear();
+	visibleEffectObjectsList.clear();
+
+	if (!PrepareVisibleObjectsListFromPotentiallyVisibleSet())
+	{
+		spatialIndex->PrepareVisibleObjectsList(*mainCamera, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+
+		cullingStatistics = spatialIndex->GetCullingStatistics();
+	}
+
+	if (occlusionCuller->HasOccluders())
+	{
+		occlusionCuller->RasterizeOccluders(*mainCamera);
+		occlusionCuller->FilterVisibleObjects(visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+
+		cullingStatistics.objectsVisible -= occlusionCuller->GetOcclusionStatistics().objectsOccluded;
+	}
+
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		levelOfDetailStatistics = {};
+
+		SelectLevelsOfDetail(visibleObjectsList);
+		SelectLevelsOfDetail(visibleTransparentObjectsList);
+		SelectLevelsOfDetail(visibleEffectObjectsList);
+
+		cullingStatistics.objectsVisible -= levelOfDetailStatistics.objectsScreenSizeCulled;
+
+		levelOfDetailStatistics.selectionTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	}
+
+	BuildDrawCommands();
+
+	previousViewVersion = mainCamera->GetViewVersion();
+	previousProjectionVersion = mainCamera->GetProjectionVersion();
+	previousOccludersVersion = occlusionCuller->GetOccludersVersion();
+	visibleObjectsListValid = true;
+}
+
+void Graphics::Scene::UpdateDirtyObjects()
+{
+	if (dirtyObjects.empty())
+		return;
+
+	boundingBoxTransformer->Clear();
+
+	for (auto& dirtyObject : dirtyObjects)
+		boundingBoxTransformer->AddBoundingBox(dirtyObject->GetLocalBoundingBox(), dirtyObject->GetWorldMatrix());
+
+	boundingBoxTransformer->Transform();
+
+	size_t boundingBoxId = 0;
+
+	for (auto& dirtyObject : dirtyObjects)
+		dirtyObject->UpdateWorldBounds(boundingBoxTransformer->GetTransformedBoundingBox(boundingBoxId++));
+
+	spatialIndex->UpdateObjects(ObjectPtrPool(dirtyObjects.begin(), dirtyObjects.end()));
+
+	dirtyObjects.clear();
+}
+
+bool Graphics::Scene::PrepareVisibleObjectsListFromPotentiallyVisibleSet()
+{
+	uint32_t cellId;
+
+	if (!potentiallyVisibleSet || !potentiallyVisibleSet->FindCell(mainCamera->GetPosition(), cellId))
+		return false;
+
+	cullingStatistics = {};
+
+	potentiallyVisibleSet->GetCellObjects(cellId, cellObjects);
+
+	cullingStatistics.objectsPrefiltered = potentiallyVisibleSet->GetObjectsCount() - cellObjects.size();
+
+	auto testObjects = [this](const ObjectPtrPool& objects)
+	{
+		for (auto& object : objects)
+		{
+			uint32_t lastRejectingPlane = 0;
+
+			cullingStatistics.objectsTested++;
+
+			if (!ISpatialIndex::IsObjectVisible(*mainCamera, object, Camera::FRUSTUM_ALL_PLANES_MASK, lastRejectingPlane, cullingStatistics))
+				continue;
+
+			ISpatialIndex::PushVisibleObject(object, visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+			cullingStatistics.objectsVisible++;
+		}
+	};
+
+	testObjects(cellObjects);
+	testObjects(dynamicObjects);
+
+	return true;
+}
+
+bool Graphics::Scene::CanReuseVisibleObjectsList() const
+{
+	if (!visibleObjectsListValid || !dirtyObjects.empty() || occlusionCuller->GetOccludersVersion() != previousOccludersVersion)
+		return false;
+
+	return mainCamera->GetViewVersion() == previousViewVersion && mainCamera->GetProjectionVersion() == previousProjectionVersion;
+}
+
+void Graphics::Scene::SelectLevelsOfDetail(ObjectPtrPool& objectsList)
+{
+	size_t remainingObjectsCount = 0;
+
+	for (auto& object : objectsList)
+	{
+		float screenSize = CalculateScreenSize(object);
+
+		if (screenSize < minScreenSize)
+		{
+			levelOfDetailStatistics.objectsScreenSizeCulled++;
+
+			continue;
+		}
+
+		objectsList[remainingObjectsCount++] = object;
+
+		uint32_t levelsOfDetailCount = object->GetLevelsOfDetailCount();
+
+		if (levelsOfDetailCount == 1)
+		{
+			levelOfDetailStatistics.objectsPerLevelOfDetail[0]++;
+
+			continue;
+		}
+
+		auto levelOfDetailIt = objectsLevelsOfDetail.try_emplace(object, 0).first;
+		uint32_t levelOfDetail = levelOfDetailIt->second;
+
+		while (levelOfDetail + 1 < levelsOfDetailCount && screenSize < object->GetLevelOfDetailScreenSize(levelOfDetail + 1) * (1.0f - levelOfDetailHysteresis))
+			levelOfDetail++;
+
+		if (levelOfDetail == levelOfDetailIt->second)
+			while (levelOfDetail > 0 && screenSize >= object->GetLevelOfDetailScreenSize(levelOfDetail) * (1.0f + levelOfDetailHysteresis))
+				levelOfDetail--;
+
+		if (levelOfDetail != levelOfDetailIt->second)
+		{
+			levelOfDetailIt->second = levelOfDetail;
+			levelOfDetailStatistics.objectsLevelOfDetailChanged++;
+		}
+
+		levelOfDetailStatistics.objectsPerLevelOfDetail[(std::min)(levelOfDetail, static_cast<uint32_t>(levelOfDetailStatistics.objectsPerLevelOfDetail.size() - 1))]++;
+	}
+
+	objectsList.resize(remainingObjectsCount);
+}
+
+float Graphics::Scene::CalculateScreenSize(const GraphicObject* object) const
+{
+	const BoundingSphere& boundingSphere = object->GetBoundingSphere();
+
+	float radius = boundingSphere.radius;
+	float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&boundingSphere.center) - XMLoadFloat3(&mainCamera->GetPosition())));
+
+	if (distance <= radius)
+		return FLT_MAX;
+
+	float projectionScaleY = XMVectorGetY(mainCamera->GetProjection().r[1]);
+
+	return radius * projectionScaleY * static_cast<float>(GraphicsSettings::GetResolutionY()) / distance;
+}
+
+uint32_t Graphics::Scene::GetLevelOfDetail(const GraphicObject* object) const
+{
+	if (object->GetLevelsOfDetailCount() == 1)
+		return 0;
+
+	auto levelOfDetailIt = objectsLevelsOfDetail.find(object);
+
+	return levelOfDetailIt == objectsLevelsOfDetail.end() ? 0 : levelOfDetailIt->second;
+}
+
+void Graphics::Scene::BuildDrawCommands()
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	drawCommands.clear();
+	pipelineStateIds.clear();
+	materialIds.clear();
+	renderableIds.clear();
+
+	AppendDrawCommands(visibleObjectsList);
+	AppendDrawCommands(visibleTransparentObjectsList);
+	AppendDrawCommands(visibleEffectObjectsList);
+
+	RadixSort(drawCommands, swapDrawCommands);
+
+	drawStatistics.sortTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+	BuildDrawBatches();
+}
+
+void Graphics::Scene::AppendDrawCommands(const ObjectPtrPool& objectsList)
+{
+	for (auto& object : objectsList)
+	{
+		uint32_t levelOfDetail = GetLevelOfDetail(object);
+
+		drawCommands.push_back({ CalculateSortKey(object, levelOfDetail), object, levelOfDetail });
+	}
+}
+
+uint64_t Graphics::Scene::CalculateSortKey(const GraphicObject* object, uint32_t levelOfDetail)
+{
+	const Material* material = object->GetMaterial();
+
+	uint64_t pipelineStateId = GetSortKeyId(pipelineStateIds, material != nullptr ? material->GetPipelineState() : nullptr, SORT_KEY_PIPELINE_STATE_BITS);
+	uint64_t materialId = GetSortKeyId(materialIds, material, SORT_KEY_MATERIAL_BITS);
+	uint64_t renderableId = GetSortKeyId(renderableIds, object->GetRenderable(levelOfDetail), SORT_KEY_RENDERABLE_BITS);
+
+	const BoundingBox& boundingBox = object->GetBoundingBox();
+	floatN center = (XMLoadFloat3(&boundingBox.minCornerPoint) + XMLoadFloat3(&boundingBox.maxCornerPoint)) * 0.5f;
+
+	float viewDepth = XMVectorGetZ(XMVector3TransformCoord(center, mainCamera->GetView()));
+	float normalizedDepth = std::clamp((viewDepth - mainCamera->GetZNear()) / (mainCamera->GetZFar() - mainCamera->GetZNear()), 0.0f, 1.0f);
+
+	const uint64_t depthMask = (1ULL << SORT_KEY_DEPTH_BITS) - 1;
+	uint64_t depth = static_cast<uint64_t>(normalizedDepth * depthMask);
+
+	uint64_t layer = static_cast<uint64_t>(object->GetRenderingLayer());
+	uint64_t stateBits = (((pipelineStateId << SORT_KEY_MATERIAL_BITS) | materialId) << SORT_KEY_RENDERABLE_BITS) | renderableId;
+	const uint32_t stateBitsCount = SORT_KEY_PIPELINE_STATE_BITS + SORT_KEY_MATERIAL_BITS + SORT_KEY_RENDERABLE_BITS;
+
+	if (object->GetRenderingLayer() == RenderingLayer::RENDERING_LAYER_OPAQUE)
+		return (((layer << stateBitsCount) | stateBits) << SORT_KEY_DEPTH_BITS) | depth;
+
+	return (((layer << SORT_KEY_DEPTH_BITS) | (depthMask - depth)) << stateBitsCount) | stateBits;
+}
+
+uint32_t Graphics::Scene::GetSortKeyId(std::unordered_map<const void*, uint32_t>& sortKeyIds, const void* key, uint32_t bits)
+{
+	uint32_t maxId = (1U << bits) - 1;
+
+	return sortKeyIds.try_emplace(key, (std::min)(static_cast<uint32_t>(sortKeyIds.size()), maxId)).first->second;
+}
+
+void Graphics::Scene::RadixSort(std::vector<DrawCommand>& commands, std::vector<DrawCommand>& swapCommands)
+{
+	const uint32_t digitBits = 8;
+	const uint32_t bucketsCount = 1 << digitBits;
+
+	if (commands.size() < 2)
+		return;
+
+	swapCommands.resize(commands.size());
+
+	for (uint32_t shift = 0; shift < 64; shift += digitBits)
+	{
+		std::array<size_t, bucketsCount> bucketOffsets{};
+
+		for (auto& command : commands)
+			bucketOffsets[(command.sortKey >> shift) & (bucketsCount - 1)]++;
+
+		if (bucketOffsets[(commands.front().sortKey >> shift) & (bucketsCount - 1)] == commands.size())
+			continue;
+
+		size_t offset = 0;
+
+		for (auto& bucketOffset : bucketOffsets)
+		{
+			size_t bucketSize = bucketOffset;
+			bucketOffset = offset;
+			offset += bucketSize;
+		}
+
+		for (auto& command : commands)
+			swapCommands[bucketOffsets[(command.sortKey >> shift) & (bucketsCount - 1)]++] = command;
+
+		commands.swap(swapCommands);
+	}
+}
+
+void Graphics::Scene::BuildDrawBatches()
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	drawBatches.clear();
+	instancesData.clear();
+
+	drawStatistics.instancedBatches = 0;
+	drawStatistics.instancedObjects = 0;
+
+	for (size_t drawCommandId = 0; drawCommandId < drawCommands.size();)
+	{
+		size_t lastDrawCommandId = drawCommandId + 1;
+
+		while (lastDrawCommandId < drawCommands.size() && CanInstanceTogether(drawCommands[drawCommandId], drawCommands[lastDrawCommandId]))
+			lastDrawCommandId++;
+
+		uint32_t drawCommandsCount = static_cast<uint32_t>(lastDrawCommandId - drawCommandId);
+
+		// The pipeline of an instancing material reads the instance stream, so even a lone object of it is drawn as a batch of one
+		if (!IsInstanceable(drawCommands[drawCommandId]))
+		{
+			drawBatches.push_back({ drawCommandId, 1, 0 });
+			drawCommandId++;
+
+			continue;
+		}
+
+		drawBatches.push_back({ drawCommandId, drawCommandsCount, static_cast<uint32_t>(instancesData.size()) });
+
+		for (; drawCommandId < lastDrawCommandId; drawCommandId++)
+			instancesData.push_back({ drawCommands[drawCommandId].object->GetWorldMatrix(), drawCommands[drawCommandId].object->GetInstanceParameters() });
+
+		drawStatistics.instancedBatches++;
+		drawStatistics.instancedObjects += drawCommandsCount;
+	}
+
+	drawStatistics.drawCalls = drawBatches.size();
+
+	if (!instancesData.empty())
+	{
+		if (instancesData.size() > instanceBufferCapacity)
+		{
+			instanceBufferCapacity = (std::max)(instancesData.size(), instanceBufferCapacity * 2);
+
+			// Batches recorded in frames still in flight read the old buffer, so it goes through the deferred release
+			if (resourceManager.IsValid(instanceBufferId))
+				resourceManager.Release(instanceBufferId);
+
+			std::vector<uint8_t> initialData(instanceBufferCapacity * sizeof(InstanceData));
+			instanceBufferId = resourceManager.CreateDynamicVertexBuffer(initialData.data(), initialData.size(), sizeof(InstanceData));
+		}
+
+		resourceManager.UpdateDynamicVertexBuffer(instanceBufferId, instancesData.data(), instancesData.size() * sizeof(InstanceData));
+	}
+
+	drawStatistics.batchingTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+bool Graphics::Scene::IsInstanceable(const DrawCommand& drawCommand) const
+{
+	const Material* material = drawCommand.object->GetMaterial();
+	const IRenderable* renderable = drawCommand.object->GetRenderable(drawCommand.levelOfDetail);
+
+	return material != nullptr && renderable != nullptr && material->IsInstancingEnabled() && renderable->SupportsInstancing();
+}
+
+bool Graphics::Scene::CanInstanceTogether(const DrawCommand& firstCommand, const DrawCommand& secondCommand) const
+{
+	if (!IsInstanceable(firstCommand))
+		return false;
+
+	return secondCommand.object->GetMaterial() == firstCommand.object->GetMaterial() &&
+		secondCommand.object->GetRenderable(secondCommand.levelOfDetail) == firstCommand.object->GetRenderable(firstCommand.levelOfDetail);
+}
+
 void Graphics::Scene::Draw(ID3D12GraphicsCommandList* commandList) const
 {
-	for (auto& visibleObject : visibleObjectsList)
-		visibleObject->Draw(commandList);
+	DrawStateCache drawStateCache{};
 
-	for (auto& visibleObject : visibleTransparentObjectsList)
-		visibleObject->Draw(commandList);
+	for (auto& drawBatch : drawBatches)
+	{
+		const DrawCommand& drawCommand = drawCommands[drawBatch.firstDrawCommand];
 
-	for (auto& visibleObject : visibleEffectObjectsList)
-		visibleObject->Draw(commandList);
+		if (drawBatch.drawCommandsCount == 1)
+		{
+			drawCommand.object->Draw(commandList, drawCommand.levelOfDetail, drawStateCache);
+
+			continue;
+		}
+
+		D3D12_VERTEX_BUFFER_VIEW instanceBufferView = resourceManager.GetVertexBufferView(instanceBufferId);
+		instanceBufferView.BufferLocation += drawBatch.firstInstance * sizeof(InstanceData);
+		instanceBufferView.SizeInBytes = drawBatch.drawCommandsCount * sizeof(InstanceData);
+
+		drawCommand.object->GetRenderable(drawCommand.levelOfDetail)->DrawInstanced(commandList, drawCommand.object->GetMaterial(), drawStateCache,
+			instanceBufferView, drawBatch.drawCommandsCount);
+	}
+
+	drawStatistics.pipelineStateChanges = drawStateCache.pipelineStateChanges;
+	drawStatistics.rootSignatureChanges = drawStateCache.rootSignatureChanges;
+	drawStatistics.rootArgumentChanges = drawStateCache.rootArgumentChanges;
+	drawStatistics.inputAssemblerChanges = drawStateCache.inputAssemblerChanges;
+	drawStatistics.bindsSkipped = drawStateCache.bindsSkipped;
 }
 
 void Graphics::Scene::DrawUI(ID3D12GraphicsCommandList* commandList) const
@@ -4,40 +4,160 @@
 #include "ComputeObject.h"
 #include "Camera.h"
 #include "Octree.h"
+#include "BoundingVolumeHierarchy.h"
+#include "OcclusionCuller.h"
+#include "BoundingBoxTransformer.h"
+#include "PotentiallyVisibleSet.h"
+#include "SweepAndPrune.h"
 #include "LightingSystem.h"
 #include "UISystem.h"
 #include "GraphicsSettings.h"
 
 namespace Graphics
 {
+	struct LevelOfDetailStatistics
+	{
+		size_t objectsScreenSizeCulled;
+		size_t objectsLevelOfDetailChanged;
+		std::array<size_t, 8> objectsPerLevelOfDetail;
+		float selectionTime;
+	};
+
+	struct DrawStatistics
+	{
+		size_t drawCalls;
+		size_t pipelineStateChanges;
+		size_t rootSignatureChanges;
+		size_t rootArgumentChanges;
+		size_t inputAssemblerChanges;
+		size_t bindsSkipped;
+		size_t instancedBatches;
+		size_t instancedObjects;
+		float sortTime;
+		float batchingTime;
+	};
+
 	class Scene
 	{
 	public:
-		Scene();
+		Scene(SpatialIndexType spatialIndexType = SpatialIndexType::SPATIAL_INDEX_OCTREE);
 		~Scene();
 
 		LightingSystem* GetLightingSystem();
 		UISystem* GetUISystem();
+		OcclusionCuller* GetOcclusionCuller();
 
 		void SetMainCamera(const Camera* camera);
 		void EmplaceComputeObject(const ComputeObject* object);
 		void EmplaceGraphicObject(const GraphicObject* object, bool isDynamic);
+		void MarkObjectDirty(GraphicObject* object);
+		void SetObjectWorldMatrix(GraphicObject* object, const float4x4& worldMatrix);
+
+		void SetMinScreenSize(float _minScreenSize);
+		void SetLevelOfDetailHysteresis(float _levelOfDetailHysteresis);
+
+		void BakePotentiallyVisibleSet(uint32_t cellsPerAxis, float zNear, float zFar);
+		void ResetPotentiallyVisibleSet();
+
+		void PrepareVisibleObjectsLists(const std::vector<const Camera*>& cameras, std::vector<VisibleObjectsLists>& visibleObjectsLists);
+		void FindOverlappingDynamicObjects(std::vector<ObjectPair>& overlappingPairs);
+
+		const CullingStatistics& GetCullingStatistics() const noexcept;
+		const CullingStatistics& GetMultiViewCullingStatistics() const noexcept;
+		const LevelOfDetailStatistics& GetLevelOfDetailStatistics() const noexcept;
+		const BoundingBoxTransformStatistics& GetBoundingBoxTransformStatistics() const noexcept;
+		const PotentiallyVisibleSetStatistics* GetPotentiallyVisibleSetStatistics() const noexcept;
+		const BroadphaseStatistics& GetBroadphaseStatistics() const noexcept;
+		const DrawStatistics& GetDrawStatistics() const noexcept;
 
 		void ExecuteScripts(ID3D12GraphicsCommandList* commandList, size_t mouseX, size_t mouseY);
 		void Draw(ID3D12GraphicsCommandList* commandList) const;
 		void DrawUI(ID3D12GraphicsCommandList* commandList) const;
 
 	private:
+		void PrepareVisibleObjectsList();
+		bool CanReuseVisibleObjectsList() const;
+		void UpdateDirtyObjects();
+		bool PrepareVisibleObjectsListFromPotentiallyVisibleSet();
+
+		void SelectLevelsOfDetail(ObjectPtrPool& objectsList);
+		float CalculateScreenSize(const GraphicObject* object) const;
+		uint32_t GetLevelOfDetail(const GraphicObject* object) const;
+
+		struct DrawCommand
+		{
+			uint64_t sortKey;
+			const GraphicObject* object;
+			uint32_t levelOfDetail;
+		};
+
+		static constexpr uint32_t SORT_KEY_DEPTH_BITS = 24;
+		static constexpr uint32_t SORT_KEY_RENDERABLE_BITS = 16;
+		static constexpr uint32_t SORT_KEY_MATERIAL_BITS = 12;
+		static constexpr uint32_t SORT_KEY_PIPELINE_STATE_BITS = 10;
+
+		struct DrawBatch
+		{
+			size_t firstDrawCommand;
+			uint32_t drawCommandsCount;
+			uint32_t firstInstance;
+		};
+
+		void BuildDrawCommands();
+		void AppendDrawCommands(const ObjectPtrPool& objectsList);
+		uint64_t CalculateSortKey(const GraphicObject* object, uint32_t levelOfDetail);
+		static uint32_t GetSortKeyId(std::unordered_map<const void*, uint32_t>& sortKeyIds, const void* key, uint32_t bits);
+		static void RadixSort(std::vector<DrawCommand>& commands, std::vector<DrawCommand>& swapCommands);
+		void BuildDrawBatches();
+		bool IsInstanceable(const DrawCommand& drawCommand) const;
+		bool CanInstanceTogether(const DrawCommand& firstCommand, const DrawCommand& secondCommand) const;
+
 		const Camera* mainCamera;
 
+		uint64_t previousViewVersion;
+		uint64_t previousProjectionVersion;
+		bool visibleObjectsListValid;
+		uint64_t previousOccludersVersion;
+
+		std::set<GraphicObject*> dirtyObjects;
+		ObjectPtrPool staticObjects;
+		ObjectPtrPool dynamicObjects;
+		ObjectPtrPool cellObjects;
+		CullingStatistics cullingStatistics;
+
+		float minScreenSize;
+		float levelOfDetailHysteresis;
+
+		std::unordered_map<const GraphicObject*, uint32_t> objectsLevelsOfDetail;
+		LevelOfDetailStatistics levelOfDetailStatistics;
+
 		ObjectPtrPool visibleObjectsList;
 		ObjectPtrPool visibleTransparentObjectsList;
 		ObjectPtrPool visibleEffectObjectsList;
+
+		std::vector<DrawCommand> drawCommands;
+		std::vector<DrawCommand> swapDrawCommands;
+		std::unordered_map<const void*, uint32_t> pipelineStateIds;
+		std::unordered_map<const void*, uint32_t> materialIds;
+		std::unordered_map<const void*, uint32_t> renderableIds;
+
+		std::vector<DrawBatch> drawBatches;
+		std::vector<InstanceData> instancesData;
+		VertexBufferId instanceBufferId;
+		size_t instanceBufferCapacity;
+
+		mutable DrawStatistics drawStatistics;
 		std::vector<const ComputeObject*> computeObjects;
 
-		std::shared_ptr<Octree> octree;
+		std::shared_ptr<ISpatialIndex> spatialIndex;
+		std::shared_ptr<OcclusionCuller> occlusionCuller;
+		std::shared_ptr<BoundingBoxTransformer> boundingBoxTransformer;
+		std::shared_ptr<PotentiallyVisibleSet> potentiallyVisibleSet;
+		std::shared_ptr<SweepAndPrune> broadphase;
 
 		std::shared_ptr<LightingSystem> lightingSystem;
 		std::shared_ptr<UISystem> uiSystem;
+
+		ResourceManager& resourceManager = ResourceManager::GetInstance();
 	};
 }
@@ -41,15 +41,11 @@ void Graphics::SceneManager::InitializeTestScene(ID3D12Device* device, ID3D12Gra
 
 	auto paddingDefaultTextureId = resourceManager.CreateTexture("Resources\\Textures\\PaddingDefaultTexture.dds");
 
-	immutableGlobalConstBuffer.projection = camera->GetProjection();
-	immutableGlobalConstBuffer.invProjection = camera->GetInvProjection();
-	immutableGlobalConstBuffer.zNear = nearZ;
-	immutableGlobalConstBuffer.zFar = farZ;
-	immutableGlobalConstBuffer.zLinearizeCoeff = { (1.0f - farZ / nearZ) / farZ, 1.0f / nearZ };
-
 	immutableGlobalConstBufferId = resourceManager.CreateConstantBuffer(&immutableGlobalConstBuffer, sizeof(immutableGlobalConstBuffer));
 	globalConstBufferId = resourceManager.CreateConstantBuffer(&globalConstBuffer, sizeof(globalConstBuffer));
 
+	PublishCameraConstants();
+
 	currentScene = CreateNewScene();
 
 	currentScene->GetLightingSystem()->CreatePointLight(float3(0.0f, 10.0f, 0.0f), float3(0.0f, 1.0f, 0.0f), 15.0f, 1.0f, false);
@@ -84,6 +80,7 @@ void Graphics::SceneManager::InitializeTestScene(ID3D12Device* device, ID3D12Gra
 
 	goldenFrame = std::make_shared<GraphicObject>();
 	goldenFrame->SetRenderingLayer(RenderingLayer::RENDERING_LAYER_OPAQUE);
+	goldenFrame->SetWorldMatrix(goldenFrameConstBuffer.world);
 	goldenFrame->AssignRenderableEntity(goldenFrameMesh.get());
 	goldenFrame->AssignMaterial(goldenFrameMaterial.get());
 
@@ -153,6 +150,7 @@ void Graphics::SceneManager::InitializeTestScene(ID3D12Device* device, ID3D12Gra
 
 	testCloth = std::shared_ptr<GraphicObject>(new GraphicObject());
 	testCloth->SetRenderingLayer(RenderingLayer::RENDERING_LAYER_OPAQUE);
+	testCloth->SetWorldMatrix(clothConstBuffer.world);
 	testCloth->AssignRenderableEntity(testClothCloth.get());
 	testCloth->AssignMaterial(testClothMaterial.get());
 
@@ -210,6 +208,8 @@ void Graphics::SceneManager::InitializeTestScene(ID3D12Device* device, ID3D12Gra
 	currentScene->EmplaceGraphicObject(goldenFrame.get(), false);
 	currentScene->EmplaceGraphicObject(testEffect.get(), false);
 	currentScene->EmplaceGraphicObject(testCloth.get(), false);
+
+	testSceneBufferMemoryReport = resourceManager.GetBufferMemoryReport();
 }
 
 void Graphics::SceneManager::ExecuteScripts(ID3D12GraphicsCommandList* commandList, size_t mouseX, size_t mouseY)
@@ -228,12 +228,9 @@ void Graphics::SceneManager::DrawCurrentScene(ID3D12GraphicsCommandList* command
 	camera->LookAt(float3(0.0f, 5.0f, 0.0f));
 	//camera->Move(float3(std::cos(cameraShift) * 4.0f, 2.0f, -6.0f));
 	camera->Update();
-	
-	globalConstBuffer.view = camera->GetView();
-	globalConstBuffer.viewProjection = camera->GetViewProjection();
-	globalConstBuffer.invView = camera->GetInvView();
-	globalConstBuffer.invViewProjection = camera->GetInvProjection();
-	globalConstBuffer.cameraPosition = camera->GetPosition();
+
+	PublishCameraConstants();
+
 	globalConstBuffer.previousElapsedTime = globalConstBuffer.elapsedTime;
 	globalConstBuffer.elapsedTime = 1.0f / Graphics::GraphicsSettings::GetFramesPerSecond();
 	globalConstBuffer.randomValues = { Random01(randomEngine.get()), Random01(randomEngine.get()), Random01(randomEngine.get()), Random01(randomEngine.get()) };
@@ -245,7 +242,10 @@ void Graphics::SceneManager::DrawCurrentScene(ID3D12GraphicsCommandList* command
 	floatN rotation = XMQuaternionRotationRollPitchYaw(0.0f, 0.0f, 0.0f);
 	float3 scale = float3(1.0f, 1.0f, 1.0f);
 	
-	goldenFrameConstBuffer.world = XMMatrixAffineTransformation(XMLoadFloat3(&scale), XMLoadFloat3(&rotationOrigin), rotation, XMLoadFloat3(&translation));
+	currentScene->SetObjectWorldMatrix(goldenFrame.get(), XMMatrixAffineTransformation(XMLoadFloat3(&scale), XMLoadFloat3(&rotationOrigin), rotation,
+		XMLoadFloat3(&translation)));
+
+	goldenFrameConstBuffer.world = goldenFrame->GetWorldMatrix();
 	goldenFrameConstBuffer.wvp = XMMatrixMultiply(goldenFrameConstBuffer.world, camera->GetViewProjection());// XMMatrixMultiply(goldenFrameConstBuffer.world, camera->GetViewProjection());
 	
 	float3 translation2 = float3(-7.0f, 5.0f, 0.0f);
@@ -253,7 +253,10 @@ void Graphics::SceneManager::DrawCurrentScene(ID3D12GraphicsCommandList* command
 	floatN rotation2 = XMQuaternionRotationRollPitchYaw(0.0f, 0.0f, 0.0f);
 	float3 scale2 = float3(2.0f, 2.0f, 2.0f);
 
-	clothConstBuffer.world = XMMatrixAffineTransformation(XMLoadFloat3(&scale2), XMLoadFloat3(&rotationOrigin2), rotation2, XMLoadFloat3(&translation2));
+	currentScene->SetObjectWorldMatrix(testCloth.get(), XMMatrixAffineTransformation(XMLoadFloat3(&scale2), XMLoadFloat3(&rotationOrigin2), rotation2,
+		XMLoadFloat3(&translation2)));
+
+	clothConstBuffer.world = testCloth->GetWorldMatrix();
 	clothConstBuffer.wvp = XMMatrixMultiply(clothConstBuffer.world, camera->GetViewProjection());
 	
 	goldenFrameMaterial->UpdateConstantBuffer(goldenFrameConstBufferId, &goldenFrameConstBuffer, sizeof(goldenFrameConstBuffer));
@@ -267,8 +270,49 @@ void Graphics::SceneManager::DrawUI(ID3D12GraphicsCommandList* commandList) cons
 	currentScene->DrawUI(commandList);
 }
 
+const Graphics::BufferMemoryReport& Graphics::SceneManager::GetTestSceneBufferMemoryReport() const noexcept
+{
+	return testSceneBufferMemoryReport;
+}
+
+void Graphics::SceneManager::PublishCameraConstants() const
+{
+	bool isProjectionChanged = camera->GetProjectionVersion() != publishedProjectionVersion;
+
+	if (isProjectionChanged)
+	{
+		immutableGlobalConstBuffer.projection = camera->GetProjection();
+		immutableGlobalConstBuffer.invProjection = camera->GetInvProjection();
+		immutableGlobalConstBuffer.zNear = camera->GetZNear();
+		immutableGlobalConstBuffer.zFar = camera->GetZFar();
+		immutableGlobalConstBuffer.zLinearizeCoeff = camera->GetZLinearizeCoeff();
+
+		for (size_t cornerId = 0; cornerId < immutableGlobalConstBuffer.frustumCorners.size(); cornerId++)
+			XMStoreFloat4(&immutableGlobalConstBuffer.frustumCorners[cornerId], camera->GetFrustumVertices()[cornerId]);
+
+		resourceManager.UpdateConstantBuffer(immutableGlobalConstBufferId, &immutableGlobalConstBuffer, sizeof(immutableGlobalConstBuffer));
+
+		publishedProjectionVersion = camera->GetProjectionVersion();
+	}
+
+	if (isProjectionChanged || camera->GetViewVersion() != publishedViewVersion)
+	{
+		globalConstBuffer.view = camera->GetView();
+		globalConstBuffer.viewProjection = camera->GetViewProjection();
+		globalConstBuffer.invView = camera->GetInvView();
+		globalConstBuffer.invViewProjection = camera->GetInvViewProjection();
+		globalConstBuffer.cameraPosition = camera->GetPosition();
+
+		for (size_t cornerId = 0; cornerId < globalConstBuffer.worldFrustumCorners.size(); cornerId++)
+			XMStoreFloat4(&globalConstBuffer.worldFrustumCorners[cornerId], camera->GetWorldFrustumVertices()[cornerId]);
+
+		publishedViewVersion = camera->GetViewVersion();
+	}
+}
+
 Graphics::SceneManager::SceneManager()
-	: currentScene(nullptr), immutableGlobalConstBuffer{}, globalConstBuffer{}, goldenFrameConstBuffer{}, cameraShift{}
+	: currentScene(nullptr), immutableGlobalConstBuffer{}, globalConstBuffer{}, publishedViewVersion(0), publishedProjectionVersion(0), testSceneBufferMemoryReport{}, goldenFrameConstBuffer{},
+	cameraShift{}
 {
 	std::random_device randomDevice;
 
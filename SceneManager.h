@@ -18,6 +18,8 @@ namespace Graphics
 		void DrawCurrentScene(ID3D12GraphicsCommandList* commandList) const;
 		void DrawUI(ID3D12GraphicsCommandList* commandList) const;
 
+		const BufferMemoryReport& GetTestSceneBufferMemoryReport() const noexcept;
+
 	private:
 		SceneManager();
 		~SceneManager();
@@ -27,6 +29,8 @@ namespace Graphics
 		SceneManager& operator=(const SceneManager&) = delete;
 		SceneManager& operator=(SceneManager&&) = delete;
 
+		void PublishCameraConstants() const;
+
 		std::list<Scene> scenes;
 
 		Scene* currentScene;
@@ -65,6 +69,7 @@ namespace Graphics
 			float zNear;
 			float zFar;
 			float2 zLinearizeCoeff;
+			std::array<float4, 8> frustumCorners;
 		};
 
 		struct GlobalConstBuffer
@@ -78,6 +83,7 @@ namespace Graphics
 			float elapsedTime;
 			float previousElapsedTime;
 			float3 padding;
+			std::array<float4, 8> worldFrustumCorners;
 		};
 
 		struct StandardMeshConstBuffer
@@ -89,9 +95,14 @@ namespace Graphics
 		mutable StandardMeshConstBuffer goldenFrameConstBuffer;
 		mutable StandardMeshConstBuffer clothConstBuffer;
 
-		ImmutableGlobalConstBuffer immutableGlobalConstBuffer;
+		mutable ImmutableGlobalConstBuffer immutableGlobalConstBuffer;
 		mutable GlobalConstBuffer globalConstBuffer;
 
+		mutable uint64_t publishedViewVersion;
+		mutable uint64_t publishedProjectionVersion;
+
+		BufferMemoryReport testSceneBufferMemoryReport;
+
 		std::shared_ptr<Camera> camera;
 
 		std::shared_ptr<std::default_random_engine> randomEngine;
@@ -0,0 +1,384 @@
+#include "SegregatedFitAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+Graphics::SegregatedFitAllocator::SegregatedFitAllocator(uint64_t _capacity, uint64_t _granularity)
+	: capacity(_capacity), granularity(_granularity), granularityLog2(0), firstLevelMap(0), secondLevelMaps{}, freeLists{}, statistics{}
+{
+	if (granularity == 0 || (granularity & (granularity - 1)) != 0)
+		throw std::runtime_error("SegregatedFitAllocator::SegregatedFitAllocator: Granularity must be a power of two");
+
+	if (capacity == 0 || capacity % granularity != 0)
+		throw std::runtime_error("SegregatedFitAllocator::SegregatedFitAllocator: Capacity must be a non-zero multiple of granularity");
+
+	granularityLog2 = static_cast<uint32_t>(std::countr_zero(granularity));
+
+	Reset();
+}
+
+Graphics::SegregatedFitAllocator::~SegregatedFitAllocator()
+{
+
+}
+
+void Graphics::SegregatedFitAllocator::Allocate(uint64_t size, uint64_t alignment, SegregatedFitAllocation& allocation)
+{
+	if (alignment != 0 && (alignment & (alignment - 1)) != 0)
+		throw std::runtime_error("SegregatedFitAllocator::Allocate: Alignment must be a power of two");
+
+	uint64_t alignedSize, alignedAlignment;
+	PrepareRequest(size, alignment, alignedSize, alignedAlignment);
+
+	uint32_t blockId = FindFreeBlock(alignedSize, alignedAlignment);
+
+	if (blockId == INVALID_BLOCK)
+		throw std::runtime_error("SegregatedFitAllocator::Allocate: Bad allocation");
+
+	RemoveFreeBlock(blockId);
+
+	uint64_t alignmentGap = AlignOffset(blocks[blockId].offset, alignedAlignment) - blocks[blockId].offset;
+
+	if (alignmentGap != 0)
+	{
+		uint32_t alignedBlockId = SplitBlock(blockId, alignmentGap);
+		InsertFreeBlock(blockId);
+		blockId = alignedBlockId;
+	}
+
+	if (blocks[blockId].size > alignedSize)
+		InsertFreeBlock(SplitBlock(blockId, alignedSize));
+
+	allocation.offset = blocks[blockId].offset;
+	allocation.size = blocks[blockId].size;
+	allocation.blockId = blockId;
+
+	statistics.allocationsCount++;
+	statistics.usedSize += allocation.size;
+}
+
+void Graphics::SegregatedFitAllocator::Deallocate(const SegregatedFitAllocation& allocation)
+{
+	uint32_t blockId = allocation.blockId;
+
+	if (blockId >= blocks.size() || blocks[blockId].isFree || blocks[blockId].offset != allocation.offset)
+		throw std::runtime_error("SegregatedFitAllocator::Deallocate: Invalid allocation");
+
+	statistics.allocationsCount--;
+	statistics.usedSize -= blocks[blockId].size;
+
+	uint32_t nextBlockId = blocks[blockId].nextPhysical;
+
+	if (nextBlockId != INVALID_BLOCK && blocks[nextBlockId].isFree)
+	{
+		RemoveFreeBlock(nextBlockId);
+		MergeWithNext(blockId);
+	}
+
+	uint32_t previousBlockId = blocks[blockId].previousPhysical;
+
+	if (previousBlockId != INVALID_BLOCK && blocks[previousBlockId].isFree)
+	{
+		RemoveFreeBlock(previousBlockId);
+		MergeWithNext(previousBlockId);
+		blockId = previousBlockId;
+	}
+
+	InsertFreeBlock(blockId);
+}
+
+void Graphics::SegregatedFitAllocator::Reset()
+{
+	blocks.clear();
+	unusedBlocks.clear();
+
+	firstLevelMap = 0;
+	secondLevelMaps.fill(0);
+
+	for (auto& secondLevelLists : freeLists)
+		secondLevelLists.fill(INVALID_BLOCK);
+
+	statistics = {};
+
+	uint32_t blockId = CreateBlock();
+	blocks[blockId].offset = 0;
+	blocks[blockId].size = capacity;
+
+	InsertFreeBlock(blockId);
+}
+
+bool Graphics::SegregatedFitAllocator::CanAllocate(uint64_t size, uint64_t alignment) const noexcept
+{
+	if (alignment != 0 && (alignment & (alignment - 1)) != 0)
+		return false;
+
+	uint64_t alignedSize, alignedAlignment;
+	PrepareRequest(size, alignment, alignedSize, alignedAlignment);
+
+	return FindFreeBlock(alignedSize, alignedAlignment) != INVALID_BLOCK;
+}
+
+bool Graphics::SegregatedFitAllocator::IsEmpty() const noexcept
+{
+	return statistics.allocationsCount == 0;
+}
+
+uint64_t Graphics::SegregatedFitAllocator::GetCapacity() const noexcept
+{
+	return capacity;
+}
+
+uint64_t Graphics::SegregatedFitAllocator::GetGranularity() const noexcept
+{
+	return granularity;
+}
+
+uint64_t Graphics::SegregatedFitAllocator::GetUsedSize() const noexcept
+{
+	return statistics.usedSize;
+}
+
+uint64_t Graphics::SegregatedFitAllocator::GetFreeSize() const noexcept
+{
+	return capacity - statistics.usedSize;
+}
+
+uint64_t Graphics::SegregatedFitAllocator::GetLargestFreeBlockSize() const noexcept
+{
+	if (firstLevelMap == 0)
+		return 0;
+
+	uint32_t firstLevel = 31 - static_cast<uint32_t>(std::countl_zero(firstLevelMap));
+	uint32_t secondLevel = 31 - static_cast<uint32_t>(std::countl_zero(secondLevelMaps[firstLevel]));
+
+	// The highest non-empty list holds the largest block, but its blocks only share a size range
+	uint64_t largestSize = 0;
+
+	for (uint32_t blockId = freeLists[firstLevel][secondLevel]; blockId != INVALID_BLOCK; blockId = blocks[blockId].nextFree)
+		largestSize = (std::max)(largestSize, blocks[blockId].size);
+
+	return largestSize;
+}
+
+const Graphics::SegregatedFitStatistics& Graphics::SegregatedFitAllocator::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+void Graphics::SegregatedFitAllocator::MapSize(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) const noexcept
+{
+	uint64_t units = size >> granularityLog2;
+
+	if (units < SECOND_LEVEL_COUNT)
+	{
+		firstLevel = 0;
+		secondLevel = static_cast<uint32_t>(units);
+	}
+	else
+	{
+		uint32_t mostSignificantBit = 63 - static_cast<uint32_t>(std::countl_zero(units));
+
+		uint32_t shift = mostSignificantBit - SECOND_LEVEL_COUNT_LOG2;
+
+		firstLevel = shift + 1;
+		secondLevel = static_cast<uint32_t>(units >> shift) ^ SECOND_LEVEL_COUNT;
+	}
+}
+
+bool Graphics::SegregatedFitAllocator::MapSearchSize(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) const noexcept
+{
+	uint64_t units = size >> granularityLog2;
+
+	if (units >= SECOND_LEVEL_COUNT)
+	{
+		uint32_t mostSignificantBit = 63 - static_cast<uint32_t>(std::countl_zero(units));
+
+		units += (1ull << (mostSignificantBit - SECOND_LEVEL_COUNT_LOG2)) - 1;
+	}
+
+	MapSize(units << granularityLog2, firstLevel, secondLevel);
+
+	return firstLevel < FIRST_LEVEL_COUNT;
+}
+
+uint32_t Graphics::SegregatedFitAllocator::FindSuitableBlock(uint64_t size) const noexcept
+{
+	uint32_t firstLevel, secondLevel;
+
+	if (!MapSearchSize(size, firstLevel, secondLevel))
+		return INVALID_BLOCK;
+
+	uint32_t secondLevelMap = secondLevelMaps[firstLevel] & (~0u << secondLevel);
+
+	if (secondLevelMap == 0)
+	{
+		uint32_t firstLevelMask = (firstLevel + 1 < FIRST_LEVEL_COUNT) ? (~0u << (firstLevel + 1)) : 0;
+		uint32_t availableFirstLevels = firstLevelMap & firstLevelMask;
+
+		if (availableFirstLevels == 0)
+			return INVALID_BLOCK;
+
+		firstLevel = static_cast<uint32_t>(std::countr_zero(availableFirstLevels));
+		secondLevelMap = secondLevelMaps[firstLevel];
+	}
+
+	return freeLists[firstLevel][std::countr_zero(secondLevelMap)];
+}
+
+uint32_t Graphics::SegregatedFitAllocator::FindFreeBlock(uint64_t alignedSize, uint64_t alignment) const noexcept
+{
+	uint32_t blockId = FindSuitableBlock(alignedSize);
+
+	if (blockId != INVALID_BLOCK && IsBlockFitting(blockId, alignedSize, alignment))
+		return blockId;
+
+	if (alignment <= granularity)
+		return INVALID_BLOCK;
+
+	// Any block of this size can hold the request regardless of where its offset falls
+	blockId = FindSuitableBlock(alignedSize + alignment - granularity);
+
+	return blockId;
+}
+
+bool Graphics::SegregatedFitAllocator::IsBlockFitting(uint32_t blockId, uint64_t alignedSize, uint64_t alignment) const noexcept
+{
+	const Block& block = blocks[blockId];
+
+	return AlignOffset(block.offset, alignment) + alignedSize <= block.offset + block.size;
+}
+
+void Graphics::SegregatedFitAllocator::InsertFreeBlock(uint32_t blockId) noexcept
+{
+	uint32_t firstLevel, secondLevel;
+	MapSize(blocks[blockId].size, firstLevel, secondLevel);
+
+	uint32_t headBlockId = freeLists[firstLevel][secondLevel];
+
+	blocks[blockId].isFree = true;
+	blocks[blockId].previousFree = INVALID_BLOCK;
+	blocks[blockId].nextFree = headBlockId;
+
+	if (headBlockId != INVALID_BLOCK)
+		blocks[headBlockId].previousFree = blockId;
+
+	freeLists[firstLevel][secondLevel] = blockId;
+
+	firstLevelMap |= 1u << firstLevel;
+	secondLevelMaps[firstLevel] |= 1u << secondLevel;
+
+	statistics.freeBlocksCount++;
+}
+
+void Graphics::SegregatedFitAllocator::RemoveFreeBlock(uint32_t blockId) noexcept
+{
+	Block& block = blocks[blockId];
+
+	if (block.previousFree != INVALID_BLOCK)
+		blocks[block.previousFree].nextFree = block.nextFree;
+
+	if (block.nextFree != INVALID_BLOCK)
+		blocks[block.nextFree].previousFree = block.previousFree;
+
+	uint32_t firstLevel, secondLevel;
+	MapSize(block.size, firstLevel, secondLevel);
+
+	if (freeLists[firstLevel][secondLevel] == blockId)
+	{
+		freeLists[firstLevel][secondLevel] = block.nextFree;
+
+		if (block.nextFree == INVALID_BLOCK)
+		{
+			secondLevelMaps[firstLevel] &= ~(1u << secondLevel);
+
+			if (secondLevelMaps[firstLevel] == 0)
+				firstLevelMap &= ~(1u << firstLevel);
+		}
+	}
+
+	block.isFree = false;
+	block.previousFree = INVALID_BLOCK;
+	block.nextFree = INVALID_BLOCK;
+
+	statistics.freeBlocksCount--;
+}
+
+uint32_t Graphics::SegregatedFitAllocator::SplitBlock(uint32_t blockId, uint64_t frontSize)
+{
+	uint32_t backBlockId = CreateBlock();
+
+	Block& frontBlock = blocks[blockId];
+	Block& backBlock = blocks[backBlockId];
+
+	backBlock.offset = frontBlock.offset + frontSize;
+	backBlock.size = frontBlock.size - frontSize;
+	backBlock.previousPhysical = blockId;
+	backBlock.nextPhysical = frontBlock.nextPhysical;
+
+	if (frontBlock.nextPhysical != INVALID_BLOCK)
+		blocks[frontBlock.nextPhysical].previousPhysical = backBlockId;
+
+	frontBlock.size = frontSize;
+	frontBlock.nextPhysical = backBlockId;
+
+	statistics.splitsCount++;
+
+	return backBlockId;
+}
+
+void Graphics::SegregatedFitAllocator::MergeWithNext(uint32_t blockId)
+{
+	uint32_t nextBlockId = blocks[blockId].nextPhysical;
+	Block& block = blocks[blockId];
+	const Block& nextBlock = blocks[nextBlockId];
+
+	block.size += nextBlock.size;
+	block.nextPhysical = nextBlock.nextPhysical;
+
+	if (nextBlock.nextPhysical != INVALID_BLOCK)
+		blocks[nextBlock.nextPhysical].previousPhysical = blockId;
+
+	ReleaseBlock(nextBlockId);
+
+	statistics.mergesCount++;
+}
+
+uint32_t Graphics::SegregatedFitAllocator::CreateBlock()
+{
+	uint32_t blockId;
+
+	if (unusedBlocks.empty())
+	{
+		blockId = static_cast<uint32_t>(blocks.size());
+		blocks.emplace_back();
+	}
+	else
+	{
+		blockId = unusedBlocks.back();
+		unusedBlocks.pop_back();
+	}
+
+	blocks[blockId] = { 0, 0, INVALID_BLOCK, INVALID_BLOCK, INVALID_BLOCK, INVALID_BLOCK, false };
+
+	return blockId;
+}
+
+void Graphics::SegregatedFitAllocator::ReleaseBlock(uint32_t blockId)
+{
+	blocks[blockId].isFree = false;
+	blocks[blockId].size = 0;
+
+	unusedBlocks.push_back(blockId);
+}
+
+void Graphics::SegregatedFitAllocator::PrepareRequest(uint64_t size, uint64_t alignment, uint64_t& alignedSize, uint64_t& alignedAlignment) const noexcept
+{
+	alignedAlignment = (std::max)(alignment, granularity);
+	alignedSize = AlignOffset((std::max)(size, uint64_t(1)), granularity);
+}
+
+uint64_t Graphics::SegregatedFitAllocator::AlignOffset(uint64_t offset, uint64_t alignment) noexcept
+{
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
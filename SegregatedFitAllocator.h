@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Graphics
+{
+	struct SegregatedFitAllocation
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint32_t blockId;
+	};
+
+	struct SegregatedFitStatistics
+	{
+		size_t allocationsCount;
+		size_t freeBlocksCount;
+		size_t splitsCount;
+		size_t mergesCount;
+		uint64_t usedSize;
+	};
+
+	// Two-level segregated fit (TLSF) allocator over an abstract address range. Only offsets are managed here,
+	// so the same bookkeeping works for GPU pages, heaps or plain CPU memory.
+	class SegregatedFitAllocator
+	{
+	public:
+		static constexpr uint32_t INVALID_BLOCK = UINT32_MAX;
+
+		SegregatedFitAllocator(uint64_t _capacity, uint64_t _granularity = 256);
+		~SegregatedFitAllocator();
+
+		void Allocate(uint64_t size, uint64_t alignment, SegregatedFitAllocation& allocation);
+		void Deallocate(const SegregatedFitAllocation& allocation);
+		void Reset();
+
+		bool CanAllocate(uint64_t size, uint64_t alignment) const noexcept;
+		bool IsEmpty() const noexcept;
+
+		uint64_t GetCapacity() const noexcept;
+		uint64_t GetGranularity() const noexcept;
+		uint64_t GetUsedSize() const noexcept;
+		uint64_t GetFreeSize() const noexcept;
+		uint64_t GetLargestFreeBlockSize() const noexcept;
+
+		const SegregatedFitStatistics& GetStatistics() const noexcept;
+
+	private:
+		SegregatedFitAllocator() = delete;
+		SegregatedFitAllocator(const SegregatedFitAllocator&) = delete;
+		SegregatedFitAllocator& operator=(const SegregatedFitAllocator&) = delete;
+
+		static constexpr uint32_t SECOND_LEVEL_COUNT_LOG2 = 4;
+		static constexpr uint32_t SECOND_LEVEL_COUNT = 1 << SECOND_LEVEL_COUNT_LOG2;
+		static constexpr uint32_t FIRST_LEVEL_COUNT = 32;
+
+		struct Block
+		{
+			uint64_t offset;
+			uint64_t size;
+
+			uint32_t previousPhysical;
+			uint32_t nextPhysical;
+			uint32_t previousFree;
+			uint32_t nextFree;
+
+			bool isFree;
+		};
+
+		void MapSize(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) const noexcept;
+		bool MapSearchSize(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) const noexcept;
+
+		uint32_t FindSuitableBlock(uint64_t size) const noexcept;
+		uint32_t FindFreeBlock(uint64_t alignedSize, uint64_t alignment) const noexcept;
+		bool IsBlockFitting(uint32_t blockId, uint64_t alignedSize, uint64_t alignment) const noexcept;
+
+		void InsertFreeBlock(uint32_t blockId) noexcept;
+		void RemoveFreeBlock(uint32_t blockId) noexcept;
+
+		uint32_t SplitBlock(uint32_t blockId, uint64_t frontSize);
+		void MergeWithNext(uint32_t blockId);
+
+		uint32_t CreateBlock();
+		void ReleaseBlock(uint32_t blockId);
+
+		void PrepareRequest(uint64_t size, uint64_t alignment, uint64_t& alignedSize, uint64_t& alignedAlignment) const noexcept;
+		static uint64_t AlignOffset(uint64_t offset, uint64_t alignment) noexcept;
+
+		uint64_t capacity;
+		uint64_t granularity;
+		uint32_t granularityLog2;
+
+		std::vector<Block> blocks;
+		std::vector<uint32_t> unusedBlocks;
+
+		uint32_t firstLevelMap;
+		std::array<uint32_t, FIRST_LEVEL_COUNT> secondLevelMaps;
+		std::array<std::array<uint32_t, SECOND_LEVEL_COUNT>, FIRST_LEVEL_COUNT> freeLists;
+
+		SegregatedFitStatistics statistics;
+	};
+}
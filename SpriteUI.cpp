@@ -29,6 +29,9 @@ Graphics::SpriteUI::SpriteUI(int32_t relativePositionX, int32_t relativePosition
 
 	GenerateMeshFromTexture(spriteMainTextureId, gridDensityX, gridDensityY, vertexBufferId, indexBufferId, vertices, indices);
 
+	triangleHierarchy = std::shared_ptr<TriangleHierarchy>(new TriangleHierarchy());
+	triangleHierarchy->Build(vertices.data(), vertices.size(), sizeof(float3), indices.data(), indices.size());
+
 	vertexBufferView = resourceManager.GetVertexBufferView(vertexBufferId);
 	indexBufferView = resourceManager.GetIndexBufferView(indexBufferId);
 }
@@ -67,25 +70,13 @@ const bool& Graphics::SpriteUI::IsActive() const noexcept
 
 bool Graphics::SpriteUI::PointInsideMesh(float2 point) const
 {
-	for (size_t triangleId = 0; triangleId < indices.size() / 3; triangleId++)
-	{
-		float3 point0 = vertices[indices[triangleId * 3]];
-		point0.x = point0.x * localConstBuffer.scale.x + localConstBuffer.screenCoordOffset.x;
-		point0.y = point0.y * localConstBuffer.scale.y + localConstBuffer.screenCoordOffset.y;
+	if (localConstBuffer.scale.x == 0.0f || localConstBuffer.scale.y == 0.0f)
+		return false;
 
-		float3 point1 = vertices[indices[triangleId * 3 + 1]];
-		point1.x += point1.x * localConstBuffer.scale.x + localConstBuffer.screenCoordOffset.x;
-		point1.y += point1.y * localConstBuffer.scale.y + localConstBuffer.screenCoordOffset.y;
+	float2 localPoint = { (point.x - localConstBuffer.screenCoordOffset.x) / localConstBuffer.scale.x,
+		(point.y - localConstBuffer.screenCoordOffset.y) / localConstBuffer.scale.y };
 
-		float3 point2 = vertices[indices[triangleId * 3 + 2]];
-		point2.x = point2.x * localConstBuffer.scale.x + localConstBuffer.screenCoordOffset.x;
-		point2.y = point2.y * localConstBuffer.scale.y + localConstBuffer.screenCoordOffset.y;
-
-		if (GeometryProcessor::CheckPointInTriangle(point0, point1, point2, { point.x, point.y, 0.0f }))
-			return true;
-	}
-
-	return false;
+	return triangleHierarchy->ContainsPoint(localPoint);
 }
 
 Graphics::ConstantBufferId Graphics::SpriteUI::GetConstantBufferId() const noexcept
@@ -3,6 +3,7 @@
 #include "GraphicsSettings.h"
 #include "ResourceManager.h"
 #include "Material.h"
+#include "TriangleHierarchy.h"
 
 namespace Graphics
 {
@@ -55,6 +56,7 @@ namespace Graphics
 
 		std::vector<float3> vertices;
 		std::vector<uint32_t> indices;
+		std::shared_ptr<TriangleHierarchy> triangleHierarchy;
 
 		TextureId spriteTextureId;
 		int64_t order;
@@ -0,0 +1,121 @@
+#include "SweepAndPrune.h"
+
+Graphics::SweepAndPrune::SweepAndPrune()
+	: nextObjectId(0), broadphaseStatistics{}
+{
+
+}
+
+Graphics::SweepAndPrune::~SweepAndPrune()
+{
+
+}
+
+void Graphics::SweepAndPrune::AddObject(const GraphicObject* newObject)
+{
+	if (newObject == nullptr)
+		throw std::exception("SweepAndPrune::AddObject: object is null");
+
+	if (!objectIds.try_emplace(newObject, nextObjectId).second)
+		return;
+
+	nextObjectId++;
+
+	Entry newEntry{};
+	newEntry.object = newObject;
+	SetEntryBounds(newEntry, newObject->GetBoundingBox());
+
+	auto position = std::upper_bound(entries.begin(), entries.end(), newEntry.minX, [](float minX, const Entry& entry) { return minX < entry.minX; });
+	entries.insert(position, newEntry);
+}
+
+void Graphics::SweepAndPrune::RemoveObject(const GraphicObject* object)
+{
+	if (objectIds.erase(object) == 0)
+		return;
+
+	entries.erase(std::find_if(entries.begin(), entries.end(), [object](const Entry& entry) { return entry.object == object; }));
+}
+
+void Graphics::SweepAndPrune::Update()
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	broadphaseStatistics.objectsCount = entries.size();
+	broadphaseStatistics.swapsCount = 0;
+
+	for (auto& entry : entries)
+		SetEntryBounds(entry, entry.object->GetBoundingBox());
+
+	for (size_t entryId = 1; entryId < entries.size(); entryId++)
+	{
+		if (entries[entryId - 1].minX <= entries[entryId].minX)
+			continue;
+
+		Entry movedEntry = entries[entryId];
+		size_t insertionId = entryId;
+
+		while (insertionId > 0 && entries[insertionId - 1].minX > movedEntry.minX)
+		{
+			entries[insertionId] = entries[insertionId - 1];
+			insertionId--;
+			broadphaseStatistics.swapsCount++;
+		}
+
+		entries[insertionId] = movedEntry;
+	}
+
+	broadphaseStatistics.sortTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void Graphics::SweepAndPrune::FindOverlappingPairs(std::vector<ObjectPair>& overlappingPairs)
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	overlappingPairs.clear();
+	broadphaseStatistics.pairsTested = 0;
+
+	for (size_t firstId = 0; firstId < entries.size(); firstId++)
+	{
+		const Entry& firstEntry = entries[firstId];
+
+		for (size_t secondId = firstId + 1; secondId < entries.size() && entries[secondId].minX <= firstEntry.maxX; secondId++)
+		{
+			broadphaseStatistics.pairsTested++;
+
+			if (CheckEntriesOverlapYZ(firstEntry, entries[secondId]))
+				overlappingPairs.push_back({ firstEntry.object, entries[secondId].object });
+		}
+	}
+
+	broadphaseStatistics.pairsFound = overlappingPairs.size();
+	broadphaseStatistics.sweepTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+size_t Graphics::SweepAndPrune::GetObjectsCount() const noexcept
+{
+	return entries.size();
+}
+
+const Graphics::BroadphaseStatistics& Graphics::SweepAndPrune::GetBroadphaseStatistics() const noexcept
+{
+	return broadphaseStatistics;
+}
+
+void Graphics::SweepAndPrune::SetEntryBounds(Entry& entry, const BoundingBox& boundingBox) noexcept
+{
+	entry.minX = boundingBox.minCornerPoint.x;
+	entry.maxX = boundingBox.maxCornerPoint.x;
+	entry.extentsYZ = { boundingBox.minCornerPoint.y, boundingBox.minCornerPoint.z, boundingBox.maxCornerPoint.y, boundingBox.maxCornerPoint.z };
+}
+
+bool Graphics::SweepAndPrune::CheckEntriesOverlapYZ(const Entry& firstEntry, const Entry& secondEntry) noexcept
+{
+	floatN firstExtents = XMLoadFloat4(&firstEntry.extentsYZ);
+	floatN secondExtents = XMLoadFloat4(&secondEntry.extentsYZ);
+
+	floatN minCorners = XMVectorPermute<0, 1, 4, 5>(firstExtents, secondExtents);
+	floatN maxCorners = XMVectorPermute<6, 7, 2, 3>(firstExtents, secondExtents);
+
+	return XMVector4LessOrEqual(minCorners, maxCorners);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "GraphicObject.h"
+
+namespace Graphics
+{
+	struct ObjectPair
+	{
+		const GraphicObject* firstObject;
+		const GraphicObject* secondObject;
+	};
+
+	struct BroadphaseStatistics
+	{
+		size_t objectsCount;
+		size_t swapsCount;
+		size_t pairsTested;
+		size_t pairsFound;
+		float sortTime;
+		float sweepTime;
+	};
+
+	class SweepAndPrune
+	{
+	public:
+		SweepAndPrune();
+		~SweepAndPrune();
+
+		void AddObject(const GraphicObject* newObject);
+		void RemoveObject(const GraphicObject* object);
+
+		void Update();
+		void FindOverlappingPairs(std::vector<ObjectPair>& overlappingPairs);
+
+		size_t GetObjectsCount() const noexcept;
+
+		const BroadphaseStatistics& GetBroadphaseStatistics() const noexcept;
+
+	private:
+		SweepAndPrune(const SweepAndPrune&) = delete;
+		SweepAndPrune& operator=(const SweepAndPrune&) = delete;
+
+		struct Entry
+		{
+			float minX;
+			float maxX;
+			float4 extentsYZ;
+			const GraphicObject* object;
+		};
+
+		static void SetEntryBounds(Entry& entry, const BoundingBox& boundingBox) noexcept;
+		static bool CheckEntriesOverlapYZ(const Entry& firstEntry, const Entry& secondEntry) noexcept;
+
+		std::vector<Entry> entries;
+		std::unordered_map<const GraphicObject*, uint32_t> objectIds;
+		uint32_t nextObjectId;
+
+		BroadphaseStatistics broadphaseStatistics;
+	};
+}
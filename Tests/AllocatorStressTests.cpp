@@ -0,0 +1,205 @@
+#include "TestFramework.h"
+#include "ResourcePool.h"
+#include "AllocatorTelemetry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+
+// Multi-threaded churn over the shared allocator bookkeeping. The results are only checked for consistency, data races are left
+// to ThreadSanitizer, see README.
+
+namespace
+{
+	struct StressResourceId
+	{
+		StressResourceId()
+			: value(0), generation(0)
+		{
+
+		}
+
+		StressResourceId(size_t resourceId, uint32_t resourceGeneration)
+			: value(resourceId), generation(resourceGeneration)
+		{
+
+		}
+
+		size_t value;
+		uint32_t generation;
+	};
+
+	using StressResourcePool = Graphics::ResourcePool<uint64_t, StressResourceId>;
+
+	const size_t WORKER_THREADS_COUNT = 8;
+	const size_t LIVE_RESOURCES_COUNT = 64;
+	const uint64_t REQUESTED_BYTES = 256;
+	const uint64_t FRAMES_IN_FLIGHT = 2;
+
+	// Inserts and releases from one worker thread, every resource carries its owner and sequence number to catch slots handed out twice
+	size_t ChurnResourcePool(StressResourcePool& pool, Graphics::AllocatorCounters& counters, size_t threadId, size_t iterationsCount)
+	{
+		std::mt19937 generator(static_cast<uint32_t>(threadId));
+		std::vector<std::pair<StressResourceId, uint64_t>> liveResources;
+
+		size_t errorsCount = 0;
+
+		auto releaseResource = [&](size_t liveResourceId)
+		{
+			const auto& liveResource = liveResources[liveResourceId];
+
+			if (pool.Get(liveResource.first) != liveResource.second)
+				errorsCount++;
+
+			pool.Release(liveResource.first);
+			counters.RemoveAllocation(threadId % 2, REQUESTED_BYTES);
+
+			liveResources[liveResourceId] = liveResources.back();
+			liveResources.pop_back();
+		};
+
+		for (size_t iteration = 0; iteration < iterationsCount; iteration++)
+		{
+			uint64_t payload = (static_cast<uint64_t>(threadId) << 32) | iteration;
+
+			liveResources.push_back({ pool.Insert(payload), payload });
+			counters.AddAllocation(threadId % 2, REQUESTED_BYTES);
+
+			if (liveResources.size() > LIVE_RESOURCES_COUNT)
+				releaseResource(generator() % liveResources.size());
+		}
+
+		while (!liveResources.empty())
+			releaseResource(liveResources.size() - 1);
+
+		return errorsCount;
+	}
+}
+
+TEST_CASE(ResourcePoolConcurrentChurn)
+{
+	const size_t ITERATIONS_COUNT = 20000;
+
+	StressResourcePool pool;
+	Graphics::AllocatorCounters counters({ "Even", "Odd" });
+
+	std::atomic<size_t> errorsCount{ 0 };
+	std::atomic<bool> isStopped{ false };
+	std::vector<std::thread> workerThreads;
+
+	for (size_t threadId = 0; threadId < WORKER_THREADS_COUNT; threadId++)
+		workerThreads.emplace_back([&, threadId]() { errorsCount += ChurnResourcePool(pool, counters, threadId, ITERATIONS_COUNT); });
+
+	// Plays the render thread: fences releases, destroys completed ones and samples telemetry while the workers run
+	std::thread frameThread([&]()
+	{
+		uint64_t fenceValue = 0;
+
+		while (!isStopped)
+		{
+			fenceValue++;
+
+			pool.AssignReleaseFence(fenceValue);
+			pool.ReleaseCompleted(fenceValue > FRAMES_IN_FLIGHT ? fenceValue - FRAMES_IN_FLIGHT : 0, [](uint64_t& resource) { resource = UINT64_MAX; });
+
+			Graphics::AllocatorTelemetry telemetry{};
+			counters.FillTelemetry("Stress", telemetry);
+		}
+	});
+
+	for (auto& workerThread : workerThreads)
+		workerThread.join();
+
+	isStopped = true;
+	frameThread.join();
+
+	pool.AssignReleaseFence(1);
+	pool.ReleaseCompleted(UINT64_MAX - 1, [](uint64_t&) {});
+
+	auto statistics = pool.GetStatistics();
+
+	Graphics::AllocatorTelemetry telemetry{};
+	counters.FillTelemetry("Stress", telemetry);
+
+	CHECK(errorsCount == 0);
+	CHECK(statistics.insertionsCount == WORKER_THREADS_COUNT * ITERATIONS_COUNT);
+	CHECK(statistics.releasesCount == statistics.insertionsCount);
+	CHECK(statistics.destructionsCount == statistics.releasesCount);
+	CHECK(pool.GetActiveCount() == 0);
+	CHECK(pool.GetPendingReleasesCount() == 0);
+	CHECK(telemetry.allocationsCount == 0);
+	CHECK(telemetry.requestedBytes == 0);
+	CHECK(telemetry.peakRequestedBytes >= LIVE_RESOURCES_COUNT * REQUESTED_BYTES);
+	CHECK(telemetry.peakRequestedBytes <= WORKER_THREADS_COUNT * (LIVE_RESOURCES_COUNT + 1) * REQUESTED_BYTES);
+}
+
+TEST_CASE(AllocatorCountersConcurrentPages)
+{
+	const size_t ITERATIONS_COUNT = 50000;
+	const uint64_t PAGE_BYTES = 65536;
+
+	Graphics::AllocatorCounters counters({ "First", "Second", "Third" });
+
+	std::vector<std::thread> workerThreads;
+
+	for (size_t threadId = 0; threadId < WORKER_THREADS_COUNT; threadId++)
+		workerThreads.emplace_back([&, threadId]()
+		{
+			size_t categoryId = threadId % 3;
+
+			for (size_t iteration = 0; iteration < ITERATIONS_COUNT; iteration++)
+			{
+				counters.AddPage(categoryId, PAGE_BYTES);
+				counters.AddAllocation(categoryId, PAGE_BYTES / 2);
+				counters.RemoveAllocation(categoryId, PAGE_BYTES / 2);
+				counters.RemovePage(categoryId, PAGE_BYTES);
+			}
+		});
+
+	for (auto& workerThread : workerThreads)
+		workerThread.join();
+
+	Graphics::AllocatorTelemetry telemetry{};
+	counters.FillTelemetry("Stress", telemetry);
+
+	CHECK(telemetry.pagesCount == 0);
+	CHECK(telemetry.reservedBytes == 0);
+	CHECK(telemetry.allocationsCount == 0);
+	CHECK(telemetry.peakReservedBytes >= PAGE_BYTES);
+	CHECK(telemetry.peakReservedBytes <= WORKER_THREADS_COUNT * PAGE_BYTES);
+
+	for (const auto& categoryTelemetry : telemetry.categories)
+		CHECK(categoryTelemetry.pagesCount == 0 && categoryTelemetry.reservedBytes == 0);
+}
+
+BENCHMARK_CASE(ResourcePoolThreadScaling)
+{
+	const size_t ITERATIONS_COUNT = 200000;
+
+	// Past the core count the numbers show the cost of contention under preemption rather than scaling
+	size_t maxThreadsCount = (std::max)(static_cast<size_t>(std::thread::hardware_concurrency()), WORKER_THREADS_COUNT);
+
+	for (size_t threadsCount = 1; threadsCount <= maxThreadsCount; threadsCount *= 2)
+	{
+		StressResourcePool pool;
+		Graphics::AllocatorCounters counters({ "Even", "Odd" });
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		std::vector<std::thread> workerThreads;
+
+		for (size_t threadId = 0; threadId < threadsCount; threadId++)
+			workerThreads.emplace_back([&, threadId]() { ChurnResourcePool(pool, counters, threadId, ITERATIONS_COUNT); });
+
+		for (auto& workerThread : workerThreads)
+			workerThread.join();
+
+		double elapsedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		// Every iteration inserts and releases one resource
+		std::cout << "ResourcePool " << threadsCount << " threads: " << 2.0 * threadsCount * ITERATIONS_COUNT / elapsedTime / 1e6 << " Mops/s" << std::endl;
+	}
+}
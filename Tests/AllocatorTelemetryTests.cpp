@@ -0,0 +1,186 @@
+#include "TestFramework.h"
+#include "AllocatorTelemetry.h"
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+	const uint64_t MB = 1024 * 1024;
+	const uint64_t PAGE_SIZE = 2 * MB;
+}
+
+TEST_CASE(BufferMemoryReportComparesPagePerBufferCost)
+{
+	Graphics::BufferMemoryReport report{};
+	report.sharedPagesCount = 3;
+	report.sharedPagesBytes = 3 * PAGE_SIZE;
+	report.heapPagesCount = 1;
+	report.heapPagesBytes = 8 * MB;
+	report.placedBuffersCount = 4;
+
+	// Rounded up to two pages when it opens a page of its own
+	Graphics::AddDedicatedBufferUsage(report, 3 * MB, true, PAGE_SIZE);
+	// Already a page of its own, smaller than the default size
+	Graphics::AddDedicatedBufferUsage(report, MB, false, PAGE_SIZE);
+
+	Graphics::FinalizeBufferMemoryReport(report, PAGE_SIZE);
+
+	CHECK(report.dedicatedBuffersCount == 2);
+	CHECK(report.dedicatedBytes == 4 * MB);
+	CHECK(report.dedicatedPagePerBufferBytes == 5 * MB);
+	CHECK(report.committedBytes == 6 * MB + 8 * MB + 4 * MB);
+	CHECK(report.pagePerBufferCommittedBytes == 6 * MB + 4 * PAGE_SIZE + 5 * MB);
+	// The size classed heaps are only worth it while they commit less than a page per buffer
+	CHECK(report.committedBytes < report.pagePerBufferCommittedBytes);
+}
+
+TEST_CASE(BufferMemoryReportOfEmptyAllocator)
+{
+	Graphics::BufferMemoryReport report{};
+
+	Graphics::FinalizeBufferMemoryReport(report, PAGE_SIZE);
+
+	CHECK(report.committedBytes == 0);
+	CHECK(report.pagePerBufferCommittedBytes == 0);
+}
+
+namespace
+{
+	Graphics::AllocatorTelemetry CreateKnownTelemetry()
+	{
+		Graphics::AllocatorTelemetry telemetry{};
+		telemetry.allocatorName = "Buffer\"Allocator\\";
+		telemetry.peakRequestedBytes = 5000;
+		telemetry.peakReservedBytes = 9000;
+		telemetry.categories.resize(2);
+
+		telemetry.categories[0].name = "Shared";
+		telemetry.categories[0].pagesCount = 2;
+		telemetry.categories[0].allocationsCount = 3;
+		telemetry.categories[0].requestedBytes = 300;
+		telemetry.categories[0].reservedBytes = 4096;
+		telemetry.categories[0].peakRequestedBytes = 700;
+		telemetry.categories[0].peakReservedBytes = 8192;
+		// 1000 free bytes, the largest block holds 750 of them
+		Graphics::AddPageUsage(telemetry.categories[0], 3096, 750);
+
+		telemetry.categories[1].name = "Line\nBreak";
+		telemetry.categories[1].pagesCount = 1;
+		telemetry.categories[1].reservedBytes = 1024;
+		telemetry.categories[1].peakReservedBytes = 1024;
+
+		Graphics::FinalizeAllocatorTelemetry(telemetry);
+
+		return telemetry;
+	}
+
+	// Strings and nesting are balanced and no value list ends with a comma
+	bool IsWellFormedJson(const std::string& json)
+	{
+		std::string nesting;
+		bool isInString = false;
+		char lastToken = 0;
+
+		for (size_t characterId = 0; characterId < json.size(); characterId++)
+		{
+			char character = json[characterId];
+
+			if (isInString)
+			{
+				if (static_cast<unsigned char>(character) < 0x20)
+					return false;
+
+				if (character == '\\')
+					characterId++;
+				else if (character == '"')
+					isInString = false;
+
+				continue;
+			}
+
+			if (character == ' ' || character == '\t' || character == '\n')
+				continue;
+
+			if (character == '"')
+				isInString = true;
+			else if (character == '{' || character == '[')
+				nesting.push_back(character == '{' ? '}' : ']');
+			else if (character == '}' || character == ']')
+			{
+				if (nesting.empty() || nesting.back() != character || lastToken == ',')
+					return false;
+
+				nesting.pop_back();
+			}
+
+			lastToken = character;
+		}
+
+		return !isInString && nesting.empty() && lastToken == '}';
+	}
+
+	bool Contains(const std::string& json, const std::string& text)
+	{
+		return json.find(text) != std::string::npos;
+	}
+}
+
+TEST_CASE(AllocatorTelemetryJsonHoldsKnownValues)
+{
+	Graphics::BufferMemoryReport bufferMemoryReport{};
+	bufferMemoryReport.placedBuffersCount = 4;
+	bufferMemoryReport.heapPagesBytes = 8192;
+	Graphics::FinalizeBufferMemoryReport(bufferMemoryReport, 2048);
+
+	std::ostringstream stream;
+	Graphics::WriteAllocatorTelemetryJson(stream, { CreateKnownTelemetry() }, bufferMemoryReport);
+	std::string json = stream.str();
+
+	CHECK(IsWellFormedJson(json));
+
+	CHECK(Contains(json, "\"name\": \"Buffer\\\"Allocator\\\\\","));
+	CHECK(Contains(json, "\"pagesCount\": 3,"));
+	CHECK(Contains(json, "\"allocationsCount\": 3,"));
+	CHECK(Contains(json, "\"requestedBytes\": 300,"));
+	CHECK(Contains(json, "\"usedBytes\": 3096,"));
+	CHECK(Contains(json, "\"reservedBytes\": 5120,"));
+	CHECK(Contains(json, "\"peakRequestedBytes\": 5000,"));
+	CHECK(Contains(json, "\"peakReservedBytes\": 9000,"));
+
+	CHECK(Contains(json, "{ \"name\": \"Shared\", \"pagesCount\": 2, \"allocationsCount\": 3, \"requestedBytes\": 300, \"usedBytes\": 3096, "
+		"\"reservedBytes\": 4096, \"largestFreeBlockBytes\": 750, \"peakRequestedBytes\": 700, \"peakReservedBytes\": 8192, \"fragmentationRatio\": 0.2500 }"));
+	CHECK(Contains(json, "{ \"name\": \"Line\\u000aBreak\", \"pagesCount\": 1, \"allocationsCount\": 0, \"requestedBytes\": 0, \"usedBytes\": 0, "
+		"\"reservedBytes\": 1024, \"largestFreeBlockBytes\": 0, \"peakRequestedBytes\": 0, \"peakReservedBytes\": 1024, \"fragmentationRatio\": 1.0000 }"));
+
+	CHECK(Contains(json, "\"placedBuffersCount\": 4,"));
+	CHECK(Contains(json, "\"committedBytes\": 8192,"));
+	CHECK(Contains(json, "\"pagePerBufferCommittedBytes\": 8192\n"));
+}
+
+TEST_CASE(AllocatorTelemetryJsonOfEmptyTelemetry)
+{
+	std::ostringstream stream;
+	Graphics::WriteAllocatorTelemetryJson(stream, {}, {});
+	CHECK(IsWellFormedJson(stream.str()));
+	CHECK(Contains(stream.str(), "\"allocators\": [],"));
+
+	Graphics::AllocatorTelemetry telemetry{};
+	telemetry.allocatorName = "Empty";
+
+	stream.str("");
+	Graphics::WriteAllocatorTelemetryJson(stream, { telemetry, telemetry }, {});
+	CHECK(IsWellFormedJson(stream.str()));
+	CHECK(Contains(stream.str(), "\"categories\": []\n"));
+}
+
+TEST_CASE(AllocatorTelemetryJsonKeepsStreamFormat)
+{
+	std::ostringstream stream;
+	Graphics::WriteAllocatorTelemetryJson(stream, { CreateKnownTelemetry() }, {});
+
+	stream.str("");
+	stream << 0.5f << " " << 255;
+
+	CHECK(stream.str() == "0.5 255");
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "TestFramework.h"
+#include "ISpatialIndex.h"
+#include "BoundingBoxTransformer.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+// Shared scene setup for the CPU-side culling, query and broadphase benchmarks. Objects use a renderable without GPU resources, so
+// every benchmark built on these helpers runs without a device.
+
+namespace Graphics
+{
+	namespace Tests
+	{
+		class BenchmarkRenderable final : public IRenderable
+		{
+		public:
+			BenchmarkRenderable(const BoundingBox& _boundingBox)
+				: boundingBox(_boundingBox)
+			{
+
+			}
+
+			const BoundingBox& GetBoundingBox() const noexcept override
+			{
+				return boundingBox;
+			}
+
+			void Update(ID3D12GraphicsCommandList* commandList) const override
+			{
+
+			}
+
+			void Draw(ID3D12GraphicsCommandList* commandList, const Material* material) const override
+			{
+
+			}
+
+		private:
+			BoundingBox boundingBox;
+		};
+
+		using BenchmarkObjectPool = std::vector<std::unique_ptr<GraphicObject>>;
+
+		class BenchmarkTimer
+		{
+		public:
+			BenchmarkTimer()
+				: startTime(std::chrono::steady_clock::now())
+			{
+
+			}
+
+			double GetElapsedSeconds() const
+			{
+				return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+			}
+
+		private:
+			std::chrono::steady_clock::time_point startTime;
+		};
+
+		// Random rotation and a uniform scale in [0.5, 2], placed inside a cube of the given half extent
+		inline float4x4 CreateRandomWorldMatrix(std::mt19937& generator, float fieldHalfExtent)
+		{
+			std::uniform_real_distribution<float> positionDistribution(-fieldHalfExtent, fieldHalfExtent);
+			std::uniform_real_distribution<float> angleDistribution(0.0f, XM_2PI);
+			std::uniform_real_distribution<float> scaleDistribution(0.5f, 2.0f);
+
+			float scale = scaleDistribution(generator);
+
+			return XMMatrixScaling(scale, scale, scale) * XMMatrixRotationRollPitchYaw(angleDistribution(generator), angleDistribution(generator), 0.0f) *
+				XMMatrixTranslation(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator));
+		}
+
+		// Recomputes world bounds the same way Scene does for its dirty objects
+		inline void UpdateObjectsWorldBounds(BenchmarkObjectPool& objects, BoundingBoxTransformer& boundingBoxTransformer)
+		{
+			boundingBoxTransformer.Clear();
+
+			for (auto& object : objects)
+				boundingBoxTransformer.AddBoundingBox(object->GetLocalBoundingBox(), object->GetWorldMatrix());
+
+			boundingBoxTransformer.Transform();
+
+			for (size_t objectId = 0; objectId < objects.size(); objectId++)
+				objects[objectId]->UpdateWorldBounds(boundingBoxTransformer.GetTransformedBoundingBox(objectId));
+		}
+
+		inline void CreateObjectsField(const IRenderable* renderable, size_t objectsCount, float fieldHalfExtent, uint32_t seed, BenchmarkObjectPool& objects)
+		{
+			std::mt19937 generator(seed);
+
+			objects.clear();
+			objects.reserve(objectsCount);
+
+			for (size_t objectId = 0; objectId < objectsCount; objectId++)
+			{
+				objects.push_back(std::make_unique<GraphicObject>());
+				objects.back()->AssignRenderableEntity(renderable);
+				objects.back()->SetWorldMatrix(CreateRandomWorldMatrix(generator, fieldHalfExtent));
+			}
+
+			BoundingBoxTransformer boundingBoxTransformer;
+			UpdateObjectsWorldBounds(objects, boundingBoxTransformer);
+		}
+
+		inline ObjectPtrPool GetObjectPointers(const BenchmarkObjectPool& objects)
+		{
+			ObjectPtrPool objectPointers;
+			objectPointers.reserve(objects.size());
+
+			for (auto& object : objects)
+				objectPointers.push_back(object.get());
+
+			return objectPointers;
+		}
+
+		// Cameras orbit the field center at the given distance, every camera looks at the center from its own angle
+		inline void CreateOrbitCameras(size_t camerasCount, float orbitRadius, std::vector<std::unique_ptr<Camera>>& cameras)
+		{
+			cameras.clear();
+
+			for (size_t cameraId = 0; cameraId < camerasCount; cameraId++)
+			{
+				float angle = XM_2PI * cameraId / camerasCount;
+
+				cameras.push_back(std::make_unique<Camera>(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 2.0f * orbitRadius));
+				cameras.back()->Move({ orbitRadius * std::cos(angle), 0.25f * orbitRadius, orbitRadius * std::sin(angle) });
+				cameras.back()->LookAt({ 0.0f, 0.0f, 0.0f });
+				cameras.back()->Update();
+			}
+		}
+
+		inline void PrintBenchmarkResult(const std::string& label, double value, const char* unit)
+		{
+			std::cout << label << ": " << value << " " << unit << std::endl;
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#include "TestFramework.h"
+#include "Camera.h"
+
+// Frustum planes against volumes placed around a camera at the origin looking down +Z, the frustum itself is checked by hand
+
+namespace
+{
+	const float Z_NEAR = 0.1f;
+	const float Z_FAR = 100.0f;
+
+	Graphics::FrustumIntersection ClassifySphere(const Graphics::Camera& camera, const float3& center, float radius)
+	{
+		uint32_t planeMask = Graphics::Camera::FRUSTUM_ALL_PLANES_MASK;
+		size_t planeTestsCount = 0;
+
+		return camera.ClassifyBoundingSphere({ center, radius }, planeMask, planeTestsCount);
+	}
+
+	Graphics::FrustumIntersection ClassifyBox(const Graphics::Camera& camera, const float3& center, float halfSize)
+	{
+		uint32_t planeMask = Graphics::Camera::FRUSTUM_ALL_PLANES_MASK;
+		uint32_t lastRejectingPlane = 0;
+		size_t planeTestsCount = 0;
+
+		Graphics::BoundingBox boundingBox = { { center.x - halfSize, center.y - halfSize, center.z - halfSize },
+			{ center.x + halfSize, center.y + halfSize, center.z + halfSize } };
+
+		return camera.ClassifyBoundingBox(boundingBox, planeMask, lastRejectingPlane, planeTestsCount);
+	}
+}
+
+TEST_CASE(CameraFrustumSphereInFrontAndBehind)
+{
+	Graphics::Camera camera(XM_PIDIV4, 1.0f, Z_NEAR, Z_FAR);
+
+	CHECK(ClassifySphere(camera, { 0.0f, 0.0f, 10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_INSIDE);
+	CHECK(ClassifySphere(camera, { 0.0f, 0.0f, -10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+}
+
+TEST_CASE(CameraFrustumNearFarAndSidePlanes)
+{
+	Graphics::Camera camera(XM_PIDIV4, 1.0f, Z_NEAR, Z_FAR);
+
+	// D3D depth starts at zero on the near plane, a sphere just behind it is outside and one across it intersects
+	CHECK(ClassifySphere(camera, { 0.0f, 0.0f, 0.0f }, 0.05f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+	CHECK(ClassifySphere(camera, { 0.0f, 0.0f, Z_NEAR }, 0.05f) == Graphics::FrustumIntersection::FRUSTUM_INTERSECTING);
+
+	CHECK(ClassifySphere(camera, { 0.0f, 0.0f, Z_FAR + 2.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+	CHECK(ClassifySphere(camera, { 0.0f, 0.0f, Z_FAR }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_INTERSECTING);
+
+	// The half field of view is 22.5 degrees, at a depth of 10 the frustum is about 4.1 units wide on each side
+	CHECK(ClassifySphere(camera, { 10.0f, 0.0f, 10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+	CHECK(ClassifySphere(camera, { -10.0f, 0.0f, 10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+	CHECK(ClassifySphere(camera, { 0.0f, 10.0f, 10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+	CHECK(ClassifySphere(camera, { 0.0f, -10.0f, 10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+	CHECK(ClassifySphere(camera, { 4.0f, 0.0f, 10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_INTERSECTING);
+}
+
+TEST_CASE(CameraFrustumFollowsView)
+{
+	Graphics::Camera camera(XM_PIDIV4, 1.0f, Z_NEAR, Z_FAR);
+
+	camera.Move({ 20.0f, 0.0f, 0.0f });
+	camera.LookAt({ 20.0f, 0.0f, -10.0f });
+	camera.Update();
+
+	CHECK(ClassifyBox(camera, { 20.0f, 0.0f, -10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_INSIDE);
+	CHECK(ClassifyBox(camera, { 20.0f, 0.0f, 10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+	CHECK(ClassifyBox(camera, { 0.0f, 0.0f, -10.0f }, 1.0f) == Graphics::FrustumIntersection::FRUSTUM_OUTSIDE);
+}
@@ -0,0 +1,151 @@
+#include "TestDevice.h"
+#include "DescriptorAllocator.h"
+
+#include <thread>
+
+// Runs on the shared WARP device. The allocator is a process-wide singleton, every test compares the counters against the values
+// it starts with instead of against zero.
+
+namespace
+{
+	const D3D12_DESCRIPTOR_HEAP_TYPE TEST_DESCRIPTOR_TYPE = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+
+	// Descriptors held by thread caches are still used from the pages' point of view, so this only drops once they are returned
+	uint64_t GetUsedDescriptorBytes()
+	{
+		return Graphics::DescriptorAllocator::GetInstance().GetTelemetry().categories[TEST_DESCRIPTOR_TYPE].usedBytes;
+	}
+
+	void AllocateDescriptors(ID3D12Device* device, std::vector<Graphics::DescriptorAllocation>& allocations, size_t descriptorsCount)
+	{
+		allocations.resize(descriptorsCount);
+
+		for (auto& allocation : allocations)
+			Graphics::DescriptorAllocator::GetInstance().Allocate(device, 1, TEST_DESCRIPTOR_TYPE, allocation);
+	}
+
+	void DeallocateDescriptors(std::vector<Graphics::DescriptorAllocation>& allocations)
+	{
+		for (auto& allocation : allocations)
+			Graphics::DescriptorAllocator::GetInstance().Deallocate(allocation);
+
+		allocations.clear();
+	}
+}
+
+TEST_CASE(DescriptorAllocatorFlushReturnsWorkerCache)
+{
+	auto& descriptorAllocator = Graphics::DescriptorAllocator::GetInstance();
+	auto* device = Graphics::Tests::GetWarpDevice();
+
+	descriptorAllocator.FlushThreadCache();
+
+	auto initialStatistics = descriptorAllocator.GetStatistics();
+	uint64_t initialUsedBytes = GetUsedDescriptorBytes();
+
+	Graphics::DescriptorAllocatorStatistics cachedStatistics{}, flushedStatistics{};
+
+	std::thread workerThread([&]()
+	{
+		std::vector<Graphics::DescriptorAllocation> allocations;
+		AllocateDescriptors(device, allocations, 100);
+		DeallocateDescriptors(allocations);
+
+		cachedStatistics = descriptorAllocator.GetStatistics();
+
+		descriptorAllocator.FlushThreadCache();
+
+		flushedStatistics = descriptorAllocator.GetStatistics();
+	});
+
+	workerThread.join();
+
+	CHECK(cachedStatistics.persistentDescriptorsCount == initialStatistics.persistentDescriptorsCount);
+	CHECK(cachedStatistics.cachedDescriptorsCount > initialStatistics.cachedDescriptorsCount);
+	CHECK(flushedStatistics.persistentDescriptorsCount == initialStatistics.persistentDescriptorsCount);
+	CHECK(flushedStatistics.cachedDescriptorsCount == initialStatistics.cachedDescriptorsCount);
+	CHECK(GetUsedDescriptorBytes() == initialUsedBytes);
+}
+
+TEST_CASE(DescriptorAllocatorThreadExitReturnsCache)
+{
+	auto& descriptorAllocator = Graphics::DescriptorAllocator::GetInstance();
+	auto* device = Graphics::Tests::GetWarpDevice();
+
+	descriptorAllocator.FlushThreadCache();
+
+	auto initialStatistics = descriptorAllocator.GetStatistics();
+	uint64_t initialUsedBytes = GetUsedDescriptorBytes();
+
+	// Descriptors allocated here and released by a worker end up in the worker's cache, its exit has to hand them back
+	std::vector<Graphics::DescriptorAllocation> allocations;
+	AllocateDescriptors(device, allocations, 64);
+	descriptorAllocator.FlushThreadCache();
+
+	CHECK(descriptorAllocator.GetStatistics().persistentDescriptorsCount == initialStatistics.persistentDescriptorsCount + 64);
+
+	std::thread workerThread([&]() { DeallocateDescriptors(allocations); });
+	workerThread.join();
+
+	auto finalStatistics = descriptorAllocator.GetStatistics();
+
+	CHECK(finalStatistics.persistentDescriptorsCount == initialStatistics.persistentDescriptorsCount);
+	CHECK(finalStatistics.cachedDescriptorsCount == initialStatistics.cachedDescriptorsCount);
+	CHECK(GetUsedDescriptorBytes() == initialUsedBytes);
+}
+
+TEST_CASE(DescriptorAllocatorConcurrentChurn)
+{
+	const size_t WORKER_THREADS_COUNT = 8;
+	const size_t ITERATIONS_COUNT = 200;
+
+	auto& descriptorAllocator = Graphics::DescriptorAllocator::GetInstance();
+	auto* device = Graphics::Tests::GetWarpDevice();
+
+	descriptorAllocator.FlushThreadCache();
+
+	auto initialStatistics = descriptorAllocator.GetStatistics();
+	uint64_t initialUsedBytes = GetUsedDescriptorBytes();
+
+	// Every worker frees the previous worker's descriptors as well as its own, so caches fill from foreign pages and drain on exit
+	std::vector<std::vector<Graphics::DescriptorAllocation>> allocations(WORKER_THREADS_COUNT);
+	std::vector<std::mutex> allocationMutexes(WORKER_THREADS_COUNT);
+	std::vector<std::thread> workerThreads;
+
+	for (size_t threadId = 0; threadId < WORKER_THREADS_COUNT; threadId++)
+		workerThreads.emplace_back([&, threadId]()
+		{
+			size_t neighbourThreadId = (threadId + WORKER_THREADS_COUNT - 1) % WORKER_THREADS_COUNT;
+
+			for (size_t iteration = 0; iteration < ITERATIONS_COUNT; iteration++)
+			{
+				std::vector<Graphics::DescriptorAllocation> newAllocations;
+				AllocateDescriptors(device, newAllocations, 1 + iteration % 40);
+
+				{
+					std::lock_guard<std::mutex> lock(allocationMutexes[neighbourThreadId]);
+
+					DeallocateDescriptors(allocations[neighbourThreadId]);
+				}
+
+				std::lock_guard<std::mutex> lock(allocationMutexes[threadId]);
+
+				DeallocateDescriptors(allocations[threadId]);
+				allocations[threadId] = std::move(newAllocations);
+			}
+		});
+
+	for (auto& workerThread : workerThreads)
+		workerThread.join();
+
+	for (auto& threadAllocations : allocations)
+		DeallocateDescriptors(threadAllocations);
+
+	descriptorAllocator.FlushThreadCache();
+
+	auto finalStatistics = descriptorAllocator.GetStatistics();
+
+	CHECK(finalStatistics.persistentDescriptorsCount == initialStatistics.persistentDescriptorsCount);
+	CHECK(finalStatistics.cachedDescriptorsCount == initialStatistics.cachedDescriptorsCount);
+	CHECK(GetUsedDescriptorBytes() == initialUsedBytes);
+}
@@ -0,0 +1,125 @@
+#include "TestFramework.h"
+#include "SegregatedFitAllocator.h"
+#include "UploadRing.h"
+
+#include <random>
+
+// Descriptor pages keep their static region in a SegregatedFitAllocator with single descriptor granularity and the rest of a
+// shader visible heap in an UploadRing, these tests drive the same bookkeeping without a device.
+
+namespace
+{
+	const uint32_t STATIC_DESCRIPTORS_COUNT = 4096;
+	const uint32_t TRANSIENT_DESCRIPTORS_COUNT = 12288;
+}
+
+TEST_CASE(DescriptorFreeListReusesSingleSlots)
+{
+	Graphics::SegregatedFitAllocator freeList(STATIC_DESCRIPTORS_COUNT, 1);
+
+	std::vector<Graphics::SegregatedFitAllocation> allocations(STATIC_DESCRIPTORS_COUNT);
+
+	for (uint32_t descriptorId = 0; descriptorId < STATIC_DESCRIPTORS_COUNT; descriptorId++)
+	{
+		freeList.Allocate(1, 1, allocations[descriptorId]);
+
+		CHECK(allocations[descriptorId].offset == descriptorId);
+		CHECK(allocations[descriptorId].size == 1);
+	}
+
+	CHECK(!freeList.CanAllocate(1, 1));
+
+	freeList.Deallocate(allocations[100]);
+	freeList.Deallocate(allocations[101]);
+
+	Graphics::SegregatedFitAllocation tableAllocation;
+	freeList.Allocate(2, 1, tableAllocation);
+
+	CHECK(tableAllocation.offset == 100);
+	CHECK(!freeList.CanAllocate(1, 1));
+}
+
+TEST_CASE(DescriptorFreeListSurvivesTableChurn)
+{
+	Graphics::SegregatedFitAllocator freeList(STATIC_DESCRIPTORS_COUNT, 1);
+
+	std::mt19937 generator(3);
+	std::vector<Graphics::SegregatedFitAllocation> allocations;
+	std::vector<uint8_t> descriptorOwners(STATIC_DESCRIPTORS_COUNT, 0);
+
+	for (int iteration = 0; iteration < 100000; iteration++)
+	{
+		uint32_t descriptorsCount = 1 + generator() % 8;
+
+		if (allocations.empty() || generator() % 2 == 0)
+		{
+			if (!freeList.CanAllocate(descriptorsCount, 1))
+				continue;
+
+			Graphics::SegregatedFitAllocation allocation;
+			freeList.Allocate(descriptorsCount, 1, allocation);
+
+			CHECK(allocation.size == descriptorsCount);
+
+			for (uint64_t descriptorId = allocation.offset; descriptorId < allocation.offset + allocation.size; descriptorId++)
+			{
+				CHECK(descriptorOwners[descriptorId] == 0);
+				descriptorOwners[descriptorId] = 1;
+			}
+
+			allocations.push_back(allocation);
+		}
+		else
+		{
+			size_t allocationId = generator() % allocations.size();
+			const auto& allocation = allocations[allocationId];
+
+			for (uint64_t descriptorId = allocation.offset; descriptorId < allocation.offset + allocation.size; descriptorId++)
+				descriptorOwners[descriptorId] = 0;
+
+			freeList.Deallocate(allocation);
+
+			allocations[allocationId] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+
+	for (const auto& allocation : allocations)
+		freeList.Deallocate(allocation);
+
+	CHECK(freeList.IsEmpty());
+	CHECK(freeList.GetLargestFreeBlockSize() == STATIC_DESCRIPTORS_COUNT);
+}
+
+TEST_CASE(DescriptorFrameRingRetiresWithFence)
+{
+	const uint64_t FRAMES_IN_FLIGHT = 2;
+
+	Graphics::UploadRing frameRing(TRANSIENT_DESCRIPTORS_COUNT);
+
+	std::mt19937 generator(5);
+
+	for (uint64_t frameId = 1; frameId <= 1000; frameId++)
+	{
+		if (frameId > FRAMES_IN_FLIGHT)
+			frameRing.ReleaseCompletedFrames(frameId - FRAMES_IN_FLIGHT);
+
+		uint32_t tablesCount = 100 + generator() % 400;
+
+		for (uint32_t tableId = 0; tableId < tablesCount; tableId++)
+		{
+			uint64_t offset;
+
+			CHECK(frameRing.Allocate(1 + generator() % 8, 1, offset));
+			CHECK(offset < TRANSIENT_DESCRIPTORS_COUNT);
+		}
+
+		frameRing.FinishFrame(frameId);
+	}
+
+	frameRing.ReleaseCompletedFrames(1000);
+
+	CHECK(frameRing.GetUsedSize() == 0);
+	CHECK(frameRing.GetStatistics().failedAllocationsCount == 0);
+	CHECK(frameRing.GetStatistics().peakUsedSize <= TRANSIENT_DESCRIPTORS_COUNT);
+}
@@ -0,0 +1,141 @@
+#include "TestFramework.h"
+#include "ResourcePool.h"
+
+#include <random>
+
+namespace
+{
+	struct TestResourceId
+	{
+		TestResourceId()
+			: value(0), generation(0)
+		{
+
+		}
+
+		TestResourceId(size_t resourceId, uint32_t resourceGeneration)
+			: value(resourceId), generation(resourceGeneration)
+		{
+
+		}
+
+		size_t value;
+		uint32_t generation;
+	};
+
+	using TestResourcePool = Graphics::ResourcePool<int, TestResourceId>;
+}
+
+TEST_CASE(ResourcePoolRejectsDefaultHandle)
+{
+	TestResourcePool pool;
+
+	CHECK(!pool.IsValid(TestResourceId()));
+
+	auto resourceId = pool.Insert(1);
+
+	CHECK(resourceId.value == 0);
+	CHECK(resourceId.generation != 0);
+	CHECK(!pool.IsValid(TestResourceId()));
+	CHECK_THROWS(pool.Get(TestResourceId()));
+	CHECK_THROWS(pool.Release(TestResourceId()));
+}
+
+TEST_CASE(ResourcePoolRejectsStaleHandles)
+{
+	TestResourcePool pool;
+
+	auto resourceId = pool.Insert(1);
+	pool.Release(resourceId, 10);
+
+	CHECK(!pool.IsValid(resourceId));
+	CHECK_THROWS(pool.Get(resourceId));
+	CHECK_THROWS(pool.Release(resourceId));
+
+	// The slot is not reused before its fence completes
+	auto otherResourceId = pool.Insert(2);
+	CHECK(otherResourceId.value != resourceId.value);
+
+	size_t destroyedCount = 0;
+	pool.ReleaseCompleted(9, [&destroyedCount](int&) { destroyedCount++; });
+	CHECK(destroyedCount == 0);
+	pool.ReleaseCompleted(10, [&destroyedCount](int&) { destroyedCount++; });
+	CHECK(destroyedCount == 1);
+
+	auto reusedResourceId = pool.Insert(3);
+
+	CHECK(reusedResourceId.value == resourceId.value);
+	CHECK(reusedResourceId.generation != resourceId.generation);
+	CHECK(!pool.IsValid(resourceId));
+	CHECK(pool.Get(reusedResourceId) == 3);
+	CHECK(pool.GetStatistics().reusedSlotsCount == 1);
+}
+
+TEST_CASE(ResourcePoolAssignsFenceToUnfencedReleases)
+{
+	TestResourcePool pool;
+
+	auto resourceId = pool.Insert(1);
+	pool.Release(resourceId);
+
+	size_t destroyedCount = 0;
+	pool.ReleaseCompleted(100, [&destroyedCount](int&) { destroyedCount++; });
+	CHECK(destroyedCount == 0);
+
+	pool.AssignReleaseFence(5);
+	pool.ReleaseCompleted(5, [&destroyedCount](int&) { destroyedCount++; });
+	CHECK(destroyedCount == 1);
+	CHECK(pool.GetPendingReleasesCount() == 0);
+}
+
+TEST_CASE(ResourcePoolSurvivesChurn)
+{
+	TestResourcePool pool;
+
+	std::mt19937 generator(11);
+	std::vector<std::pair<TestResourceId, int>> liveResources;
+	std::vector<TestResourceId> staleResources;
+
+	uint64_t fenceValue = 0;
+	size_t destroyedCount = 0;
+
+	for (int iteration = 0; iteration < 50000; iteration++)
+	{
+		if (liveResources.empty() || generator() % 2 == 0)
+		{
+			liveResources.push_back({ pool.Insert(iteration), iteration });
+		}
+		else
+		{
+			size_t resourceId = generator() % liveResources.size();
+
+			pool.Release(liveResources[resourceId].first, fenceValue);
+			staleResources.push_back(liveResources[resourceId].first);
+
+			liveResources[resourceId] = liveResources.back();
+			liveResources.pop_back();
+		}
+
+		if (iteration % 64 == 0)
+		{
+			pool.ReleaseCompleted(fenceValue, [&destroyedCount](int&) { destroyedCount++; });
+			fenceValue++;
+		}
+	}
+
+	for (const auto& liveResource : liveResources)
+		CHECK(pool.Get(liveResource.first) == liveResource.second);
+
+	for (const auto& staleResource : staleResources)
+		CHECK(!pool.IsValid(staleResource));
+
+	pool.ReleaseCompleted(fenceValue, [&destroyedCount](int&) { destroyedCount++; });
+
+	auto statistics = pool.GetStatistics();
+
+	CHECK(destroyedCount == staleResources.size());
+	CHECK(statistics.releasesCount == staleResources.size());
+	CHECK(statistics.destructionsCount == staleResources.size());
+	CHECK(pool.GetActiveCount() == liveResources.size());
+	CHECK(pool.GetCapacity() < statistics.insertionsCount);
+}
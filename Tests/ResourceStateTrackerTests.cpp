@@ -0,0 +1,186 @@
+#include "TestFramework.h"
+#include "ResourceStateTracker.h"
+
+#include <vector>
+
+namespace
+{
+	// Records every ResourceBarrier call, the tracker only needs that method of the command list
+	class RecordingCommandList
+	{
+	public:
+		void ResourceBarrier(UINT barriersCount, const D3D12_RESOURCE_BARRIER* barriers)
+		{
+			calls.emplace_back(barriers, barriers + barriersCount);
+		}
+
+		std::vector<std::vector<D3D12_RESOURCE_BARRIER>> calls;
+	};
+
+	// The tracker never dereferences resources, any distinct address works as a handle
+	ID3D12Resource* GetFakeResource(size_t resourceId)
+	{
+		static char resourcesStorage[16];
+
+		return reinterpret_cast<ID3D12Resource*>(&resourcesStorage[resourceId]);
+	}
+}
+
+TEST_CASE(ResourceStateTrackerDropsRedundantTransitions)
+{
+	Graphics::ResourceStateTracker tracker;
+	ID3D12Resource* texture = GetFakeResource(0);
+
+	tracker.RegisterResource(texture, D3D12_RESOURCE_STATE_GENERIC_READ, 1);
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_GENERIC_READ);
+	// Already part of the combined read state
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+	CHECK(!tracker.HasPendingBarriers());
+	CHECK(tracker.GetStatistics().transitionsRequested == 2);
+	CHECK(tracker.GetStatistics().barriersDropped == 2);
+	CHECK(tracker.GetResourceState(texture) == D3D12_RESOURCE_STATE_GENERIC_READ);
+
+	RecordingCommandList commandList;
+	tracker.FlushBarriers(&commandList);
+
+	CHECK(commandList.calls.empty());
+	CHECK(tracker.GetStatistics().barrierCalls == 0);
+}
+
+TEST_CASE(ResourceStateTrackerMergesTransitionsOfSameSubresource)
+{
+	Graphics::ResourceStateTracker tracker;
+	ID3D12Resource* texture = GetFakeResource(0);
+	ID3D12Resource* buffer = GetFakeResource(1);
+
+	tracker.RegisterResource(texture, D3D12_RESOURCE_STATE_RENDER_TARGET, 1);
+	tracker.RegisterResource(buffer, D3D12_RESOURCE_STATE_COPY_DEST, 1);
+
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	// Back to where it started, the queued barrier disappears
+	tracker.TransitionResource(buffer, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+	tracker.TransitionResource(buffer, D3D12_RESOURCE_STATE_COPY_DEST);
+
+	CHECK(tracker.GetStatistics().transitionsMerged == 2);
+
+	RecordingCommandList commandList;
+	tracker.FlushBarriers(&commandList);
+
+	CHECK(commandList.calls.size() == 1 && commandList.calls[0].size() == 1);
+
+	const D3D12_RESOURCE_BARRIER& barrier = commandList.calls[0][0];
+	CHECK(barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION && barrier.Transition.pResource == texture);
+	CHECK(barrier.Transition.StateBefore == D3D12_RESOURCE_STATE_RENDER_TARGET);
+	CHECK(barrier.Transition.StateAfter == D3D12_RESOURCE_STATE_COPY_SOURCE);
+	CHECK(tracker.GetResourceState(buffer) == D3D12_RESOURCE_STATE_COPY_DEST);
+}
+
+TEST_CASE(ResourceStateTrackerIssuesOneCallPerFlush)
+{
+	Graphics::ResourceStateTracker tracker;
+
+	for (size_t resourceId = 0; resourceId < 3; resourceId++)
+	{
+		tracker.RegisterResource(GetFakeResource(resourceId), D3D12_RESOURCE_STATE_COMMON, 1);
+		tracker.TransitionResource(GetFakeResource(resourceId), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	}
+
+	tracker.SetUAVBarrier(GetFakeResource(0));
+
+	RecordingCommandList commandList;
+	tracker.FlushBarriers(&commandList);
+	tracker.FlushBarriers(&commandList);
+
+	CHECK(commandList.calls.size() == 1 && commandList.calls[0].size() == 4);
+	CHECK(!tracker.HasPendingBarriers());
+	CHECK(tracker.GetStatistics().barriersIssued == 4);
+	CHECK(tracker.GetStatistics().barrierCalls == 1);
+	CHECK(tracker.GetStatistics().uavBarriersIssued == 1);
+}
+
+TEST_CASE(ResourceStateTrackerSplitsBarriers)
+{
+	Graphics::ResourceStateTracker tracker;
+	ID3D12Resource* texture = GetFakeResource(0);
+
+	tracker.RegisterResource(texture, D3D12_RESOURCE_STATE_RENDER_TARGET, 1);
+
+	RecordingCommandList commandList;
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+	tracker.FlushBarriers(&commandList);
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	tracker.FlushBarriers(&commandList);
+
+	CHECK(commandList.calls.size() == 2 && commandList.calls[0].size() == 1 && commandList.calls[1].size() == 1);
+	CHECK(commandList.calls[0][0].Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+	CHECK(commandList.calls[1][0].Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+	CHECK(commandList.calls[1][0].Transition.StateBefore == D3D12_RESOURCE_STATE_RENDER_TARGET);
+	CHECK(commandList.calls[1][0].Transition.StateAfter == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	CHECK(tracker.GetResourceState(texture) == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	CHECK(tracker.GetStatistics().splitBarriersIssued == 2);
+
+	// Without split barriers the begin request is dropped and the end request becomes a plain transition
+	tracker.SetSplitBarriersEnabled(false);
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+	tracker.FlushBarriers(&commandList);
+
+	CHECK(commandList.calls.size() == 3 && commandList.calls[2].size() == 1);
+	CHECK(commandList.calls[2][0].Flags == D3D12_RESOURCE_BARRIER_FLAG_NONE);
+	CHECK(tracker.GetStatistics().splitBarriersIssued == 2);
+}
+
+TEST_CASE(ResourceStateTrackerFlushesSingleResource)
+{
+	Graphics::ResourceStateTracker tracker;
+	ID3D12Resource* texture = GetFakeResource(0);
+	ID3D12Resource* buffer = GetFakeResource(1);
+
+	tracker.RegisterResource(texture, D3D12_RESOURCE_STATE_RENDER_TARGET, 1);
+	tracker.RegisterResource(buffer, D3D12_RESOURCE_STATE_COPY_DEST, 1);
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	tracker.TransitionResource(buffer, D3D12_RESOURCE_STATE_INDEX_BUFFER);
+
+	RecordingCommandList commandList;
+	tracker.FlushBarriers(&commandList, buffer);
+
+	CHECK(commandList.calls.size() == 1 && commandList.calls[0].size() == 1);
+	CHECK(commandList.calls[0][0].Transition.pResource == buffer);
+	CHECK(tracker.HasPendingBarriers());
+
+	tracker.FlushBarriers(&commandList, buffer);
+	CHECK(commandList.calls.size() == 1);
+
+	tracker.FlushBarriers(&commandList);
+
+	CHECK(commandList.calls.size() == 2 && commandList.calls[1].size() == 1);
+	CHECK(commandList.calls[1][0].Transition.pResource == texture);
+	CHECK(!tracker.HasPendingBarriers());
+}
+
+TEST_CASE(ResourceStateTrackerKeepsLastFrameStatistics)
+{
+	Graphics::ResourceStateTracker tracker;
+	ID3D12Resource* texture = GetFakeResource(0);
+
+	tracker.RegisterResource(texture, D3D12_RESOURCE_STATE_RENDER_TARGET, 1);
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	tracker.TransitionResource(texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+	RecordingCommandList commandList;
+	tracker.FlushBarriers(&commandList);
+	tracker.FinishFrame();
+
+	const Graphics::ResourceBarrierStatistics& lastFrameStatistics = tracker.GetLastFrameStatistics();
+	CHECK(lastFrameStatistics.transitionsRequested == 2);
+	CHECK(lastFrameStatistics.barriersDropped == 1);
+	CHECK(lastFrameStatistics.barriersIssued == 1);
+	CHECK(lastFrameStatistics.barrierCalls == 1);
+
+	CHECK(tracker.GetStatistics().transitionsRequested == 0);
+	CHECK(tracker.GetStatistics().barriersIssued == 0);
+	// Tracked states survive the frame boundary
+	CHECK(tracker.GetResourceState(texture) == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+}
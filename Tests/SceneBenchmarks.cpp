@@ -0,0 +1,1187 @@
+#include "BenchmarkHelpers.h"
+#include "BoundingVolumeHierarchy.h"
+#include "Octree.h"
+#include "OcclusionCuller.h"
+#include "Scene.h"
+#include "SweepAndPrune.h"
+#include "TriangleHierarchy.h"
+
+#include <algorithm>
+
+// CPU-side scene benchmarks, see BenchmarkHelpers.h for the shared object field. Run with --benchmark.
+
+namespace
+{
+	const Graphics::BoundingBox UNIT_BOUNDING_BOX = { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } };
+	const Graphics::BoundingBox OCTREE_BOUNDING_BOX = { { -1024.0f, -1024.0f, -1024.0f }, { 1024.0f, 1024.0f, 1024.0f } };
+	const uint32_t OCTREE_DEPTH = 5;
+
+	const float FIELD_HALF_EXTENT = 200.0f;
+	const float CAMERA_ORBIT_RADIUS = 400.0f;
+
+	std::unique_ptr<Graphics::Octree> CreateOctree(const Graphics::Tests::BenchmarkObjectPool& objects)
+	{
+		auto octree = std::make_unique<Graphics::Octree>(OCTREE_DEPTH, OCTREE_BOUNDING_BOX);
+
+		for (auto& object : objects)
+			octree->AddObject(object.get(), false);
+
+		return octree;
+	}
+
+	// Pulls the objects of a uniform field into a few dense clusters, the distribution a fixed octree subdivision handles worst
+	void ClusterObjectsField(size_t clustersCount, float clusterRadius, uint32_t seed, Graphics::Tests::BenchmarkObjectPool& objects)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> centerDistribution(-FIELD_HALF_EXTENT, FIELD_HALF_EXTENT);
+		std::normal_distribution<float> offsetDistribution(0.0f, clusterRadius);
+
+		std::vector<floatN> clusterCenters(clustersCount);
+
+		for (auto& clusterCenter : clusterCenters)
+			clusterCenter = XMVectorSet(centerDistribution(generator), centerDistribution(generator), centerDistribution(generator), 1.0f);
+
+		for (size_t objectId = 0; objectId < objects.size(); objectId++)
+		{
+			float4x4 worldMatrix = objects[objectId]->GetWorldMatrix();
+			worldMatrix.r[3] = clusterCenters[objectId % clustersCount] + XMVectorSet(offsetDistribution(generator), offsetDistribution(generator),
+				offsetDistribution(generator), 0.0f);
+
+			objects[objectId]->SetWorldMatrix(worldMatrix);
+		}
+
+		Graphics::BoundingBoxTransformer boundingBoxTransformer;
+		Graphics::Tests::UpdateObjectsWorldBounds(objects, boundingBoxTransformer);
+	}
+
+	// Rays from points around the field towards random points inside it, as picking and line-of-sight queries would cast them
+	void CreateRandomRays(size_t raysCount, uint32_t seed, std::vector<Graphics::Ray>& rays)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> coordinateDistribution(-1.0f, 1.0f);
+
+		rays.resize(raysCount);
+
+		for (auto& ray : rays)
+		{
+			floatN origin = XMVector3Normalize(XMVectorSet(coordinateDistribution(generator), coordinateDistribution(generator),
+				coordinateDistribution(generator), 0.0f)) * CAMERA_ORBIT_RADIUS;
+			floatN target = XMVectorSet(coordinateDistribution(generator), coordinateDistribution(generator), coordinateDistribution(generator),
+				0.0f) * FIELD_HALF_EXTENT;
+
+			XMStoreFloat3(&ray.origin, origin);
+			XMStoreFloat3(&ray.direction, XMVector3Normalize(target - origin));
+			ray.maxDistance = 4.0f * CAMERA_ORBIT_RADIUS;
+		}
+	}
+
+	// Per-object reference: transforms the eight corners and takes their bounds
+	Graphics::BoundingBox TransformBoundingBoxCorners(const Graphics::BoundingBox& localBoundingBox, const float4x4& worldMatrix)
+	{
+		std::array<floatN, 8> boundingBoxVertices;
+		Graphics::BoundingBoxVertices(localBoundingBox, boundingBoxVertices);
+
+		floatN minCornerPoint = XMVector3TransformCoord(boundingBoxVertices[0], worldMatrix);
+		floatN maxCornerPoint = minCornerPoint;
+
+		for (auto& vertex : boundingBoxVertices)
+		{
+			floatN worldVertex = XMVector3TransformCoord(vertex, worldMatrix);
+
+			minCornerPoint = XMVectorMin(minCornerPoint, worldVertex);
+			maxCornerPoint = XMVectorMax(maxCornerPoint, worldVertex);
+		}
+
+		Graphics::BoundingBox worldBoundingBox{};
+		XMStoreFloat3(&worldBoundingBox.minCornerPoint, minCornerPoint);
+		XMStoreFloat3(&worldBoundingBox.maxCornerPoint, maxCornerPoint);
+
+		return worldBoundingBox;
+	}
+
+	bool RaycastLinear(const Graphics::ObjectPtrPool& objects, const Graphics::Ray& ray, Graphics::RayHit& result)
+	{
+		floatN origin = XMLoadFloat3(&ray.origin);
+		floatN inverseDirection = XMVectorReciprocal(XMLoadFloat3(&ray.direction));
+
+		result = { nullptr, ray.maxDistance };
+
+		for (auto& object : objects)
+		{
+			float entryDistance;
+
+			if (Graphics::IntersectRayBoundingBox(origin, inverseDirection, object->GetBoundingBox(), result.distance, entryDistance))
+				result = { object, entryDistance };
+		}
+
+		return result.object != nullptr;
+	}
+
+	// Reference pair finders for the sweep and prune, each pair is reported once
+	void FindOverlappingPairsBruteForce(const Graphics::ObjectPtrPool& objects, std::vector<Graphics::ObjectPair>& overlappingPairs)
+	{
+		overlappingPairs.clear();
+
+		for (size_t firstId = 0; firstId < objects.size(); firstId++)
+			for (size_t secondId = firstId + 1; secondId < objects.size(); secondId++)
+				if (Graphics::CheckBoxIntersectsBox(objects[firstId]->GetBoundingBox(), objects[secondId]->GetBoundingBox()))
+					overlappingPairs.push_back({ objects[firstId], objects[secondId] });
+	}
+
+	void FindOverlappingPairsWithOctree(const Graphics::ObjectPtrPool& objects, Graphics::Octree& octree, std::vector<const Graphics::GraphicObject*>& queryResults,
+		std::vector<Graphics::ObjectPair>& overlappingPairs)
+	{
+		overlappingPairs.clear();
+
+		for (auto& object : objects)
+		{
+			const Graphics::BoundingBox& boundingBox = object->GetBoundingBox();
+
+			size_t resultsCount = octree.QueryBoundingBox(boundingBox, queryResults.data(), queryResults.size());
+
+			if (resultsCount > queryResults.size())
+			{
+				queryResults.resize(resultsCount);
+				resultsCount = octree.QueryBoundingBox(boundingBox, queryResults.data(), queryResults.size());
+			}
+
+			// Both objects of a pair find each other, only the one at the lower address reports it
+			for (size_t resultId = 0; resultId < resultsCount; resultId++)
+				if (std::less<const Graphics::GraphicObject*>()(object, queryResults[resultId]))
+					overlappingPairs.push_back({ object, queryResults[resultId] });
+		}
+	}
+
+	// Height field in the XY plane, so the same triangles serve both the raycasts and the 2D point queries
+	void CreateHeightField(uint32_t cellsPerAxis, float cellSize, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+	{
+		uint32_t verticesPerAxis = cellsPerAxis + 1;
+
+		positions.clear();
+		indices.clear();
+
+		for (uint32_t y = 0; y < verticesPerAxis; y++)
+			for (uint32_t x = 0; x < verticesPerAxis; x++)
+				positions.push_back({ x * cellSize, y * cellSize, 4.0f * std::sin(0.1f * x) * std::cos(0.1f * y) });
+
+		for (uint32_t y = 0; y < cellsPerAxis; y++)
+			for (uint32_t x = 0; x < cellsPerAxis; x++)
+			{
+				uint32_t cornerIndex = y * verticesPerAxis + x;
+
+				indices.insert(indices.end(), { cornerIndex, cornerIndex + 1, cornerIndex + verticesPerAxis + 1 });
+				indices.insert(indices.end(), { cornerIndex, cornerIndex + verticesPerAxis + 1, cornerIndex + verticesPerAxis });
+			}
+	}
+
+	// Linear references for the triangle hierarchy, every triangle is tested against the query
+	bool RaycastTrianglesLinear(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, const float3& origin, const float3& direction,
+		float maxDistance, float& nearestDistance)
+	{
+		floatN rayOrigin = XMLoadFloat3(&origin);
+		floatN rayDirection = XMVector3Normalize(XMLoadFloat3(&direction));
+
+		bool isHit = false;
+
+		for (size_t indexId = 0; indexId < indices.size(); indexId += 3)
+		{
+			floatN position0 = XMLoadFloat3(&positions[indices[indexId]]);
+			floatN edge1 = XMLoadFloat3(&positions[indices[indexId + 1]]) - position0;
+			floatN edge2 = XMLoadFloat3(&positions[indices[indexId + 2]]) - position0;
+
+			floatN directionCrossEdge2 = XMVector3Cross(rayDirection, edge2);
+			float determinant = XMVectorGetX(XMVector3Dot(edge1, directionCrossEdge2));
+
+			if (std::abs(determinant) < FLT_EPSILON)
+				continue;
+
+			float inverseDeterminant = 1.0f / determinant;
+
+			floatN originOffset = rayOrigin - position0;
+			float u = XMVectorGetX(XMVector3Dot(originOffset, directionCrossEdge2)) * inverseDeterminant;
+
+			if (u < 0.0f || u > 1.0f)
+				continue;
+
+			floatN offsetCrossEdge1 = XMVector3Cross(originOffset, edge1);
+			float v = XMVectorGetX(XMVector3Dot(rayDirection, offsetCrossEdge1)) * inverseDeterminant;
+
+			if (v < 0.0f || u + v > 1.0f)
+				continue;
+
+			float distance = XMVectorGetX(XMVector3Dot(edge2, offsetCrossEdge1)) * inverseDeterminant;
+
+			if (distance < 0.0f || distance > maxDistance)
+				continue;
+
+			maxDistance = distance;
+			nearestDistance = distance;
+			isHit = true;
+		}
+
+		return isHit;
+	}
+
+	bool ContainsPointLinear(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, const float2& point)
+	{
+		for (size_t indexId = 0; indexId < indices.size(); indexId += 3)
+		{
+			const float3& position0 = positions[indices[indexId]];
+			const float3& position1 = positions[indices[indexId + 1]];
+			const float3& position2 = positions[indices[indexId + 2]];
+
+			float edge1X = position1.x - position0.x, edge1Y = position1.y - position0.y;
+			float edge2X = position2.x - position0.x, edge2Y = position2.y - position0.y;
+			float determinant = edge1X * edge2Y - edge1Y * edge2X;
+
+			if (determinant == 0.0f)
+				continue;
+
+			float offsetX = point.x - position0.x;
+			float offsetY = point.y - position0.y;
+
+			float u = (offsetX * edge2Y - offsetY * edge2X) / determinant;
+			float v = (edge1X * offsetY - edge1Y * offsetX) / determinant;
+
+			if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f)
+				return true;
+		}
+
+		return false;
+	}
+}
+
+using namespace Graphics::Tests;
+
+BENCHMARK_CASE(FlythroughTemporalCoherence)
+{
+	const size_t OBJECTS_COUNT = 50000;
+	const size_t FRAMES_COUNT = 200;
+	const float FLIGHT_RADIUS = 0.5f * FIELD_HALF_EXTENT;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 12, objects);
+
+	auto octree = CreateOctree(objects);
+
+	Graphics::Camera camera(XM_PIDIV4, 16.0f / 9.0f, 0.1f, FIELD_HALF_EXTENT);
+
+	Graphics::ObjectPtrPool coherentObjectsList, coherentTransparentObjectsList, coherentEffectObjectsList;
+	Graphics::ObjectPtrPool fullObjectsList, fullTransparentObjectsList, fullEffectObjectsList;
+
+	size_t coherentPlaneTests = 0;
+	size_t fullPlaneTests = 0;
+
+	// The camera circles inside the field looking along its path, the same frame is culled with the cached planes and without them
+	for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+	{
+		float angle = XM_2PI * frameId / FRAMES_COUNT;
+
+		camera.Move({ FLIGHT_RADIUS * std::cos(angle), 0.0f, FLIGHT_RADIUS * std::sin(angle) });
+		camera.LookAt({ FLIGHT_RADIUS * std::cos(angle + 0.1f), 0.0f, FLIGHT_RADIUS * std::sin(angle + 0.1f) });
+		camera.Update();
+
+		coherentObjectsList.clear();
+		coherentTransparentObjectsList.clear();
+		coherentEffectObjectsList.clear();
+
+		octree->SetTemporalCoherence(true);
+		octree->PrepareVisibleObjectsList(camera, coherentObjectsList, coherentTransparentObjectsList, coherentEffectObjectsList);
+
+		coherentPlaneTests += octree->GetCullingStatistics().planeTests;
+
+		fullObjectsList.clear();
+		fullTransparentObjectsList.clear();
+		fullEffectObjectsList.clear();
+
+		octree->SetTemporalCoherence(false);
+		octree->PrepareVisibleObjectsList(camera, fullObjectsList, fullTransparentObjectsList, fullEffectObjectsList);
+
+		fullPlaneTests += octree->GetCullingStatistics().planeTests;
+
+		std::sort(coherentObjectsList.begin(), coherentObjectsList.end());
+		std::sort(fullObjectsList.begin(), fullObjectsList.end());
+
+		CHECK(coherentObjectsList == fullObjectsList);
+	}
+
+	PrintBenchmarkResult("Flythrough plane tests with coherence", static_cast<double>(coherentPlaneTests) / FRAMES_COUNT, "tests/frame");
+	PrintBenchmarkResult("Flythrough plane tests without coherence", static_cast<double>(fullPlaneTests) / FRAMES_COUNT, "tests/frame");
+}
+
+BENCHMARK_CASE(BoundingVolumeHierarchyVersusOctree)
+{
+	const size_t OBJECTS_COUNT = 50000;
+	const size_t FRAMES_COUNT = 50;
+	const size_t CAMERAS_COUNT = 8;
+	const float STEP_LENGTH = 0.5f;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+
+	std::vector<std::unique_ptr<Graphics::Camera>> cameras;
+	CreateOrbitCameras(CAMERAS_COUNT, CAMERA_ORBIT_RADIUS, cameras);
+
+	const char* distributionNames[] = { "uniform", "clustered" };
+
+	for (const char* distributionName : distributionNames)
+	{
+		bool isClustered = std::string(distributionName) == "clustered";
+
+		BenchmarkObjectPool objects;
+		CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 13, objects);
+
+		if (isClustered)
+			ClusterObjectsField(16, 10.0f, 14, objects);
+
+		auto objectPointers = GetObjectPointers(objects);
+
+		double hierarchyBuildTime, octreeBuildTime;
+		double hierarchyRefitTime = 0.0, octreeRefitTime = 0.0;
+		double hierarchyCullingTime = 0.0, octreeCullingTime = 0.0;
+
+		Graphics::BoundingVolumeHierarchy hierarchy;
+		Graphics::Octree octree(OCTREE_DEPTH, OCTREE_BOUNDING_BOX);
+
+		{
+			BenchmarkTimer timer;
+
+			for (auto& object : objects)
+				hierarchy.AddObject(object.get(), true);
+
+			hierarchy.Build();
+
+			hierarchyBuildTime = timer.GetElapsedSeconds();
+		}
+
+		{
+			BenchmarkTimer timer;
+
+			for (auto& object : objects)
+				octree.AddObject(object.get(), true);
+
+			octreeBuildTime = timer.GetElapsedSeconds();
+		}
+
+		Graphics::BoundingBoxTransformer boundingBoxTransformer;
+
+		std::mt19937 generator(15);
+		std::uniform_real_distribution<float> stepDistribution(-STEP_LENGTH, STEP_LENGTH);
+
+		Graphics::ObjectPtrPool hierarchyObjectsList, hierarchyTransparentObjectsList, hierarchyEffectObjectsList;
+		Graphics::ObjectPtrPool octreeObjectsList, octreeTransparentObjectsList, octreeEffectObjectsList;
+
+		// Every object drifts a little each frame, both indices take the whole moved list and then cull it from every camera
+		for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+		{
+			for (auto& object : objects)
+			{
+				float4x4 worldMatrix = object->GetWorldMatrix();
+				worldMatrix.r[3] = XMVectorAdd(worldMatrix.r[3], XMVectorSet(stepDistribution(generator), stepDistribution(generator),
+					stepDistribution(generator), 0.0f));
+
+				object->SetWorldMatrix(worldMatrix);
+			}
+
+			UpdateObjectsWorldBounds(objects, boundingBoxTransformer);
+
+			{
+				BenchmarkTimer timer;
+				hierarchy.UpdateObjects(objectPointers);
+				hierarchyRefitTime += timer.GetElapsedSeconds();
+			}
+
+			{
+				BenchmarkTimer timer;
+				octree.UpdateObjects(objectPointers);
+				octreeRefitTime += timer.GetElapsedSeconds();
+			}
+
+			for (auto& camera : cameras)
+			{
+				hierarchyObjectsList.clear();
+				hierarchyTransparentObjectsList.clear();
+				hierarchyEffectObjectsList.clear();
+
+				{
+					BenchmarkTimer timer;
+					hierarchy.PrepareVisibleObjectsList(*camera, hierarchyObjectsList, hierarchyTransparentObjectsList, hierarchyEffectObjectsList);
+					hierarchyCullingTime += timer.GetElapsedSeconds();
+				}
+
+				octreeObjectsList.clear();
+				octreeTransparentObjectsList.clear();
+				octreeEffectObjectsList.clear();
+
+				{
+					BenchmarkTimer timer;
+					octree.PrepareVisibleObjectsList(*camera, octreeObjectsList, octreeTransparentObjectsList, octreeEffectObjectsList);
+					octreeCullingTime += timer.GetElapsedSeconds();
+				}
+
+				std::sort(hierarchyObjectsList.begin(), hierarchyObjectsList.end());
+				std::sort(octreeObjectsList.begin(), octreeObjectsList.end());
+
+				CHECK(hierarchyObjectsList == octreeObjectsList);
+			}
+		}
+
+		std::string distributionLabel = std::string(", ") + distributionName;
+
+		PrintBenchmarkResult("BVH build" + distributionLabel, 1e3 * hierarchyBuildTime, "ms");
+		PrintBenchmarkResult("Octree build" + distributionLabel, 1e3 * octreeBuildTime, "ms");
+		PrintBenchmarkResult("BVH refit" + distributionLabel, 1e3 * hierarchyRefitTime / FRAMES_COUNT, "ms/frame");
+		PrintBenchmarkResult("Octree update" + distributionLabel, 1e3 * octreeRefitTime / FRAMES_COUNT, "ms/frame");
+		PrintBenchmarkResult("BVH culling" + distributionLabel, 1e3 * hierarchyCullingTime / (FRAMES_COUNT * CAMERAS_COUNT), "ms/view");
+		PrintBenchmarkResult("Octree culling" + distributionLabel, 1e3 * octreeCullingTime / (FRAMES_COUNT * CAMERAS_COUNT), "ms/view");
+	}
+}
+
+BENCHMARK_CASE(OcclusionCullingThroughput)
+{
+	const size_t OBJECTS_COUNT = 20000;
+	const size_t FRAMES_COUNT = 100;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 1, objects);
+
+	auto octree = CreateOctree(objects);
+
+	std::vector<std::unique_ptr<Graphics::Camera>> cameras;
+	CreateOrbitCameras(1, CAMERA_ORBIT_RADIUS, cameras);
+
+	// A wall between the camera and one half of the field, the other half stays in plain view
+	const float3 wallVertices[] = { { 250.0f, -300.0f, -300.0f }, { 250.0f, 300.0f, -300.0f }, { 250.0f, 300.0f, 0.0f }, { 250.0f, -300.0f, 0.0f } };
+	const uint32_t wallIndices[] = { 0, 1, 2, 0, 2, 3 };
+
+	Graphics::OcclusionCuller occlusionCuller;
+	occlusionCuller.AddOccluder(wallVertices, sizeof(wallVertices), Graphics::VertexFormat::POSITION, wallIndices, sizeof(wallIndices));
+
+	Graphics::ObjectPtrPool visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList;
+
+	double rasterizationTime = 0.0;
+	double testingTime = 0.0;
+	size_t objectsTested = 0;
+	size_t objectsOccluded = 0;
+
+	for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+	{
+		visibleObjectsList.clear();
+		visibleTransparentObjectsList.clear();
+		visibleEffectObjectsList.clear();
+
+		octree->PrepareVisibleObjectsList(*cameras.front(), visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+
+		occlusionCuller.RasterizeOccluders(*cameras.front());
+		occlusionCuller.FilterVisibleObjects(visibleObjectsList, visibleTransparentObjectsList, visibleEffectObjectsList);
+
+		const auto& occlusionStatistics = occlusionCuller.GetOcclusionStatistics();
+
+		rasterizationTime += occlusionStatistics.rasterizationTime;
+		testingTime += occlusionStatistics.testingTime;
+		objectsTested += occlusionStatistics.objectsTested;
+		objectsOccluded += occlusionStatistics.objectsOccluded;
+	}
+
+	CHECK(objectsOccluded > 0 && objectsOccluded < objectsTested);
+
+	PrintBenchmarkResult("Occlusion rasterization", rasterizationTime / FRAMES_COUNT, "ms/frame");
+	PrintBenchmarkResult("Occlusion testing", objectsTested / testingTime / 1e3, "Mobjects/s");
+	PrintBenchmarkResult("Occlusion rejected", 100.0 * objectsOccluded / objectsTested, "% of frustum-visible objects");
+}
+
+BENCHMARK_CASE(RaycastThroughput)
+{
+	const size_t OBJECTS_COUNT = 20000;
+	const size_t RAYS_COUNT = 2000;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 2, objects);
+
+	auto octree = CreateOctree(objects);
+	auto objectPointers = GetObjectPointers(objects);
+
+	std::vector<Graphics::Ray> rays;
+	CreateRandomRays(RAYS_COUNT, 3, rays);
+
+	std::vector<Graphics::RayHit> linearHits(RAYS_COUNT);
+	std::vector<Graphics::RayHit> octreeHits(RAYS_COUNT);
+	std::vector<Graphics::RayHit> packetHits;
+
+	double linearTime, octreeTime, packetTime;
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t rayId = 0; rayId < RAYS_COUNT; rayId++)
+			RaycastLinear(objectPointers, rays[rayId], linearHits[rayId]);
+
+		linearTime = timer.GetElapsedSeconds();
+	}
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t rayId = 0; rayId < RAYS_COUNT; rayId++)
+			if (!octree->RaycastNearest(rays[rayId], octreeHits[rayId]))
+				octreeHits[rayId] = { nullptr, rays[rayId].maxDistance };
+
+		octreeTime = timer.GetElapsedSeconds();
+	}
+
+	{
+		BenchmarkTimer timer;
+
+		octree->RaycastPacket(rays, packetHits);
+
+		packetTime = timer.GetElapsedSeconds();
+	}
+
+	// Ties between overlapping boxes may pick different objects, the nearest distance must still match
+	for (size_t rayId = 0; rayId < RAYS_COUNT; rayId++)
+	{
+		CHECK((linearHits[rayId].object == nullptr) == (octreeHits[rayId].object == nullptr));
+		CHECK((linearHits[rayId].object == nullptr) == (packetHits[rayId].object == nullptr));
+		CHECK(std::abs(linearHits[rayId].distance - octreeHits[rayId].distance) < 1e-3f);
+		CHECK(std::abs(linearHits[rayId].distance - packetHits[rayId].distance) < 1e-3f);
+	}
+
+	PrintBenchmarkResult("Raycast linear", RAYS_COUNT / linearTime / 1e3, "Krays/s");
+	PrintBenchmarkResult("Raycast octree nearest", RAYS_COUNT / octreeTime / 1e3, "Krays/s");
+	PrintBenchmarkResult("Raycast octree packet", RAYS_COUNT / packetTime / 1e3, "Krays/s");
+}
+
+BENCHMARK_CASE(LightInfluenceQueries)
+{
+	const size_t OBJECTS_COUNT = 20000;
+	const size_t LIGHTS_COUNT = 4096;
+	const size_t RESULTS_CAPACITY = 1 << 22;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 4, objects);
+
+	auto octree = CreateOctree(objects);
+
+	std::mt19937 generator(5);
+	std::uniform_real_distribution<float> positionDistribution(-FIELD_HALF_EXTENT, FIELD_HALF_EXTENT);
+	std::uniform_real_distribution<float> radiusDistribution(2.0f, 20.0f);
+
+	std::vector<Graphics::BoundingSphere> lightSpheres(LIGHTS_COUNT);
+
+	for (auto& lightSphere : lightSpheres)
+	{
+		lightSphere.center = { positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+		lightSphere.radius = radiusDistribution(generator);
+	}
+
+	std::vector<const Graphics::GraphicObject*> sphereResults(RESULTS_CAPACITY);
+	std::vector<Graphics::ObjectOverlap> batchedResults(RESULTS_CAPACITY);
+
+	size_t singleOverlapsCount = 0;
+	double singleTime, batchedTime;
+
+	{
+		BenchmarkTimer timer;
+
+		for (auto& lightSphere : lightSpheres)
+			singleOverlapsCount += octree->QuerySphere(lightSphere, sphereResults.data(), sphereResults.size());
+
+		singleTime = timer.GetElapsedSeconds();
+	}
+
+	size_t batchedOverlapsCount;
+
+	{
+		BenchmarkTimer timer;
+
+		batchedOverlapsCount = octree->QuerySpheres(lightSpheres.data(), lightSpheres.size(), batchedResults.data(), batchedResults.size());
+
+		batchedTime = timer.GetElapsedSeconds();
+	}
+
+	CHECK(singleOverlapsCount == batchedOverlapsCount);
+	CHECK(batchedOverlapsCount < RESULTS_CAPACITY);
+
+	PrintBenchmarkResult("Light queries one by one", LIGHTS_COUNT / singleTime / 1e3, "Klights/s");
+	PrintBenchmarkResult("Light queries batched", LIGHTS_COUNT / batchedTime / 1e3, "Klights/s");
+	PrintBenchmarkResult("Light influence overlaps", static_cast<double>(batchedOverlapsCount) / LIGHTS_COUNT, "objects/light");
+}
+
+BENCHMARK_CASE(LevelOfDetailSelection)
+{
+	const size_t OBJECTS_COUNT = 100000;
+	const size_t FRAMES_COUNT = 20;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+	BenchmarkRenderable mediumRenderable(UNIT_BOUNDING_BOX);
+	BenchmarkRenderable lowRenderable(UNIT_BOUNDING_BOX);
+
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 6, objects);
+
+	Graphics::Scene scene;
+	scene.SetMinScreenSize(2.0f);
+
+	for (auto& object : objects)
+	{
+		object->AddLevelOfDetail(&mediumRenderable, 64.0f);
+		object->AddLevelOfDetail(&lowRenderable, 16.0f);
+
+		scene.EmplaceGraphicObject(object.get(), false);
+	}
+
+	std::vector<std::unique_ptr<Graphics::Camera>> cameras;
+	CreateOrbitCameras(1, CAMERA_ORBIT_RADIUS, cameras);
+
+	scene.SetMainCamera(cameras.front().get());
+
+	double selectionTime = 0.0;
+	size_t objectsSelected = 0;
+	size_t objectsScreenSizeCulled = 0;
+	size_t objectsLevelOfDetailChanged = 0;
+
+	// The camera moves every frame, otherwise the scene reuses the previous visible list and skips the selection
+	for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+	{
+		cameras.front()->MoveRelative({ 0.0f, 0.0f, 2.0f });
+		cameras.front()->Update();
+
+		scene.ExecuteScripts(nullptr, 0, 0);
+
+		const auto& levelOfDetailStatistics = scene.GetLevelOfDetailStatistics();
+
+		selectionTime += levelOfDetailStatistics.selectionTime;
+		objectsScreenSizeCulled += levelOfDetailStatistics.objectsScreenSizeCulled;
+		objectsLevelOfDetailChanged += levelOfDetailStatistics.objectsLevelOfDetailChanged;
+
+		for (auto& objectsCount : levelOfDetailStatistics.objectsPerLevelOfDetail)
+			objectsSelected += objectsCount;
+	}
+
+	CHECK(objectsSelected > 0);
+
+	PrintBenchmarkResult("Level of detail selection", (objectsSelected + objectsScreenSizeCulled) / selectionTime / 1e3, "Mobjects/s");
+	PrintBenchmarkResult("Screen size culled", static_cast<double>(objectsScreenSizeCulled) / FRAMES_COUNT, "objects/frame");
+	PrintBenchmarkResult("Level of detail changed", static_cast<double>(objectsLevelOfDetailChanged) / FRAMES_COUNT, "objects/frame");
+}
+
+BENCHMARK_CASE(MultiViewCulling)
+{
+	const size_t OBJECTS_COUNT = 50000;
+	const size_t FRAMES_COUNT = 20;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 7, objects);
+
+	auto octree = CreateOctree(objects);
+
+	std::vector<std::unique_ptr<Graphics::Camera>> cameras;
+	CreateOrbitCameras(Graphics::ISpatialIndex::MAX_VIEWS_COUNT, CAMERA_ORBIT_RADIUS, cameras);
+
+	std::vector<const Graphics::Camera*> cameraPointers;
+
+	for (auto& camera : cameras)
+		cameraPointers.push_back(camera.get());
+
+	std::vector<Graphics::VisibleObjectsLists> sequentialObjectsLists(cameras.size());
+	std::vector<Graphics::VisibleObjectsLists> multiViewObjectsLists;
+
+	double sequentialTime, multiViewTime;
+	size_t sequentialPlaneTests = 0;
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+			for (size_t viewId = 0; viewId < cameras.size(); viewId++)
+			{
+				auto& viewObjectsLists = sequentialObjectsLists[viewId];
+
+				viewObjectsLists.visibleObjectsList.clear();
+				viewObjectsLists.visibleTransparentObjectsList.clear();
+				viewObjectsLists.visibleEffectObjectsList.clear();
+
+				octree->PrepareVisibleObjectsList(*cameras[viewId], viewObjectsLists.visibleObjectsList, viewObjectsLists.visibleTransparentObjectsList,
+					viewObjectsLists.visibleEffectObjectsList);
+
+				sequentialPlaneTests += octree->GetCullingStatistics().planeTests;
+			}
+
+		sequentialTime = timer.GetElapsedSeconds();
+	}
+
+	size_t multiViewPlaneTests = 0;
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+		{
+			octree->PrepareVisibleObjectsLists(cameraPointers, multiViewObjectsLists);
+
+			multiViewPlaneTests += octree->GetMultiViewCullingStatistics().planeTests;
+		}
+
+		multiViewTime = timer.GetElapsedSeconds();
+	}
+
+	for (size_t viewId = 0; viewId < cameras.size(); viewId++)
+		CHECK(sequentialObjectsLists[viewId].visibleObjectsList.size() == multiViewObjectsLists[viewId].visibleObjectsList.size());
+
+	PrintBenchmarkResult("Sequential culling of " + std::to_string(cameras.size()) + " views", 1e3 * sequentialTime / FRAMES_COUNT, "ms/frame");
+	PrintBenchmarkResult("Multi-view culling of " + std::to_string(cameras.size()) + " views", 1e3 * multiViewTime / FRAMES_COUNT, "ms/frame");
+	PrintBenchmarkResult("Plane tests saved", 100.0 - 100.0 * multiViewPlaneTests / sequentialPlaneTests, "%");
+}
+
+BENCHMARK_CASE(BoundingVolumeCascade)
+{
+	const size_t OBJECTS_COUNT = 50000;
+
+	// Long thin boxes under random rotations, the case where the world AABB is loosest
+	const Graphics::BoundingBox elongatedBoundingBox = { { -4.0f, -0.25f, -0.25f }, { 4.0f, 0.25f, 0.25f } };
+
+	BenchmarkRenderable renderable(elongatedBoundingBox);
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 8, objects);
+
+	std::vector<std::unique_ptr<Graphics::Camera>> cameras;
+	CreateOrbitCameras(1, 0.5f * FIELD_HALF_EXTENT, cameras);
+
+	const Graphics::Camera& camera = *cameras.front();
+
+	size_t sphereAccepted = 0;
+	size_t boxAccepted = 0;
+	size_t orientedBoxAccepted = 0;
+	size_t cascadeAccepted = 0;
+
+	Graphics::CullingStatistics cullingStatistics{};
+	double cascadeTime;
+
+	for (auto& object : objects)
+	{
+		uint32_t planeMask = Graphics::Camera::FRUSTUM_ALL_PLANES_MASK;
+		uint32_t lastRejectingPlane = 0;
+		size_t planeTestsCount = 0;
+
+		if (camera.ClassifyBoundingSphere(object->GetBoundingSphere(), planeMask, planeTestsCount) != Graphics::FrustumIntersection::FRUSTUM_OUTSIDE)
+			sphereAccepted++;
+
+		planeMask = Graphics::Camera::FRUSTUM_ALL_PLANES_MASK;
+
+		if (camera.ClassifyBoundingBox(object->GetBoundingBox(), planeMask, lastRejectingPlane, planeTestsCount) !=
+			Graphics::FrustumIntersection::FRUSTUM_OUTSIDE)
+			boxAccepted++;
+
+		planeMask = Graphics::Camera::FRUSTUM_ALL_PLANES_MASK;
+
+		if (camera.ClassifyOrientedBoundingBox(object->GetOrientedBoundingBox(), planeMask, planeTestsCount) !=
+			Graphics::FrustumIntersection::FRUSTUM_OUTSIDE)
+			orientedBoxAccepted++;
+	}
+
+	{
+		BenchmarkTimer timer;
+
+		for (auto& object : objects)
+		{
+			uint32_t lastRejectingPlane = 0;
+
+			if (Graphics::ISpatialIndex::IsObjectVisible(camera, object.get(), Graphics::Camera::FRUSTUM_ALL_PLANES_MASK, lastRejectingPlane,
+				cullingStatistics))
+				cascadeAccepted++;
+		}
+
+		cascadeTime = timer.GetElapsedSeconds();
+	}
+
+	CHECK(cascadeAccepted <= boxAccepted && cascadeAccepted <= sphereAccepted);
+
+	// The cascade is the tightest test available, objects the single-volume tests accept on top of it are counted as false positives
+	PrintBenchmarkResult("Sphere only false positives", 100.0 * (sphereAccepted - cascadeAccepted) / sphereAccepted, "%");
+	PrintBenchmarkResult("AABB only false positives", 100.0 * (boxAccepted - cascadeAccepted) / boxAccepted, "%");
+	PrintBenchmarkResult("OBB only false positives", 100.0 * (orientedBoxAccepted - cascadeAccepted) / orientedBoxAccepted, "%");
+	PrintBenchmarkResult("Cascade sphere rejections", static_cast<double>(cullingStatistics.sphereRejections), "objects");
+	PrintBenchmarkResult("Cascade AABB rejections", static_cast<double>(cullingStatistics.boxRejections), "objects");
+	PrintBenchmarkResult("Cascade OBB rejections", static_cast<double>(cullingStatistics.orientedBoxRejections), "objects");
+	PrintBenchmarkResult("Cascade throughput", OBJECTS_COUNT / cascadeTime / 1e6, "Mobjects/s");
+}
+
+BENCHMARK_CASE(BoundingBoxTransformThroughput)
+{
+	const size_t OBJECTS_COUNT = 100000;
+	const size_t FRAMES_COUNT = 20;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 9, objects);
+
+	std::vector<Graphics::BoundingBox> cornerBoundingBoxes(OBJECTS_COUNT);
+	double cornerTime, batchedTime;
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+			for (size_t objectId = 0; objectId < OBJECTS_COUNT; objectId++)
+				cornerBoundingBoxes[objectId] = TransformBoundingBoxCorners(objects[objectId]->GetLocalBoundingBox(), objects[objectId]->GetWorldMatrix());
+
+		cornerTime = timer.GetElapsedSeconds();
+	}
+
+	Graphics::BoundingBoxTransformer boundingBoxTransformer;
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+			UpdateObjectsWorldBounds(objects, boundingBoxTransformer);
+
+		batchedTime = timer.GetElapsedSeconds();
+	}
+
+	auto isPointNear = [](const float3& firstPoint, const float3& secondPoint)
+	{
+		return std::abs(firstPoint.x - secondPoint.x) < 1e-3f && std::abs(firstPoint.y - secondPoint.y) < 1e-3f && std::abs(firstPoint.z - secondPoint.z) < 1e-3f;
+	};
+
+	for (size_t objectId = 0; objectId < OBJECTS_COUNT; objectId++)
+	{
+		CHECK(isPointNear(objects[objectId]->GetBoundingBox().minCornerPoint, cornerBoundingBoxes[objectId].minCornerPoint));
+		CHECK(isPointNear(objects[objectId]->GetBoundingBox().maxCornerPoint, cornerBoundingBoxes[objectId].maxCornerPoint));
+	}
+
+	// The batched figure includes loading the matrices and writing the bounds back to the objects, as Scene does for dirty objects
+	PrintBenchmarkResult("AABB transform by corners", FRAMES_COUNT * OBJECTS_COUNT / cornerTime / 1e6, "Mboxes/s");
+	PrintBenchmarkResult("AABB transform batched", FRAMES_COUNT * OBJECTS_COUNT / batchedTime / 1e6, "Mboxes/s");
+	PrintBenchmarkResult("AABB transform kernel", boundingBoxTransformer.GetTransformStatistics().boundingBoxesTransformed /
+		(1e3 * boundingBoxTransformer.GetTransformStatistics().transformTime), "Mboxes/s");
+}
+
+BENCHMARK_CASE(PotentiallyVisibleSetReduction)
+{
+	const size_t OBJECTS_COUNT = 5000;
+	const size_t CAMERAS_COUNT = 16;
+	const float WALL_HALF_HEIGHT = 50.0f;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+	BenchmarkObjectPool objects;
+	CreateObjectsField(&renderable, OBJECTS_COUNT, FIELD_HALF_EXTENT, 17, objects);
+
+	// Cameras circle between the walls, inside the volume the static objects span
+	std::vector<std::unique_ptr<Graphics::Camera>> cameras;
+	CreateOrbitCameras(CAMERAS_COUNT, 0.5f * FIELD_HALF_EXTENT, cameras);
+
+	const uint32_t cellsPerAxisSteps[] = { 2, 4 };
+
+	for (uint32_t cellsPerAxis : cellsPerAxisSteps)
+	{
+		Graphics::Scene scene;
+
+		// A cross of walls through the field center splits it into four rooms
+		const float3 wallsVertices[] = {
+			{ -FIELD_HALF_EXTENT, -WALL_HALF_HEIGHT, 0.0f }, { -FIELD_HALF_EXTENT, WALL_HALF_HEIGHT, 0.0f }, { FIELD_HALF_EXTENT, WALL_HALF_HEIGHT, 0.0f },
+			{ FIELD_HALF_EXTENT, -WALL_HALF_HEIGHT, 0.0f },
+			{ 0.0f, -WALL_HALF_HEIGHT, -FIELD_HALF_EXTENT }, { 0.0f, WALL_HALF_HEIGHT, -FIELD_HALF_EXTENT }, { 0.0f, WALL_HALF_HEIGHT, FIELD_HALF_EXTENT },
+			{ 0.0f, -WALL_HALF_HEIGHT, FIELD_HALF_EXTENT } };
+		const uint32_t wallsIndices[] = { 0, 1, 2, 0, 2, 3, 0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 4, 6, 5, 4, 7, 6 };
+
+		scene.GetOcclusionCuller()->AddOccluder(wallsVertices, sizeof(wallsVertices), Graphics::VertexFormat::POSITION, wallsIndices, sizeof(wallsIndices));
+
+		for (auto& object : objects)
+			scene.EmplaceGraphicObject(object.get(), false);
+
+		scene.BakePotentiallyVisibleSet(cellsPerAxis, 0.1f, FIELD_HALF_EXTENT);
+
+		const Graphics::PotentiallyVisibleSetStatistics potentiallyVisibleSetStatistics = *scene.GetPotentiallyVisibleSetStatistics();
+
+		size_t prefilteredObjects = 0, setTestedObjects = 0, setVisibleObjects = 0;
+
+		for (auto& camera : cameras)
+		{
+			scene.SetMainCamera(camera.get());
+			scene.ExecuteScripts(nullptr, 0, 0);
+
+			prefilteredObjects += scene.GetCullingStatistics().objectsPrefiltered;
+			setTestedObjects += scene.GetCullingStatistics().objectsTested;
+			setVisibleObjects += scene.GetCullingStatistics().objectsVisible;
+		}
+
+		scene.ResetPotentiallyVisibleSet();
+
+		size_t fullVisibleObjects = 0;
+
+		for (auto& camera : cameras)
+		{
+			scene.SetMainCamera(camera.get());
+			scene.ExecuteScripts(nullptr, 0, 0);
+
+			fullVisibleObjects += scene.GetCullingStatistics().objectsVisible;
+		}
+
+		// The set only removes objects, it never adds one the frustum and the occluders would reject
+		CHECK(setVisibleObjects <= fullVisibleObjects);
+		CHECK(prefilteredObjects > 0);
+
+		// A baked static object that moves takes the set with it
+		float4x4 bakedWorldMatrix = objects.front()->GetWorldMatrix();
+
+		scene.BakePotentiallyVisibleSet(cellsPerAxis, 0.1f, FIELD_HALF_EXTENT);
+		scene.SetObjectWorldMatrix(objects.front().get(), XMMatrixTranslation(0.0f, 0.0f, 0.0f));
+
+		CHECK(scene.GetPotentiallyVisibleSetStatistics() == nullptr);
+
+		scene.SetObjectWorldMatrix(objects.front().get(), bakedWorldMatrix);
+
+		std::string cellsLabel = ", " + std::to_string(potentiallyVisibleSetStatistics.cellsCount) + " cells";
+
+		PrintBenchmarkResult("PVS bake" + cellsLabel, potentiallyVisibleSetStatistics.bakeTime, "ms");
+		PrintBenchmarkResult("PVS storage" + cellsLabel, potentiallyVisibleSetStatistics.storageSize / 1024.0, "KB");
+		PrintBenchmarkResult("PVS objects per cell" + cellsLabel, 100.0 * potentiallyVisibleSetStatistics.averageVisibleObjects / OBJECTS_COUNT, "% of static objects");
+		PrintBenchmarkResult("PVS prefiltered" + cellsLabel, 100.0 * prefilteredObjects / (CAMERAS_COUNT * OBJECTS_COUNT), "% of static objects");
+		PrintBenchmarkResult("Objects frustum tested with PVS" + cellsLabel, static_cast<double>(setTestedObjects) / CAMERAS_COUNT, "objects/view");
+		PrintBenchmarkResult("Objects visible with PVS" + cellsLabel, static_cast<double>(setVisibleObjects) / CAMERAS_COUNT, "objects/view");
+		PrintBenchmarkResult("Objects visible without PVS" + cellsLabel, static_cast<double>(fullVisibleObjects) / CAMERAS_COUNT, "objects/view");
+	}
+}
+
+BENCHMARK_CASE(BroadphaseScaling)
+{
+	const size_t FRAMES_COUNT = 5;
+	const size_t MAX_BRUTE_FORCE_OBJECTS_COUNT = 10000;
+	const float STEP_LENGTH = 0.5f;
+
+	BenchmarkRenderable renderable(UNIT_BOUNDING_BOX);
+
+	for (size_t objectsCount = 1000; objectsCount <= 100000; objectsCount *= 10)
+	{
+		// The field grows with the object count, so the density and the overlaps per object stay the same
+		float fieldHalfExtent = 20.0f * std::cbrt(objectsCount / 1000.0f);
+
+		BenchmarkObjectPool objects;
+		CreateObjectsField(&renderable, objectsCount, fieldHalfExtent, 10, objects);
+
+		Graphics::Octree octree(OCTREE_DEPTH, OCTREE_BOUNDING_BOX);
+		Graphics::SweepAndPrune sweepAndPrune;
+
+		for (auto& object : objects)
+		{
+			octree.AddObject(object.get(), true);
+			sweepAndPrune.AddObject(object.get());
+		}
+
+		auto objectPointers = GetObjectPointers(objects);
+
+		Graphics::BoundingBoxTransformer boundingBoxTransformer;
+		std::vector<Graphics::ObjectPair> overlappingPairs;
+		std::vector<const Graphics::GraphicObject*> queryResults;
+
+		std::mt19937 generator(11);
+		std::uniform_real_distribution<float> stepDistribution(-STEP_LENGTH, STEP_LENGTH);
+
+		double sweepAndPruneTime = 0.0, bruteForceTime = 0.0, octreeTime = 0.0;
+		size_t sweepAndPrunePairsCount = 0, bruteForcePairsCount = 0, octreePairsCount = 0;
+
+		bool isBruteForceRun = objectsCount <= MAX_BRUTE_FORCE_OBJECTS_COUNT;
+
+		for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+		{
+			for (auto& object : objects)
+			{
+				float4x4 worldMatrix = object->GetWorldMatrix();
+				worldMatrix.r[3] = XMVectorAdd(worldMatrix.r[3], XMVectorSet(stepDistribution(generator), stepDistribution(generator),
+					stepDistribution(generator), 0.0f));
+
+				object->SetWorldMatrix(worldMatrix);
+			}
+
+			UpdateObjectsWorldBounds(objects, boundingBoxTransformer);
+			octree.UpdateObjects(objectPointers);
+
+			// Update keeps the entries sorted from the previous frame, so its cost is part of the incremental sweep
+			sweepAndPrune.Update();
+			sweepAndPrune.FindOverlappingPairs(overlappingPairs);
+
+			const auto& broadphaseStatistics = sweepAndPrune.GetBroadphaseStatistics();
+
+			sweepAndPruneTime += broadphaseStatistics.sortTime + broadphaseStatistics.sweepTime;
+			sweepAndPrunePairsCount += overlappingPairs.size();
+
+			if (isBruteForceRun)
+			{
+				BenchmarkTimer timer;
+				FindOverlappingPairsBruteForce(objectPointers, overlappingPairs);
+				bruteForceTime += 1e3 * timer.GetElapsedSeconds();
+
+				bruteForcePairsCount += overlappingPairs.size();
+			}
+
+			{
+				BenchmarkTimer timer;
+				FindOverlappingPairsWithOctree(objectPointers, octree, queryResults, overlappingPairs);
+				octreeTime += 1e3 * timer.GetElapsedSeconds();
+
+				octreePairsCount += overlappingPairs.size();
+			}
+		}
+
+		CHECK(sweepAndPrunePairsCount == octreePairsCount);
+		CHECK(!isBruteForceRun || sweepAndPrunePairsCount == bruteForcePairsCount);
+
+		std::string objectsCountLabel = std::to_string(objectsCount) + " boxes";
+
+		PrintBenchmarkResult("Sweep and prune " + objectsCountLabel, sweepAndPruneTime / FRAMES_COUNT, "ms/frame");
+
+		if (isBruteForceRun)
+			PrintBenchmarkResult("Brute force " + objectsCountLabel, bruteForceTime / FRAMES_COUNT, "ms/frame");
+
+		PrintBenchmarkResult("Octree pairs " + objectsCountLabel, octreeTime / FRAMES_COUNT, "ms/frame");
+		PrintBenchmarkResult("Overlapping pairs " + objectsCountLabel, static_cast<double>(sweepAndPrunePairsCount) / FRAMES_COUNT, "pairs/frame");
+	}
+}
+
+BENCHMARK_CASE(TriangleHierarchyQueries)
+{
+	const uint32_t CELLS_PER_AXIS = 128;
+	const float CELL_SIZE = 1.0f;
+	const size_t QUERIES_COUNT = 2000;
+
+	std::vector<float3> positions;
+	std::vector<uint32_t> indices;
+	CreateHeightField(CELLS_PER_AXIS, CELL_SIZE, positions, indices);
+
+	Graphics::TriangleHierarchy triangleHierarchy;
+	double buildTime;
+
+	{
+		BenchmarkTimer timer;
+		triangleHierarchy.Build(positions.data(), positions.size(), sizeof(float3), indices.data(), indices.size());
+		buildTime = timer.GetElapsedSeconds();
+	}
+
+	const float fieldSize = CELLS_PER_AXIS * CELL_SIZE;
+
+	std::mt19937 generator(16);
+	std::uniform_real_distribution<float> coordinateDistribution(-0.1f * fieldSize, 1.1f * fieldSize);
+
+	std::vector<float3> rayOrigins(QUERIES_COUNT), rayDirections(QUERIES_COUNT);
+	std::vector<float2> points(QUERIES_COUNT);
+
+	// Rays from above the field towards random points around it, some of them miss it
+	for (size_t queryId = 0; queryId < QUERIES_COUNT; queryId++)
+	{
+		rayOrigins[queryId] = { coordinateDistribution(generator), coordinateDistribution(generator), 50.0f };
+		rayDirections[queryId] = { coordinateDistribution(generator) - rayOrigins[queryId].x, coordinateDistribution(generator) - rayOrigins[queryId].y, -50.0f };
+		points[queryId] = { coordinateDistribution(generator), coordinateDistribution(generator) };
+	}
+
+	std::vector<float> hierarchyDistances(QUERIES_COUNT, -1.0f), linearDistances(QUERIES_COUNT, -1.0f);
+	std::vector<bool> hierarchyContains(QUERIES_COUNT), linearContains(QUERIES_COUNT);
+	double hierarchyRaycastTime, linearRaycastTime, hierarchyPointTime, linearPointTime;
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t queryId = 0; queryId < QUERIES_COUNT; queryId++)
+		{
+			Graphics::TriangleHit hit;
+
+			if (triangleHierarchy.RaycastNearest(rayOrigins[queryId], rayDirections[queryId], FLT_MAX, hit))
+				hierarchyDistances[queryId] = hit.distance;
+		}
+
+		hierarchyRaycastTime = timer.GetElapsedSeconds();
+	}
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t queryId = 0; queryId < QUERIES_COUNT; queryId++)
+			RaycastTrianglesLinear(positions, indices, rayOrigins[queryId], rayDirections[queryId], FLT_MAX, linearDistances[queryId]);
+
+		linearRaycastTime = timer.GetElapsedSeconds();
+	}
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t queryId = 0; queryId < QUERIES_COUNT; queryId++)
+			hierarchyContains[queryId] = triangleHierarchy.ContainsPoint(points[queryId]);
+
+		hierarchyPointTime = timer.GetElapsedSeconds();
+	}
+
+	{
+		BenchmarkTimer timer;
+
+		for (size_t queryId = 0; queryId < QUERIES_COUNT; queryId++)
+			linearContains[queryId] = ContainsPointLinear(positions, indices, points[queryId]);
+
+		linearPointTime = timer.GetElapsedSeconds();
+	}
+
+	for (size_t queryId = 0; queryId < QUERIES_COUNT; queryId++)
+	{
+		CHECK(std::abs(hierarchyDistances[queryId] - linearDistances[queryId]) < 1e-3f);
+		CHECK(hierarchyContains[queryId] == linearContains[queryId]);
+	}
+
+	const auto& queryStatistics = triangleHierarchy.GetQueryStatistics();
+
+	PrintBenchmarkResult("Triangle hierarchy build, " + std::to_string(indices.size() / 3) + " triangles", 1e3 * buildTime, "ms");
+	PrintBenchmarkResult("Triangle hierarchy raycast", 1e6 * hierarchyRaycastTime / QUERIES_COUNT, "us/query");
+	PrintBenchmarkResult("Linear raycast", 1e6 * linearRaycastTime / QUERIES_COUNT, "us/query");
+	PrintBenchmarkResult("Triangle hierarchy point query", 1e6 * hierarchyPointTime / QUERIES_COUNT, "us/query");
+	PrintBenchmarkResult("Linear point query", 1e6 * linearPointTime / QUERIES_COUNT, "us/query");
+	PrintBenchmarkResult("Triangles tested by the hierarchy", static_cast<double>(queryStatistics.trianglesTested) / queryStatistics.queries, "triangles/query");
+}
+
+BENCHMARK_CASE(CameraUpdateCost)
+{
+	const size_t CAMERAS_COUNT = 1000;
+	const size_t FRAMES_COUNT = 100;
+
+	std::vector<std::unique_ptr<Graphics::Camera>> cameras;
+	CreateOrbitCameras(CAMERAS_COUNT, CAMERA_ORBIT_RADIUS, cameras);
+
+	// Shadow and probe cameras mostly stay still, so the first run moves one camera in ten per frame and the second moves every camera
+	const size_t movedCamerasSteps[] = { 10, 1 };
+
+	for (size_t movedCamerasStep : movedCamerasSteps)
+	{
+		for (auto& camera : cameras)
+			camera->ResetCameraStatistics();
+
+		BenchmarkTimer timer;
+
+		for (size_t frameId = 0; frameId < FRAMES_COUNT; frameId++)
+			for (size_t cameraId = 0; cameraId < CAMERAS_COUNT; cameraId++)
+			{
+				if ((cameraId + frameId) % movedCamerasStep == 0)
+					cameras[cameraId]->MoveRelative({ 0.0f, 0.0f, 0.1f });
+
+				cameras[cameraId]->Update();
+			}
+
+		double updateTime = timer.GetElapsedSeconds();
+
+		size_t updatesRequested = 0;
+		size_t updatesSkipped = 0;
+
+		for (auto& camera : cameras)
+		{
+			updatesRequested += camera->GetCameraStatistics().updatesRequested;
+			updatesSkipped += camera->GetCameraStatistics().updatesSkipped;
+		}
+
+		CHECK(updatesRequested == CAMERAS_COUNT * FRAMES_COUNT);
+
+		std::string movedCamerasLabel = "1/" + std::to_string(movedCamerasStep) + " cameras moving";
+
+		PrintBenchmarkResult("Camera updates, " + movedCamerasLabel, 1e3 * updateTime / FRAMES_COUNT, "ms/frame");
+		PrintBenchmarkResult("Camera updates skipped, " + movedCamerasLabel, 100.0 * updatesSkipped / updatesRequested, "%");
+	}
+}
@@ -0,0 +1,125 @@
+#include "TestDevice.h"
+#include "Scene.h"
+
+// Batches are built on the CPU, only the instance buffer they fill needs the device. Nothing is drawn, so the materials are never composed.
+
+namespace
+{
+	class InstanceableRenderable final : public Graphics::IRenderable
+	{
+	public:
+		InstanceableRenderable(bool _supportsInstancing)
+			: boundingBox{ { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } }, supportsInstancing(_supportsInstancing)
+		{
+
+		}
+
+		const Graphics::BoundingBox& GetBoundingBox() const noexcept override
+		{
+			return boundingBox;
+		}
+
+		void Update(ID3D12GraphicsCommandList* commandList) const override
+		{
+
+		}
+
+		void Draw(ID3D12GraphicsCommandList* commandList, const Graphics::Material* material) const override
+		{
+
+		}
+
+		bool SupportsInstancing() const noexcept override
+		{
+			return supportsInstancing;
+		}
+
+	private:
+		Graphics::BoundingBox boundingBox;
+		bool supportsInstancing;
+	};
+
+	// A row of objects in front of the camera, every one of them visible
+	void CreateObjectsRow(const Graphics::IRenderable* renderable, const Graphics::Material* material, size_t objectsCount,
+		std::vector<std::unique_ptr<Graphics::GraphicObject>>& objects)
+	{
+		for (size_t objectId = 0; objectId < objectsCount; objectId++)
+		{
+			objects.push_back(std::make_unique<Graphics::GraphicObject>());
+			objects.back()->AssignRenderableEntity(renderable);
+			objects.back()->AssignMaterial(material);
+			objects.back()->SetWorldMatrix(XMMatrixTranslation(3.0f * objectId - 1.5f * objectsCount, 0.0f, 0.0f));
+		}
+	}
+
+	const Graphics::DrawStatistics& BuildSceneDrawBatches(const std::vector<std::unique_ptr<Graphics::GraphicObject>>& objects, Graphics::Camera& camera,
+		Graphics::Scene& scene)
+	{
+		camera.Move({ 0.0f, 0.0f, -400.0f });
+		camera.LookAt({ 0.0f, 0.0f, 0.0f });
+		camera.Update();
+
+		for (auto& object : objects)
+			scene.EmplaceGraphicObject(object.get(), false);
+
+		scene.SetMainCamera(&camera);
+		scene.ExecuteScripts(nullptr, 0, 0);
+
+		return scene.GetDrawStatistics();
+	}
+}
+
+TEST_CASE(SceneBatchesIdenticalInstancedObjects)
+{
+	const size_t OBJECTS_COUNT = 64;
+
+	Graphics::Tests::GetInitializedResourceManager();
+
+	InstanceableRenderable renderable(true);
+	Graphics::Material instancedMaterial;
+	instancedMaterial.SetInstancing(true);
+
+	std::vector<std::unique_ptr<Graphics::GraphicObject>> objects;
+	CreateObjectsRow(&renderable, &instancedMaterial, OBJECTS_COUNT, objects);
+
+	Graphics::Camera camera(XM_PIDIV4, 1.0f, 0.1f, 1000.0f);
+	Graphics::Scene scene;
+	const Graphics::DrawStatistics& drawStatistics = BuildSceneDrawBatches(objects, camera, scene);
+
+	CHECK(scene.GetCullingStatistics().objectsVisible == OBJECTS_COUNT);
+	CHECK(drawStatistics.drawCalls == 1);
+	CHECK(drawStatistics.instancedBatches == 1);
+	CHECK(drawStatistics.instancedObjects == OBJECTS_COUNT);
+}
+
+TEST_CASE(SceneSplitsBatchesByMaterialAndInstancingSupport)
+{
+	const size_t OBJECTS_COUNT = 16;
+
+	Graphics::Tests::GetInitializedResourceManager();
+
+	InstanceableRenderable renderable(true);
+	InstanceableRenderable plainRenderable(false);
+	Graphics::Material firstMaterial, secondMaterial, loneMaterial, plainMaterial;
+	firstMaterial.SetInstancing(true);
+	secondMaterial.SetInstancing(true);
+	loneMaterial.SetInstancing(true);
+
+	std::vector<std::unique_ptr<Graphics::GraphicObject>> objects;
+	CreateObjectsRow(&renderable, &firstMaterial, OBJECTS_COUNT, objects);
+	CreateObjectsRow(&renderable, &secondMaterial, OBJECTS_COUNT, objects);
+	// Neither of these can be instanced, each one is a draw call of its own
+	CreateObjectsRow(&renderable, &plainMaterial, OBJECTS_COUNT, objects);
+	CreateObjectsRow(&plainRenderable, &firstMaterial, OBJECTS_COUNT, objects);
+	// A lone object of an instancing material still goes through the instance stream its pipeline expects
+	CreateObjectsRow(&renderable, &loneMaterial, 1, objects);
+
+	Graphics::Camera camera(XM_PIDIV4, 1.0f, 0.1f, 1000.0f);
+	Graphics::Scene scene;
+	const Graphics::DrawStatistics& drawStatistics = BuildSceneDrawBatches(objects, camera, scene);
+
+	CHECK(scene.GetCullingStatistics().objectsVisible == objects.size());
+	CHECK(drawStatistics.instancedBatches == 3);
+	CHECK(drawStatistics.instancedObjects == 2 * OBJECTS_COUNT + 1);
+	CHECK(drawStatistics.drawCalls == 3 + 2 * OBJECTS_COUNT);
+}
@@ -0,0 +1,114 @@
+#include "TestFramework.h"
+#include "SegregatedFitAllocator.h"
+
+#include <random>
+
+TEST_CASE(SegregatedFitAllocatorMergesFreedNeighbours)
+{
+	Graphics::SegregatedFitAllocator allocator(64 * 1024, 256);
+
+	Graphics::SegregatedFitAllocation allocations[3];
+
+	for (auto& allocation : allocations)
+		allocator.Allocate(1000, 0, allocation);
+
+	CHECK(allocations[0].size == 1024);
+	CHECK(allocations[1].offset == allocations[0].offset + allocations[0].size);
+	CHECK(allocator.GetUsedSize() == 3 * 1024);
+
+	allocator.Deallocate(allocations[0]);
+	allocator.Deallocate(allocations[2]);
+	allocator.Deallocate(allocations[1]);
+
+	CHECK(allocator.IsEmpty());
+	CHECK(allocator.GetUsedSize() == 0);
+	CHECK(allocator.GetLargestFreeBlockSize() == allocator.GetCapacity());
+	CHECK(allocator.GetStatistics().freeBlocksCount == 1);
+}
+
+TEST_CASE(SegregatedFitAllocatorRespectsAlignment)
+{
+	Graphics::SegregatedFitAllocator allocator(1024 * 1024, 256);
+
+	Graphics::SegregatedFitAllocation smallAllocation, alignedAllocation;
+	allocator.Allocate(256, 0, smallAllocation);
+	allocator.Allocate(4096, 65536, alignedAllocation);
+
+	CHECK(alignedAllocation.offset % 65536 == 0);
+	CHECK(alignedAllocation.offset >= smallAllocation.offset + smallAllocation.size);
+
+	CHECK_THROWS(allocator.Allocate(256, 3, alignedAllocation));
+	CHECK(!allocator.CanAllocate(256, 3));
+}
+
+TEST_CASE(SegregatedFitAllocatorRejectsExhaustion)
+{
+	Graphics::SegregatedFitAllocator allocator(4096, 256);
+
+	Graphics::SegregatedFitAllocation allocation;
+	allocator.Allocate(4096, 0, allocation);
+
+	CHECK(!allocator.CanAllocate(256, 0));
+	CHECK_THROWS(allocator.Allocate(256, 0, allocation));
+	CHECK_THROWS(Graphics::SegregatedFitAllocator(4096, 100));
+	CHECK_THROWS(Graphics::SegregatedFitAllocator(1000, 256));
+
+	allocator.Reset();
+
+	CHECK(allocator.IsEmpty());
+	CHECK(allocator.CanAllocate(4096, 0));
+}
+
+TEST_CASE(SegregatedFitAllocatorSurvivesChurn)
+{
+	const uint64_t capacity = 16 * 1024 * 1024;
+
+	Graphics::SegregatedFitAllocator allocator(capacity, 256);
+
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<uint64_t> sizeDistribution(1, 256 * 1024);
+	std::vector<Graphics::SegregatedFitAllocation> allocations;
+
+	for (int iteration = 0; iteration < 20000; iteration++)
+	{
+		if (allocations.empty() || generator() % 3 != 0)
+		{
+			uint64_t size = sizeDistribution(generator);
+			uint64_t alignment = 256ull << (generator() % 4);
+
+			if (!allocator.CanAllocate(size, alignment))
+				continue;
+
+			Graphics::SegregatedFitAllocation allocation;
+			allocator.Allocate(size, alignment, allocation);
+
+			CHECK(allocation.offset % alignment == 0);
+			CHECK(allocation.size >= size);
+			CHECK(allocation.offset + allocation.size <= capacity);
+
+			allocations.push_back(allocation);
+		}
+		else
+		{
+			size_t allocationId = generator() % allocations.size();
+
+			allocator.Deallocate(allocations[allocationId]);
+
+			allocations[allocationId] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+
+	uint64_t usedSize = 0;
+
+	for (const auto& allocation : allocations)
+		usedSize += allocation.size;
+
+	CHECK(allocator.GetUsedSize() == usedSize);
+
+	for (const auto& allocation : allocations)
+		allocator.Deallocate(allocation);
+
+	CHECK(allocator.IsEmpty());
+	CHECK(allocator.GetLargestFreeBlockSize() == capacity);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "TestFramework.h"
+#include "GraphicsHelper.h"
+#include "ResourceManager.h"
+
+// Device for the tests that need one. It runs on the WARP adapter, so no GPU is required, and it is shared by every test file
+// because the allocators and the resource manager are process-wide singletons.
+
+namespace Graphics
+{
+	namespace Tests
+	{
+		inline ID3D12Device* GetWarpDevice()
+		{
+			static ComPtr<ID3D12Device> device;
+
+			if (device == nullptr)
+			{
+				ComPtr<IDXGIFactory4> factory;
+				CreateFactory(&factory);
+
+				ComPtr<IDXGIAdapter1> warpAdapter;
+				ThrowIfFailed(factory->EnumWarpAdapter(IID_PPV_ARGS(&warpAdapter)), "GetWarpDevice: WARP adapter enumerating failed!");
+
+				CreateDevice(warpAdapter.Get(), &device);
+			}
+
+			return device.Get();
+		}
+
+		inline ResourceManager& GetInitializedResourceManager()
+		{
+			static bool isInitialized = false;
+
+			if (!isInitialized)
+			{
+				ResourceManager::GetInstance().Initialize(GetWarpDevice());
+				isInitialized = true;
+			}
+
+			return ResourceManager::GetInstance();
+		}
+	}
+}
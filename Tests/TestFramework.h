@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Graphics
+{
+	namespace Tests
+	{
+		struct TestCase
+		{
+			const char* name;
+			void (*function)();
+			bool isBenchmark;
+		};
+
+		std::vector<TestCase>& GetTestCases();
+
+		class TestRegistrar
+		{
+		public:
+			TestRegistrar(const char* name, void (*function)(), bool isBenchmark)
+			{
+				GetTestCases().push_back({ name, function, isBenchmark });
+			}
+		};
+
+		class TestFailure : public std::runtime_error
+		{
+		public:
+			TestFailure(const char* file, int line, const char* expression)
+				: std::runtime_error(BuildMessage(file, line, expression))
+			{
+
+			}
+
+		private:
+			static std::string BuildMessage(const char* file, int line, const char* expression)
+			{
+				std::stringstream message;
+				message << file << "(" << line << "): " << expression;
+
+				return message.str();
+			}
+		};
+	}
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static Graphics::Tests::TestRegistrar name##Registrar(#name, name, false); \
+	static void name()
+
+#define BENCHMARK_CASE(name) \
+	static void name(); \
+	static Graphics::Tests::TestRegistrar name##Registrar(#name, name, true); \
+	static void name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) throw Graphics::Tests::TestFailure(__FILE__, __LINE__, #expression); } while (false)
+
+#define CHECK_THROWS(expression) \
+	do { bool isThrown = false; try { expression; } catch (const std::exception&) { isThrown = true; } \
+		if (!isThrown) throw Graphics::Tests::TestFailure(__FILE__, __LINE__, "expected exception: " #expression); } while (false)
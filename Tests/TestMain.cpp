@@ -0,0 +1,45 @@
+#include "TestFramework.h"
+
+#include <cstring>
+#include <iostream>
+
+std::vector<Graphics::Tests::TestCase>& Graphics::Tests::GetTestCases()
+{
+	static std::vector<TestCase> testCases;
+
+	return testCases;
+}
+
+// Runs every unit test, or every benchmark when started with --benchmark. The exit code is the number of failed cases.
+int main(int argc, char* argv[])
+{
+	bool isBenchmarkRun = argc > 1 && std::strcmp(argv[1], "--benchmark") == 0;
+
+	int failedCount = 0;
+	int runCount = 0;
+
+	for (const auto& testCase : Graphics::Tests::GetTestCases())
+	{
+		if (testCase.isBenchmark != isBenchmarkRun)
+			continue;
+
+		runCount++;
+
+		try
+		{
+			testCase.function();
+
+			std::cout << "[PASSED] " << testCase.name << std::endl;
+		}
+		catch (const std::exception& exception)
+		{
+			failedCount++;
+
+			std::cout << "[FAILED] " << testCase.name << ": " << exception.what() << std::endl;
+		}
+	}
+
+	std::cout << runCount - failedCount << "/" << runCount << " passed" << std::endl;
+
+	return failedCount;
+}
@@ -0,0 +1,82 @@
+#include "TestFramework.h"
+#include "TextureAliasingPlanner.h"
+
+TEST_CASE(TextureAliasingPlannerSharesDisjointLifetimes)
+{
+	Graphics::TextureAliasingPlanner planner;
+
+	auto firstResourceId = planner.AddResource(4096, 256, 0, 1);
+	auto secondResourceId = planner.AddResource(4096, 256, 2, 3);
+
+	planner.Plan();
+
+	CHECK(planner.GetOffset(firstResourceId) == planner.GetOffset(secondResourceId));
+	CHECK(planner.IsOverlapping(firstResourceId, secondResourceId));
+	CHECK(planner.GetHeapSize() == 4096);
+
+	const auto& report = planner.GetReport();
+	CHECK(report.resourcesCount == 2);
+	CHECK(report.aliasedResourcesCount == 2);
+	CHECK(report.unaliasedSize == 8192);
+	CHECK(report.peakLiveSize == 4096);
+	CHECK(report.aliasedSize == 4096);
+}
+
+TEST_CASE(TextureAliasingPlannerSeparatesOverlappingLifetimes)
+{
+	Graphics::TextureAliasingPlanner planner;
+
+	auto firstResourceId = planner.AddResource(4096, 256, 0, 2);
+	auto secondResourceId = planner.AddResource(2048, 256, 2, 3);
+	auto thirdResourceId = planner.AddResource(1024, 256, 1, 1);
+
+	planner.Plan();
+
+	CHECK(!planner.IsOverlapping(firstResourceId, secondResourceId));
+	CHECK(!planner.IsOverlapping(firstResourceId, thirdResourceId));
+	// The second and third lifetimes are disjoint, so the third one may reuse the second one's range
+	CHECK(planner.GetHeapSize() == 4096 + 2048);
+
+	const auto& report = planner.GetReport();
+	CHECK(report.unaliasedSize == 4096 + 2048 + 1024);
+	CHECK(report.peakLiveSize == 4096 + 2048);
+}
+
+TEST_CASE(TextureAliasingPlannerRespectsAlignment)
+{
+	Graphics::TextureAliasingPlanner planner;
+
+	auto firstResourceId = planner.AddResource(100, 64, 0, 0);
+	auto secondResourceId = planner.AddResource(10, 65536, 0, 0);
+	auto thirdResourceId = planner.AddResource(30, 256, 0, 0);
+
+	planner.Plan();
+
+	CHECK(planner.GetOffset(firstResourceId) % 64 == 0);
+	CHECK(planner.GetOffset(secondResourceId) % 65536 == 0);
+	CHECK(planner.GetOffset(thirdResourceId) % 256 == 0);
+	CHECK(!planner.IsOverlapping(firstResourceId, secondResourceId));
+	CHECK(!planner.IsOverlapping(firstResourceId, thirdResourceId));
+	CHECK(!planner.IsOverlapping(secondResourceId, thirdResourceId));
+	CHECK(planner.GetHeapAlignment() == 65536);
+	CHECK(planner.GetHeapSize() % 65536 == 0);
+
+	CHECK_THROWS(planner.AddResource(100, 48, 0, 0));
+	CHECK_THROWS(planner.AddResource(0, 64, 0, 0));
+}
+
+TEST_CASE(TextureAliasingPlannerReportsOnlyLiveResources)
+{
+	Graphics::TextureAliasingPlanner planner;
+
+	planner.AddResource(4096, 256, 0, 1);
+	planner.AddResource(8192, 256, 2, 1);
+
+	planner.Plan();
+
+	const auto& report = planner.GetReport();
+	CHECK(report.resourcesCount == 1);
+	CHECK(report.aliasedResourcesCount == 0);
+	CHECK(report.unaliasedSize == 4096);
+	CHECK(report.peakLiveSize == 4096);
+}
@@ -0,0 +1,107 @@
+#include "TestFramework.h"
+#include "UploadBatcher.h"
+
+namespace
+{
+	const Graphics::UploadTimingModel TIMING_MODEL = { 0.05f, 0.5f, 1024.0f * 1024.0f };
+}
+
+TEST_CASE(UploadBatcherRequiresFlushAtByteLimit)
+{
+	Graphics::UploadBatcher batcher(1, 1000, 100, TIMING_MODEL);
+
+	batcher.RecordUpload(600);
+	CHECK(!batcher.IsFlushRequired());
+
+	batcher.RecordUpload(399);
+	CHECK(!batcher.IsFlushRequired());
+
+	batcher.RecordUpload(1);
+	CHECK(batcher.IsFlushRequired());
+
+	batcher.Flush(false);
+
+	CHECK(!batcher.IsFlushRequired());
+	CHECK(!batcher.HasPendingUploads());
+}
+
+TEST_CASE(UploadBatcherRequiresFlushAtUploadsLimit)
+{
+	Graphics::UploadBatcher batcher(1, 1 << 20, 4, TIMING_MODEL);
+
+	for (size_t uploadId = 0; uploadId < 3; uploadId++)
+		batcher.RecordUpload(16);
+
+	CHECK(!batcher.IsFlushRequired());
+
+	batcher.RecordUpload(16);
+	CHECK(batcher.IsFlushRequired());
+}
+
+TEST_CASE(UploadBatcherCompletesTicketsByBatch)
+{
+	Graphics::UploadBatcher batcher(5, 1 << 20, 100, TIMING_MODEL);
+
+	Graphics::UploadTicket firstTicket = batcher.RecordUpload(64);
+	CHECK(firstTicket.batchId == 5);
+	CHECK(batcher.Flush(false) == 5);
+	CHECK(batcher.GetLastFlushedBatchId() == 5);
+
+	Graphics::UploadTicket secondTicket = batcher.RecordUpload(64);
+	CHECK(secondTicket.batchId == 6 && batcher.GetCurrentBatchId() == 6);
+
+	CHECK(!batcher.IsComplete(firstTicket, 4));
+	CHECK(batcher.IsComplete(firstTicket, 5));
+	// The batch is still open, no fence value can complete it before it is flushed
+	CHECK(!batcher.IsComplete(secondTicket, 6));
+	CHECK(!batcher.IsComplete(secondTicket, 100));
+
+	batcher.Flush(true);
+
+	CHECK(!batcher.IsComplete(secondTicket, 5));
+	CHECK(batcher.IsComplete(secondTicket, 6));
+}
+
+TEST_CASE(UploadBatcherCountsForcedFlushesAndWaits)
+{
+	Graphics::UploadBatcher batcher(1, 1 << 20, 100, TIMING_MODEL);
+
+	batcher.RecordUpload(64);
+	batcher.Flush(false);
+	batcher.RecordUpload(64);
+	batcher.Flush(true);
+	batcher.RegisterWait();
+
+	const Graphics::UploadBatchStatistics& statistics = batcher.GetStatistics();
+	CHECK(statistics.uploadsRecorded == 2);
+	CHECK(statistics.bytesRecorded == 128);
+	CHECK(statistics.batchesFlushed == 2);
+	CHECK(statistics.forcedFlushes == 1);
+	CHECK(statistics.cpuWaits == 1);
+
+	batcher.ResetStatistics();
+
+	CHECK(batcher.GetStatistics().batchesFlushed == 0 && batcher.GetStatistics().cpuWaits == 0);
+}
+
+TEST_CASE(UploadBatcherModelsBatchingGain)
+{
+	const size_t UPLOADS_COUNT = 64;
+
+	Graphics::UploadBatcher batcher(1, 1 << 20, 16, TIMING_MODEL);
+
+	for (size_t uploadId = 0; uploadId < UPLOADS_COUNT; uploadId++)
+	{
+		batcher.RecordUpload(4096);
+
+		if (batcher.IsFlushRequired())
+			batcher.Flush(false);
+	}
+
+	// One wait for the last batch, as a frame waiting on its uploads would do
+	batcher.RegisterWait();
+
+	const Graphics::UploadBatchStatistics& statistics = batcher.GetStatistics();
+	CHECK(statistics.batchesFlushed == UPLOADS_COUNT / 16);
+	CHECK(statistics.modeledBatchedTime < statistics.modeledUnbatchedTime);
+}
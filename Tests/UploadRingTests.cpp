@@ -0,0 +1,64 @@
+#include "TestFramework.h"
+#include "UploadRing.h"
+
+TEST_CASE(UploadRingRetiresFramesByFence)
+{
+	Graphics::UploadRing ring(1024);
+
+	uint64_t offset;
+	CHECK(ring.Allocate(300, 1, offset) && offset == 0);
+	ring.FinishFrame(1);
+	CHECK(ring.Allocate(300, 256, offset) && offset == 512);
+	ring.FinishFrame(2);
+
+	CHECK(ring.GetUsedSize() == 812);
+	CHECK(!ring.Allocate(300, 1, offset));
+
+	ring.ReleaseCompletedFrames(1);
+
+	CHECK(ring.GetUsedSize() == 512);
+	// The end of the range cannot hold it, the allocation wraps to the space freed by the first frame
+	CHECK(ring.Allocate(250, 1, offset) && offset == 0);
+	CHECK(ring.GetStatistics().framesRetired == 1);
+	CHECK(ring.GetStatistics().failedAllocationsCount == 1);
+}
+
+TEST_CASE(UploadRingRewindsWhenEmpty)
+{
+	Graphics::UploadRing ring(1024);
+
+	uint64_t offset;
+	CHECK(ring.Allocate(700, 1, offset));
+	ring.FinishFrame(1);
+	ring.ReleaseCompletedFrames(1);
+
+	CHECK(ring.GetUsedSize() == 0);
+	// Without the rewind the head would stay at 700 and the tail would leave only 700 bytes to wrap into
+	CHECK(ring.Allocate(1024, 1, offset) && offset == 0);
+	ring.FinishFrame(2);
+	ring.ReleaseCompletedFrames(2);
+
+	CHECK(ring.GetUsedSize() == 0);
+	CHECK(ring.Allocate(800, 1, offset) && offset == 0);
+}
+
+TEST_CASE(UploadRingIgnoresStaleEmptyFrames)
+{
+	Graphics::UploadRing ring(1024);
+
+	uint64_t offset;
+	CHECK(ring.Allocate(500, 1, offset));
+	ring.FinishFrame(1);
+	// Empty frame, tagged with the head of the previous one
+	ring.FinishFrame(3);
+	ring.ReleaseCompletedFrames(1);
+
+	CHECK(ring.Allocate(600, 1, offset) && offset == 0);
+	ring.FinishFrame(4);
+	ring.ReleaseCompletedFrames(3);
+
+	// The released empty frame must not move the tail into the live allocation
+	CHECK(ring.GetUsedSize() == 600);
+	CHECK(!ring.Allocate(500, 1, offset));
+	CHECK(ring.Allocate(400, 1, offset) && offset == 600);
+}
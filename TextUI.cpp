@@ -23,7 +23,6 @@ Graphics::TextUI::TextUI(ID3D12Device* device, int32_t relativePositionX, int32_
 	vertices.resize(STRING_LENGTH_MAX, {});
 
 	vertexBufferId = resourceManager.CreateDynamicVertexBuffer(vertices.data(), vertices.size() * sizeof(VertexData), sizeof(VertexData));
-	vertexBufferView = resourceManager.GetVertexBufferView(vertexBufferId);
 
 	letterHeight = pixelsPerHeight * 2.0f / static_cast<float>(GraphicsSettings::GetResolutionY());
 	letterSpacing = pixelsPerLetterSpacing * 2.0f / static_cast<float>(GraphicsSettings::GetResolutionX());
@@ -140,6 +139,8 @@ void Graphics::TextUI::Draw(ID3D12GraphicsCommandList* commandList) const
 {
 	if (material != nullptr && stringSize > 0)
 	{
+		D3D12_VERTEX_BUFFER_VIEW vertexBufferView = resourceManager.GetVertexBufferView(vertexBufferId);
+
 		commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
 		commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
 
@@ -34,7 +34,6 @@ namespace Graphics
 		VertexBufferId vertexBufferId;
 		ConstantBufferId localConstBufferId;
 
-		D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
 
 		struct LocalConstBuffer
 		{
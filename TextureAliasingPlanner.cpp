@@ -0,0 +1,214 @@
+#include "TextureAliasingPlanner.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+Graphics::TextureAliasingPlanner::TextureAliasingPlanner()
+	: heapSize(0), heapAlignment(1), isPlanned(false), report{}
+{
+
+}
+
+Graphics::TextureAliasingPlanner::~TextureAliasingPlanner()
+{
+	resources.clear();
+}
+
+size_t Graphics::TextureAliasingPlanner::AddResource(uint64_t size, uint64_t alignment, uint32_t firstPass, uint32_t lastPass)
+{
+	if (size == 0)
+		throw std::runtime_error("TextureAliasingPlanner::AddResource: Size must be non-zero");
+
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		throw std::runtime_error("TextureAliasingPlanner::AddResource: Alignment must be a power of two");
+
+	PlannedResource resource{};
+	resource.size = size;
+	resource.alignment = alignment;
+	resource.firstPass = firstPass;
+	resource.lastPass = lastPass;
+
+	resources.push_back(resource);
+
+	isPlanned = false;
+
+	return resources.size() - 1;
+}
+
+void Graphics::TextureAliasingPlanner::Plan()
+{
+	std::vector<size_t> placementOrder(resources.size());
+	std::iota(placementOrder.begin(), placementOrder.end(), 0);
+
+	// Largest resources go first, they leave the fewest unusable gaps for the smaller ones
+	std::stable_sort(placementOrder.begin(), placementOrder.end(),
+		[this](size_t firstResourceId, size_t secondResourceId) { return resources[firstResourceId].size > resources[secondResourceId].size; });
+
+	struct OccupiedRange
+	{
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	std::vector<size_t> placedResources;
+	std::vector<OccupiedRange> occupiedRanges;
+
+	heapSize = 0;
+	heapAlignment = 1;
+	report = {};
+
+	for (auto resourceId : placementOrder)
+	{
+		auto& resource = resources[resourceId];
+
+		occupiedRanges.clear();
+
+		for (auto placedResourceId : placedResources)
+		{
+			const auto& placedResource = resources[placedResourceId];
+
+			if (IsLifetimeIntersecting(resource, placedResource))
+				occupiedRanges.push_back({ placedResource.offset, placedResource.offset + placedResource.size });
+		}
+
+		std::sort(occupiedRanges.begin(), occupiedRanges.end(),
+			[](const OccupiedRange& firstRange, const OccupiedRange& secondRange) { return firstRange.begin < secondRange.begin; });
+
+		uint64_t offset = 0;
+
+		for (const auto& occupiedRange : occupiedRanges)
+		{
+			uint64_t alignedOffset = (offset + resource.alignment - 1) & ~(resource.alignment - 1);
+
+			if (alignedOffset + resource.size <= occupiedRange.begin)
+				break;
+
+			offset = (std::max)(offset, occupiedRange.end);
+		}
+
+		resource.offset = (offset + resource.alignment - 1) & ~(resource.alignment - 1);
+
+		placedResources.push_back(resourceId);
+
+		heapSize = (std::max)(heapSize, resource.offset + resource.size);
+		heapAlignment = (std::max)(heapAlignment, resource.alignment);
+
+		if (IsAlive(resource))
+		{
+			report.resourcesCount++;
+			report.unaliasedSize += resource.size;
+		}
+	}
+
+	isPlanned = true;
+
+	for (size_t resourceId = 0; resourceId < resources.size(); resourceId++)
+	{
+		if (!IsAlive(resources[resourceId]))
+			continue;
+
+		for (size_t otherResourceId = 0; otherResourceId < resources.size(); otherResourceId++)
+		{
+			if (resourceId != otherResourceId && IsAlive(resources[otherResourceId]) && IsOverlapping(resourceId, otherResourceId))
+			{
+				report.aliasedResourcesCount++;
+
+				break;
+			}
+		}
+	}
+
+	heapSize = (heapSize + heapAlignment - 1) & ~(heapAlignment - 1);
+
+	report.peakLiveSize = ComputePeakLiveSize();
+	report.aliasedSize = heapSize;
+}
+
+void Graphics::TextureAliasingPlanner::Reset()
+{
+	resources.clear();
+
+	heapSize = 0;
+	heapAlignment = 1;
+	isPlanned = false;
+	report = {};
+}
+
+uint64_t Graphics::TextureAliasingPlanner::GetOffset(size_t resourceId) const
+{
+	if (!isPlanned || resourceId >= resources.size())
+		throw std::runtime_error("TextureAliasingPlanner::GetOffset: Resource is not planned");
+
+	return resources[resourceId].offset;
+}
+
+uint64_t Graphics::TextureAliasingPlanner::GetHeapSize() const noexcept
+{
+	return heapSize;
+}
+
+uint64_t Graphics::TextureAliasingPlanner::GetHeapAlignment() const noexcept
+{
+	return heapAlignment;
+}
+
+bool Graphics::TextureAliasingPlanner::IsOverlapping(size_t firstResourceId, size_t secondResourceId) const
+{
+	if (!isPlanned || firstResourceId >= resources.size() || secondResourceId >= resources.size())
+		throw std::runtime_error("TextureAliasingPlanner::IsOverlapping: Resource is not planned");
+
+	const auto& firstResource = resources[firstResourceId];
+	const auto& secondResource = resources[secondResourceId];
+
+	return firstResource.offset < secondResource.offset + secondResource.size && secondResource.offset < firstResource.offset + firstResource.size;
+}
+
+const Graphics::TextureAliasingReport& Graphics::TextureAliasingPlanner::GetReport() const noexcept
+{
+	return report;
+}
+
+bool Graphics::TextureAliasingPlanner::IsAlive(const PlannedResource& resource) noexcept
+{
+	return resource.firstPass <= resource.lastPass;
+}
+
+bool Graphics::TextureAliasingPlanner::IsLifetimeIntersecting(const PlannedResource& firstResource, const PlannedResource& secondResource) noexcept
+{
+	if (!IsAlive(firstResource) || !IsAlive(secondResource))
+		return false;
+
+	return firstResource.firstPass <= secondResource.lastPass && secondResource.firstPass <= firstResource.lastPass;
+}
+
+uint64_t Graphics::TextureAliasingPlanner::ComputePeakLiveSize() const
+{
+	// Sweep over lifetime boundaries: a resource adds its size at its first pass and removes it right after its last one
+	std::vector<std::pair<uint64_t, int64_t>> events;
+	events.reserve(resources.size() * 2);
+
+	for (const auto& resource : resources)
+	{
+		if (!IsAlive(resource))
+			continue;
+
+		events.push_back({ resource.firstPass, static_cast<int64_t>(resource.size) });
+		events.push_back({ static_cast<uint64_t>(resource.lastPass) + 1, -static_cast<int64_t>(resource.size) });
+	}
+
+	// Releases sort before allocations at the same pass, so back-to-back lifetimes are not counted together
+	std::sort(events.begin(), events.end());
+
+	int64_t liveSize = 0;
+	int64_t peakLiveSize = 0;
+
+	for (const auto& event : events)
+	{
+		liveSize += event.second;
+		peakLiveSize = (std::max)(peakLiveSize, liveSize);
+	}
+
+	return static_cast<uint64_t>(peakLiveSize);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Graphics
+{
+	struct TextureAliasingReport
+	{
+		size_t resourcesCount;
+		size_t aliasedResourcesCount;
+		uint64_t unaliasedSize;
+		uint64_t peakLiveSize;
+		uint64_t aliasedSize;
+	};
+
+	// Assigns heap offsets to transient resources from their lifetimes, given as inclusive pass intervals. Resources whose intervals
+	// intersect never share memory, the rest may overlap. A resource with firstPass greater than lastPass is never alive in the planned
+	// chain and can overlap any other one, it is still placed but left out of the report. Only sizes and offsets are handled here,
+	// the heap itself is created by the caller.
+	class TextureAliasingPlanner
+	{
+	public:
+		TextureAliasingPlanner();
+		~TextureAliasingPlanner();
+
+		size_t AddResource(uint64_t size, uint64_t alignment, uint32_t firstPass, uint32_t lastPass);
+		void Plan();
+		void Reset();
+
+		uint64_t GetOffset(size_t resourceId) const;
+		uint64_t GetHeapSize() const noexcept;
+		uint64_t GetHeapAlignment() const noexcept;
+
+		bool IsOverlapping(size_t firstResourceId, size_t secondResourceId) const;
+
+		const TextureAliasingReport& GetReport() const noexcept;
+
+	private:
+		TextureAliasingPlanner(const TextureAliasingPlanner&) = delete;
+		TextureAliasingPlanner& operator=(const TextureAliasingPlanner&) = delete;
+
+		struct PlannedResource
+		{
+			uint64_t size;
+			uint64_t alignment;
+			uint64_t offset;
+			uint32_t firstPass;
+			uint32_t lastPass;
+		};
+
+		static bool IsAlive(const PlannedResource& resource) noexcept;
+		static bool IsLifetimeIntersecting(const PlannedResource& firstResource, const PlannedResource& secondResource) noexcept;
+
+		uint64_t ComputePeakLiveSize() const;
+
+		std::vector<PlannedResource> resources;
+
+		uint64_t heapSize;
+		uint64_t heapAlignment;
+
+		bool isPlanned;
+
+		TextureAliasingReport report;
+	};
+}
@@ -2,7 +2,7 @@
 
 Graphics::TextureAllocationPage::TextureAllocationPage(ID3D12Device* device, D3D12_HEAP_TYPE _heapType, D3D12_RESOURCE_FLAGS resourceFlags,
 	const D3D12_CLEAR_VALUE* clearValue, const TextureInfo& textureInfo)
-	: cpuAddress(nullptr), heapType(_heapType)
+	: cpuAddress(nullptr), pageSize(0), heapType(_heapType)
 {
 	D3D12_HEAP_PROPERTIES heapProperties;
 	SetupHeapProperties(heapProperties, heapType);
@@ -24,11 +24,13 @@ Graphics::TextureAllocationPage::TextureAllocationPage(ID3D12Device* device, D3D
 
 		SetupResourceBufferDesc(resourceDesc, requiredUploadBufferSize);
 		resourceState = D3D12_RESOURCE_STATE_GENERIC_READ;
+		pageSize = requiredUploadBufferSize;
 	}
 	else
 	{
 		SetupResourceTextureDesc(resourceDesc, textureInfo, resourceFlags);
 		resourceState = D3D12_RESOURCE_STATE_COMMON;
+		pageSize = device->GetResourceAllocationInfo(0, 1, &resourceDesc).SizeInBytes;
 	}
 
 	if (resourceFlags == D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET)
@@ -58,4 +60,12 @@ void Graphics::TextureAllocationPage::GetAllocation(TextureAllocation& allocatio
 {
 	allocation.cpuAddress = cpuAddress;
 	allocation.textureResource = pageResource.Get();
+	allocation.page = this;
+	allocation.heapPage = nullptr;
+	allocation.sizeInBytes = pageSize;
+}
+
+uint64_t Graphics::TextureAllocationPage::GetPageSize() const noexcept
+{
+	return pageSize;
 }
@@ -1,13 +1,21 @@
 #pragma once
 
 #include "GraphicsHelper.h"
+#include "SegregatedFitAllocator.h"
 
 namespace Graphics
 {
+	class TextureAllocationPage;
+	class TextureHeapPage;
+
 	struct TextureAllocation
 	{
 		uint8_t* cpuAddress;
 		ID3D12Resource* textureResource;
+		TextureAllocationPage* page;
+		TextureHeapPage* heapPage;
+		SegregatedFitAllocation subAllocation;
+		uint64_t sizeInBytes;
 	};
 
 	class TextureAllocationPage
@@ -19,8 +27,11 @@ namespace Graphics
 
 		void GetAllocation(TextureAllocation& allocation);
 
+		uint64_t GetPageSize() const noexcept;
+
 	private:
 		uint8_t* cpuAddress;
+		uint64_t pageSize;
 
 		D3D12_HEAP_TYPE heapType;
 
@@ -10,20 +10,244 @@ Graphics::TextureAllocator& Graphics::TextureAllocator::GetInstance()
 void Graphics::TextureAllocator::Allocate(ID3D12Device* device, D3D12_RESOURCE_FLAGS resourceFlags, const D3D12_CLEAR_VALUE* clearValue,
     const TextureInfo& textureInfo, TextureAllocation& allocation)
 {
-    pages.push_back(std::make_shared<TextureAllocationPage>(device, D3D12_HEAP_TYPE_DEFAULT, resourceFlags, clearValue, textureInfo));
+    D3D12_RESOURCE_DESC resourceDesc{};
+    SetupResourceTextureDesc(resourceDesc, textureInfo, resourceFlags);
 
-    pages[pages.size() - 1]->GetAllocation(allocation);
+    auto allocationInfo = device->GetResourceAllocationInfo(0, 1, &resourceDesc);
+
+    // Textures taking more than half a heap page would waste most of it, they keep their own committed resource
+    if (allocationInfo.SizeInBytes > HEAP_PAGE_SIZE / 2)
+    {
+        auto page = std::make_shared<TextureAllocationPage>(device, D3D12_HEAP_TYPE_DEFAULT, resourceFlags, clearValue, textureInfo);
+        page->GetAllocation(allocation);
+
+        {
+            std::lock_guard<std::mutex> lock(poolMutexes[COMMITTED_CATEGORY]);
+
+            pages.push_back(page);
+        }
+
+        counters.AddPage(COMMITTED_CATEGORY, allocation.sizeInBytes);
+        counters.AddAllocation(COMMITTED_CATEGORY, allocation.sizeInBytes);
+
+        return;
+    }
+
+    auto heapFlags = GetHeapFlags(resourceFlags);
+    auto category = heapFlags == D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES ? RENDER_TARGET_HEAP_CATEGORY : TEXTURE_HEAP_CATEGORY;
+    auto& heapPagePool = GetHeapPagePool(category);
+
+    std::lock_guard<std::mutex> lock(poolMutexes[category]);
+
+    auto heapPageIt = std::find_if(heapPagePool.begin(), heapPagePool.end(),
+        [&allocationInfo](const std::shared_ptr<TextureHeapPage>& heapPage) { return heapPage->HasSpace(allocationInfo.SizeInBytes, allocationInfo.Alignment); });
+
+    if (heapPageIt == heapPagePool.end())
+    {
+        heapPagePool.push_back(std::shared_ptr<TextureHeapPage>(new TextureHeapPage(device, heapFlags, HEAP_PAGE_SIZE)));
+        heapPageIt = std::prev(heapPagePool.end());
+
+        counters.AddPage(category, HEAP_PAGE_SIZE);
+    }
+
+    (*heapPageIt)->Allocate(device, resourceDesc, allocationInfo, GetInitialState(resourceFlags), clearValue, allocation);
+
+    allocation.sizeInBytes = allocationInfo.SizeInBytes;
+
+    counters.AddAllocation(category, allocation.sizeInBytes);
+}
+
+void Graphics::TextureAllocator::AllocateAliased(ID3D12Device* device, uint64_t heapSize, uint64_t heapAlignment, const std::vector<AliasedTextureRequest>& requests,
+    std::vector<TextureAllocation>& allocations)
+{
+    if (requests.empty())
+        throw std::exception("TextureAllocator::AllocateAliased: No textures requested");
+
+    auto heapFlags = GetHeapFlags(requests.front().resourceFlags);
+
+    for (const auto& request : requests)
+        if (GetHeapFlags(request.resourceFlags) != heapFlags)
+            throw std::exception("TextureAllocator::AllocateAliased: Textures of different heap categories can not alias");
+
+    // The heap is filled before it is published to the pool, nothing else can reach it in the meantime
+    std::shared_ptr<TextureHeapPage> heapPage(new TextureHeapPage(device, heapFlags, heapSize, heapAlignment, true));
+
+    counters.AddPage(ALIASING_HEAP_CATEGORY, heapSize);
+
+    allocations.resize(requests.size());
+
+    for (size_t requestId = 0; requestId < requests.size(); requestId++)
+    {
+        const auto& request = requests[requestId];
+
+        D3D12_RESOURCE_DESC resourceDesc{};
+        SetupResourceTextureDesc(resourceDesc, request.textureInfo, request.resourceFlags);
+
+        bool hasClearValue = (request.resourceFlags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0;
+
+        heapPage->AllocateAt(device, request.offset, resourceDesc, GetInitialState(request.resourceFlags), hasClearValue ? &request.clearValue : nullptr,
+            allocations[requestId]);
+
+        allocations[requestId].sizeInBytes = device->GetResourceAllocationInfo(0, 1, &resourceDesc).SizeInBytes;
+
+        counters.AddAllocation(ALIASING_HEAP_CATEGORY, allocations[requestId].sizeInBytes);
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutexes[ALIASING_HEAP_CATEGORY]);
+
+    aliasingHeapPages.push_back(heapPage);
+}
+
+void Graphics::TextureAllocator::Deallocate(TextureAllocation& allocation)
+{
+    if (allocation.heapPage != nullptr)
+    {
+        auto category = GetHeapCategory(allocation.heapPage);
+        auto& heapPagePool = GetHeapPagePool(category);
+
+        std::lock_guard<std::mutex> lock(poolMutexes[category]);
+
+        auto heapPageIt = std::find_if(heapPagePool.begin(), heapPagePool.end(),
+            [&allocation](const std::shared_ptr<TextureHeapPage>& heapPage) { return heapPage.get() == allocation.heapPage; });
+
+        if (heapPageIt == heapPagePool.end())
+            throw std::exception("TextureAllocator::Deallocate: Heap page is not found");
+
+        (*heapPageIt)->Deallocate(allocation);
+
+        counters.RemoveAllocation(category, allocation.sizeInBytes);
+
+        // One empty page per category stays around for the next texture, aliasing heaps are sized for their plan and go away with it
+        if ((*heapPageIt)->IsEmpty() && ((*heapPageIt)->IsAliasing() || heapPagePool.size() > 1))
+        {
+            counters.RemovePage(category, (*heapPageIt)->GetHeapSize());
+
+            heapPagePool.erase(heapPageIt);
+        }
+
+        allocation = {};
+
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutexes[COMMITTED_CATEGORY]);
+
+    auto pageIt = std::find_if(pages.begin(), pages.end(),
+        [&allocation](const std::shared_ptr<TextureAllocationPage>& page) { return page.get() == allocation.page; });
+
+    if (pageIt == pages.end())
+        throw std::exception("TextureAllocator::Deallocate: Invalid allocation");
+
+    counters.RemoveAllocation(COMMITTED_CATEGORY, (*pageIt)->GetPageSize());
+    counters.RemovePage(COMMITTED_CATEGORY, (*pageIt)->GetPageSize());
+
+    pages.erase(pageIt);
+
+    allocation = {};
 }
 
 void Graphics::TextureAllocator::AllocateTemporaryUpload(ID3D12Device* device, D3D12_RESOURCE_FLAGS resourceFlags, const TextureInfo& textureInfo,
     TextureAllocation& allocation)
 {
-    tempUploadPages.push_back(std::make_shared<TextureAllocationPage>(device, D3D12_HEAP_TYPE_UPLOAD, resourceFlags, nullptr, textureInfo));
+    auto tempUploadPage = std::make_shared<TextureAllocationPage>(device, D3D12_HEAP_TYPE_UPLOAD, resourceFlags, nullptr, textureInfo);
+    tempUploadPage->GetAllocation(allocation);
+
+    {
+        std::lock_guard<std::mutex> lock(poolMutexes[TEMPORARY_UPLOAD_CATEGORY]);
+
+        tempUploadPages.push_back(tempUploadPage);
+    }
+
+    counters.AddPage(TEMPORARY_UPLOAD_CATEGORY, allocation.sizeInBytes);
+    counters.AddAllocation(TEMPORARY_UPLOAD_CATEGORY, allocation.sizeInBytes);
+}
+
+D3D12_RESOURCE_ALLOCATION_INFO Graphics::TextureAllocator::GetAllocationInfo(ID3D12Device* device, D3D12_RESOURCE_FLAGS resourceFlags,
+    const TextureInfo& textureInfo) const
+{
+    D3D12_RESOURCE_DESC resourceDesc{};
+    SetupResourceTextureDesc(resourceDesc, textureInfo, resourceFlags);
 
-    tempUploadPages[tempUploadPages.size() - 1]->GetAllocation(allocation);
+    return device->GetResourceAllocationInfo(0, 1, &resourceDesc);
 }
 
 void Graphics::TextureAllocator::ReleaseTemporaryBuffers()
 {
+    std::lock_guard<std::mutex> lock(poolMutexes[TEMPORARY_UPLOAD_CATEGORY]);
+
+    for (const auto& page : tempUploadPages)
+    {
+        counters.RemoveAllocation(TEMPORARY_UPLOAD_CATEGORY, page->GetPageSize());
+        counters.RemovePage(TEMPORARY_UPLOAD_CATEGORY, page->GetPageSize());
+    }
+
     tempUploadPages.clear();
 }
+
+Graphics::AllocatorTelemetry Graphics::TextureAllocator::GetTelemetry() const
+{
+    AllocatorTelemetry telemetry;
+    counters.FillTelemetry("TextureAllocator", telemetry);
+
+    // Committed resources are exactly as large as their texture, only heaps can hold free space
+    for (auto [category, pagePool] : { std::pair<TelemetryCategory, const TextureAllocationPagePool*>{ COMMITTED_CATEGORY, &pages },
+        { TEMPORARY_UPLOAD_CATEGORY, &tempUploadPages } })
+    {
+        std::lock_guard<std::mutex> lock(poolMutexes[category]);
+
+        for (const auto& page : *pagePool)
+            AddPageUsage(telemetry.categories[category], page->GetPageSize(), 0);
+    }
+
+    for (auto [category, heapPagePool] : { std::pair<TelemetryCategory, const TextureHeapPagePool*>{ RENDER_TARGET_HEAP_CATEGORY, &renderTargetHeapPages },
+        { TEXTURE_HEAP_CATEGORY, &textureHeapPages }, { ALIASING_HEAP_CATEGORY, &aliasingHeapPages } })
+    {
+        std::lock_guard<std::mutex> lock(poolMutexes[category]);
+
+        for (const auto& heapPage : *heapPagePool)
+            AddPageUsage(telemetry.categories[category], heapPage->GetUsedSize(), heapPage->GetLargestFreeBlockSize());
+    }
+
+    FinalizeAllocatorTelemetry(telemetry);
+
+    return telemetry;
+}
+
+D3D12_HEAP_FLAGS Graphics::TextureAllocator::GetHeapFlags(D3D12_RESOURCE_FLAGS resourceFlags) noexcept
+{
+    if ((resourceFlags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0)
+        return D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+
+    return D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+}
+
+D3D12_RESOURCE_STATES Graphics::TextureAllocator::GetInitialState(D3D12_RESOURCE_FLAGS resourceFlags) noexcept
+{
+    if (resourceFlags == D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET)
+        return D3D12_RESOURCE_STATE_RENDER_TARGET;
+    else if (resourceFlags == D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
+        return D3D12_RESOURCE_STATE_DEPTH_WRITE;
+
+    return D3D12_RESOURCE_STATE_COMMON;
+}
+
+Graphics::TextureAllocator::TelemetryCategory Graphics::TextureAllocator::GetHeapCategory(const TextureHeapPage* heapPage) noexcept
+{
+    // Read from the page itself, so a deallocation only has to lock the pool it returns to
+    if (heapPage->IsAliasing())
+        return ALIASING_HEAP_CATEGORY;
+    else if (heapPage->GetHeapFlags() == D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES)
+        return RENDER_TARGET_HEAP_CATEGORY;
+
+    return TEXTURE_HEAP_CATEGORY;
+}
+
+Graphics::TextureAllocator::TextureHeapPagePool& Graphics::TextureAllocator::GetHeapPagePool(TelemetryCategory category) noexcept
+{
+    if (category == RENDER_TARGET_HEAP_CATEGORY)
+        return renderTargetHeapPages;
+    else if (category == TEXTURE_HEAP_CATEGORY)
+        return textureHeapPages;
+
+    return aliasingHeapPages;
+}
@@ -2,9 +2,21 @@
 
 #include "GraphicsHelper.h"
 #include "TextureAllocationPage.h"
+#include "TextureHeapPage.h"
+#include "AllocatorTelemetry.h"
 
 namespace Graphics
 {
+	struct AliasedTextureRequest
+	{
+		D3D12_RESOURCE_FLAGS resourceFlags;
+		D3D12_CLEAR_VALUE clearValue;
+		TextureInfo textureInfo;
+		uint64_t offset;
+	};
+
+	// Safe to call from several threads. Textures are large and few compared to buffers and views, so instead of thread caches every
+	// pool has its own lock and loaders only wait for each other while placing textures of the same category.
 	class TextureAllocator
 	{
 	public:
@@ -12,12 +24,19 @@ namespace Graphics
 
 		void Allocate(ID3D12Device* device, D3D12_RESOURCE_FLAGS resourceFlags, const D3D12_CLEAR_VALUE* clearValue, const TextureInfo& textureInfo,
 			TextureAllocation& allocation);
+		void AllocateAliased(ID3D12Device* device, uint64_t heapSize, uint64_t heapAlignment, const std::vector<AliasedTextureRequest>& requests,
+			std::vector<TextureAllocation>& allocations);
+		void Deallocate(TextureAllocation& allocation);
 		void AllocateTemporaryUpload(ID3D12Device* device, D3D12_RESOURCE_FLAGS resourceFlags, const TextureInfo& textureInfo, TextureAllocation& allocation);
 
+		D3D12_RESOURCE_ALLOCATION_INFO GetAllocationInfo(ID3D12Device* device, D3D12_RESOURCE_FLAGS resourceFlags, const TextureInfo& textureInfo) const;
+
 		void ReleaseTemporaryBuffers();
 
+		AllocatorTelemetry GetTelemetry() const;
+
 	private:
-		TextureAllocator() {};
+		TextureAllocator() : counters({ "Committed", "RenderTargetHeaps", "TextureHeaps", "AliasingHeaps", "TemporaryUpload" }) {};
 		~TextureAllocator() {};
 
 		TextureAllocator(const TextureAllocator&) = delete;
@@ -26,8 +45,36 @@ namespace Graphics
 		TextureAllocator& operator=(TextureAllocator&&) = delete;
 
 		using TextureAllocationPagePool = std::deque<std::shared_ptr<TextureAllocationPage>>;
+		using TextureHeapPagePool = std::deque<std::shared_ptr<TextureHeapPage>>;
+
+		static constexpr uint64_t HEAP_PAGE_SIZE = 64 * _MB;
+
+		enum TelemetryCategory : size_t
+		{
+			COMMITTED_CATEGORY,
+			RENDER_TARGET_HEAP_CATEGORY,
+			TEXTURE_HEAP_CATEGORY,
+			ALIASING_HEAP_CATEGORY,
+			TEMPORARY_UPLOAD_CATEGORY
+		};
+
+		static D3D12_HEAP_FLAGS GetHeapFlags(D3D12_RESOURCE_FLAGS resourceFlags) noexcept;
+		static D3D12_RESOURCE_STATES GetInitialState(D3D12_RESOURCE_FLAGS resourceFlags) noexcept;
+
+		static TelemetryCategory GetHeapCategory(const TextureHeapPage* heapPage) noexcept;
+		TextureHeapPagePool& GetHeapPagePool(TelemetryCategory category) noexcept;
 
 		TextureAllocationPagePool pages;
 		TextureAllocationPagePool tempUploadPages;
+
+		// Render targets and depth stencils need their own heaps on resource heap tier 1 hardware
+		TextureHeapPagePool renderTargetHeapPages;
+		TextureHeapPagePool textureHeapPages;
+		TextureHeapPagePool aliasingHeapPages;
+
+		// Indexed by telemetry category, each category owns exactly one pool
+		mutable std::array<std::mutex, TEMPORARY_UPLOAD_CATEGORY + 1> poolMutexes;
+
+		AllocatorCounters counters;
 	};
 }
@@ -0,0 +1,108 @@
+#include "TextureHeapPage.h"
+
+Graphics::TextureHeapPage::TextureHeapPage(ID3D12Device* device, D3D12_HEAP_FLAGS _heapFlags, uint64_t _heapSize, uint64_t heapAlignment, bool _isAliasing)
+	: heapFlags(_heapFlags), heapSize(_heapSize), isAliasing(_isAliasing), subAllocator(_heapSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+{
+	D3D12_HEAP_DESC heapDesc{};
+	heapDesc.SizeInBytes = heapSize;
+	heapDesc.Alignment = heapAlignment;
+	heapDesc.Flags = heapFlags;
+	SetupHeapProperties(heapDesc.Properties, D3D12_HEAP_TYPE_DEFAULT);
+
+	ThrowIfFailed(device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap)), "TextureHeapPage::TextureHeapPage: Heap creating error");
+}
+
+Graphics::TextureHeapPage::~TextureHeapPage()
+{
+	placedResources.clear();
+}
+
+void Graphics::TextureHeapPage::Allocate(ID3D12Device* device, const D3D12_RESOURCE_DESC& resourceDesc, const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo,
+	D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue, TextureAllocation& allocation)
+{
+	if (isAliasing || !HasSpace(allocationInfo.SizeInBytes, allocationInfo.Alignment))
+		throw std::exception("TextureHeapPage::Allocate: Bad allocation");
+
+	SegregatedFitAllocation subAllocation{};
+	subAllocator.Allocate(allocationInfo.SizeInBytes, allocationInfo.Alignment, subAllocation);
+
+	CreatePlacedResource(device, subAllocation.offset, resourceDesc, initialState, clearValue, allocation);
+
+	allocation.subAllocation = subAllocation;
+}
+
+void Graphics::TextureHeapPage::AllocateAt(ID3D12Device* device, uint64_t offset, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState,
+	const D3D12_CLEAR_VALUE* clearValue, TextureAllocation& allocation)
+{
+	if (!isAliasing || offset >= heapSize)
+		throw std::exception("TextureHeapPage::AllocateAt: Bad allocation");
+
+	CreatePlacedResource(device, offset, resourceDesc, initialState, clearValue, allocation);
+
+	allocation.subAllocation = { offset, 0, SegregatedFitAllocator::INVALID_BLOCK };
+}
+
+void Graphics::TextureHeapPage::Deallocate(const TextureAllocation& allocation)
+{
+	auto placedResourceIt = std::find_if(placedResources.begin(), placedResources.end(),
+		[&allocation](const ComPtr<ID3D12Resource>& placedResource) { return placedResource.Get() == allocation.textureResource; });
+
+	if (allocation.heapPage != this || placedResourceIt == placedResources.end())
+		throw std::exception("TextureHeapPage::Deallocate: Invalid allocation");
+
+	if (!isAliasing)
+		subAllocator.Deallocate(allocation.subAllocation);
+
+	placedResources.erase(placedResourceIt);
+}
+
+bool Graphics::TextureHeapPage::HasSpace(uint64_t _size, uint64_t alignment) const noexcept
+{
+	return !isAliasing && subAllocator.CanAllocate(_size, alignment);
+}
+
+bool Graphics::TextureHeapPage::IsEmpty() const noexcept
+{
+	return placedResources.empty();
+}
+
+bool Graphics::TextureHeapPage::IsAliasing() const noexcept
+{
+	return isAliasing;
+}
+
+D3D12_HEAP_FLAGS Graphics::TextureHeapPage::GetHeapFlags() const noexcept
+{
+	return heapFlags;
+}
+
+uint64_t Graphics::TextureHeapPage::GetHeapSize() const noexcept
+{
+	return heapSize;
+}
+
+uint64_t Graphics::TextureHeapPage::GetUsedSize() const noexcept
+{
+	return isAliasing ? heapSize : subAllocator.GetUsedSize();
+}
+
+uint64_t Graphics::TextureHeapPage::GetLargestFreeBlockSize() const noexcept
+{
+	return isAliasing ? 0 : subAllocator.GetLargestFreeBlockSize();
+}
+
+void Graphics::TextureHeapPage::CreatePlacedResource(ID3D12Device* device, uint64_t offset, const D3D12_RESOURCE_DESC& resourceDesc,
+	D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue, TextureAllocation& allocation)
+{
+	ComPtr<ID3D12Resource> placedResource;
+
+	ThrowIfFailed(device->CreatePlacedResource(heap.Get(), offset, &resourceDesc, initialState, clearValue, IID_PPV_ARGS(&placedResource)),
+		"TextureHeapPage::CreatePlacedResource: Placed resource creating error");
+
+	placedResources.push_back(placedResource);
+
+	allocation.cpuAddress = nullptr;
+	allocation.textureResource = placedResource.Get();
+	allocation.page = nullptr;
+	allocation.heapPage = this;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "TextureAllocationPage.h"
+
+namespace Graphics
+{
+	// Default heap holding placed textures. Regular pages sub-allocate their range, so textures sharing a heap never overlap.
+	// Aliasing pages take fixed offsets from an aliasing plan instead, and textures placed there may share memory.
+	class TextureHeapPage
+	{
+	public:
+		TextureHeapPage(ID3D12Device* device, D3D12_HEAP_FLAGS _heapFlags, uint64_t _heapSize, uint64_t heapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+			bool _isAliasing = false);
+		~TextureHeapPage();
+
+		void Allocate(ID3D12Device* device, const D3D12_RESOURCE_DESC& resourceDesc, const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo,
+			D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue, TextureAllocation& allocation);
+		void AllocateAt(ID3D12Device* device, uint64_t offset, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState,
+			const D3D12_CLEAR_VALUE* clearValue, TextureAllocation& allocation);
+		void Deallocate(const TextureAllocation& allocation);
+
+		bool HasSpace(uint64_t _size, uint64_t alignment) const noexcept;
+		bool IsEmpty() const noexcept;
+		bool IsAliasing() const noexcept;
+
+		D3D12_HEAP_FLAGS GetHeapFlags() const noexcept;
+		uint64_t GetHeapSize() const noexcept;
+		uint64_t GetUsedSize() const noexcept;
+		uint64_t GetLargestFreeBlockSize() const noexcept;
+
+	private:
+		TextureHeapPage(const TextureHeapPage&) = delete;
+		TextureHeapPage& operator=(const TextureHeapPage&) = delete;
+
+		void CreatePlacedResource(ID3D12Device* device, uint64_t offset, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState,
+			const D3D12_CLEAR_VALUE* clearValue, TextureAllocation& allocation);
+
+		D3D12_HEAP_FLAGS heapFlags;
+		uint64_t heapSize;
+
+		bool isAliasing;
+
+		SegregatedFitAllocator subAllocator;
+
+		std::vector<ComPtr<ID3D12Resource>> placedResources;
+
+		ComPtr<ID3D12Heap> heap;
+	};
+}
@@ -0,0 +1,344 @@
+#include "TriangleHierarchy.h"
+
+Graphics::TriangleHierarchy::TriangleHierarchy(uint32_t _maxTrianglesPerLeaf)
+	: maxTrianglesPerLeaf((std::max)(_maxTrianglesPerLeaf, 1u)), queryStatistics{}
+{
+
+}
+
+Graphics::TriangleHierarchy::~TriangleHierarchy()
+{
+
+}
+
+void Graphics::TriangleHierarchy::Build(const float3* positions, size_t positionsCount, size_t positionsStride, const uint32_t* indices, size_t indicesCount)
+{
+	if (indicesCount % 3 != 0)
+		throw std::exception("TriangleHierarchy::Build: indices count is not a multiple of three");
+
+	nodes.clear();
+	triangles.clear();
+
+	size_t trianglesCount = indicesCount / 3;
+
+	if (trianglesCount == 0)
+		return;
+
+	auto getPosition = [positions, positionsCount, positionsStride](uint32_t index)
+	{
+		if (index >= positionsCount)
+			throw std::exception("TriangleHierarchy::Build: index is out of range");
+
+		return XMLoadFloat3(reinterpret_cast<const float3*>(reinterpret_cast<const uint8_t*>(positions) + index * positionsStride));
+	};
+
+	std::vector<float3> centroids(trianglesCount);
+	triangles.resize(trianglesCount);
+
+	for (size_t triangleId = 0; triangleId < trianglesCount; triangleId++)
+	{
+		floatN position0 = getPosition(indices[triangleId * 3]);
+		floatN position1 = getPosition(indices[triangleId * 3 + 1]);
+		floatN position2 = getPosition(indices[triangleId * 3 + 2]);
+
+		Triangle& triangle = triangles[triangleId];
+		XMStoreFloat3(&triangle.position0, position0);
+		XMStoreFloat3(&triangle.edge1, position1 - position0);
+		XMStoreFloat3(&triangle.edge2, position2 - position0);
+		triangle.triangleId = static_cast<uint32_t>(triangleId);
+
+		XMStoreFloat3(&centroids[triangleId], (position0 + position1 + position2) / 3.0f);
+	}
+
+	nodes.reserve(2 * trianglesCount / maxTrianglesPerLeaf + 1);
+
+	BuildNode(0, static_cast<uint32_t>(trianglesCount), 1, centroids);
+}
+
+bool Graphics::TriangleHierarchy::RaycastNearest(const float3& origin, const float3& direction, float maxDistance, TriangleHit& result)
+{
+	return CastRay<false>(origin, direction, maxDistance, result);
+}
+
+bool Graphics::TriangleHierarchy::RaycastAny(const float3& origin, const float3& direction, float maxDistance)
+{
+	TriangleHit hit;
+
+	return CastRay<true>(origin, direction, maxDistance, hit);
+}
+
+bool Graphics::TriangleHierarchy::ContainsPoint(const float2& point)
+{
+	if (nodes.empty())
+		return false;
+
+	queryStatistics.queries++;
+
+	bool isInside = false;
+
+	uint32_t traversalStack[MAX_TRAVERSAL_DEPTH];
+	uint32_t traversalStackSize = 0;
+
+	traversalStack[traversalStackSize++] = 0;
+
+	while (traversalStackSize != 0 && !isInside)
+	{
+		const Node& node = nodes[traversalStack[--traversalStackSize]];
+
+		queryStatistics.nodesVisited++;
+
+		if (point.x < node.minCornerPoint.x || point.x > node.maxCornerPoint.x || point.y < node.minCornerPoint.y || point.y > node.maxCornerPoint.y)
+			continue;
+
+		if (node.IsLeaf())
+		{
+			for (uint32_t triangleId = node.offset; triangleId < node.offset + node.trianglesCount && !isInside; triangleId++)
+			{
+				queryStatistics.trianglesTested++;
+
+				isInside = CheckPointInTriangle(point, triangles[triangleId]);
+			}
+
+			continue;
+		}
+
+		traversalStack[traversalStackSize++] = node.offset;
+		traversalStack[traversalStackSize++] = static_cast<uint32_t>(&node - nodes.data()) + 1;
+	}
+
+	return isInside;
+}
+
+bool Graphics::TriangleHierarchy::IsEmpty() const noexcept
+{
+	return nodes.empty();
+}
+
+size_t Graphics::TriangleHierarchy::GetTrianglesCount() const noexcept
+{
+	return triangles.size();
+}
+
+size_t Graphics::TriangleHierarchy::GetNodesCount() const noexcept
+{
+	return nodes.size();
+}
+
+const Graphics::TriangleQueryStatistics& Graphics::TriangleHierarchy::GetQueryStatistics() const noexcept
+{
+	return queryStatistics;
+}
+
+void Graphics::TriangleHierarchy::ResetQueryStatistics() noexcept
+{
+	queryStatistics = {};
+}
+
+uint32_t Graphics::TriangleHierarchy::BuildNode(uint32_t firstTriangle, uint32_t trianglesCount, uint32_t depth, std::vector<float3>& centroids)
+{
+	// Median splits keep the depth near log2 of the triangles count, a split rule that cannot promise that has to fail here instead of
+	// overflowing the traversal stack of a query
+	if (depth >= MAX_TRAVERSAL_DEPTH)
+		throw std::exception("TriangleHierarchy::Build: hierarchy is deeper than the traversal stack");
+
+	uint32_t nodeId = static_cast<uint32_t>(nodes.size());
+	nodes.emplace_back();
+
+	floatN minCornerPoint = XMVectorReplicate(FLT_MAX);
+	floatN maxCornerPoint = XMVectorReplicate(-FLT_MAX);
+	floatN minCentroid = XMVectorReplicate(FLT_MAX);
+	floatN maxCentroid = XMVectorReplicate(-FLT_MAX);
+
+	for (uint32_t triangleId = firstTriangle; triangleId < firstTriangle + trianglesCount; triangleId++)
+	{
+		const Triangle& triangle = triangles[triangleId];
+
+		floatN position0 = XMLoadFloat3(&triangle.position0);
+		floatN position1 = position0 + XMLoadFloat3(&triangle.edge1);
+		floatN position2 = position0 + XMLoadFloat3(&triangle.edge2);
+
+		minCornerPoint = XMVectorMin(minCornerPoint, XMVectorMin(position0, XMVectorMin(position1, position2)));
+		maxCornerPoint = XMVectorMax(maxCornerPoint, XMVectorMax(position0, XMVectorMax(position1, position2)));
+
+		floatN centroid = XMLoadFloat3(&centroids[triangleId]);
+		minCentroid = XMVectorMin(minCentroid, centroid);
+		maxCentroid = XMVectorMax(maxCentroid, centroid);
+	}
+
+	XMStoreFloat3(&nodes[nodeId].minCornerPoint, minCornerPoint);
+	XMStoreFloat3(&nodes[nodeId].maxCornerPoint, maxCornerPoint);
+
+	float3 centroidsExtent;
+	XMStoreFloat3(&centroidsExtent, maxCentroid - minCentroid);
+
+	if (trianglesCount <= maxTrianglesPerLeaf || (centroidsExtent.x == 0.0f && centroidsExtent.y == 0.0f && centroidsExtent.z == 0.0f))
+	{
+		nodes[nodeId].offset = firstTriangle;
+		nodes[nodeId].trianglesCount = trianglesCount;
+
+		return nodeId;
+	}
+
+	uint32_t splitAxis = (centroidsExtent.x >= centroidsExtent.y && centroidsExtent.x >= centroidsExtent.z) ? 0 : (centroidsExtent.y >= centroidsExtent.z) ? 1 : 2;
+	uint32_t middleTriangle = firstTriangle + trianglesCount / 2;
+
+	std::vector<uint32_t> order(trianglesCount);
+	std::iota(order.begin(), order.end(), firstTriangle);
+
+	auto getCentroidAxis = [&centroids, splitAxis](uint32_t triangleId)
+	{
+		const float3& centroid = centroids[triangleId];
+
+		return splitAxis == 0 ? centroid.x : splitAxis == 1 ? centroid.y : centroid.z;
+	};
+
+	std::nth_element(order.begin(), order.begin() + (middleTriangle - firstTriangle), order.end(),
+		[&getCentroidAxis](uint32_t leftTriangleId, uint32_t rightTriangleId) { return getCentroidAxis(leftTriangleId) < getCentroidAxis(rightTriangleId); });
+
+	std::vector<Triangle> sortedTriangles(trianglesCount);
+	std::vector<float3> sortedCentroids(trianglesCount);
+
+	for (uint32_t orderId = 0; orderId < trianglesCount; orderId++)
+	{
+		sortedTriangles[orderId] = triangles[order[orderId]];
+		sortedCentroids[orderId] = centroids[order[orderId]];
+	}
+
+	std::copy(sortedTriangles.begin(), sortedTriangles.end(), triangles.begin() + firstTriangle);
+	std::copy(sortedCentroids.begin(), sortedCentroids.end(), centroids.begin() + firstTriangle);
+
+	BuildNode(firstTriangle, middleTriangle - firstTriangle, depth + 1, centroids);
+	uint32_t rightChild = BuildNode(middleTriangle, firstTriangle + trianglesCount - middleTriangle, depth + 1, centroids);
+
+	nodes[nodeId].offset = rightChild;
+	nodes[nodeId].trianglesCount = 0;
+
+	return nodeId;
+}
+
+template<bool anyHit>
+bool Graphics::TriangleHierarchy::CastRay(const float3& origin, const float3& direction, float maxDistance, TriangleHit& result)
+{
+	floatN rayDirection = XMLoadFloat3(&direction);
+
+	if (nodes.empty() || XMVector3Equal(rayDirection, XMVectorZero()))
+		return false;
+
+	queryStatistics.queries++;
+
+	floatN rayOrigin = XMLoadFloat3(&origin);
+	rayDirection = XMVector3Normalize(rayDirection);
+	floatN rayInverseDirection = XMVectorReciprocal(rayDirection);
+
+	bool isHit = false;
+
+	uint32_t traversalStack[MAX_TRAVERSAL_DEPTH];
+	uint32_t traversalStackSize = 0;
+
+	traversalStack[traversalStackSize++] = 0;
+
+	while (traversalStackSize != 0)
+	{
+		uint32_t nodeId = traversalStack[--traversalStackSize];
+		const Node& node = nodes[nodeId];
+
+		queryStatistics.nodesVisited++;
+
+		float entryDistance;
+
+		if (!IntersectRayBoundingBox(rayOrigin, rayInverseDirection, { node.minCornerPoint, node.maxCornerPoint }, maxDistance, entryDistance))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			for (uint32_t triangleId = node.offset; triangleId < node.offset + node.trianglesCount; triangleId++)
+			{
+				queryStatistics.trianglesTested++;
+
+				if (IntersectRayTriangle(rayOrigin, rayDirection, triangles[triangleId], maxDistance, result))
+				{
+					isHit = true;
+
+					if (anyHit)
+						break;
+
+					maxDistance = result.distance;
+				}
+			}
+
+			if (anyHit && isHit)
+				break;
+
+			continue;
+		}
+
+		uint32_t nearChild = nodeId + 1;
+		uint32_t farChild = node.offset;
+
+		float nearEntryDistance = FLT_MAX, farEntryDistance = FLT_MAX;
+		IntersectRayBoundingBox(rayOrigin, rayInverseDirection, { nodes[nearChild].minCornerPoint, nodes[nearChild].maxCornerPoint }, maxDistance,
+			nearEntryDistance);
+		IntersectRayBoundingBox(rayOrigin, rayInverseDirection, { nodes[farChild].minCornerPoint, nodes[farChild].maxCornerPoint }, maxDistance,
+			farEntryDistance);
+
+		if (farEntryDistance < nearEntryDistance)
+			std::swap(nearChild, farChild);
+
+		traversalStack[traversalStackSize++] = farChild;
+		traversalStack[traversalStackSize++] = nearChild;
+	}
+
+	return isHit;
+}
+
+bool Graphics::TriangleHierarchy::IntersectRayTriangle(const floatN& origin, const floatN& direction, const Triangle& triangle, float maxDistance,
+	TriangleHit& result) noexcept
+{
+	floatN edge1 = XMLoadFloat3(&triangle.edge1);
+	floatN edge2 = XMLoadFloat3(&triangle.edge2);
+
+	floatN directionCrossEdge2 = XMVector3Cross(direction, edge2);
+	float determinant = XMVectorGetX(XMVector3Dot(edge1, directionCrossEdge2));
+
+	if (std::abs(determinant) < FLT_EPSILON)
+		return false;
+
+	float inverseDeterminant = 1.0f / determinant;
+
+	floatN originOffset = origin - XMLoadFloat3(&triangle.position0);
+	float u = XMVectorGetX(XMVector3Dot(originOffset, directionCrossEdge2)) * inverseDeterminant;
+
+	if (u < 0.0f || u > 1.0f)
+		return false;
+
+	floatN offsetCrossEdge1 = XMVector3Cross(originOffset, edge1);
+	float v = XMVectorGetX(XMVector3Dot(direction, offsetCrossEdge1)) * inverseDeterminant;
+
+	if (v < 0.0f || u + v > 1.0f)
+		return false;
+
+	float distance = XMVectorGetX(XMVector3Dot(edge2, offsetCrossEdge1)) * inverseDeterminant;
+
+	if (distance < 0.0f || distance > maxDistance)
+		return false;
+
+	result = { triangle.triangleId, distance, { u, v } };
+
+	return true;
+}
+
+bool Graphics::TriangleHierarchy::CheckPointInTriangle(const float2& point, const Triangle& triangle) noexcept
+{
+	float offsetX = point.x - triangle.position0.x;
+	float offsetY = point.y - triangle.position0.y;
+
+	float determinant = triangle.edge1.x * triangle.edge2.y - triangle.edge1.y * triangle.edge2.x;
+
+	if (determinant == 0.0f)
+		return false;
+
+	float u = (offsetX * triangle.edge2.y - offsetY * triangle.edge2.x) / determinant;
+	float v = (triangle.edge1.x * offsetY - triangle.edge1.y * offsetX) / determinant;
+
+	return u >= 0.0f && v >= 0.0f && u + v <= 1.0f;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "GraphicsHelper.h"
+
+namespace Graphics
+{
+	struct TriangleHit
+	{
+		uint32_t triangleId;
+		float distance;
+		float2 barycentric;
+	};
+
+	struct TriangleQueryStatistics
+	{
+		size_t queries;
+		size_t nodesVisited;
+		size_t trianglesTested;
+	};
+
+	class TriangleHierarchy
+	{
+	public:
+		TriangleHierarchy(uint32_t _maxTrianglesPerLeaf = 4);
+		~TriangleHierarchy();
+
+		void Build(const float3* positions, size_t positionsCount, size_t positionsStride, const uint32_t* indices, size_t indicesCount);
+
+		bool RaycastNearest(const float3& origin, const float3& direction, float maxDistance, TriangleHit& result);
+		bool RaycastAny(const float3& origin, const float3& direction, float maxDistance);
+		bool ContainsPoint(const float2& point);
+
+		bool IsEmpty() const noexcept;
+		size_t GetTrianglesCount() const noexcept;
+		size_t GetNodesCount() const noexcept;
+
+		const TriangleQueryStatistics& GetQueryStatistics() const noexcept;
+		void ResetQueryStatistics() noexcept;
+
+	private:
+		TriangleHierarchy(const TriangleHierarchy&) = delete;
+		TriangleHierarchy& operator=(const TriangleHierarchy&) = delete;
+
+		// Queries keep their traversal stack on the stack, it holds at most one entry per level plus one
+		static constexpr uint32_t MAX_TRAVERSAL_DEPTH = 64;
+
+		struct Node
+		{
+			float3 minCornerPoint;
+			uint32_t offset;
+			float3 maxCornerPoint;
+			uint32_t trianglesCount;
+
+			bool IsLeaf() const noexcept
+			{
+				return trianglesCount != 0;
+			}
+		};
+
+		struct Triangle
+		{
+			float3 position0;
+			float3 edge1;
+			float3 edge2;
+			uint32_t triangleId;
+		};
+
+		uint32_t BuildNode(uint32_t firstTriangle, uint32_t trianglesCount, uint32_t depth, std::vector<float3>& centroids);
+
+		template<bool anyHit>
+		bool CastRay(const float3& origin, const float3& direction, float maxDistance, TriangleHit& result);
+
+		static bool IntersectRayTriangle(const floatN& origin, const floatN& direction, const Triangle& triangle, float maxDistance, TriangleHit& result) noexcept;
+		static bool CheckPointInTriangle(const float2& point, const Triangle& triangle) noexcept;
+
+		uint32_t maxTrianglesPerLeaf;
+
+		std::vector<Node> nodes;
+		std::vector<Triangle> triangles;
+
+		TriangleQueryStatistics queryStatistics;
+	};
+}
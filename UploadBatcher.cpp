@@ -0,0 +1,87 @@
+#include "UploadBatcher.h"
+
+Graphics::UploadBatcher::UploadBatcher(uint64_t firstBatchId, uint64_t _maxBatchSize, size_t _maxBatchUploads, const UploadTimingModel& _timingModel)
+	: currentBatchId(firstBatchId), maxBatchSize(_maxBatchSize), maxBatchUploads(_maxBatchUploads), pendingBytes(0), pendingUploads(0),
+	timingModel(_timingModel), statistics{}
+{
+
+}
+
+Graphics::UploadBatcher::~UploadBatcher()
+{
+
+}
+
+Graphics::UploadTicket Graphics::UploadBatcher::RecordUpload(uint64_t size) noexcept
+{
+	pendingBytes += size;
+	pendingUploads++;
+
+	float transferTime = size / timingModel.bytesPerMillisecond;
+
+	statistics.uploadsRecorded++;
+	statistics.bytesRecorded += size;
+	statistics.modeledBatchedTime += transferTime;
+
+	// Without batching every upload pays a submit and a blocking round trip of its own
+	statistics.modeledUnbatchedTime += timingModel.submitTime + timingModel.roundTripTime + transferTime;
+
+	return { currentBatchId };
+}
+
+uint64_t Graphics::UploadBatcher::Flush(bool isForced) noexcept
+{
+	uint64_t flushedBatchId = currentBatchId++;
+
+	pendingBytes = 0;
+	pendingUploads = 0;
+
+	statistics.batchesFlushed++;
+	statistics.modeledBatchedTime += timingModel.submitTime;
+
+	if (isForced)
+		statistics.forcedFlushes++;
+
+	return flushedBatchId;
+}
+
+void Graphics::UploadBatcher::RegisterWait() noexcept
+{
+	statistics.cpuWaits++;
+	statistics.modeledBatchedTime += timingModel.roundTripTime;
+}
+
+bool Graphics::UploadBatcher::HasPendingUploads() const noexcept
+{
+	return pendingUploads != 0;
+}
+
+bool Graphics::UploadBatcher::IsFlushRequired() const noexcept
+{
+	return pendingBytes >= maxBatchSize || pendingUploads >= maxBatchUploads;
+}
+
+bool Graphics::UploadBatcher::IsComplete(const UploadTicket& ticket, uint64_t completedBatchId) const noexcept
+{
+	return ticket.batchId < currentBatchId && ticket.batchId <= completedBatchId;
+}
+
+uint64_t Graphics::UploadBatcher::GetCurrentBatchId() const noexcept
+{
+	return currentBatchId;
+}
+
+uint64_t Graphics::UploadBatcher::GetLastFlushedBatchId() const noexcept
+{
+	return currentBatchId - 1;
+}
+
+const Graphics::UploadBatchStatistics& Graphics::UploadBatcher::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+void Graphics::UploadBatcher::ResetStatistics() noexcept
+{
+	statistics = {};
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Graphics
+{
+	struct UploadTicket
+	{
+		uint64_t batchId;
+	};
+
+	struct UploadTimingModel
+	{
+		float submitTime;
+		float roundTripTime;
+		float bytesPerMillisecond;
+	};
+
+	struct UploadBatchStatistics
+	{
+		size_t uploadsRecorded;
+		size_t batchesFlushed;
+		size_t forcedFlushes;
+		size_t cpuWaits;
+		uint64_t bytesRecorded;
+		float modeledBatchedTime;
+		float modeledUnbatchedTime;
+	};
+
+	// Groups uploads into batches and decides when a batch has to be submitted. Batch ids are the fence values the batches
+	// are signaled with, so a ticket is complete once the fence reaches its batch id.
+	class UploadBatcher
+	{
+	public:
+		UploadBatcher(uint64_t firstBatchId, uint64_t _maxBatchSize, size_t _maxBatchUploads, const UploadTimingModel& _timingModel);
+		~UploadBatcher();
+
+		UploadTicket RecordUpload(uint64_t size) noexcept;
+		// Always closes the current batch and consumes its id, even an empty one is counted as a submit. Callers with nothing to send
+		// check HasPendingUploads first, readbacks flush regardless because their copies are recorded into the batch.
+		uint64_t Flush(bool isForced) noexcept;
+		void RegisterWait() noexcept;
+
+		bool HasPendingUploads() const noexcept;
+		bool IsFlushRequired() const noexcept;
+		bool IsComplete(const UploadTicket& ticket, uint64_t completedBatchId) const noexcept;
+
+		uint64_t GetCurrentBatchId() const noexcept;
+		uint64_t GetLastFlushedBatchId() const noexcept;
+
+		const UploadBatchStatistics& GetStatistics() const noexcept;
+		void ResetStatistics() noexcept;
+
+	private:
+		UploadBatcher() = delete;
+		UploadBatcher(const UploadBatcher&) = delete;
+		UploadBatcher& operator=(const UploadBatcher&) = delete;
+
+		uint64_t currentBatchId;
+		uint64_t maxBatchSize;
+		size_t maxBatchUploads;
+
+		uint64_t pendingBytes;
+		size_t pendingUploads;
+
+		UploadTimingModel timingModel;
+		UploadBatchStatistics statistics;
+	};
+}
@@ -0,0 +1,132 @@
+#include "UploadRing.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+Graphics::UploadRing::UploadRing(uint64_t _capacity)
+	: capacity(_capacity), head(0), tail(0), usedSize(0), currentFrameSize(0), frameIndex(0), statistics{}
+{
+	if (capacity == 0)
+		throw std::runtime_error("UploadRing::UploadRing: Capacity must be non-zero");
+}
+
+Graphics::UploadRing::~UploadRing()
+{
+
+}
+
+bool Graphics::UploadRing::Allocate(uint64_t size, uint64_t alignment, uint64_t& offset) noexcept
+{
+	alignment = (std::max)(alignment, uint64_t(1));
+
+	uint64_t alignedHead = (head + alignment - 1) & ~(alignment - 1);
+	uint64_t consumedSize = 0;
+
+	if (usedSize != 0 && head == tail)
+	{
+		statistics.failedAllocationsCount++;
+
+		return false;
+	}
+
+	if (head >= tail)
+	{
+		if (alignedHead + size <= capacity)
+		{
+			offset = alignedHead;
+			consumedSize = alignedHead + size - head;
+		}
+		else if (size <= tail)
+		{
+			// The remainder of the range up to capacity is skipped and retires together with this frame
+			offset = 0;
+			consumedSize = capacity - head + size;
+		}
+		else
+		{
+			statistics.failedAllocationsCount++;
+
+			return false;
+		}
+	}
+	else
+	{
+		if (alignedHead + size <= tail)
+		{
+			offset = alignedHead;
+			consumedSize = alignedHead + size - head;
+		}
+		else
+		{
+			statistics.failedAllocationsCount++;
+
+			return false;
+		}
+	}
+
+	head = offset + size;
+	usedSize += consumedSize;
+	currentFrameSize += consumedSize;
+
+	statistics.allocationsCount++;
+	statistics.allocatedBytes += size;
+	statistics.peakUsedSize = (std::max)(statistics.peakUsedSize, usedSize);
+
+	return true;
+}
+
+void Graphics::UploadRing::FinishFrame(uint64_t fenceValue)
+{
+	pendingFrames.push_back({ fenceValue, head, currentFrameSize });
+
+	currentFrameSize = 0;
+	frameIndex++;
+}
+
+void Graphics::UploadRing::ReleaseCompletedFrames(uint64_t completedFenceValue) noexcept
+{
+	while (!pendingFrames.empty() && pendingFrames.front().fenceValue <= completedFenceValue)
+	{
+		// A frame without allocations may have been finished before the last rewind, its end offset is stale
+		if (pendingFrames.front().usedSize != 0)
+			tail = pendingFrames.front().endOffset;
+
+		usedSize -= pendingFrames.front().usedSize;
+
+		pendingFrames.pop_front();
+
+		statistics.framesRetired++;
+	}
+
+	// Nothing is in flight, so the next allocations start from the beginning and never have to skip the end of the range
+	if (usedSize == 0)
+	{
+		head = 0;
+		tail = 0;
+	}
+}
+
+uint64_t Graphics::UploadRing::GetFrameIndex() const noexcept
+{
+	return frameIndex;
+}
+
+uint64_t Graphics::UploadRing::GetCapacity() const noexcept
+{
+	return capacity;
+}
+
+uint64_t Graphics::UploadRing::GetUsedSize() const noexcept
+{
+	return usedSize;
+}
+
+const Graphics::UploadRingStatistics& Graphics::UploadRing::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+void Graphics::UploadRing::ResetStatistics() noexcept
+{
+	statistics = {};
+}
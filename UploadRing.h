@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace Graphics
+{
+	struct UploadRingStatistics
+	{
+		size_t allocationsCount;
+		size_t failedAllocationsCount;
+		size_t framesRetired;
+		uint64_t allocatedBytes;
+		uint64_t peakUsedSize;
+	};
+
+	// Linear ring over an abstract address range. Every frame bump-allocates from the head and is tagged with a fence value
+	// when finished, the tail moves forward once that fence is reported as completed.
+	class UploadRing
+	{
+	public:
+		UploadRing(uint64_t _capacity);
+		~UploadRing();
+
+		bool Allocate(uint64_t size, uint64_t alignment, uint64_t& offset) noexcept;
+
+		void FinishFrame(uint64_t fenceValue);
+		void ReleaseCompletedFrames(uint64_t completedFenceValue) noexcept;
+
+		uint64_t GetFrameIndex() const noexcept;
+		uint64_t GetCapacity() const noexcept;
+		uint64_t GetUsedSize() const noexcept;
+
+		const UploadRingStatistics& GetStatistics() const noexcept;
+		void ResetStatistics() noexcept;
+
+	private:
+		UploadRing() = delete;
+		UploadRing(const UploadRing&) = delete;
+		UploadRing& operator=(const UploadRing&) = delete;
+
+		struct FrameMarker
+		{
+			uint64_t fenceValue;
+			uint64_t endOffset;
+			uint64_t usedSize;
+		};
+
+		uint64_t capacity;
+		uint64_t head;
+		uint64_t tail;
+		uint64_t usedSize;
+		uint64_t currentFrameSize;
+		uint64_t frameIndex;
+
+		std::deque<FrameMarker> pendingFrames;
+
+		UploadRingStatistics statistics;
+	};
+}
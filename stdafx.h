@@ -40,11 +40,16 @@
 #include <deque>
 #include <list>
 #include <mutex>
+#include <atomic>
 #include <set>
+#include <unordered_map>
 #include <algorithm>
 #include <regex>
 #include <set>
 #include <random>
+#include <chrono>
+#include <cfloat>
+#include <bitset>
 
 using namespace Microsoft::WRL;
 using namespace DirectX;